@@ -0,0 +1,205 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#pragma once
+
+#include <joemath/matrix.hpp>
+#include <joemath/types.hpp>
+
+//
+// Affine transforms
+//
+// An Affine stores the upper three rows of a 4x4 matrix whose last row is
+// 0 0 0 1, so it takes three quarters of the memory of the 4x4 matrix and
+// composing and inverting them skips all the work on the last row. The
+// columns are the same as those of the 4x4 matrix: right, forward, up and
+// then the translation.
+//
+
+namespace JoeMath
+{
+template <typename Scalar>
+class Affine
+{
+public:
+    Matrix<Scalar, 3, 4> m_matrix;
+
+    using scalar_type = Scalar;
+    using vector_type = Vector<Scalar, 3>;
+    using linear_type = Matrix<Scalar, 3, 3>;
+
+    //
+    // Constructors
+    //
+
+    /**
+      * Doesn't initialize the data
+      */
+    Affine              ( );
+
+    Affine              ( const Matrix<Scalar, 3, 3>& linear,
+                          const Vector<Scalar, 3>& translation );
+
+    explicit Affine     ( const Matrix<Scalar, 3, 4>& m );
+
+    /**
+      * Takes the upper three rows of m, the last row is assumed to be 0 0 0 1
+      */
+    explicit Affine     ( const Matrix<Scalar, 4, 4>& m );
+
+    //
+    // Setters and Getters
+    //
+
+    const Vector<Scalar, 3>&            GetRight      ( )         const;
+          Vector<Scalar, 3>&            GetRight      ( );
+    void                                SetRight      (
+                                                const Vector<Scalar, 3>& v );
+
+    const Vector<Scalar, 3>&            GetForward    ( )         const;
+          Vector<Scalar, 3>&            GetForward    ( );
+    void                                SetForward    (
+                                                const Vector<Scalar, 3>& v );
+
+    const Vector<Scalar, 3>&            GetUp         ( )         const;
+          Vector<Scalar, 3>&            GetUp         ( );
+    void                                SetUp         (
+                                                const Vector<Scalar, 3>& v );
+
+    const Vector<Scalar, 3>&            GetTranslation( )         const;
+          Vector<Scalar, 3>&            GetTranslation( );
+    void                                SetTranslation(
+                                                const Vector<Scalar, 3>& v );
+
+    /**
+      * The upper left 3x3 of the matrix
+      */
+    Matrix<Scalar, 3, 3>                GetLinear     ( )         const;
+    void                                SetLinear     (
+                                                const Matrix<Scalar, 3, 3>& m );
+};
+
+////////////////////////////////////////
+////////////////////////////////////////
+// Operators on affine transforms
+////////////////////////////////////////
+////////////////////////////////////////
+
+template <typename Scalar>
+bool                operator == ( const Affine<Scalar>& a0,
+                                  const Affine<Scalar>& a1 );
+
+template <typename Scalar>
+bool                operator != ( const Affine<Scalar>& a0,
+                                  const Affine<Scalar>& a1 );
+
+////////////////////////////////////////
+////////////////////////////////////////
+// Functions on affine transforms
+////////////////////////////////////////
+////////////////////////////////////////
+
+/**
+  * The transform a1 followed by a0, the same as multiplying the 4x4 matrices
+  * but with 36 multiplies instead of 64
+  */
+template <typename Scalar>
+Affine<Scalar>          Mul             ( const Affine<Scalar>& a0,
+                                          const Affine<Scalar>& a1 );
+
+/**
+  * Transforms p treating it as having a w component of 1
+  */
+template <typename Scalar>
+Vector<Scalar, 3>       TransformPoint  ( const Affine<Scalar>& a,
+                                          const Vector<Scalar, 3>& p );
+
+/**
+  * Transforms v treating it as having a w component of 0, so that it isn't
+  * translated
+  */
+template <typename Scalar>
+Vector<Scalar, 3>       TransformVector ( const Affine<Scalar>& a,
+                                          const Vector<Scalar, 3>& v );
+
+/**
+  * The determinant of the linear part
+  */
+template <typename Scalar>
+Scalar                  Determinant     ( const Affine<Scalar>& a );
+
+/**
+  * Inverts an affine transform in place by inverting the linear part
+  */
+template <typename Scalar>
+void                    Invert          ( Affine<Scalar>& a );
+
+template <typename Scalar>
+Affine<Scalar>          Inverted        ( const Affine<Scalar>& a );
+
+/**
+  * Inverts a rotation and translation in place by transposing the linear
+  * part, this is only valid when the linear part is orthonormal
+  */
+template <typename Scalar>
+void                    InvertRigid     ( Affine<Scalar>& a );
+
+template <typename Scalar>
+Affine<Scalar>          InvertedRigid   ( const Affine<Scalar>& a );
+
+/**
+  * The 4x4 matrix with a as its upper three rows and 0 0 0 1 as its last
+  */
+template <typename Scalar>
+Matrix<Scalar, 4, 4>    ToMatrix        ( const Affine<Scalar>& a );
+
+template <typename Scalar = float>
+Affine<Scalar>          IdentityAffine  ( );
+
+//
+// Batched transforms, these behave like the ones in batch.hpp
+//
+
+template <typename Scalar>
+void    TransformPoints     ( const Affine<Scalar>& a,
+                              const Vector<Scalar, 3>* in,
+                              Vector<Scalar, 3>* out,
+                              u32 count,
+                              u32 in_stride  = sizeof(Vector<Scalar, 3>),
+                              u32 out_stride = sizeof(Vector<Scalar, 3>) );
+
+template <typename Scalar>
+void    TransformVectors    ( const Affine<Scalar>& a,
+                              const Vector<Scalar, 3>* in,
+                              Vector<Scalar, 3>* out,
+                              u32 count,
+                              u32 in_stride  = sizeof(Vector<Scalar, 3>),
+                              u32 out_stride = sizeof(Vector<Scalar, 3>) );
+}
+
+#include "inl/affine-inl.hpp"
@@ -0,0 +1,111 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#pragma once
+
+#include <cstddef>
+
+#include <joemath/types.hpp>
+
+//
+// Alignment configuration
+//
+// By default a Matrix has the alignment of its Scalar. Defining
+// JOEMATH_ALIGNMENT to 16, 32 or 64 before including joemath aligns every
+// Matrix whose size is a multiple of 16 bytes to the largest power of two up
+// to JOEMATH_ALIGNMENT which divides its size, so float4 is aligned to 16
+// bytes and float4x4 to JOEMATH_ALIGNMENT. The size of a Matrix never
+// changes, so arrays of them stay dense.
+//
+// Vectors are only aligned when they have a multiple of four elements. A
+// Vector returned by xy, xyz or xyzw must be at least as aligned as the vector
+// it's taken from, so with alignment enabled xyzw can't be used on other
+// vectors with more than four elements.
+//
+// Before C++17 std::allocator and new don't respect alignments greater than
+// that of std::max_align_t, so containers of aligned matrices should use
+// AlignedAllocator.
+//
+
+#if !defined( JOEMATH_ALIGNMENT )
+    #define JOEMATH_ALIGNMENT 0
+#endif
+
+static_assert( JOEMATH_ALIGNMENT == 0  || JOEMATH_ALIGNMENT == 16 ||
+               JOEMATH_ALIGNMENT == 32 || JOEMATH_ALIGNMENT == 64,
+               "JOEMATH_ALIGNMENT must be one of 0, 16, 32 or 64" );
+
+namespace JoeMath
+{
+    const std::size_t cache_line_size = 64;
+
+    /**
+      * A standard allocator which aligns its allocations to the larger of
+      * Alignment and the alignment of T
+      */
+    template <typename T, std::size_t Alignment = cache_line_size>
+    class AlignedAllocator
+    {
+    public:
+        static_assert( Alignment != 0 && ( Alignment & ( Alignment - 1 ) ) == 0,
+                       "AlignedAllocator's alignment must be a power of two" );
+
+        using value_type = T;
+
+        static const std::size_t alignment =
+                                 Alignment > alignof(T) ? Alignment : alignof(T);
+
+        template <typename U>
+        struct rebind
+        {
+            using other = AlignedAllocator<U, Alignment>;
+        };
+
+        AlignedAllocator    ( ) noexcept;
+
+        template <typename U>
+        AlignedAllocator    ( const AlignedAllocator<U, Alignment>& ) noexcept;
+
+        /**
+          * Throws std::bad_alloc on failure
+          */
+        T*      allocate    ( std::size_t count );
+
+        void    deallocate  ( T* p, std::size_t count ) noexcept;
+    };
+
+    template <typename T, typename U, std::size_t Alignment>
+    bool        operator == ( const AlignedAllocator<T, Alignment>&,
+                              const AlignedAllocator<U, Alignment>& );
+
+    template <typename T, typename U, std::size_t Alignment>
+    bool        operator != ( const AlignedAllocator<T, Alignment>&,
+                              const AlignedAllocator<U, Alignment>& );
+}
+
+#include "inl/alignment-inl.hpp"
@@ -0,0 +1,187 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#pragma once
+
+#include <joemath/matrix.hpp>
+#include <joemath/types.hpp>
+
+//
+// Functions which transform arrays of vectors by a single matrix, or operate
+// on arrays of matrices
+//
+// The arrays are given as a pointer and a count, and optionally the distance
+// in bytes between consecutive elements so that vectors can be read from and
+// written to the middle of larger structures. Each element is read completely
+// before its result is written, so out may be the same as in as long as the
+// strides are the same.
+//
+
+namespace JoeMath
+{
+/**
+  * Transforms count points by m, treating them as having a w component of 1.
+  * The last row of m is ignored, so this is only valid for affine transforms.
+  * The results are the same as those of Mul with the extended vector.
+  */
+template <typename Scalar, u32 Size>
+void    TransformPoints     ( const Matrix<Scalar, Size, Size>& m,
+                              const Vector<Scalar, Size-1>* in,
+                              Vector<Scalar, Size-1>* out,
+                              u32 count,
+                              u32 in_stride  = sizeof(Vector<Scalar, Size-1>),
+                              u32 out_stride = sizeof(Vector<Scalar, Size-1>) );
+
+/**
+  * Transforms count vectors by m, treating them as having a w component of 0,
+  * so that they aren't affected by the translation in m.
+  */
+template <typename Scalar, u32 Size>
+void    TransformVectors    ( const Matrix<Scalar, Size, Size>& m,
+                              const Vector<Scalar, Size-1>* in,
+                              Vector<Scalar, Size-1>* out,
+                              u32 count,
+                              u32 in_stride  = sizeof(Vector<Scalar, Size-1>),
+                              u32 out_stride = sizeof(Vector<Scalar, Size-1>) );
+
+/**
+  * Transforms count homogeneous vectors by m. Each result is Mul( m, in[i] ).
+  */
+template <typename Scalar, u32 Size>
+void    TransformHomogeneous( const Matrix<Scalar, Size, Size>& m,
+                              const Vector<Scalar, Size>* in,
+                              Vector<Scalar, Size>* out,
+                              u32 count,
+                              u32 in_stride  = sizeof(Vector<Scalar, Size>),
+                              u32 out_stride = sizeof(Vector<Scalar, Size>) );
+
+/**
+  * Inverts count matrices, out[i] = Inverted( in[i] ). out may be the same as
+  * in. If singular isn't null, singular[i] is set to whether the determinant
+  * of in[i] is too small to take the reciprocal of, in which case out[i] is
+  * unspecified.
+  */
+template <typename Scalar, u32 Size>
+void    InvertBatch         ( const Matrix<Scalar, Size, Size>* in,
+                              Matrix<Scalar, Size, Size>* out,
+                              u32 count,
+                              bool* singular = nullptr );
+
+//
+// Normalizing and measuring arrays of vectors, out[i] is the result of the
+// function of the same name in matrix.hpp on in[i]. The float3 and float4
+// versions process four vectors at a time and give the same results. For the
+// normalizing functions out may be the same as in.
+//
+
+template <typename Scalar, u32 Size>
+void    NormalizedPrecise   ( const Vector<Scalar, Size>* in,
+                              Vector<Scalar, Size>* out,
+                              u32 count );
+
+template <typename Scalar, u32 Size>
+void    NormalizedFast      ( const Vector<Scalar, Size>* in,
+                              Vector<Scalar, Size>* out,
+                              u32 count );
+
+template <typename Scalar, u32 Size>
+void    NormalizedSafe      ( const Vector<Scalar, Size>* in,
+                              Vector<Scalar, Size>* out,
+                              u32 count,
+                              const Vector<Scalar, Size>& fallback =
+                                            Vector<Scalar, Size>( Scalar{0} ) );
+
+template <typename Scalar, u32 Size>
+void    LengthFast          ( const Vector<Scalar, Size>* in,
+                              Scalar* out,
+                              u32 count );
+
+template <typename Scalar, u32 Size>
+void    InverseLength       ( const Vector<Scalar, Size>* in,
+                              Scalar* out,
+                              u32 count );
+
+//
+// Rotations of arrays of angles, sin[i] and cos[i] are the results of
+// SinCosFast on angles[i], and the float version computes four at a time.
+// out[i] is RotateZ( angles[i] ).
+//
+
+template <typename Scalar>
+void    SinCosFast          ( const Scalar* angles,
+                              Scalar* sin,
+                              Scalar* cos,
+                              u32 count );
+
+inline void SinCosFast      ( const float* angles,
+                              float* sin,
+                              float* cos,
+                              u32 count );
+
+template <typename Scalar, u32 Size>
+void    RotateZBatch        ( const Scalar* angles,
+                              Matrix<Scalar, Size, Size>* out,
+                              u32 count );
+
+//
+// Decompositions of arrays of 3x3 matrices, out[i] is EigenSymmetric( in[i] )
+// or SVD( in[i] ). The float versions decompose four matrices at a time and
+// give the same results.
+//
+
+template <typename Scalar>
+void    EigenSymmetricBatch ( const Matrix<Scalar, 3, 3>* in,
+                              EigenDecomposition<Scalar>* out,
+                              u32 count );
+
+template <typename Scalar>
+void    SVDBatch            ( const Matrix<Scalar, 3, 3>* in,
+                              SingularValueDecomposition<Scalar>* out,
+                              u32 count );
+
+/**
+  * out[i] = Orthonormalized( in[i] ), out may be the same as in. The float3x3
+  * and float4x4 versions process four matrices at a time and give the same
+  * results.
+  */
+template <typename Scalar, u32 Size>
+void    OrthonormalizeBatch ( const Matrix<Scalar, Size, Size>* in,
+                              Matrix<Scalar, Size, Size>* out,
+                              u32 count );
+
+/**
+  * out[i] = PolarDecompose( in[i] ), the float version processes four
+  * matrices at a time and gives the same results
+  */
+template <typename Scalar>
+void    PolarDecomposeBatch ( const Matrix<Scalar, 3, 3>* in,
+                              PolarDecomposition<Scalar>* out,
+                              u32 count );
+}
+
+#include "inl/batch-inl.hpp"
@@ -0,0 +1,191 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <system_error>
+#include <type_traits>
+
+#include <joemath/matrix.hpp>
+#include <joemath/types.hpp>
+
+//
+// Text conversion
+//
+// ToChars and FromChars convert scalars and matrices to and from text in
+// buffers owned by the caller, they never allocate and behave like
+// std::to_chars and std::from_chars.
+//
+// Floating point values are written with the fewest digits that read back to
+// the same value, and of those the closest to it, using Grisu3. The one
+// value in two hundred or so which Grisu3 can't be sure of is done exactly
+// with Dragon4 instead, which is much slower but rare enough to make little
+// difference on average. Like std::to_chars they're written in fixed or
+// scientific notation, whichever is shorter, preferring fixed. Reading is
+// exact: short inputs are converted with a single correctly rounded
+// multiplication or division and longer ones are handed to strtod without a
+// decimal point so the locale doesn't matter.
+//
+// The elements of a matrix are written in the order they're stored, column by
+// column, separated by single spaces.
+//
+// WriteArray and ReadArray stream arrays of scalars or matrices, one per line,
+// through a fixed buffer on the stack.
+//
+
+namespace JoeMath
+{
+/**
+  * ptr is one past the last character written, or last with ec set to
+  * std::errc::value_too_large if the value didn't fit
+  */
+struct ToCharsResult
+{
+    char*       ptr;
+    std::errc   ec;
+};
+
+/**
+  * ptr is one past the last character used, or first with ec set to
+  * std::errc::invalid_argument if there wasn't a value there. If the value is
+  * out of range ec is std::errc::result_out_of_range and ptr is past it.
+  */
+struct FromCharsResult
+{
+    const char* ptr;
+    std::errc   ec;
+};
+
+/**
+  * The most characters ToChars writes for a T, which is a scalar or a matrix
+  */
+template <typename T, typename = void>
+struct max_chars;
+
+template <>
+struct max_chars<float>
+: public std::integral_constant<u32, 15>
+{ };
+
+template <>
+struct max_chars<double>
+: public std::integral_constant<u32, 24>
+{ };
+
+template <typename Integer>
+struct max_chars<Integer,
+                 typename std::enable_if<std::is_integral<Integer>::value>::type>
+: public std::integral_constant<u32,
+                                std::numeric_limits<Integer>::digits10 + 1 +
+                                std::is_signed<Integer>::value>
+{ };
+
+template <typename Scalar, u32 Rows, u32 Columns>
+struct max_chars<Matrix<Scalar, Rows, Columns>>
+: public std::integral_constant<u32,
+                                Rows * Columns * ( max_chars<Scalar>::value + 1 )
+                                - 1>
+{ };
+
+////////////////////////////////////////////////////////////////////////////////
+// Writing
+////////////////////////////////////////////////////////////////////////////////
+
+ToCharsResult   ToChars     ( char* first, char* last, float value );
+
+ToCharsResult   ToChars     ( char* first, char* last, double value );
+
+template <typename Integer,
+          typename = typename std::enable_if<
+                                      std::is_integral<Integer>::value>::type>
+ToCharsResult   ToChars     ( char* first, char* last, Integer value );
+
+template <typename Scalar, u32 Rows, u32 Columns>
+ToCharsResult   ToChars     ( char* first,
+                              char* last,
+                              const Matrix<Scalar, Rows, Columns>& m );
+
+////////////////////////////////////////////////////////////////////////////////
+// Reading
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+  * Reads a number in fixed or scientific notation, or inf, infinity or nan
+  * ignoring case. Like std::from_chars there mustn't be any leading
+  * whitespace or plus sign.
+  */
+FromCharsResult FromChars   ( const char* first, const char* last, float& value );
+
+FromCharsResult FromChars   ( const char* first, const char* last, double& value );
+
+template <typename Integer,
+          typename = typename std::enable_if<
+                                      std::is_integral<Integer>::value>::type>
+FromCharsResult FromChars   ( const char* first,
+                              const char* last,
+                              Integer& value );
+
+/**
+  * Reads the elements in the order they're stored, skipping any whitespace
+  * before each of them. m is only changed if every element was read.
+  */
+template <typename Scalar, u32 Rows, u32 Columns>
+FromCharsResult FromChars   ( const char* first,
+                              const char* last,
+                              Matrix<Scalar, Rows, Columns>& m );
+
+////////////////////////////////////////////////////////////////////////////////
+// Streaming
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+  * Writes each of the count elements of data on its own line
+  */
+template <typename T>
+std::ostream&   WriteArray  ( std::ostream& out,
+                              const T* data,
+                              std::size_t count );
+
+/**
+  * Reads up to count elements separated by whitespace into data and returns
+  * how many were read. It stops early at the end of the stream, or at
+  * something which isn't an element, in which case the failbit is set. The
+  * stream is read in chunks, so to leave it just after the last element it
+  * has to be seekable.
+  */
+template <typename T>
+std::size_t     ReadArray   ( std::istream& in,
+                              T* data,
+                              std::size_t count );
+}
+
+#include "inl/charconv-inl.hpp"
@@ -0,0 +1,374 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#pragma once
+
+#include <type_traits>
+
+#include <joemath/functional.hpp>
+#include <joemath/matrix.hpp>
+#include <joemath/matrix_traits.hpp>
+#include <joemath/types.hpp>
+
+//
+// Lazy expressions
+//
+// Wrapping a matrix with Lazy makes arithmetic on it build a tree of
+// expression nodes instead of creating a temporary matrix for every operator.
+// The tree is evaluated in a single pass when it's assigned to a Matrix, so
+//
+//     m = Lazy(a) * s + b * t - c;
+//
+// reads each element of a, b and c once and doesn't create any temporaries.
+// The element types of the result are the same as they would be without Lazy.
+//
+// Expressions hold references to their operands, so they shouldn't outlive the
+// statement they're created in. Use Evaluate to get a Matrix from them.
+//
+
+namespace JoeMath
+{
+/**
+  * A reference to the elements of a matrix
+  */
+template <typename Scalar, u32 Rows, u32 Columns>
+class MatrixReference
+{
+public:
+    using scalar_type = Scalar;
+
+    static const u32 rows    = Rows;
+    static const u32 columns = Columns;
+
+    explicit MatrixReference ( const Matrix<Scalar, Rows, Columns>& m );
+
+    const scalar_type& operator [] ( u32 i ) const;
+
+private:
+    const Matrix<Scalar, Rows, Columns>& m_matrix;
+};
+
+/**
+  * A scalar which has the same value for every element
+  */
+template <typename Scalar, u32 Rows, u32 Columns>
+class ScalarExpression
+{
+public:
+    using scalar_type = Scalar;
+
+    static const u32 rows    = Rows;
+    static const u32 columns = Columns;
+
+    explicit ScalarExpression ( Scalar s );
+
+    const scalar_type& operator [] ( u32 i ) const;
+
+private:
+    Scalar m_scalar;
+};
+
+/**
+  * Op applied to every element of an expression
+  */
+template <typename Op, typename Operand>
+class UnaryExpression
+{
+public:
+    using scalar_type = decltype( std::declval<Op>()(
+                            std::declval<typename Operand::scalar_type>() ) );
+
+    static const u32 rows    = Operand::rows;
+    static const u32 columns = Operand::columns;
+
+    explicit UnaryExpression ( const Operand& operand );
+
+    scalar_type operator [] ( u32 i ) const;
+
+private:
+    Operand m_operand;
+};
+
+/**
+  * Op applied to every pair of elements of two expressions
+  */
+template <typename Op, typename Left, typename Right>
+class BinaryExpression
+{
+public:
+    static_assert( Left::rows == Right::rows &&
+                   Left::columns == Right::columns,
+                   "Trying to combine expressions of different sizes" );
+
+    using scalar_type = decltype( std::declval<Op>()(
+                            std::declval<typename Left::scalar_type>(),
+                            std::declval<typename Right::scalar_type>() ) );
+
+    static const u32 rows    = Left::rows;
+    static const u32 columns = Left::columns;
+
+    BinaryExpression ( const Left& left, const Right& right );
+
+    scalar_type operator [] ( u32 i ) const;
+
+private:
+    Left  m_left;
+    Right m_right;
+};
+
+template <typename Scalar, u32 Rows, u32 Columns>
+struct is_expression <MatrixReference<Scalar, Rows, Columns>>
+: public std::true_type
+{ };
+
+template <typename Scalar, u32 Rows, u32 Columns>
+struct is_expression <ScalarExpression<Scalar, Rows, Columns>>
+: public std::true_type
+{ };
+
+template <typename Op, typename Operand>
+struct is_expression <UnaryExpression<Op, Operand>>
+: public std::true_type
+{ };
+
+template <typename Op, typename Left, typename Right>
+struct is_expression <BinaryExpression<Op, Left, Right>>
+: public std::true_type
+{ };
+
+namespace detail
+{
+    //
+    // Converts a matrix, expression or scalar into an expression of the given
+    // size
+    //
+    template <typename T, u32 Rows, u32 Columns, typename = void>
+    struct Operand
+    { };
+
+    template <typename Scalar, u32 MatrixRows, u32 MatrixColumns,
+              u32 Rows, u32 Columns>
+    struct Operand <Matrix<Scalar, MatrixRows, MatrixColumns>, Rows, Columns>
+    {
+        using type = MatrixReference<Scalar, MatrixRows, MatrixColumns>;
+        static type Make( const Matrix<Scalar, MatrixRows, MatrixColumns>& m )
+        { return type( m ); }
+    };
+
+    template <typename T, u32 Rows, u32 Columns>
+    struct Operand <T, Rows, Columns,
+                    typename std::enable_if<is_expression<T>::value>::type>
+    {
+        using type = T;
+        static const type& Make( const T& e )
+        { return e; }
+    };
+
+    template <typename T, u32 Rows, u32 Columns>
+    struct Operand <T, Rows, Columns,
+                    typename std::enable_if<std::is_arithmetic<T>::value>::type>
+    {
+        using type = ScalarExpression<T, Rows, Columns>;
+        static type Make( const T& s )
+        { return type( s ); }
+    };
+
+    //
+    // The size of an expression or matrix
+    //
+    template <typename T, typename = void>
+    struct expression_size
+    { };
+
+    template <typename Scalar, u32 Rows, u32 Columns>
+    struct expression_size <Matrix<Scalar, Rows, Columns>>
+    {
+        static const u32 rows    = Rows;
+        static const u32 columns = Columns;
+    };
+
+    template <typename T>
+    struct expression_size <T,
+                    typename std::enable_if<is_expression<T>::value>::type>
+    {
+        static const u32 rows    = T::rows;
+        static const u32 columns = T::columns;
+    };
+
+    template <typename T, bool AllowScalar>
+    struct is_operand
+    : public std::integral_constant<bool,
+                                    is_expression<T>::value ||
+                                    is_matrix<T>::value ||
+                                    ( AllowScalar &&
+                                      std::is_arithmetic<T>::value )>
+    { };
+
+    //
+    // The node for Op between L and R, at least one of which must be an
+    // expression and the other must be an expression or matrix, or a scalar
+    // if AllowScalar is true
+    //
+    template <typename Op, typename L, typename R,
+              bool AllowScalar = true,
+              bool LeftIsScalar = std::is_arithmetic<L>::value,
+              bool Valid = ( is_expression<L>::value ||
+                             is_expression<R>::value ) &&
+                           is_operand<L, AllowScalar>::value &&
+                           is_operand<R, AllowScalar>::value>
+    struct binary_expression
+    { };
+
+    template <typename Op, typename L, typename R, bool AllowScalar>
+    struct binary_expression <Op, L, R, AllowScalar, false, true>
+    {
+        using left_type  = Operand<L, expression_size<L>::rows,
+                                      expression_size<L>::columns>;
+        using right_type = Operand<R, expression_size<L>::rows,
+                                      expression_size<L>::columns>;
+        using type = BinaryExpression<Op, typename left_type::type,
+                                          typename right_type::type>;
+    };
+
+    template <typename Op, typename L, typename R, bool AllowScalar>
+    struct binary_expression <Op, L, R, AllowScalar, true, true>
+    {
+        using left_type  = Operand<L, expression_size<R>::rows,
+                                      expression_size<R>::columns>;
+        using right_type = Operand<R, expression_size<R>::rows,
+                                      expression_size<R>::columns>;
+        using type = BinaryExpression<Op, typename left_type::type,
+                                          typename right_type::type>;
+    };
+}
+
+/**
+  * Start a lazy expression with a matrix
+  */
+template <typename Scalar, u32 Rows, u32 Columns>
+MatrixReference<Scalar, Rows, Columns> Lazy (
+                                       const Matrix<Scalar, Rows, Columns>& m );
+
+/**
+  * Evaluate an expression into a matrix
+  */
+template <typename Expression,
+          typename = typename std::enable_if<
+                                      is_expression<Expression>::value>::type>
+Matrix<typename Expression::scalar_type, Expression::rows, Expression::columns>
+                                        Evaluate ( const Expression& e );
+
+//
+// Unary Operators
+//
+
+template <typename Expression,
+          typename = typename std::enable_if<
+                                      is_expression<Expression>::value>::type>
+const Expression& operator + ( const Expression& e );
+
+template <typename Expression,
+          typename = typename std::enable_if<
+                                      is_expression<Expression>::value>::type>
+UnaryExpression<detail::Negate, Expression> operator - ( const Expression& e );
+
+//
+// Arithmetic
+//
+// These take any combination of expressions and matrices, at least one of
+// which must be an expression. Scalars are allowed on the same sides as for
+// Matrix: either side for multiplication and the right for everything else.
+//
+
+template <typename L, typename R>
+typename detail::binary_expression<detail::Add, L, R,
+                                   !std::is_arithmetic<L>::value>::type
+                                   operator + ( const L& l, const R& r );
+
+template <typename L, typename R>
+typename detail::binary_expression<detail::Subtract, L, R,
+                                   !std::is_arithmetic<L>::value>::type
+                                   operator - ( const L& l, const R& r );
+
+template <typename L, typename R>
+typename detail::binary_expression<detail::Multiply, L, R>::type
+                                   operator * ( const L& l, const R& r );
+
+/**
+  * Division by a scalar multiplies by its reciprocal, like Matrix
+  */
+template <typename L, typename R>
+typename detail::binary_expression<detail::Divide, L, R, false>::type
+                                   operator / ( const L& l, const R& r );
+
+template <typename L, typename Scalar,
+          typename = typename std::enable_if<
+                                      is_expression<L>::value &&
+                                      std::is_arithmetic<Scalar>::value>::type>
+BinaryExpression<detail::Multiply, L,
+                 ScalarExpression<decltype( typename L::scalar_type{1} /
+                                            std::declval<Scalar>() ),
+                                  L::rows, L::columns>>
+                                   operator / ( const L& l, const Scalar s );
+
+//
+// Assignment operators
+//
+// These evaluate the expression straight into the elements of m
+//
+
+// Component wise addition
+template <typename Scalar, u32 Rows, u32 Columns, typename Expression,
+          typename = typename std::enable_if<
+                                      is_expression<Expression>::value>::type>
+Matrix<Scalar, Rows, Columns>&  operator += ( Matrix<Scalar, Rows, Columns>& m,
+                                              const Expression& e );
+
+// Component wise subtraction
+template <typename Scalar, u32 Rows, u32 Columns, typename Expression,
+          typename = typename std::enable_if<
+                                      is_expression<Expression>::value>::type>
+Matrix<Scalar, Rows, Columns>&  operator -= ( Matrix<Scalar, Rows, Columns>& m,
+                                              const Expression& e );
+
+// Component wise multiplication
+template <typename Scalar, u32 Rows, u32 Columns, typename Expression,
+          typename = typename std::enable_if<
+                                      is_expression<Expression>::value>::type>
+Matrix<Scalar, Rows, Columns>&  operator *= ( Matrix<Scalar, Rows, Columns>& m,
+                                              const Expression& e );
+
+// Component wise division
+template <typename Scalar, u32 Rows, u32 Columns, typename Expression,
+          typename = typename std::enable_if<
+                                      is_expression<Expression>::value>::type>
+Matrix<Scalar, Rows, Columns>&  operator /= ( Matrix<Scalar, Rows, Columns>& m,
+                                              const Expression& e );
+}
+
+#include "inl/expression-inl.hpp"
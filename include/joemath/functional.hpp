@@ -0,0 +1,79 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#pragma once
+
+//
+// Function objects for the arithmetic operators, these work with any types
+// for which the operator is defined
+//
+
+namespace JoeMath
+{
+namespace detail
+{
+    struct Negate
+    {
+        template <typename T>
+        constexpr auto operator () ( const T& a ) const -> decltype( -a )
+        { return -a; }
+    };
+
+    struct Add
+    {
+        template <typename T, typename U>
+        constexpr auto operator () ( const T& a, const U& b ) const ->
+                                                              decltype( a + b )
+        { return a + b; }
+    };
+
+    struct Subtract
+    {
+        template <typename T, typename U>
+        constexpr auto operator () ( const T& a, const U& b ) const ->
+                                                              decltype( a - b )
+        { return a - b; }
+    };
+
+    struct Multiply
+    {
+        template <typename T, typename U>
+        constexpr auto operator () ( const T& a, const U& b ) const ->
+                                                              decltype( a * b )
+        { return a * b; }
+    };
+
+    struct Divide
+    {
+        template <typename T, typename U>
+        constexpr auto operator () ( const T& a, const U& b ) const ->
+                                                              decltype( a / b )
+        { return a / b; }
+    };
+}
+}
@@ -0,0 +1,146 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#pragma once
+
+#include <type_traits>
+#include <vector>
+
+#include <joemath/alignment.hpp>
+#include <joemath/matrix.hpp>
+#include <joemath/types.hpp>
+
+//
+// Transform hierarchies
+//
+// A TransformHierarchy stores the local transform of each node relative to its
+// parent in flat arrays, with every parent before its children. This means
+// that the world transforms can be found in one pass from front to back,
+// reading each parent's world transform which has already been updated.
+//
+// Changing a node's local transform marks it as dirty and Update only
+// recomputes the world transforms of dirty nodes and their descendants,
+// starting at the first dirty node. The inverse world transforms are computed
+// when they are asked for and kept until the world transform changes.
+//
+
+namespace JoeMath
+{
+template <typename Scalar>
+class TransformHierarchy
+{
+public:
+    static_assert( std::is_floating_point<Scalar>::value,
+                   "Trying to create a TransformHierarchy of integers" );
+
+    using scalar_type = Scalar;
+    using matrix_type = Matrix<Scalar, 4, 4>;
+
+    /**
+      * The parent of root nodes
+      */
+    static const u32 no_parent = ~u32{0};
+
+    TransformHierarchy                  ( ) = default;
+
+    /**
+      * Adds a node and returns its index. The parent must have been added
+      * already, which keeps the nodes sorted by depth.
+      */
+    u32                 AddNode         ( const matrix_type& local,
+                                          u32 parent = no_parent );
+
+    u32                 GetSize         ( ) const;
+    void                Reserve         ( u32 size );
+    void                Clear           ( );
+
+    u32                 GetParent       ( u32 node ) const;
+
+    const matrix_type&  GetLocal        ( u32 node ) const;
+
+    /**
+      * Marks the node as dirty, its world transform and those of its
+      * descendants aren't updated until the next call to Update
+      */
+    void                SetLocal        ( u32 node, const matrix_type& local );
+
+    bool                IsDirty         ( u32 node ) const;
+
+    /**
+      * Recomputes the world transforms of the dirty nodes and their
+      * descendants
+      */
+    void                Update          ( );
+
+    /**
+      * The transform from this node's space to world space as of the last
+      * call to Update
+      */
+    const matrix_type&  GetWorld        ( u32 node ) const;
+
+    /**
+      * All of the world transforms in node order, for uploading them in one go
+      */
+    const matrix_type*  GetWorldData    ( ) const;
+
+    /**
+      * The inverse of GetWorld, this is computed on the first call after the
+      * world transform changes. It writes to the cache so it mustn't be called
+      * from several threads at once.
+      */
+    const matrix_type&  GetInverseWorld ( u32 node ) const;
+
+private:
+    using MatrixArray = std::vector<matrix_type,
+                                    AlignedAllocator<matrix_type>>;
+
+    enum Flags : u8
+    {
+        DIRTY           = 1 << 0,
+        INVERSE_VALID   = 1 << 1,
+        //
+        // Set on the nodes whose world transform changed in the Update which
+        // is in progress
+        //
+        CHANGED         = 1 << 2
+    };
+
+    MatrixArray         m_local;
+    MatrixArray         m_world;
+    mutable MatrixArray m_inverse_world;
+    std::vector<u32>    m_parent;
+    mutable std::vector<u8> m_flags;
+
+    /**
+      * The index of the first dirty node, or GetSize() if there aren't any
+      */
+    u32                 m_first_dirty = 0;
+};
+}
+
+#include "inl/hierarchy-inl.hpp"
@@ -0,0 +1,374 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#pragma once
+
+#include <joemath/affine.hpp>
+#include <joemath/batch.hpp>
+#include <joemath/matrix.hpp>
+#include <joemath/simd.hpp>
+
+namespace JoeMath
+{
+////////////////////////////////////////
+////////////////////////////////////////
+// Affine members
+////////////////////////////////////////
+////////////////////////////////////////
+
+template <typename Scalar>
+Affine<Scalar>::Affine( )
+{
+}
+
+template <typename Scalar>
+Affine<Scalar>::Affine( const Matrix<Scalar, 3, 3>& linear,
+                        const Vector<Scalar, 3>& translation )
+{
+    SetLinear( linear );
+    SetTranslation( translation );
+}
+
+template <typename Scalar>
+Affine<Scalar>::Affine( const Matrix<Scalar, 3, 4>& m )
+    :m_matrix( m )
+{
+}
+
+template <typename Scalar>
+Affine<Scalar>::Affine( const Matrix<Scalar, 4, 4>& m )
+    :m_matrix( m.template GetSubMatrix<3, 4>() )
+{
+}
+
+template <typename Scalar>
+const Vector<Scalar, 3>& Affine<Scalar>::GetRight( ) const
+{
+    return m_matrix.GetColumn( 0 );
+}
+
+template <typename Scalar>
+Vector<Scalar, 3>& Affine<Scalar>::GetRight( )
+{
+    return m_matrix.GetColumn( 0 );
+}
+
+template <typename Scalar>
+void Affine<Scalar>::SetRight( const Vector<Scalar, 3>& v )
+{
+    m_matrix.SetColumn( 0, v );
+}
+
+template <typename Scalar>
+const Vector<Scalar, 3>& Affine<Scalar>::GetForward( ) const
+{
+    return m_matrix.GetColumn( 1 );
+}
+
+template <typename Scalar>
+Vector<Scalar, 3>& Affine<Scalar>::GetForward( )
+{
+    return m_matrix.GetColumn( 1 );
+}
+
+template <typename Scalar>
+void Affine<Scalar>::SetForward( const Vector<Scalar, 3>& v )
+{
+    m_matrix.SetColumn( 1, v );
+}
+
+template <typename Scalar>
+const Vector<Scalar, 3>& Affine<Scalar>::GetUp( ) const
+{
+    return m_matrix.GetColumn( 2 );
+}
+
+template <typename Scalar>
+Vector<Scalar, 3>& Affine<Scalar>::GetUp( )
+{
+    return m_matrix.GetColumn( 2 );
+}
+
+template <typename Scalar>
+void Affine<Scalar>::SetUp( const Vector<Scalar, 3>& v )
+{
+    m_matrix.SetColumn( 2, v );
+}
+
+template <typename Scalar>
+const Vector<Scalar, 3>& Affine<Scalar>::GetTranslation( ) const
+{
+    return m_matrix.GetColumn( 3 );
+}
+
+template <typename Scalar>
+Vector<Scalar, 3>& Affine<Scalar>::GetTranslation( )
+{
+    return m_matrix.GetColumn( 3 );
+}
+
+template <typename Scalar>
+void Affine<Scalar>::SetTranslation( const Vector<Scalar, 3>& v )
+{
+    m_matrix.SetColumn( 3, v );
+}
+
+template <typename Scalar>
+Matrix<Scalar, 3, 3> Affine<Scalar>::GetLinear( ) const
+{
+    return m_matrix.template GetSubMatrix<3, 3>();
+}
+
+template <typename Scalar>
+void Affine<Scalar>::SetLinear( const Matrix<Scalar, 3, 3>& m )
+{
+    m_matrix.SetSubMatrix( m );
+}
+
+////////////////////////////////////////
+////////////////////////////////////////
+// Operators on affine transforms
+////////////////////////////////////////
+////////////////////////////////////////
+
+template <typename Scalar>
+bool                operator == ( const Affine<Scalar>& a0,
+                                  const Affine<Scalar>& a1 )
+{
+    return a0.m_matrix == a1.m_matrix;
+}
+
+template <typename Scalar>
+bool                operator != ( const Affine<Scalar>& a0,
+                                  const Affine<Scalar>& a1 )
+{
+    return !( a0 == a1 );
+}
+
+////////////////////////////////////////
+////////////////////////////////////////
+// Functions on affine transforms
+////////////////////////////////////////
+////////////////////////////////////////
+
+namespace detail
+{
+    //
+    // The linear part of a applied to the three scalars at v. The products
+    // are summed in the same order as Mul and the SSE versions
+    //
+    template <typename Scalar>
+    Vector<Scalar, 3> TransformLinear( const Affine<Scalar>& a,
+                                       const Scalar* v )
+    {
+        const auto& e = a.m_matrix.m_elements;
+        Vector<Scalar, 3> r;
+        for( u32 i = 0; i < 3; ++i )
+            r.m_elements[0][i] = e[0][i] * v[0] + e[1][i] * v[1] +
+                                 e[2][i] * v[2];
+        return r;
+    }
+}
+
+template <typename Scalar>
+Affine<Scalar>          Mul             ( const Affine<Scalar>& a0,
+                                          const Affine<Scalar>& a1 )
+{
+    const auto& e = a1.m_matrix.m_elements;
+    Affine<Scalar> ret;
+    for( u32 j = 0; j < 3; ++j )
+        ret.m_matrix.SetColumn( j, detail::TransformLinear( a0, &e[j][0] ) );
+    ret.SetTranslation( detail::TransformLinear( a0, &e[3][0] ) +
+                        a0.GetTranslation() );
+    return ret;
+}
+
+template <typename Scalar>
+Vector<Scalar, 3>       TransformPoint  ( const Affine<Scalar>& a,
+                                          const Vector<Scalar, 3>& p )
+{
+    return detail::TransformLinear( a, &p.m_elements[0][0] ) +
+           a.GetTranslation();
+}
+
+template <typename Scalar>
+Vector<Scalar, 3>       TransformVector ( const Affine<Scalar>& a,
+                                          const Vector<Scalar, 3>& v )
+{
+    return detail::TransformLinear( a, &v.m_elements[0][0] );
+}
+
+template <typename Scalar>
+Scalar                  Determinant     ( const Affine<Scalar>& a )
+{
+    return Determinant( a.GetLinear() );
+}
+
+template <typename Scalar>
+void                    Invert          ( Affine<Scalar>& a )
+{
+    a = Inverted( a );
+}
+
+template <typename Scalar>
+Affine<Scalar>          Inverted        ( const Affine<Scalar>& a )
+{
+    const Matrix<Scalar, 3, 3> linear = Inverted( a.GetLinear() );
+    return Affine<Scalar>( linear, -Mul( linear, a.GetTranslation() ) );
+}
+
+template <typename Scalar>
+void                    InvertRigid     ( Affine<Scalar>& a )
+{
+    a = InvertedRigid( a );
+}
+
+template <typename Scalar>
+Affine<Scalar>          InvertedRigid   ( const Affine<Scalar>& a )
+{
+    const Matrix<Scalar, 3, 3> linear = Transposed( a.GetLinear() );
+    return Affine<Scalar>( linear, -Mul( linear, a.GetTranslation() ) );
+}
+
+template <typename Scalar>
+Matrix<Scalar, 4, 4>    ToMatrix        ( const Affine<Scalar>& a )
+{
+    Matrix<Scalar, 4, 4> ret = Identity<Scalar, 4>();
+    ret.SetSubMatrix( a.m_matrix );
+    return ret;
+}
+
+template <typename Scalar>
+Affine<Scalar>          IdentityAffine  ( )
+{
+    return Affine<Scalar>( Identity<Scalar, 3>(), Vector<Scalar, 3>( 0 ) );
+}
+
+template <typename Scalar>
+void    TransformPoints     ( const Affine<Scalar>& a,
+                              const Vector<Scalar, 3>* in,
+                              Vector<Scalar, 3>* out,
+                              u32 count,
+                              u32 in_stride,
+                              u32 out_stride )
+{
+    for( u32 n = 0; n < count; ++n )
+        *detail::Advance( out, n, out_stride ) =
+                    TransformPoint( a, *detail::Advance( in, n, in_stride ) );
+}
+
+template <typename Scalar>
+void    TransformVectors    ( const Affine<Scalar>& a,
+                              const Vector<Scalar, 3>* in,
+                              Vector<Scalar, 3>* out,
+                              u32 count,
+                              u32 in_stride,
+                              u32 out_stride )
+{
+    for( u32 n = 0; n < count; ++n )
+        *detail::Advance( out, n, out_stride ) =
+                    TransformVector( a, *detail::Advance( in, n, in_stride ) );
+}
+
+#if defined( JOEMATH_SSE )
+
+//
+// The first three columns are loaded four floats at a time, which reads the
+// first element of the next column into the unused lane. The translation is
+// loaded on its own so that nothing is read past the end of the Affine.
+//
+
+inline Affine<float>    Mul             ( const Affine<float>& a0,
+                                          const Affine<float>& a1 )
+{
+    using namespace detail::sse;
+    const float* p = &a0.m_matrix.m_elements[0][0];
+    const float* q = &a1.m_matrix.m_elements[0][0];
+    const __m128 c0 = Load( p );
+    const __m128 c1 = Load( p + 3 );
+    const __m128 c2 = Load( p + 6 );
+    const __m128 c3 = LoadXYZ( p + 9 );
+
+    //
+    // Each column overwrites the unused lane of the one before
+    //
+    Affine<float> ret;
+    float* r = &ret.m_matrix.m_elements[0][0];
+    Store( r,     LinearCombination3( c0, c1, c2, q ) );
+    Store( r + 3, LinearCombination3( c0, c1, c2, q + 3 ) );
+    Store( r + 6, LinearCombination3( c0, c1, c2, q + 6 ) );
+    StoreXYZ( r + 9, _mm_add_ps( LinearCombination3( c0, c1, c2, q + 9 ),
+                                 c3 ) );
+    return ret;
+}
+
+inline void TransformPoints     ( const Affine<float>& a,
+                                  const float3* in,
+                                  float3* out,
+                                  u32 count,
+                                  u32 in_stride  = sizeof(float3),
+                                  u32 out_stride = sizeof(float3) )
+{
+    using namespace detail::sse;
+    const float* m = &a.m_matrix.m_elements[0][0];
+    const __m128 c0 = Load( m );
+    const __m128 c1 = Load( m + 3 );
+    const __m128 c2 = Load( m + 6 );
+    const __m128 c3 = LoadXYZ( m + 9 );
+
+    for( u32 n = 0; n < count; ++n )
+    {
+        const float* p = &detail::Advance( in, n, in_stride )->m_elements[0][0];
+        float*       q = &detail::Advance( out, n, out_stride )->m_elements[0][0];
+        StoreXYZ( q, _mm_add_ps( LinearCombination3( c0, c1, c2, p ), c3 ) );
+    }
+}
+
+inline void TransformVectors    ( const Affine<float>& a,
+                                  const float3* in,
+                                  float3* out,
+                                  u32 count,
+                                  u32 in_stride  = sizeof(float3),
+                                  u32 out_stride = sizeof(float3) )
+{
+    using namespace detail::sse;
+    const float* m = &a.m_matrix.m_elements[0][0];
+    const __m128 c0 = Load( m );
+    const __m128 c1 = Load( m + 3 );
+    const __m128 c2 = Load( m + 6 );
+
+    for( u32 n = 0; n < count; ++n )
+    {
+        const float* p = &detail::Advance( in, n, in_stride )->m_elements[0][0];
+        float*       q = &detail::Advance( out, n, out_stride )->m_elements[0][0];
+        StoreXYZ( q, LinearCombination3( c0, c1, c2, p ) );
+    }
+}
+
+#endif
+}
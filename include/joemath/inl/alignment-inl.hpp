@@ -0,0 +1,101 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <new>
+
+#include <joemath/alignment.hpp>
+
+namespace JoeMath
+{
+
+template <typename T, std::size_t Alignment>
+const std::size_t AlignedAllocator<T, Alignment>::alignment;
+
+template <typename T, std::size_t Alignment>
+AlignedAllocator<T, Alignment>::AlignedAllocator ( ) noexcept
+{
+}
+
+template <typename T, std::size_t Alignment>
+template <typename U>
+AlignedAllocator<T, Alignment>::AlignedAllocator (
+                               const AlignedAllocator<U, Alignment>& ) noexcept
+{
+}
+
+//
+// This allocates enough extra space to align the block and to store the
+// pointer returned by malloc just before it
+//
+template <typename T, std::size_t Alignment>
+T* AlignedAllocator<T, Alignment>::allocate( std::size_t count )
+{
+    const std::size_t overhead = alignment - 1 + sizeof(void*);
+    if( count > ( std::numeric_limits<std::size_t>::max() - overhead ) /
+                                                                     sizeof(T) )
+        throw std::bad_alloc();
+
+    void* block = std::malloc( count * sizeof(T) + overhead );
+    if( !block )
+        throw std::bad_alloc();
+
+    const std::uintptr_t start = reinterpret_cast<std::uintptr_t>( block ) +
+                                 sizeof(void*);
+    void** aligned = reinterpret_cast<void**>(
+                          ( start + alignment - 1 ) & ~( alignment - 1 ) );
+    aligned[-1] = block;
+    return reinterpret_cast<T*>( aligned );
+}
+
+template <typename T, std::size_t Alignment>
+void AlignedAllocator<T, Alignment>::deallocate( T* p, std::size_t ) noexcept
+{
+    if( p )
+        std::free( reinterpret_cast<void**>( p )[-1] );
+}
+
+template <typename T, typename U, std::size_t Alignment>
+bool        operator == ( const AlignedAllocator<T, Alignment>&,
+                          const AlignedAllocator<U, Alignment>& )
+{
+    return true;
+}
+
+template <typename T, typename U, std::size_t Alignment>
+bool        operator != ( const AlignedAllocator<T, Alignment>&,
+                          const AlignedAllocator<U, Alignment>& )
+{
+    return false;
+}
+
+}
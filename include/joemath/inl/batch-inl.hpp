@@ -0,0 +1,1504 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+#include <joemath/batch.hpp>
+#include <joemath/matrix.hpp>
+#include <joemath/simd.hpp>
+
+namespace JoeMath
+{
+namespace detail
+{
+    //
+    // Returns the address of the ith element of an array with the given stride
+    // in bytes
+    //
+    template <typename T>
+    T* Advance( T* p, u32 i, u32 stride )
+    {
+        using byte = typename std::conditional<std::is_const<T>::value,
+                                               const char,
+                                               char>::type;
+        return reinterpret_cast<T*>( reinterpret_cast<byte*>( p ) +
+                                     std::size_t( i ) * stride );
+    }
+
+    //
+    // Transforms by the upper Size-1 rows of m. The translation column is
+    // added if Translate is true_type
+    //
+    template <typename Scalar, u32 Size, typename Translate>
+    void TransformAffine( const Matrix<Scalar, Size, Size>& m,
+                          const Vector<Scalar, Size-1>* in,
+                          Vector<Scalar, Size-1>* out,
+                          u32 count,
+                          u32 in_stride,
+                          u32 out_stride,
+                          Translate )
+    {
+        static_assert( Size > 1, "Trying to transform zero sized vectors" );
+
+        for( u32 n = 0; n < count; ++n )
+        {
+            const Vector<Scalar, Size-1> v = *Advance( in, n, in_stride );
+            Vector<Scalar, Size-1> r;
+
+            for( u32 i = 0; i < Size-1; ++i )
+                r.m_elements[0][i] = m.m_elements[0][i] * v.m_elements[0][0];
+            for( u32 j = 1; j < Size-1; ++j )
+                for( u32 i = 0; i < Size-1; ++i )
+                    r.m_elements[0][i] += m.m_elements[j][i] *
+                                          v.m_elements[0][j];
+            if( Translate::value )
+                for( u32 i = 0; i < Size-1; ++i )
+                    r.m_elements[0][i] += m.m_elements[Size-1][i];
+
+            *Advance( out, n, out_stride ) = r;
+        }
+    }
+}
+
+template <typename Scalar, u32 Size>
+void    TransformPoints     ( const Matrix<Scalar, Size, Size>& m,
+                              const Vector<Scalar, Size-1>* in,
+                              Vector<Scalar, Size-1>* out,
+                              u32 count,
+                              u32 in_stride,
+                              u32 out_stride )
+{
+    detail::TransformAffine( m, in, out, count, in_stride, out_stride,
+                             std::true_type() );
+}
+
+template <typename Scalar, u32 Size>
+void    TransformVectors    ( const Matrix<Scalar, Size, Size>& m,
+                              const Vector<Scalar, Size-1>* in,
+                              Vector<Scalar, Size-1>* out,
+                              u32 count,
+                              u32 in_stride,
+                              u32 out_stride )
+{
+    detail::TransformAffine( m, in, out, count, in_stride, out_stride,
+                             std::false_type() );
+}
+
+template <typename Scalar, u32 Size>
+void    TransformHomogeneous( const Matrix<Scalar, Size, Size>& m,
+                              const Vector<Scalar, Size>* in,
+                              Vector<Scalar, Size>* out,
+                              u32 count,
+                              u32 in_stride,
+                              u32 out_stride )
+{
+    for( u32 n = 0; n < count; ++n )
+    {
+        const Vector<Scalar, Size> v = *detail::Advance( in, n, in_stride );
+        Vector<Scalar, Size> r;
+
+        for( u32 i = 0; i < Size; ++i )
+            r.m_elements[0][i] = m.m_elements[0][i] * v.m_elements[0][0];
+        for( u32 j = 1; j < Size; ++j )
+            for( u32 i = 0; i < Size; ++i )
+                r.m_elements[0][i] += m.m_elements[j][i] * v.m_elements[0][j];
+
+        *detail::Advance( out, n, out_stride ) = r;
+    }
+}
+
+template <typename Scalar, u32 Size>
+void    InvertBatch         ( const Matrix<Scalar, Size, Size>* in,
+                              Matrix<Scalar, Size, Size>* out,
+                              u32 count,
+                              bool* singular )
+{
+    static_assert( std::is_floating_point<Scalar>::value,
+                   "Trying to invert a batch of integer matrices" );
+
+    for( u32 n = 0; n < count; ++n )
+    {
+        const Matrix<Scalar, Size, Size> m = in[n];
+        if( singular )
+            singular[n] = !( std::abs( Determinant( m ) ) >=
+                             std::numeric_limits<Scalar>::min() );
+        out[n] = Inverted( m );
+    }
+}
+
+template <typename Scalar, u32 Size>
+void    NormalizedPrecise   ( const Vector<Scalar, Size>* in,
+                              Vector<Scalar, Size>* out,
+                              u32 count )
+{
+    for( u32 n = 0; n < count; ++n )
+        out[n] = NormalizedPrecise( in[n] );
+}
+
+template <typename Scalar, u32 Size>
+void    NormalizedFast      ( const Vector<Scalar, Size>* in,
+                              Vector<Scalar, Size>* out,
+                              u32 count )
+{
+    for( u32 n = 0; n < count; ++n )
+        out[n] = NormalizedFast( in[n] );
+}
+
+template <typename Scalar, u32 Size>
+void    NormalizedSafe      ( const Vector<Scalar, Size>* in,
+                              Vector<Scalar, Size>* out,
+                              u32 count,
+                              const Vector<Scalar, Size>& fallback )
+{
+    for( u32 n = 0; n < count; ++n )
+        out[n] = NormalizedSafe( in[n], fallback );
+}
+
+template <typename Scalar, u32 Size>
+void    LengthFast          ( const Vector<Scalar, Size>* in,
+                              Scalar* out,
+                              u32 count )
+{
+    for( u32 n = 0; n < count; ++n )
+        out[n] = LengthFast( in[n] );
+}
+
+template <typename Scalar, u32 Size>
+void    InverseLength       ( const Vector<Scalar, Size>* in,
+                              Scalar* out,
+                              u32 count )
+{
+    for( u32 n = 0; n < count; ++n )
+        out[n] = InverseLength( in[n] );
+}
+
+template <typename Scalar>
+void    SinCosFast          ( const Scalar* angles,
+                              Scalar* sin,
+                              Scalar* cos,
+                              u32 count )
+{
+    for( u32 n = 0; n < count; ++n )
+        SinCosFast( angles[n], sin[n], cos[n] );
+}
+
+inline void SinCosFast      ( const float* angles,
+                              float* sin,
+                              float* cos,
+                              u32 count )
+{
+    u32 n = 0;
+#if defined( JOEMATH_SSE )
+    for( ; n + 4 <= count; n += 4 )
+    {
+        __m128 s;
+        __m128 c;
+        detail::sse::SinCosFast( detail::sse::Load( angles + n ), s, c );
+        detail::sse::Store( sin + n, s );
+        detail::sse::Store( cos + n, c );
+    }
+#endif
+    for( ; n < count; ++n )
+        SinCosFast( angles[n], sin[n], cos[n] );
+}
+
+//
+// The sines and cosines are computed a block at a time so that the float
+// version can use the array SinCosFast
+//
+template <typename Scalar, u32 Size>
+void    RotateZBatch        ( const Scalar* angles,
+                              Matrix<Scalar, Size, Size>* out,
+                              u32 count )
+{
+    static_assert( Size >= 3,
+                   "Trying to construct an z axis rotation matrix of size <"
+                   " 3" );
+
+    const u32 block_size = 64;
+    Scalar sin[block_size];
+    Scalar cos[block_size];
+    for( u32 n = 0; n < count; n += block_size )
+    {
+        const u32 block = std::min( block_size, count - n );
+        SinCosFast( angles + n, sin, cos, block );
+        for( u32 i = 0; i < block; ++i )
+            out[n + i] = detail::PlaneRotation<Scalar, Size>( 0, 1,
+                                                              sin[i], cos[i] );
+    }
+}
+
+template <typename Scalar>
+void    EigenSymmetricBatch ( const Matrix<Scalar, 3, 3>* in,
+                              EigenDecomposition<Scalar>* out,
+                              u32 count )
+{
+    for( u32 n = 0; n < count; ++n )
+        out[n] = EigenSymmetric( in[n] );
+}
+
+template <typename Scalar>
+void    SVDBatch            ( const Matrix<Scalar, 3, 3>* in,
+                              SingularValueDecomposition<Scalar>* out,
+                              u32 count )
+{
+    for( u32 n = 0; n < count; ++n )
+        out[n] = SVD( in[n] );
+}
+
+template <typename Scalar, u32 Size>
+void    OrthonormalizeBatch ( const Matrix<Scalar, Size, Size>* in,
+                              Matrix<Scalar, Size, Size>* out,
+                              u32 count )
+{
+    for( u32 n = 0; n < count; ++n )
+        out[n] = Orthonormalized( in[n] );
+}
+
+template <typename Scalar>
+void    PolarDecomposeBatch ( const Matrix<Scalar, 3, 3>* in,
+                              PolarDecomposition<Scalar>* out,
+                              u32 count )
+{
+    for( u32 n = 0; n < count; ++n )
+        out[n] = PolarDecompose( in[n] );
+}
+
+#if defined( JOEMATH_SSE )
+
+//
+// TransformHomogeneous keeps the columns of m in registers and broadcasts each
+// component of the input straight from memory, so there are no shuffles. The
+// products are summed in the same order as the generic versions and Mul.
+//
+
+namespace detail
+{
+namespace sse
+{
+    inline __m128 LoadXYZ( const float* p )
+    {
+        return _mm_movelh_ps( LoadLow( p ), _mm_load_ss( p + 2 ) );
+    }
+
+    inline void StoreXYZ( float* p, __m128 v )
+    {
+        _mm_storel_pi( reinterpret_cast<__m64*>( p ), v );
+        _mm_store_ss( p + 2, _mm_movehl_ps( v, v ) );
+    }
+
+    inline __m128 LinearCombination3( __m128 c0, __m128 c1, __m128 c2,
+                                      const float* p )
+    {
+        __m128 r = _mm_mul_ps( c0, _mm_load1_ps( p ) );
+        r = _mm_add_ps( r, _mm_mul_ps( c1, _mm_load1_ps( p + 1 ) ) );
+        r = _mm_add_ps( r, _mm_mul_ps( c2, _mm_load1_ps( p + 2 ) ) );
+        return r;
+    }
+
+    //
+    // Four consecutive float3s are x0 y0 z0 x1, y1 z1 x2 y2, z2 x3 y3 z3 in
+    // a, b and c. These convert between that and the components of all four
+    // in x, y and z.
+    //
+    inline void Deinterleave3( __m128 a, __m128 b, __m128 c,
+                               __m128& x, __m128& y, __m128& z )
+    {
+        const __m128 b1c2 = _mm_shuffle_ps( b, c, _MM_SHUFFLE( 1, 1, 2, 2 ) );
+        const __m128 a1b0 = _mm_shuffle_ps( a, b, _MM_SHUFFLE( 0, 0, 1, 1 ) );
+        const __m128 b3c2 = _mm_shuffle_ps( b, c, _MM_SHUFFLE( 2, 2, 3, 3 ) );
+        const __m128 a2b1 = _mm_shuffle_ps( a, b, _MM_SHUFFLE( 1, 1, 2, 2 ) );
+        const __m128 c0c3 = _mm_shuffle_ps( c, c, _MM_SHUFFLE( 3, 3, 0, 0 ) );
+        x = _mm_shuffle_ps( a, b1c2, _MM_SHUFFLE( 2, 0, 3, 0 ) );
+        y = _mm_shuffle_ps( a1b0, b3c2, _MM_SHUFFLE( 2, 0, 2, 0 ) );
+        z = _mm_shuffle_ps( a2b1, c0c3, _MM_SHUFFLE( 2, 0, 2, 0 ) );
+    }
+
+    inline void Interleave3( __m128 x, __m128 y, __m128 z,
+                             __m128& a, __m128& b, __m128& c )
+    {
+        const __m128 x0y0 = _mm_unpacklo_ps( x, y );
+        const __m128 x2y2 = _mm_unpackhi_ps( x, y );
+        const __m128 z0x1 = _mm_shuffle_ps( z, x, _MM_SHUFFLE( 1, 1, 0, 0 ) );
+        const __m128 y1z1 = _mm_shuffle_ps( y, z, _MM_SHUFFLE( 1, 1, 1, 1 ) );
+        const __m128 z2x3 = _mm_shuffle_ps( z, x, _MM_SHUFFLE( 3, 3, 2, 2 ) );
+        const __m128 y3z3 = _mm_shuffle_ps( y, z, _MM_SHUFFLE( 3, 3, 3, 3 ) );
+        a = _mm_shuffle_ps( x0y0, z0x1, _MM_SHUFFLE( 2, 0, 1, 0 ) );
+        b = _mm_shuffle_ps( y1z1, x2y2, _MM_SHUFFLE( 1, 0, 2, 0 ) );
+        c = _mm_shuffle_ps( z2x3, y3z3, _MM_SHUFFLE( 2, 0, 2, 0 ) );
+    }
+
+#if defined( JOEMATH_AVX )
+    //
+    // The same on each half, with the first four float3s in the low halves
+    // and the next four in the high halves
+    //
+    inline void Deinterleave3( __m256 a, __m256 b, __m256 c,
+                               __m256& x, __m256& y, __m256& z )
+    {
+        const __m256 b1c2 = _mm256_shuffle_ps( b, c,
+                                               _MM_SHUFFLE( 1, 1, 2, 2 ) );
+        const __m256 a1b0 = _mm256_shuffle_ps( a, b,
+                                               _MM_SHUFFLE( 0, 0, 1, 1 ) );
+        const __m256 b3c2 = _mm256_shuffle_ps( b, c,
+                                               _MM_SHUFFLE( 2, 2, 3, 3 ) );
+        const __m256 a2b1 = _mm256_shuffle_ps( a, b,
+                                               _MM_SHUFFLE( 1, 1, 2, 2 ) );
+        const __m256 c0c3 = _mm256_shuffle_ps( c, c,
+                                               _MM_SHUFFLE( 3, 3, 0, 0 ) );
+        x = _mm256_shuffle_ps( a, b1c2, _MM_SHUFFLE( 2, 0, 3, 0 ) );
+        y = _mm256_shuffle_ps( a1b0, b3c2, _MM_SHUFFLE( 2, 0, 2, 0 ) );
+        z = _mm256_shuffle_ps( a2b1, c0c3, _MM_SHUFFLE( 2, 0, 2, 0 ) );
+    }
+
+    inline void Interleave3( __m256 x, __m256 y, __m256 z,
+                             __m256& a, __m256& b, __m256& c )
+    {
+        const __m256 x0y0 = _mm256_unpacklo_ps( x, y );
+        const __m256 x2y2 = _mm256_unpackhi_ps( x, y );
+        const __m256 z0x1 = _mm256_shuffle_ps( z, x,
+                                               _MM_SHUFFLE( 1, 1, 0, 0 ) );
+        const __m256 y1z1 = _mm256_shuffle_ps( y, z,
+                                               _MM_SHUFFLE( 1, 1, 1, 1 ) );
+        const __m256 z2x3 = _mm256_shuffle_ps( z, x,
+                                               _MM_SHUFFLE( 3, 3, 2, 2 ) );
+        const __m256 y3z3 = _mm256_shuffle_ps( y, z,
+                                               _MM_SHUFFLE( 3, 3, 3, 3 ) );
+        a = _mm256_shuffle_ps( x0y0, z0x1, _MM_SHUFFLE( 2, 0, 1, 0 ) );
+        b = _mm256_shuffle_ps( y1z1, x2y2, _MM_SHUFFLE( 1, 0, 2, 0 ) );
+        c = _mm256_shuffle_ps( z2x3, y3z3, _MM_SHUFFLE( 2, 0, 2, 0 ) );
+    }
+#endif
+}
+}
+
+inline void TransformHomogeneous( const float4x4& m,
+                                  const float4* in,
+                                  float4* out,
+                                  u32 count,
+                                  u32 in_stride  = sizeof(float4),
+                                  u32 out_stride = sizeof(float4) )
+{
+    using namespace detail::sse;
+    const __m128 c0 = Load( &m.m_elements[0][0] );
+    const __m128 c1 = Load( &m.m_elements[1][0] );
+    const __m128 c2 = Load( &m.m_elements[2][0] );
+    const __m128 c3 = Load( &m.m_elements[3][0] );
+
+    for( u32 n = 0; n < count; ++n )
+    {
+        const float* p = &detail::Advance( in, n, in_stride )->m_elements[0][0];
+        float*       q = &detail::Advance( out, n, out_stride )->m_elements[0][0];
+        const __m128 r = _mm_add_ps( LinearCombination3( c0, c1, c2, p ),
+                                     _mm_mul_ps( c3, _mm_load1_ps( p + 3 ) ) );
+        Store( q, r );
+    }
+}
+
+//
+// InvertBatch transposes groups of four matrices, or eight with AVX, so that
+// each register holds the same element of every matrix in the group. The
+// cofactors are then computed for the whole group at once from the 2x2
+// determinants of the first and last pairs of columns, as in "The Laplace
+// Expansion Theorem: Computing the Determinants and Inverses of Matrices" by
+// David Eberly. The inverse of the transpose is the transpose of the inverse,
+// so this works on our column major storage as is.
+//
+
+namespace detail
+{
+namespace sse
+{
+    inline void Transpose4( __m128& a, __m128& b, __m128& c, __m128& d )
+    {
+        _MM_TRANSPOSE4_PS( a, b, c, d );
+    }
+
+    //
+    // Four matrices, element i, j of matrix k is in lane k of m[i][j]
+    //
+    struct Pack4
+    {
+        using type = __m128;
+        static const u32 width = 4;
+
+        static void LoadPack( const float4x4* in, __m128 (&m)[4][4] )
+        {
+            for( u32 i = 0; i < 4; ++i )
+            {
+                for( u32 k = 0; k < 4; ++k )
+                    m[i][k] = Load( &in[k].m_elements[i][0] );
+                Transpose4( m[i][0], m[i][1], m[i][2], m[i][3] );
+            }
+        }
+
+        //
+        // Stores column i of each matrix from the elements in c
+        //
+        static void StoreColumn( float4x4* out, u32 i,
+                                 __m128 c0, __m128 c1, __m128 c2, __m128 c3 )
+        {
+            Transpose4( c0, c1, c2, c3 );
+            Store( &out[0].m_elements[i][0], c0 );
+            Store( &out[1].m_elements[i][0], c1 );
+            Store( &out[2].m_elements[i][0], c2 );
+            Store( &out[3].m_elements[i][0], c3 );
+        }
+
+        //
+        // Four float3s stride bytes apart, component i of vector k is in lane
+        // k of v[i]. Packed arrays are read three registers at a time, others
+        // a vector at a time so that nothing between them is touched.
+        //
+        static void LoadVectors( const float3* in, u32 stride,
+                                 __m128 (&v)[3] )
+        {
+            if( stride == sizeof(float3) )
+            {
+                const float* f = &in->m_elements[0][0];
+                Deinterleave3( Load( f ), Load( f + 4 ), Load( f + 8 ),
+                               v[0], v[1], v[2] );
+                return;
+            }
+
+            __m128 p[4];
+            for( u32 k = 0; k < 4; ++k )
+                p[k] = LoadXYZ( &Advance( in, k, stride )->m_elements[0][0] );
+            Transpose4( p[0], p[1], p[2], p[3] );
+            v[0] = p[0];
+            v[1] = p[1];
+            v[2] = p[2];
+        }
+
+        static void StoreVectors( float3* out, u32 stride,
+                                  const __m128 (&v)[3] )
+        {
+            if( stride == sizeof(float3) )
+            {
+                __m128 a, b, c;
+                Interleave3( v[0], v[1], v[2], a, b, c );
+                float* f = &out->m_elements[0][0];
+                Store( f, a );
+                Store( f + 4, b );
+                Store( f + 8, c );
+                return;
+            }
+
+            __m128 p[4] = { v[0], v[1], v[2], _mm_setzero_ps() };
+            Transpose4( p[0], p[1], p[2], p[3] );
+            for( u32 k = 0; k < 4; ++k )
+                StoreXYZ( &Advance( out, k, stride )->m_elements[0][0], p[k] );
+        }
+
+        static __m128 Set( float f )
+        {
+            return _mm_set1_ps( f );
+        }
+
+        static __m128 Reciprocal( __m128 v )
+        {
+            return _mm_rcp_ps( v );
+        }
+
+        //
+        // The lanes in which |v| isn't at least min, including NaNs
+        //
+        static u32 LessMask( __m128 v, __m128 min )
+        {
+            return _mm_movemask_ps(
+                   _mm_cmpnge_ps( _mm_andnot_ps( Set( -0.f ), v ), min ) );
+        }
+    };
+
+#if defined( JOEMATH_AVX )
+    //
+    // This transposes each half separately
+    //
+    inline void Transpose4( __m256& a, __m256& b, __m256& c, __m256& d )
+    {
+        const __m256 t0 = _mm256_unpacklo_ps( a, b );
+        const __m256 t1 = _mm256_unpacklo_ps( c, d );
+        const __m256 t2 = _mm256_unpackhi_ps( a, b );
+        const __m256 t3 = _mm256_unpackhi_ps( c, d );
+        a = _mm256_shuffle_ps( t0, t1, _MM_SHUFFLE( 1, 0, 1, 0 ) );
+        b = _mm256_shuffle_ps( t0, t1, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+        c = _mm256_shuffle_ps( t2, t3, _MM_SHUFFLE( 1, 0, 1, 0 ) );
+        d = _mm256_shuffle_ps( t2, t3, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+    }
+
+    //
+    // Eight matrices, element i, j of matrix k is in lane k of m[i][j]. The
+    // low half holds the first four and the high half the last four.
+    //
+    struct Pack8
+    {
+        using type = __m256;
+        static const u32 width = 8;
+
+        static void LoadPack( const float4x4* in, __m256 (&m)[4][4] )
+        {
+            for( u32 i = 0; i < 4; ++i )
+            {
+                for( u32 k = 0; k < 4; ++k )
+                    m[i][k] = _mm256_insertf128_ps(
+                        _mm256_castps128_ps256(
+                                      Load( &in[k].m_elements[i][0] ) ),
+                        Load( &in[k + 4].m_elements[i][0] ), 1 );
+                Transpose4( m[i][0], m[i][1], m[i][2], m[i][3] );
+            }
+        }
+
+        static void StoreColumn( float4x4* out, u32 i,
+                                 __m256 c0, __m256 c1, __m256 c2, __m256 c3 )
+        {
+            Transpose4( c0, c1, c2, c3 );
+            const __m256 c[4] = { c0, c1, c2, c3 };
+            for( u32 k = 0; k < 4; ++k )
+            {
+                Store( &out[k].m_elements[i][0],
+                       _mm256_castps256_ps128( c[k] ) );
+                Store( &out[k + 4].m_elements[i][0],
+                       _mm256_extractf128_ps( c[k], 1 ) );
+            }
+        }
+
+        //
+        // Packed arrays are read as three registers of eight floats and the
+        // halves swapped around so that each half holds four whole float3s
+        //
+        static void LoadVectors( const float3* in, u32 stride,
+                                 __m256 (&v)[3] )
+        {
+            if( stride == sizeof(float3) )
+            {
+                const float* f = &in->m_elements[0][0];
+                const __m256 l0 = _mm256_loadu_ps( f );
+                const __m256 l1 = _mm256_loadu_ps( f + 8 );
+                const __m256 l2 = _mm256_loadu_ps( f + 16 );
+                Deinterleave3( _mm256_permute2f128_ps( l0, l1, 0x30 ),
+                               _mm256_permute2f128_ps( l0, l2, 0x21 ),
+                               _mm256_blend_ps( l1, l2, 0xF0 ),
+                               v[0], v[1], v[2] );
+                return;
+            }
+
+            __m256 p[4];
+            for( u32 k = 0; k < 4; ++k )
+                p[k] = _mm256_insertf128_ps(
+                    _mm256_castps128_ps256( LoadXYZ(
+                            &Advance( in, k, stride )->m_elements[0][0] ) ),
+                    LoadXYZ( &Advance( in, k + 4, stride )->m_elements[0][0] ),
+                    1 );
+            Transpose4( p[0], p[1], p[2], p[3] );
+            v[0] = p[0];
+            v[1] = p[1];
+            v[2] = p[2];
+        }
+
+        static void StoreVectors( float3* out, u32 stride,
+                                  const __m256 (&v)[3] )
+        {
+            if( stride == sizeof(float3) )
+            {
+                __m256 a, b, c;
+                Interleave3( v[0], v[1], v[2], a, b, c );
+                float* f = &out->m_elements[0][0];
+                _mm256_storeu_ps( f,      _mm256_permute2f128_ps( a, b, 0x20 ) );
+                _mm256_storeu_ps( f + 8,  _mm256_blend_ps( c, a, 0xF0 ) );
+                _mm256_storeu_ps( f + 16, _mm256_permute2f128_ps( b, c, 0x31 ) );
+                return;
+            }
+
+            __m256 p[4] = { v[0], v[1], v[2], _mm256_setzero_ps() };
+            Transpose4( p[0], p[1], p[2], p[3] );
+            for( u32 k = 0; k < 4; ++k )
+            {
+                StoreXYZ( &Advance( out, k, stride )->m_elements[0][0],
+                          _mm256_castps256_ps128( p[k] ) );
+                StoreXYZ( &Advance( out, k + 4, stride )->m_elements[0][0],
+                          _mm256_extractf128_ps( p[k], 1 ) );
+            }
+        }
+
+        static __m256 Set( float f )
+        {
+            return _mm256_set1_ps( f );
+        }
+
+        static __m256 Reciprocal( __m256 v )
+        {
+            return _mm256_rcp_ps( v );
+        }
+
+        static u32 LessMask( __m256 v, __m256 min )
+        {
+            return _mm256_movemask_ps(
+                   _mm256_cmp_ps( _mm256_andnot_ps( Set( -0.f ), v ), min,
+                                  _CMP_NGE_UQ ) );
+        }
+    };
+#endif
+
+    //
+    // a * x - b * y + c * z
+    //
+    template <typename R>
+    inline R Cofactor( R a, R x, R b, R y, R c, R z )
+    {
+        const Add add;
+        const Sub sub;
+        const Mul mul;
+        return add( sub( mul( a, x ), mul( b, y ) ), mul( c, z ) );
+    }
+
+    //
+    // Inverts Pack::width matrices from in to out, which may be the same, and
+    // returns a mask of the singular ones
+    //
+    template <typename Pack>
+    inline u32 InvertPack( const float4x4* in, float4x4* out )
+    {
+        using R = typename Pack::type;
+        const Add add;
+        const Sub sub;
+        const Mul mul;
+
+        R a[4][4];
+        Pack::LoadPack( in, a );
+
+        //
+        // The 2x2 determinants of the first two and last two columns
+        //
+        const R s0 = sub( mul( a[0][0], a[1][1] ), mul( a[1][0], a[0][1] ) );
+        const R s1 = sub( mul( a[0][0], a[1][2] ), mul( a[1][0], a[0][2] ) );
+        const R s2 = sub( mul( a[0][0], a[1][3] ), mul( a[1][0], a[0][3] ) );
+        const R s3 = sub( mul( a[0][1], a[1][2] ), mul( a[1][1], a[0][2] ) );
+        const R s4 = sub( mul( a[0][1], a[1][3] ), mul( a[1][1], a[0][3] ) );
+        const R s5 = sub( mul( a[0][2], a[1][3] ), mul( a[1][2], a[0][3] ) );
+
+        const R c5 = sub( mul( a[2][2], a[3][3] ), mul( a[3][2], a[2][3] ) );
+        const R c4 = sub( mul( a[2][1], a[3][3] ), mul( a[3][1], a[2][3] ) );
+        const R c3 = sub( mul( a[2][1], a[3][2] ), mul( a[3][1], a[2][2] ) );
+        const R c2 = sub( mul( a[2][0], a[3][3] ), mul( a[3][0], a[2][3] ) );
+        const R c1 = sub( mul( a[2][0], a[3][2] ), mul( a[3][0], a[2][2] ) );
+        const R c0 = sub( mul( a[2][0], a[3][1] ), mul( a[3][0], a[2][1] ) );
+
+        const R det = add( Cofactor( s0, c5, s1, c4, s2, c3 ),
+                           Cofactor( s3, c2, s4, c1, s5, c0 ) );
+
+        //
+        // The reciprocal estimate is good to 12 bits, one Newton-Raphson step
+        // doubles that. The cofactors with odd i + j are negated by using the
+        // negated reciprocal.
+        //
+        R r = Pack::Reciprocal( det );
+        r = mul( r, sub( Pack::Set( 2.f ), mul( det, r ) ) );
+        const R n = Xor()( r, Pack::Set( -0.f ) );
+
+        //
+        // Each column is stored as soon as it's computed, all of them may not
+        // fit in registers at once
+        //
+        Pack::StoreColumn( out, 0,
+            mul( Cofactor( a[1][1], c5, a[1][2], c4, a[1][3], c3 ), r ),
+            mul( Cofactor( a[0][1], c5, a[0][2], c4, a[0][3], c3 ), n ),
+            mul( Cofactor( a[3][1], s5, a[3][2], s4, a[3][3], s3 ), r ),
+            mul( Cofactor( a[2][1], s5, a[2][2], s4, a[2][3], s3 ), n ) );
+        Pack::StoreColumn( out, 1,
+            mul( Cofactor( a[1][0], c5, a[1][2], c2, a[1][3], c1 ), n ),
+            mul( Cofactor( a[0][0], c5, a[0][2], c2, a[0][3], c1 ), r ),
+            mul( Cofactor( a[3][0], s5, a[3][2], s2, a[3][3], s1 ), n ),
+            mul( Cofactor( a[2][0], s5, a[2][2], s2, a[2][3], s1 ), r ) );
+        Pack::StoreColumn( out, 2,
+            mul( Cofactor( a[1][0], c4, a[1][1], c2, a[1][3], c0 ), r ),
+            mul( Cofactor( a[0][0], c4, a[0][1], c2, a[0][3], c0 ), n ),
+            mul( Cofactor( a[3][0], s4, a[3][1], s2, a[3][3], s0 ), r ),
+            mul( Cofactor( a[2][0], s4, a[2][1], s2, a[2][3], s0 ), n ) );
+        Pack::StoreColumn( out, 3,
+            mul( Cofactor( a[1][0], c3, a[1][1], c1, a[1][2], c0 ), n ),
+            mul( Cofactor( a[0][0], c3, a[0][1], c1, a[0][2], c0 ), r ),
+            mul( Cofactor( a[3][0], s3, a[3][1], s1, a[3][2], s0 ), n ),
+            mul( Cofactor( a[2][0], s3, a[2][1], s1, a[2][2], s0 ), r ) );
+
+        return Pack::LessMask( det,
+                           Pack::Set( std::numeric_limits<float>::min() ) );
+    }
+
+    inline void StoreMask( bool* singular, u32 mask, u32 count )
+    {
+        for( u32 k = 0; k < count; ++k )
+            singular[k] = ( mask >> k ) & 1;
+    }
+}
+}
+
+/**
+  * The results are within a few ulps of Inverted, but not identical to it
+  */
+inline void InvertBatch         ( const float4x4* in,
+                                  float4x4* out,
+                                  u32 count,
+                                  bool* singular = nullptr )
+{
+#if defined( JOEMATH_AVX )
+    using Pack = detail::sse::Pack8;
+#else
+    using Pack = detail::sse::Pack4;
+#endif
+    const u32 width = Pack::width;
+
+    u32 n = 0;
+    for( ; n + width <= count; n += width )
+    {
+        const u32 mask = detail::sse::InvertPack<Pack>( in + n, out + n );
+        if( singular )
+            detail::sse::StoreMask( singular + n, mask, width );
+    }
+
+    //
+    // The remainder is padded with identities
+    //
+    if( n < count )
+    {
+        const u32 rest = count - n;
+        float4x4 pack[width];
+        for( u32 k = 0; k < width; ++k )
+            pack[k] = k < rest ? in[n + k] : Identity<float, 4>();
+
+        const u32 mask = detail::sse::InvertPack<Pack>( pack, pack );
+        for( u32 k = 0; k < rest; ++k )
+            out[n + k] = pack[k];
+        if( singular )
+            detail::sse::StoreMask( singular + n, mask, rest );
+    }
+}
+
+//
+// TransformPoints and TransformVectors use the same packs as InvertBatch, with
+// each register holding one component of four vectors, or eight with AVX.
+// Every element of m is broadcast to its own register once, and then each
+// component of the results is a sum of products of whole registers. The
+// products are summed in the same order as the generic versions, which
+// transform the vectors left over at the end.
+//
+
+namespace detail
+{
+namespace sse
+{
+    //
+    // Transforms as many whole packs of vectors as there are in count, and
+    // returns how many vectors that was
+    //
+    template <typename Pack, typename Translate>
+    u32 TransformAffinePacks( const float4x4& m,
+                              const float3* in,
+                              float3* out,
+                              u32 count,
+                              u32 in_stride,
+                              u32 out_stride,
+                              Translate )
+    {
+        using R = typename Pack::type;
+        const Add add;
+        const Mul mul;
+
+        R c[4][3];
+        for( u32 j = 0; j < 4; ++j )
+            for( u32 i = 0; i < 3; ++i )
+                c[j][i] = Pack::Set( m.m_elements[j][i] );
+
+        u32 n = 0;
+        for( ; n + Pack::width <= count; n += Pack::width )
+        {
+            R v[3];
+            Pack::LoadVectors( Advance( in, n, in_stride ), in_stride, v );
+
+            R r[3];
+            for( u32 i = 0; i < 3; ++i )
+            {
+                r[i] = mul( c[0][i], v[0] );
+                r[i] = add( r[i], mul( c[1][i], v[1] ) );
+                r[i] = add( r[i], mul( c[2][i], v[2] ) );
+                if( Translate::value )
+                    r[i] = add( r[i], c[3][i] );
+            }
+
+            Pack::StoreVectors( Advance( out, n, out_stride ), out_stride, r );
+        }
+        return n;
+    }
+
+    template <typename Translate>
+    void TransformAffine( const float4x4& m,
+                          const float3* in,
+                          float3* out,
+                          u32 count,
+                          u32 in_stride,
+                          u32 out_stride,
+                          Translate translate )
+    {
+#if defined( JOEMATH_AVX )
+        using Pack = Pack8;
+#else
+        using Pack = Pack4;
+#endif
+        const u32 n = TransformAffinePacks<Pack>( m, in, out, count,
+                                                  in_stride, out_stride,
+                                                  translate );
+        detail::TransformAffine( m,
+                                 Advance( in, n, in_stride ),
+                                 Advance( out, n, out_stride ),
+                                 count - n,
+                                 in_stride,
+                                 out_stride,
+                                 translate );
+    }
+}
+}
+
+inline void TransformPoints     ( const float4x4& m,
+                                  const float3* in,
+                                  float3* out,
+                                  u32 count,
+                                  u32 in_stride  = sizeof(float3),
+                                  u32 out_stride = sizeof(float3) )
+{
+    detail::sse::TransformAffine( m, in, out, count, in_stride, out_stride,
+                                  std::true_type() );
+}
+
+inline void TransformVectors    ( const float4x4& m,
+                                  const float3* in,
+                                  float3* out,
+                                  u32 count,
+                                  u32 in_stride  = sizeof(float3),
+                                  u32 out_stride = sizeof(float3) )
+{
+    detail::sse::TransformAffine( m, in, out, count, in_stride, out_stride,
+                                  std::false_type() );
+}
+
+//
+// The array normalizing functions load four vectors at a time into a Group,
+// and compute the squared lengths of all four with each component in its own
+// register. The components are summed in the same order as Dot, and the
+// scales are computed in the same way as the single vector functions, so the
+// results are identical.
+//
+
+namespace detail
+{
+namespace sse
+{
+    template <u32 Size>
+    struct Group;
+
+    //
+    // Four float3s in three registers, x0 y0 z0 x1, y1 z1 x2 y2, z2 x3 y3 z3
+    //
+    template <>
+    struct Group<3>
+    {
+        explicit Group( const float3* p )
+        {
+            const float* f = &p[0].m_elements[0][0];
+            m_a = Load( f );
+            m_b = Load( f + 4 );
+            m_c = Load( f + 8 );
+        }
+
+        void Store( float3* p ) const
+        {
+            float* f = &p[0].m_elements[0][0];
+            sse::Store( f, m_a );
+            sse::Store( f + 4, m_b );
+            sse::Store( f + 8, m_c );
+        }
+
+        __m128 LengthSq( ) const
+        {
+            __m128 x, y, z;
+            Deinterleave3( m_a, m_b, m_c, x, y, z );
+            return _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, x ),
+                                           _mm_mul_ps( y, y ) ),
+                               _mm_mul_ps( z, z ) );
+        }
+
+        //
+        // Multiplies vector i by lane i of s
+        //
+        void Scale( __m128 s )
+        {
+            m_a = _mm_mul_ps( m_a, _mm_shuffle_ps( s, s,
+                                               _MM_SHUFFLE( 1, 0, 0, 0 ) ) );
+            m_b = _mm_mul_ps( m_b, _mm_shuffle_ps( s, s,
+                                               _MM_SHUFFLE( 2, 2, 1, 1 ) ) );
+            m_c = _mm_mul_ps( m_c, _mm_shuffle_ps( s, s,
+                                               _MM_SHUFFLE( 3, 3, 3, 2 ) ) );
+        }
+
+        //
+        // Replaces vector i with vector i of g where lane i of mask is clear
+        //
+        void Select( __m128 mask, const Group& g )
+        {
+            m_a = _mm_blendv_ps( g.m_a, m_a, _mm_shuffle_ps( mask, mask,
+                                               _MM_SHUFFLE( 1, 0, 0, 0 ) ) );
+            m_b = _mm_blendv_ps( g.m_b, m_b, _mm_shuffle_ps( mask, mask,
+                                               _MM_SHUFFLE( 2, 2, 1, 1 ) ) );
+            m_c = _mm_blendv_ps( g.m_c, m_c, _mm_shuffle_ps( mask, mask,
+                                               _MM_SHUFFLE( 3, 3, 3, 2 ) ) );
+        }
+
+        __m128 m_a, m_b, m_c;
+    };
+
+    //
+    // Four float4s, one in each register
+    //
+    template <>
+    struct Group<4>
+    {
+        explicit Group( const float4* p )
+        {
+            for( u32 i = 0; i < 4; ++i )
+                m_v[i] = Load( &p[i].m_elements[0][0] );
+        }
+
+        void Store( float4* p ) const
+        {
+            for( u32 i = 0; i < 4; ++i )
+                sse::Store( &p[i].m_elements[0][0], m_v[i] );
+        }
+
+        __m128 LengthSq( ) const
+        {
+            __m128 x = m_v[0];
+            __m128 y = m_v[1];
+            __m128 z = m_v[2];
+            __m128 w = m_v[3];
+            _MM_TRANSPOSE4_PS( x, y, z, w );
+            return _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, x ),
+                                                       _mm_mul_ps( y, y ) ),
+                                           _mm_mul_ps( z, z ) ),
+                               _mm_mul_ps( w, w ) );
+        }
+
+        void Scale( __m128 s )
+        {
+            m_v[0] = _mm_mul_ps( m_v[0], Splat<0>( s ) );
+            m_v[1] = _mm_mul_ps( m_v[1], Splat<1>( s ) );
+            m_v[2] = _mm_mul_ps( m_v[2], Splat<2>( s ) );
+            m_v[3] = _mm_mul_ps( m_v[3], Splat<3>( s ) );
+        }
+
+        void Select( __m128 mask, const Group& g )
+        {
+            m_v[0] = _mm_blendv_ps( g.m_v[0], m_v[0], Splat<0>( mask ) );
+            m_v[1] = _mm_blendv_ps( g.m_v[1], m_v[1], Splat<1>( mask ) );
+            m_v[2] = _mm_blendv_ps( g.m_v[2], m_v[2], Splat<2>( mask ) );
+            m_v[3] = _mm_blendv_ps( g.m_v[3], m_v[3], Splat<3>( mask ) );
+        }
+
+        __m128 m_v[4];
+    };
+
+    inline __m128 InverseSqrt( __m128 length_sq )
+    {
+        return _mm_div_ps( _mm_set1_ps( 1.f ), _mm_sqrt_ps( length_sq ) );
+    }
+
+    struct NormalizePrecise
+    {
+        template <u32 Size>
+        void operator () ( Group<Size>& g, __m128 length_sq ) const
+        {
+            g.Scale( InverseSqrt( length_sq ) );
+        }
+    };
+
+    struct NormalizeFast
+    {
+        template <u32 Size>
+        void operator () ( Group<Size>& g, __m128 length_sq ) const
+        {
+            g.Scale( InverseSqrtFast( length_sq ) );
+        }
+    };
+
+    template <u32 Size>
+    struct NormalizeSafe
+    {
+        //
+        // Like std::isnormal, this is false for NaNs
+        //
+        void operator () ( Group<Size>& g, __m128 length_sq ) const
+        {
+            const __m128 min = _mm_set1_ps( std::numeric_limits<float>::min() );
+            const __m128 max = _mm_set1_ps( std::numeric_limits<float>::max() );
+            const __m128 normal = _mm_and_ps( _mm_cmpge_ps( length_sq, min ),
+                                              _mm_cmple_ps( length_sq, max ) );
+            g.Scale( InverseSqrt( length_sq ) );
+            g.Select( normal, m_fallback );
+        }
+
+        Group<Size> m_fallback;
+    };
+
+    struct LengthFast
+    {
+        __m128 operator () ( __m128 length_sq ) const
+        {
+            return _mm_and_ps( _mm_cmpgt_ps( length_sq, _mm_setzero_ps() ),
+                               _mm_mul_ps( length_sq,
+                                           InverseSqrtFast( length_sq ) ) );
+        }
+    };
+
+    struct InverseLength
+    {
+        __m128 operator () ( __m128 length_sq ) const
+        {
+            return InverseSqrt( length_sq );
+        }
+    };
+
+    //
+    // These process as many groups of four as there are in count, and return
+    // the number of vectors processed
+    //
+    template <u32 Size, typename Op>
+    inline u32 NormalizeGroups( const Vector<float, Size>* in,
+                                Vector<float, Size>* out,
+                                u32 count,
+                                Op op )
+    {
+        u32 n = 0;
+        for( ; n + 4 <= count; n += 4 )
+        {
+            Group<Size> g( in + n );
+            op( g, g.LengthSq() );
+            g.Store( out + n );
+        }
+        return n;
+    }
+
+    template <u32 Size, typename Op>
+    inline u32 LengthGroups( const Vector<float, Size>* in,
+                             float* out,
+                             u32 count,
+                             Op op )
+    {
+        u32 n = 0;
+        for( ; n + 4 <= count; n += 4 )
+            Store( out + n, op( Group<Size>( in + n ).LengthSq() ) );
+        return n;
+    }
+
+    template <u32 Size>
+    inline NormalizeSafe<Size> MakeNormalizeSafe(
+                                       const Vector<float, Size>& fallback )
+    {
+        const Vector<float, Size> f[4] = { fallback, fallback,
+                                           fallback, fallback };
+        return NormalizeSafe<Size>{ Group<Size>( f ) };
+    }
+}
+}
+
+inline void NormalizedPrecise   ( const float3* in, float3* out, u32 count )
+{
+    for( u32 n = detail::sse::NormalizeGroups(
+                         in, out, count, detail::sse::NormalizePrecise() );
+         n < count; ++n )
+        out[n] = NormalizedPrecise( in[n] );
+}
+
+inline void NormalizedPrecise   ( const float4* in, float4* out, u32 count )
+{
+    for( u32 n = detail::sse::NormalizeGroups(
+                         in, out, count, detail::sse::NormalizePrecise() );
+         n < count; ++n )
+        out[n] = NormalizedPrecise( in[n] );
+}
+
+inline void NormalizedFast      ( const float3* in, float3* out, u32 count )
+{
+    for( u32 n = detail::sse::NormalizeGroups(
+                         in, out, count, detail::sse::NormalizeFast() );
+         n < count; ++n )
+        out[n] = NormalizedFast( in[n] );
+}
+
+inline void NormalizedFast      ( const float4* in, float4* out, u32 count )
+{
+    for( u32 n = detail::sse::NormalizeGroups(
+                         in, out, count, detail::sse::NormalizeFast() );
+         n < count; ++n )
+        out[n] = NormalizedFast( in[n] );
+}
+
+inline void NormalizedSafe      ( const float3* in,
+                                  float3* out,
+                                  u32 count,
+                                  const float3& fallback = float3( 0.f ) )
+{
+    for( u32 n = detail::sse::NormalizeGroups(
+                         in, out, count,
+                         detail::sse::MakeNormalizeSafe( fallback ) );
+         n < count; ++n )
+        out[n] = NormalizedSafe( in[n], fallback );
+}
+
+inline void NormalizedSafe      ( const float4* in,
+                                  float4* out,
+                                  u32 count,
+                                  const float4& fallback = float4( 0.f ) )
+{
+    for( u32 n = detail::sse::NormalizeGroups(
+                         in, out, count,
+                         detail::sse::MakeNormalizeSafe( fallback ) );
+         n < count; ++n )
+        out[n] = NormalizedSafe( in[n], fallback );
+}
+
+inline void LengthFast          ( const float3* in, float* out, u32 count )
+{
+    for( u32 n = detail::sse::LengthGroups(
+                         in, out, count, detail::sse::LengthFast() );
+         n < count; ++n )
+        out[n] = LengthFast( in[n] );
+}
+
+inline void LengthFast          ( const float4* in, float* out, u32 count )
+{
+    for( u32 n = detail::sse::LengthGroups(
+                         in, out, count, detail::sse::LengthFast() );
+         n < count; ++n )
+        out[n] = LengthFast( in[n] );
+}
+
+inline void InverseLength       ( const float3* in, float* out, u32 count )
+{
+    for( u32 n = detail::sse::LengthGroups(
+                         in, out, count, detail::sse::InverseLength() );
+         n < count; ++n )
+        out[n] = InverseLength( in[n] );
+}
+
+inline void InverseLength       ( const float4* in, float* out, u32 count )
+{
+    for( u32 n = detail::sse::LengthGroups(
+                         in, out, count, detail::sse::InverseLength() );
+         n < count; ++n )
+        out[n] = InverseLength( in[n] );
+}
+
+
+//
+// The array decompositions run the generic code in matrix-inl.hpp on Lanes,
+// which hold the same element of four matrices. Every operation it uses is
+// correctly rounded, so the results are the same as for a single matrix.
+//
+
+namespace detail
+{
+namespace sse
+{
+    struct Lanes
+    {
+        Lanes( ) = default;
+
+        explicit Lanes( float f )
+            : m_v( _mm_set1_ps( f ) )
+        {
+        }
+
+        explicit Lanes( __m128 v )
+            : m_v( v )
+        {
+        }
+
+        __m128 m_v;
+    };
+
+    inline Lanes operator + ( Lanes a, Lanes b )
+    {
+        return Lanes( _mm_add_ps( a.m_v, b.m_v ) );
+    }
+
+    inline Lanes operator - ( Lanes a, Lanes b )
+    {
+        return Lanes( _mm_sub_ps( a.m_v, b.m_v ) );
+    }
+
+    inline Lanes operator - ( Lanes a )
+    {
+        return Lanes( _mm_xor_ps( a.m_v, _mm_set1_ps( -0.f ) ) );
+    }
+
+    inline Lanes operator * ( Lanes a, Lanes b )
+    {
+        return Lanes( _mm_mul_ps( a.m_v, b.m_v ) );
+    }
+
+    inline Lanes operator / ( Lanes a, Lanes b )
+    {
+        return Lanes( _mm_div_ps( a.m_v, b.m_v ) );
+    }
+
+    inline Lanes Sqrt( Lanes x )
+    {
+        return Lanes( _mm_sqrt_ps( x.m_v ) );
+    }
+
+    inline Lanes Abs( Lanes x )
+    {
+        return Lanes( _mm_andnot_ps( _mm_set1_ps( -0.f ), x.m_v ) );
+    }
+
+    //
+    // Like the generic Max this returns b if either is NaN
+    //
+    inline Lanes Max( Lanes a, Lanes b )
+    {
+        return Lanes( _mm_max_ps( a.m_v, b.m_v ) );
+    }
+
+    inline Lanes CopySign( Lanes magnitude, Lanes sign )
+    {
+        const __m128 m = _mm_set1_ps( -0.f );
+        return Lanes( _mm_or_ps( _mm_andnot_ps( m, magnitude.m_v ),
+                                 _mm_and_ps( m, sign.m_v ) ) );
+    }
+
+    inline Lanes Less( Lanes a, Lanes b )
+    {
+        return Lanes( _mm_cmplt_ps( a.m_v, b.m_v ) );
+    }
+
+    inline Lanes Select( Lanes condition, Lanes a, Lanes b )
+    {
+        return Lanes( _mm_blendv_ps( b.m_v, a.m_v, condition.m_v ) );
+    }
+
+    //
+    // Element j, i of matrix k goes in lane k of m[j][i], for the upper left
+    // 3x3 of each matrix
+    //
+    template <typename M>
+    void LoadLanes( const M* in, Lanes (&m)[3][3] )
+    {
+        for( u32 j = 0; j < 3; ++j )
+            for( u32 i = 0; i < 3; ++i )
+                m[j][i] = Lanes( _mm_setr_ps( in[0].m_elements[j][i],
+                                              in[1].m_elements[j][i],
+                                              in[2].m_elements[j][i],
+                                              in[3].m_elements[j][i] ) );
+    }
+
+    inline void StoreLanes( Lanes l, float& o0, float& o1, float& o2,
+                            float& o3 )
+    {
+        alignas(16) float f[4];
+        _mm_store_ps( f, l.m_v );
+        o0 = f[0];
+        o1 = f[1];
+        o2 = f[2];
+        o3 = f[3];
+    }
+
+    //
+    // Stores lane k of m[j][i] in element j, i of matrix k, the rest of a
+    // larger matrix is unchanged
+    //
+    template <typename M>
+    void StoreLanes( const Lanes (&m)[3][3], M& o0, M& o1, M& o2, M& o3 )
+    {
+        for( u32 j = 0; j < 3; ++j )
+            for( u32 i = 0; i < 3; ++i )
+                StoreLanes( m[j][i], o0.m_elements[j][i],
+                                     o1.m_elements[j][i],
+                                     o2.m_elements[j][i],
+                                     o3.m_elements[j][i] );
+    }
+
+    inline void StoreLanes( const Lanes (&v)[3], float3& o0, float3& o1,
+                            float3& o2, float3& o3 )
+    {
+        for( u32 i = 0; i < 3; ++i )
+            StoreLanes( v[i], o0[i], o1[i], o2[i], o3[i] );
+    }
+}
+
+namespace decompose
+{
+    template <>
+    struct lane_traits<sse::Lanes>
+    {
+        using scalar_type = float;
+    };
+}
+
+namespace sse
+{
+    //
+    // Each group of matrices is copied to out before the upper left 3x3s are
+    // stored, so that the rest of a 4x4 matrix is kept
+    //
+    template <u32 Size>
+    void OrthonormalizeBatch( const Matrix<float, Size, Size>* in,
+                              Matrix<float, Size, Size>* out,
+                              u32 count )
+    {
+        u32 n = 0;
+        for( ; n + 4 <= count; n += 4 )
+        {
+            Lanes m[3][3];
+            LoadLanes( in + n, m );
+            decompose::Orthonormalize( m );
+
+            Matrix<float, Size, Size>* o = out + n;
+            if( o != in + n )
+                std::copy( in + n, in + n + 4, o );
+            StoreLanes( m, o[0], o[1], o[2], o[3] );
+        }
+        for( ; n < count; ++n )
+            out[n] = Orthonormalized( in[n] );
+    }
+}
+}
+
+inline void EigenSymmetricBatch ( const float3x3* in,
+                                  EigenDecomposition<float>* out,
+                                  u32 count )
+{
+    using detail::sse::Lanes;
+    using detail::sse::StoreLanes;
+
+    u32 n = 0;
+    for( ; n + 4 <= count; n += 4 )
+    {
+        Lanes s[3][3];
+        detail::sse::LoadLanes( in + n, s );
+        for( u32 j = 0; j < 3; ++j )
+            for( u32 i = 0; i < j; ++i )
+                s[j][i] = s[i][j];
+
+        Lanes values[3];
+        Lanes vectors[3][3];
+        detail::decompose::EigenSymmetric( s, values, vectors );
+
+        EigenDecomposition<float>* o = out + n;
+        StoreLanes( values, o[0].m_values, o[1].m_values,
+                            o[2].m_values, o[3].m_values );
+        StoreLanes( vectors, o[0].m_vectors, o[1].m_vectors,
+                             o[2].m_vectors, o[3].m_vectors );
+    }
+    for( ; n < count; ++n )
+        out[n] = EigenSymmetric( in[n] );
+}
+
+inline void SVDBatch            ( const float3x3* in,
+                                  SingularValueDecomposition<float>* out,
+                                  u32 count )
+{
+    using detail::sse::Lanes;
+    using detail::sse::StoreLanes;
+
+    u32 n = 0;
+    for( ; n + 4 <= count; n += 4 )
+    {
+        Lanes a[3][3];
+        detail::sse::LoadLanes( in + n, a );
+
+        Lanes u[3][3];
+        Lanes values[3];
+        Lanes v[3][3];
+        detail::decompose::SVD( a, u, values, v );
+
+        SingularValueDecomposition<float>* o = out + n;
+        StoreLanes( u, o[0].m_u, o[1].m_u, o[2].m_u, o[3].m_u );
+        StoreLanes( values, o[0].m_values, o[1].m_values,
+                            o[2].m_values, o[3].m_values );
+        StoreLanes( v, o[0].m_v, o[1].m_v, o[2].m_v, o[3].m_v );
+    }
+    for( ; n < count; ++n )
+        out[n] = SVD( in[n] );
+}
+
+inline void OrthonormalizeBatch ( const float3x3* in,
+                                  float3x3* out,
+                                  u32 count )
+{
+    detail::sse::OrthonormalizeBatch( in, out, count );
+}
+
+inline void OrthonormalizeBatch ( const float4x4* in,
+                                  float4x4* out,
+                                  u32 count )
+{
+    detail::sse::OrthonormalizeBatch( in, out, count );
+}
+
+inline void PolarDecomposeBatch ( const float3x3* in,
+                                  PolarDecomposition<float>* out,
+                                  u32 count )
+{
+    using detail::sse::Lanes;
+    using detail::sse::StoreLanes;
+
+    u32 n = 0;
+    for( ; n + 4 <= count; n += 4 )
+    {
+        Lanes m[3][3];
+        detail::sse::LoadLanes( in + n, m );
+
+        Lanes rotation[3][3];
+        Lanes stretch[3][3];
+        detail::decompose::Polar( m, rotation, stretch );
+
+        PolarDecomposition<float>* o = out + n;
+        StoreLanes( rotation, o[0].m_rotation, o[1].m_rotation,
+                              o[2].m_rotation, o[3].m_rotation );
+        StoreLanes( stretch, o[0].m_stretch, o[1].m_stretch,
+                             o[2].m_stretch, o[3].m_stretch );
+    }
+    for( ; n < count; ++n )
+        out[n] = PolarDecompose( in[n] );
+}
+
+#endif
+}
@@ -0,0 +1,1373 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <system_error>
+#include <type_traits>
+
+#include <joemath/charconv.hpp>
+#include <joemath/matrix.hpp>
+
+namespace JoeMath
+{
+namespace detail
+{
+namespace charconv
+{
+    inline ToCharsResult Copy( char* first,
+                               char* last,
+                               const char* begin,
+                               const char* end )
+    {
+        if( last - first < end - begin )
+            return { last, std::errc::value_too_large };
+        std::memcpy( first, begin, end - begin );
+        return { first + ( end - begin ), std::errc() };
+    }
+
+    inline bool IsSpace( char c )
+    {
+        return c == ' '  || c == '\t' || c == '\n' ||
+               c == '\r' || c == '\v' || c == '\f';
+    }
+
+    inline bool IsDigit( char c )
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    //
+    // These look at the bits, so they still work with -ffast-math
+    //
+    template <typename Float>
+    typename std::conditional<sizeof(Float) == 4, u32, u64>::type
+    GetBits( Float value )
+    {
+        typename std::conditional<sizeof(Float) == 4, u32, u64>::type bits;
+        std::memcpy( &bits, &value, sizeof(bits) );
+        return bits;
+    }
+
+    template <typename Float>
+    bool IsNegative( Float value )
+    {
+        return GetBits( value ) >> ( sizeof(Float) * 8 - 1 );
+    }
+
+    template <typename Float>
+    Float WithSign( Float value, bool negative )
+    {
+        auto bits = GetBits( value );
+        const decltype( bits ) sign = decltype( bits ){1} <<
+                                      ( sizeof(Float) * 8 - 1 );
+        bits = negative ? bits | sign : bits & ~sign;
+        std::memcpy( &value, &bits, sizeof(value) );
+        return value;
+    }
+
+    template <typename Float>
+    bool IsZero( Float value )
+    {
+        return GetBits( WithSign( value, false ) ) == 0;
+    }
+
+    //
+    // Returns true for infinities and nans, which are told apart by their
+    // fraction being zero or not
+    //
+    template <typename Float>
+    bool IsSpecial( Float value, bool& is_nan )
+    {
+        const int fraction_bits = std::numeric_limits<Float>::digits - 1;
+        const auto bits = GetBits( value ) & ~( decltype( GetBits( value ) ){1} <<
+                                                ( sizeof(Float) * 8 - 1 ) );
+        const auto infinity = GetBits( std::numeric_limits<Float>::infinity() );
+        is_nan = bits > infinity;
+        return ( bits >> fraction_bits ) == ( infinity >> fraction_bits );
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Grisu3
+    //
+    // From "Printing Floating-Point Numbers Quickly and Accurately with
+    // Integers" by Florian Loitsch. The value and its neighbours are scaled
+    // by a cached power of ten so that their binary exponents are in
+    // [-60, -32], then digits are generated until the result is closer
+    // to the value than either neighbour.
+    ////////////////////////////////////////////////////////////////////////////
+
+    //
+    // f * 2^e
+    //
+    struct DiyFp
+    {
+        u64 f;
+        int e;
+    };
+
+    inline DiyFp Sub( DiyFp x, DiyFp y )
+    {
+        return { x.f - y.f, x.e };
+    }
+
+    //
+    // The upper 64 bits of the product, rounded
+    //
+    inline DiyFp Mul( DiyFp x, DiyFp y )
+    {
+        const u64 x_lo = x.f & 0xFFFFFFFF;
+        const u64 x_hi = x.f >> 32;
+        const u64 y_lo = y.f & 0xFFFFFFFF;
+        const u64 y_hi = y.f >> 32;
+
+        const u64 p0 = x_lo * y_lo;
+        const u64 p1 = x_lo * y_hi;
+        const u64 p2 = x_hi * y_lo;
+        const u64 p3 = x_hi * y_hi;
+
+        u64 q = ( p0 >> 32 ) + ( p1 & 0xFFFFFFFF ) + ( p2 & 0xFFFFFFFF );
+        q += u64{1} << 31;
+
+        return { p3 + ( p1 >> 32 ) + ( p2 >> 32 ) + ( q >> 32 ),
+                 x.e + y.e + 64 };
+    }
+
+    inline DiyFp Normalize( DiyFp x )
+    {
+        while( ( x.f >> 63 ) == 0 )
+        {
+            x.f <<= 1;
+            --x.e;
+        }
+        return x;
+    }
+
+    inline DiyFp NormalizeTo( DiyFp x, int e )
+    {
+        return { x.f << ( x.e - e ), e };
+    }
+
+    //
+    // The value and the midpoints between it and its neighbours, any number
+    // strictly between minus and plus reads back to the value
+    //
+    struct Boundaries
+    {
+        DiyFp w;
+        DiyFp minus;
+        DiyFp plus;
+    };
+
+    template <typename Float>
+    Boundaries ComputeBoundaries( Float value )
+    {
+        typedef typename std::conditional<sizeof(Float) == 4,
+                                          u32, u64>::type Bits;
+
+        const int precision  = std::numeric_limits<Float>::digits;
+        const int bias       = std::numeric_limits<Float>::max_exponent - 1 +
+                               ( precision - 1 );
+        const int min_exp    = 1 - bias;
+        const u64 hidden_bit = u64{1} << ( precision - 1 );
+
+        Bits bits;
+        std::memcpy( &bits, &value, sizeof(bits) );
+        const u64 biased_exponent = bits >> ( precision - 1 );
+        const u64 fraction        = bits & ( hidden_bit - 1 );
+
+        const DiyFp v = biased_exponent == 0 ?
+                DiyFp{ fraction, min_exp } :
+                DiyFp{ fraction + hidden_bit, int( biased_exponent ) - bias };
+
+        //
+        // At a power of two the next value down is half as far away
+        //
+        const bool lower_is_closer = fraction == 0 && biased_exponent > 1;
+        const DiyFp plus  = { 2 * v.f + 1, v.e - 1 };
+        const DiyFp minus = lower_is_closer ? DiyFp{ 4 * v.f - 1, v.e - 2 } :
+                                              DiyFp{ 2 * v.f - 1, v.e - 1 };
+
+        const DiyFp w_plus = Normalize( plus );
+        return { Normalize( v ), NormalizeTo( minus, w_plus.e ), w_plus };
+    }
+
+    const int min_scaled_exponent = -60;
+
+    //
+    // f * 2^e is 10^-k, rounded
+    //
+    struct CachedPower
+    {
+        u64 f;
+        int e;
+        int k;
+    };
+
+    //
+    // Returns a power of ten which scales a DiyFp with exponent e to one with
+    // an exponent in [-60, -32]
+    //
+    inline CachedPower GetCachedPower( int e )
+    {
+        const int min_decimal_exponent = -300;
+        const int decimal_step         = 8;
+
+        static const CachedPower powers[] =
+        {
+        { 0xAB70FE17C79AC6CA, -1060, -300 },
+        { 0xFF77B1FCBEBCDC4F, -1034, -292 },
+        { 0xBE5691EF416BD60C, -1007, -284 },
+        { 0x8DD01FAD907FFC3C,  -980, -276 },
+        { 0xD3515C2831559A83,  -954, -268 },
+        { 0x9D71AC8FADA6C9B5,  -927, -260 },
+        { 0xEA9C227723EE8BCB,  -901, -252 },
+        { 0xAECC49914078536D,  -874, -244 },
+        { 0x823C12795DB6CE57,  -847, -236 },
+        { 0xC21094364DFB5637,  -821, -228 },
+        { 0x9096EA6F3848984F,  -794, -220 },
+        { 0xD77485CB25823AC7,  -768, -212 },
+        { 0xA086CFCD97BF97F4,  -741, -204 },
+        { 0xEF340A98172AACE5,  -715, -196 },
+        { 0xB23867FB2A35B28E,  -688, -188 },
+        { 0x84C8D4DFD2C63F3B,  -661, -180 },
+        { 0xC5DD44271AD3CDBA,  -635, -172 },
+        { 0x936B9FCEBB25C996,  -608, -164 },
+        { 0xDBAC6C247D62A584,  -582, -156 },
+        { 0xA3AB66580D5FDAF6,  -555, -148 },
+        { 0xF3E2F893DEC3F126,  -529, -140 },
+        { 0xB5B5ADA8AAFF80B8,  -502, -132 },
+        { 0x87625F056C7C4A8B,  -475, -124 },
+        { 0xC9BCFF6034C13053,  -449, -116 },
+        { 0x964E858C91BA2655,  -422, -108 },
+        { 0xDFF9772470297EBD,  -396, -100 },
+        { 0xA6DFBD9FB8E5B88F,  -369,  -92 },
+        { 0xF8A95FCF88747D94,  -343,  -84 },
+        { 0xB94470938FA89BCF,  -316,  -76 },
+        { 0x8A08F0F8BF0F156B,  -289,  -68 },
+        { 0xCDB02555653131B6,  -263,  -60 },
+        { 0x993FE2C6D07B7FAC,  -236,  -52 },
+        { 0xE45C10C42A2B3B06,  -210,  -44 },
+        { 0xAA242499697392D3,  -183,  -36 },
+        { 0xFD87B5F28300CA0E,  -157,  -28 },
+        { 0xBCE5086492111AEB,  -130,  -20 },
+        { 0x8CBCCC096F5088CC,  -103,  -12 },
+        { 0xD1B71758E219652C,   -77,   -4 },
+        { 0x9C40000000000000,   -50,    4 },
+        { 0xE8D4A51000000000,   -24,   12 },
+        { 0xAD78EBC5AC620000,     3,   20 },
+        { 0x813F3978F8940984,    30,   28 },
+        { 0xC097CE7BC90715B3,    56,   36 },
+        { 0x8F7E32CE7BEA5C70,    83,   44 },
+        { 0xD5D238A4ABE98068,   109,   52 },
+        { 0x9F4F2726179A2245,   136,   60 },
+        { 0xED63A231D4C4FB27,   162,   68 },
+        { 0xB0DE65388CC8ADA8,   189,   76 },
+        { 0x83C7088E1AAB65DB,   216,   84 },
+        { 0xC45D1DF942711D9A,   242,   92 },
+        { 0x924D692CA61BE758,   269,  100 },
+        { 0xDA01EE641A708DEA,   295,  108 },
+        { 0xA26DA3999AEF774A,   322,  116 },
+        { 0xF209787BB47D6B85,   348,  124 },
+        { 0xB454E4A179DD1877,   375,  132 },
+        { 0x865B86925B9BC5C2,   402,  140 },
+        { 0xC83553C5C8965D3D,   428,  148 },
+        { 0x952AB45CFA97A0B3,   455,  156 },
+        { 0xDE469FBD99A05FE3,   481,  164 },
+        { 0xA59BC234DB398C25,   508,  172 },
+        { 0xF6C69A72A3989F5C,   534,  180 },
+        { 0xB7DCBF5354E9BECE,   561,  188 },
+        { 0x88FCF317F22241E2,   588,  196 },
+        { 0xCC20CE9BD35C78A5,   614,  204 },
+        { 0x98165AF37B2153DF,   641,  212 },
+        { 0xE2A0B5DC971F303A,   667,  220 },
+        { 0xA8D9D1535CE3B396,   694,  228 },
+        { 0xFB9B7CD9A4A7443C,   720,  236 },
+        { 0xBB764C4CA7A44410,   747,  244 },
+        { 0x8BAB8EEFB6409C1A,   774,  252 },
+        { 0xD01FEF10A657842C,   800,  260 },
+        { 0x9B10A4E5E9913129,   827,  268 },
+        { 0xE7109BFBA19C0C9D,   853,  276 },
+        { 0xAC2820D9623BF429,   880,  284 },
+        { 0x80444B5E7AA7CF85,   907,  292 },
+        { 0xBF21E44003ACDD2D,   933,  300 },
+        { 0x8E679C2F5E44FF8F,   960,  308 },
+        { 0xD433179D9C8CB841,   986,  316 },
+        { 0x9E19DB92B4E31BA9,  1013,  324 },
+        { 0xEB96BF6EBADF77D9,  1039,  332 },
+        { 0xAF87023B9BF0EE6B,  1066,  340 },
+        };
+
+        //
+        // k = ceil( ( -60 - e - 1 ) * log10(2) )
+        //
+        const int f = min_scaled_exponent - e - 1;
+        const int k = ( f * 78913 ) / ( 1 << 18 ) + int( f > 0 );
+        const int index = ( -min_decimal_exponent + k + ( decimal_step - 1 ) ) /
+                          decimal_step;
+        return powers[index];
+    }
+
+    //
+    // Returns the number of decimal digits in n, and the largest power of ten
+    // no greater than n
+    //
+    inline int FindLargestPow10( u32 n, u32& pow10 )
+    {
+        int digits = 10;
+        pow10 = 1000000000;
+        while( digits > 1 && n < pow10 )
+        {
+            pow10 /= 10;
+            --digits;
+        }
+        return digits;
+    }
+
+    //
+    // Moves the last digit towards w while it stays in the unsafe interval.
+    // The scaled values are only known to within unit, so this returns false
+    // if another digit could be closer to w or if the result could be outside
+    // the real boundaries.
+    //
+    inline bool RoundWeed( char* digits,
+                           int length,
+                           u64 distance_too_high_w,
+                           u64 unsafe_interval,
+                           u64 rest,
+                           u64 ten_k,
+                           u64 unit )
+    {
+        const u64 small_distance = distance_too_high_w - unit;
+        const u64 big_distance   = distance_too_high_w + unit;
+
+        while( rest < small_distance &&
+               unsafe_interval - rest >= ten_k &&
+               ( rest + ten_k < small_distance ||
+                 small_distance - rest >= rest + ten_k - small_distance ) )
+        {
+            --digits[length - 1];
+            rest += ten_k;
+        }
+
+        if( rest < big_distance &&
+            unsafe_interval - rest >= ten_k &&
+            ( rest + ten_k < big_distance ||
+              big_distance - rest > rest + ten_k - big_distance ) )
+            return false;
+
+        return 2 * unit <= rest && rest <= unsafe_interval - 4 * unit;
+    }
+
+    //
+    // Generates the shortest digits in the range between low and high, all
+    // with exponents in [-60, -32], which are closest to w. The value is
+    // digits * 10^kappa.
+    //
+    inline bool GenerateDigits( char* digits,
+                                int& length,
+                                int& kappa,
+                                DiyFp low,
+                                DiyFp w,
+                                DiyFp high )
+    {
+        //
+        // The products may be out by one ulp, so everything in the unsafe
+        // interval may be in range and the result has to be found in a
+        // narrower one
+        //
+        u64 unit = 1;
+        const DiyFp too_low  = { low.f - unit, low.e };
+        const DiyFp too_high = { high.f + unit, high.e };
+        u64 unsafe_interval  = Sub( too_high, too_low ).f;
+
+        //
+        // Split too_high into its integer and fractional parts
+        //
+        const DiyFp one = { u64{1} << -w.e, w.e };
+        u32 p1 = u32( too_high.f >> -one.e );
+        u64 p2 = too_high.f & ( one.f - 1 );
+
+        u32 pow10;
+        kappa  = FindLargestPow10( p1, pow10 );
+        length = 0;
+
+        while( kappa > 0 )
+        {
+            digits[length++] = char( '0' + p1 / pow10 );
+            p1 %= pow10;
+            --kappa;
+
+            const u64 rest = ( u64{p1} << -one.e ) + p2;
+            if( rest < unsafe_interval )
+                return RoundWeed( digits, length, Sub( too_high, w ).f,
+                                  unsafe_interval, rest,
+                                  u64{pow10} << -one.e, unit );
+            pow10 /= 10;
+        }
+
+        while( true )
+        {
+            p2              *= 10;
+            unit            *= 10;
+            unsafe_interval *= 10;
+
+            digits[length++] = char( '0' + ( p2 >> -one.e ) );
+            p2 &= one.f - 1;
+            --kappa;
+
+            if( p2 < unsafe_interval )
+                return RoundWeed( digits, length, Sub( too_high, w ).f * unit,
+                                  unsafe_interval, p2, one.f, unit );
+        }
+    }
+
+    //
+    // Writes the shortest digits of a positive finite value, the value is
+    // digits * 10^exponent. This returns false when it can't be sure they're
+    // the shortest and closest, which is about one double in two hundred
+    //
+    template <typename Float>
+    bool Grisu3( char* digits, int& length, int& exponent, Float value )
+    {
+        const Boundaries b = ComputeBoundaries( value );
+        const CachedPower cached = GetCachedPower( b.plus.e );
+        const DiyFp c = { cached.f, cached.e };
+
+        int kappa;
+        const bool ok = GenerateDigits( digits, length, kappa,
+                                        Mul( b.minus, c ),
+                                        Mul( b.w, c ),
+                                        Mul( b.plus, c ) );
+        exponent = kappa - cached.k;
+        return ok;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Dragon4
+    //
+    // From "Printing Floating-Point Numbers Quickly and Accurately" by Robert
+    // G. Burger and R. Kent Dybvig. The value and its boundaries are kept as
+    // exact fractions of big integers, so the digits are always the shortest
+    // and closest. It's much slower than Grisu3 and only used when Grisu3
+    // can't decide.
+    ////////////////////////////////////////////////////////////////////////////
+
+    //
+    // An unsigned integer big enough for the scaled value and boundaries of
+    // any double, least significant limb first
+    //
+    struct BigInt
+    {
+        u32 limbs[40];
+        int size;
+    };
+
+    inline BigInt MakeBigInt( u64 n )
+    {
+        BigInt x;
+        x.size = 0;
+        for( ; n != 0; n >>= 32 )
+            x.limbs[x.size++] = u32( n );
+        return x;
+    }
+
+    inline int Compare( const BigInt& x, const BigInt& y )
+    {
+        if( x.size != y.size )
+            return x.size < y.size ? -1 : 1;
+        for( int i = x.size - 1; i >= 0; --i )
+            if( x.limbs[i] != y.limbs[i] )
+                return x.limbs[i] < y.limbs[i] ? -1 : 1;
+        return 0;
+    }
+
+    inline BigInt Add( const BigInt& x, const BigInt& y )
+    {
+        const BigInt& a = x.size >= y.size ? x : y;
+        const BigInt& b = x.size >= y.size ? y : x;
+
+        BigInt sum;
+        u64 carry = 0;
+        for( int i = 0; i < a.size; ++i )
+        {
+            carry += u64{a.limbs[i]} + ( i < b.size ? b.limbs[i] : 0 );
+            sum.limbs[i] = u32( carry );
+            carry >>= 32;
+        }
+        sum.size = a.size;
+        if( carry != 0 )
+            sum.limbs[sum.size++] = u32( carry );
+        return sum;
+    }
+
+    //
+    // x -= y, y must be no greater than x
+    //
+    inline void Subtract( BigInt& x, const BigInt& y )
+    {
+        u64 borrow = 0;
+        for( int i = 0; i < x.size; ++i )
+        {
+            const u64 d = u64{x.limbs[i]} -
+                          ( i < y.size ? y.limbs[i] : 0 ) - borrow;
+            x.limbs[i] = u32( d );
+            borrow = d >> 63;
+        }
+        while( x.size > 0 && x.limbs[x.size - 1] == 0 )
+            --x.size;
+    }
+
+    inline void MulSmall( BigInt& x, u32 m )
+    {
+        u64 carry = 0;
+        for( int i = 0; i < x.size; ++i )
+        {
+            carry += u64{x.limbs[i]} * m;
+            x.limbs[i] = u32( carry );
+            carry >>= 32;
+        }
+        if( carry != 0 )
+            x.limbs[x.size++] = u32( carry );
+    }
+
+    inline void MulPow10( BigInt& x, int n )
+    {
+        static const u32 small_powers[] =
+        {
+            1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000
+        };
+
+        for( ; n >= 9; n -= 9 )
+            MulSmall( x, 1000000000 );
+        MulSmall( x, small_powers[n] );
+    }
+
+    inline void ShiftLeft( BigInt& x, int n )
+    {
+        if( x.size == 0 )
+            return;
+
+        const int limbs = n / 32;
+        const int bits  = n % 32;
+
+        if( bits != 0 )
+        {
+            u32 carry = 0;
+            for( int i = 0; i < x.size; ++i )
+            {
+                const u32 limb = x.limbs[i];
+                x.limbs[i] = ( limb << bits ) | carry;
+                carry = limb >> ( 32 - bits );
+            }
+            if( carry != 0 )
+                x.limbs[x.size++] = carry;
+        }
+
+        if( limbs != 0 )
+        {
+            for( int i = x.size - 1; i >= 0; --i )
+                x.limbs[i + limbs] = x.limbs[i];
+            std::fill_n( x.limbs, limbs, u32{0} );
+            x.size += limbs;
+        }
+    }
+
+    //
+    // Returns r / s and leaves the remainder in r, the quotient must be a
+    // single digit
+    //
+    inline int DivideDigit( BigInt& r, const BigInt& s )
+    {
+        int d = 0;
+        for( ; Compare( r, s ) >= 0; ++d )
+            Subtract( r, s );
+        return d;
+    }
+
+    //
+    // Writes the shortest digits of a positive finite value which are
+    // closest to it, and returns how many there are. The value is
+    // digits * 10^exponent.
+    //
+    template <typename Float>
+    int Dragon4( char* digits, int& exponent, Float value )
+    {
+        const int precision  = std::numeric_limits<Float>::digits;
+        const int bias       = std::numeric_limits<Float>::max_exponent - 1 +
+                               ( precision - 1 );
+        const u64 hidden_bit = u64{1} << ( precision - 1 );
+
+        const u64 bits            = GetBits( value );
+        const u64 biased_exponent = bits >> ( precision - 1 );
+        const u64 fraction        = bits & ( hidden_bit - 1 );
+
+        const u64 f = biased_exponent == 0 ? fraction : fraction + hidden_bit;
+        const int e = biased_exponent == 0 ? 1 - bias :
+                                             int( biased_exponent ) - bias;
+        const bool lower_is_closer = fraction == 0 && biased_exponent > 1;
+
+        //
+        // Ties round to even, so the boundaries themselves read back to the
+        // value when its significand is even
+        //
+        const bool even = ( f & 1 ) == 0;
+
+        //
+        // The value is r / s and the boundaries are ( r - m_minus ) / s and
+        // ( r + m_plus ) / s
+        //
+        const int extra = lower_is_closer ? 1 : 0;
+        BigInt r       = MakeBigInt( f );
+        BigInt s       = MakeBigInt( 1 );
+        BigInt m_plus  = MakeBigInt( 1 );
+        BigInt m_minus = MakeBigInt( 1 );
+        ShiftLeft( r, 1 + extra );
+        ShiftLeft( s, 1 + extra );
+        ShiftLeft( m_plus, extra );
+        if( e >= 0 )
+        {
+            ShiftLeft( r, e );
+            ShiftLeft( m_plus, e );
+            ShiftLeft( m_minus, e );
+        }
+        else
+            ShiftLeft( s, -e );
+
+        //
+        // Estimate k = ceil( log10( value ) ) from the position of the top
+        // bit, this may be one too small
+        //
+        int top_bit = e;
+        for( u64 g = f >> 1; g != 0; g >>= 1 )
+            ++top_bit;
+        int k = ( top_bit * 78913 ) / ( 1 << 18 ) + int( top_bit > 0 );
+
+        if( k >= 0 )
+            MulPow10( s, k );
+        else
+        {
+            MulPow10( r, -k );
+            MulPow10( m_plus, -k );
+            MulPow10( m_minus, -k );
+        }
+
+        const int high = Compare( Add( r, m_plus ), s );
+        if( even ? high >= 0 : high > 0 )
+        {
+            MulSmall( s, 10 );
+            ++k;
+        }
+
+        int length = 0;
+        while( true )
+        {
+            MulSmall( r, 10 );
+            MulSmall( m_plus, 10 );
+            MulSmall( m_minus, 10 );
+
+            int d = DivideDigit( r, s );
+
+            const int below = Compare( r, m_minus );
+            const int above = Compare( Add( r, m_plus ), s );
+            const bool round_down = even ? below <= 0 : below < 0;
+            const bool round_up   = even ? above >= 0 : above > 0;
+
+            if( !round_down && !round_up )
+            {
+                digits[length++] = char( '0' + d );
+                continue;
+            }
+
+            //
+            // If both are in range take the closer, or the even one on a tie
+            //
+            if( round_down && round_up )
+            {
+                const int c = Compare( Add( r, r ), s );
+                d += int( c > 0 || ( c == 0 && ( d & 1 ) ) );
+            }
+            else if( round_up )
+                ++d;
+            digits[length++] = char( '0' + d );
+            break;
+        }
+
+        exponent = k - length;
+        return length;
+    }
+
+    //
+    // Grisu3 never returns a number on the boundary between the value and
+    // its neighbours, but one there reads back to the value when its
+    // significand is even, as ties round to even. Large values are often
+    // written as short numbers like this, such as 1.5e10f which is halfway
+    // between two floats, so if a boundary is an integer with fewer digits
+    // it's used instead.
+    //
+    template <typename Float>
+    int ShortenToBoundary( char* digits, int& exponent, int n, Float value )
+    {
+        const int precision  = std::numeric_limits<Float>::digits;
+        const int bias       = std::numeric_limits<Float>::max_exponent - 1 +
+                               ( precision - 1 );
+        const u64 hidden_bit = u64{1} << ( precision - 1 );
+
+        const u64 bits            = GetBits( value );
+        const u64 biased_exponent = bits >> ( precision - 1 );
+        const u64 fraction        = bits & ( hidden_bit - 1 );
+        if( biased_exponent == 0 || ( fraction & 1 ) )
+            return n;
+
+        const u64 f = fraction + hidden_bit;
+        const int e = int( biased_exponent ) - bias;
+        const bool lower_is_closer = fraction == 0 && biased_exponent > 1;
+
+        //
+        // Each boundary is odd * 2^shift
+        //
+        const u64 odds[2]   = { 2 * f + 1,
+                                lower_is_closer ? 4 * f - 1 : 2 * f - 1 };
+        const int shifts[2] = { e - 1, lower_is_closer ? e - 2 : e - 1 };
+
+        for( int b = 0; b < 2; ++b )
+        {
+            //
+            // Take out as many factors of ten as there are, the rest has to
+            // fit in a u64
+            //
+            u64 odd   = odds[b];
+            int shift = shifts[b];
+            if( shift < 0 )
+                continue;
+            int tens = 0;
+            while( tens < shift && odd % 5 == 0 )
+            {
+                odd /= 5;
+                ++tens;
+            }
+            shift -= tens;
+            if( shift >= 64 || ( odd >> ( 63 - shift ) ) != 0 )
+                continue;
+            u64 m = odd << shift;
+
+            char boundary[20];
+            int length = 0;
+            for( ; m != 0; m /= 10 )
+                boundary[length++] = char( '0' + m % 10 );
+            if( length >= n )
+                continue;
+
+            std::reverse_copy( boundary, boundary + length, digits );
+            exponent = tens;
+            n = length;
+        }
+        return n;
+    }
+
+    template <typename Float>
+    ToCharsResult FloatToChars( char* first, char* last, Float value )
+    {
+        char buffer[32];
+        char* p = buffer;
+
+        if( IsNegative( value ) )
+        {
+            *p++ = '-';
+            value = WithSign( value, false );
+        }
+
+        bool is_nan;
+        if( IsSpecial( value, is_nan ) )
+            return Copy( first, last, buffer,
+                         std::copy_n( is_nan ? "nan" : "inf", 3, p ) );
+        if( IsZero( value ) )
+        {
+            *p++ = '0';
+            return Copy( first, last, buffer, p );
+        }
+
+        char digits[20];
+        int  exponent;
+        int  n;
+        if( !Grisu3( digits, n, exponent, value ) )
+            n = Dragon4( digits, exponent, value );
+        n = ShortenToBoundary( digits, exponent, n, value );
+
+        //
+        // The value is 0.digits * 10^k, write whichever of fixed and
+        // scientific notation is shorter
+        //
+        const int k = n + exponent;
+        const int fixed_length = k >= n ? k :
+                                 k > 0  ? n + 1 :
+                                          2 - k + n;
+        const int e = k - 1;
+        const int scientific_length = n + ( n > 1 ) + 2 +
+                                      ( e >= 100 || e <= -100 ? 3 : 2 );
+
+        if( fixed_length <= scientific_length )
+        {
+            if( k >= n )
+            {
+                p = std::copy_n( digits, n, p );
+                p = std::fill_n( p, k - n, '0' );
+            }
+            else if( k > 0 )
+            {
+                p = std::copy_n( digits, k, p );
+                *p++ = '.';
+                p = std::copy_n( digits + k, n - k, p );
+            }
+            else
+            {
+                *p++ = '0';
+                *p++ = '.';
+                p = std::fill_n( p, -k, '0' );
+                p = std::copy_n( digits, n, p );
+            }
+        }
+        else
+        {
+            *p++ = digits[0];
+            if( n > 1 )
+            {
+                *p++ = '.';
+                p = std::copy_n( digits + 1, n - 1, p );
+            }
+            *p++ = 'e';
+            *p++ = e < 0 ? '-' : '+';
+            const int a = e < 0 ? -e : e;
+            if( a >= 100 )
+                *p++ = char( '0' + a / 100 );
+            *p++ = char( '0' + a / 10 % 10 );
+            *p++ = char( '0' + a % 10 );
+        }
+
+        return Copy( first, last, buffer, p );
+    }
+
+    template <typename Integer>
+    ToCharsResult IntegerToChars( char* first, char* last, Integer value )
+    {
+        typedef typename std::make_unsigned<Integer>::type Unsigned;
+
+        char buffer[max_chars<Integer>::value];
+        char* const end = buffer + sizeof(buffer);
+        char* p = end;
+
+        const bool negative = std::is_signed<Integer>::value &&
+                              value < Integer( 0 );
+        Unsigned magnitude = negative ? Unsigned( 0 ) - Unsigned( value ) :
+                                        Unsigned( value );
+        do
+        {
+            *--p = char( '0' + magnitude % 10 );
+            magnitude /= 10;
+        }
+        while( magnitude != 0 );
+
+        if( negative )
+            *--p = '-';
+
+        return Copy( first, last, p, end );
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Parsing
+    ////////////////////////////////////////////////////////////////////////////
+
+    //
+    // Advances p past s if it's there, ignoring case
+    //
+    inline bool MatchCaseless( const char*& p, const char* last, const char* s )
+    {
+        const char* q = p;
+        for( ; *s; ++s, ++q )
+            if( q == last || ( *q | 0x20 ) != *s )
+                return false;
+        p = q;
+        return true;
+    }
+
+    //
+    // Inputs with at most this many significant digits and powers of ten
+    // which are exactly representable can be converted with one rounding
+    //
+    template <typename Float>
+    struct fast_path;
+
+    template <>
+    struct fast_path<float>
+    {
+        static const u64 max_mantissa = u64{1} << 24;
+        static const int max_exponent = 10;
+
+        static float Pow10( int e )
+        {
+            static const float powers[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f,
+                                            1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+            return powers[e];
+        }
+
+        static float Parse( const char* s )
+        {
+            return std::strtof( s, nullptr );
+        }
+    };
+
+    template <>
+    struct fast_path<double>
+    {
+        static const u64 max_mantissa = u64{1} << 53;
+        static const int max_exponent = 22;
+
+        static double Pow10( int e )
+        {
+            static const double powers[] = { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,
+                                             1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                             1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+                                             1e18, 1e19, 1e20, 1e21, 1e22 };
+            return powers[e];
+        }
+
+        static double Parse( const char* s )
+        {
+            return std::strtod( s, nullptr );
+        }
+    };
+
+    //
+    // Digits past this many only matter for whether they're all zero, there
+    // are never more than this many in a number exactly halfway between two
+    // doubles
+    //
+    const int max_significant_digits = 770;
+
+    template <typename Float>
+    FromCharsResult FloatFromChars( const char* first,
+                                    const char* last,
+                                    Float& value )
+    {
+        const char* p = first;
+        const bool negative = p != last && *p == '-';
+        if( negative )
+            ++p;
+
+        if( MatchCaseless( p, last, "inf" ) )
+        {
+            MatchCaseless( p, last, "inity" );
+            value = WithSign( std::numeric_limits<Float>::infinity(),
+                              negative );
+            return { p, std::errc() };
+        }
+        if( MatchCaseless( p, last, "nan" ) )
+        {
+            //
+            // nan may be followed by (n-char-sequence)
+            //
+            const char* q = p;
+            if( q != last && *q == '(' )
+            {
+                ++q;
+                while( q != last && ( IsDigit( *q ) || *q == '_' ||
+                                      ( ( *q | 0x20 ) >= 'a' &&
+                                        ( *q | 0x20 ) <= 'z' ) ) )
+                    ++q;
+                if( q != last && *q == ')' )
+                    p = q + 1;
+            }
+            value = WithSign( std::numeric_limits<Float>::quiet_NaN(),
+                              negative );
+            return { p, std::errc() };
+        }
+
+        //
+        // The value is digits * 10^exponent, without leading zeros
+        //
+        char digits[max_significant_digits + 16];
+        int  length   = 0;
+        int  exponent = 0;
+        bool any_digits = false;
+        bool sticky     = false;
+
+        for( ; p != last && IsDigit( *p ); ++p )
+        {
+            any_digits = true;
+            if( length == 0 && *p == '0' )
+                continue;
+            if( length < max_significant_digits )
+                digits[length++] = *p;
+            else
+            {
+                sticky |= *p != '0';
+                ++exponent;
+            }
+        }
+        if( p != last && *p == '.' )
+        {
+            for( ++p; p != last && IsDigit( *p ); ++p )
+            {
+                any_digits = true;
+                if( length == 0 && *p == '0' )
+                    --exponent;
+                else if( length < max_significant_digits )
+                {
+                    digits[length++] = *p;
+                    --exponent;
+                }
+                else
+                    sticky |= *p != '0';
+            }
+        }
+
+        if( !any_digits )
+            return { first, std::errc::invalid_argument };
+
+        if( p != last && ( *p == 'e' || *p == 'E' ) )
+        {
+            const char* q = p + 1;
+            const bool negative_exponent = q != last && *q == '-';
+            if( q != last && ( *q == '-' || *q == '+' ) )
+                ++q;
+            if( q != last && IsDigit( *q ) )
+            {
+                int e = 0;
+                for( ; q != last && IsDigit( *q ); ++q )
+                    e = std::min( e * 10 + ( *q - '0' ), 100000 );
+                exponent += negative_exponent ? -e : e;
+                p = q;
+            }
+        }
+
+        if( length == 0 )
+        {
+            value = WithSign( Float( 0 ), negative );
+            return { p, std::errc() };
+        }
+
+        typedef fast_path<Float> Fast;
+        if( length <= 19 && !sticky &&
+            exponent >= -Fast::max_exponent && exponent <= Fast::max_exponent )
+        {
+            u64 mantissa = 0;
+            for( int i = 0; i < length; ++i )
+                mantissa = mantissa * 10 + u64( digits[i] - '0' );
+            if( mantissa <= Fast::max_mantissa )
+            {
+                Float v = Float( mantissa );
+                v = exponent < 0 ? v / Fast::Pow10( -exponent ) :
+                                   v * Fast::Pow10( exponent );
+                value = WithSign( v, negative );
+                return { p, std::errc() };
+            }
+        }
+
+        //
+        // Otherwise strtod rounds correctly. It's given an integer mantissa so
+        // that the locale's decimal point doesn't matter, with a final 1 if
+        // any nonzero digits were dropped.
+        //
+        char* s = digits + length;
+        if( sticky )
+        {
+            *s++ = '1';
+            --exponent;
+        }
+        *s++ = 'e';
+        if( exponent < 0 )
+            *s++ = '-';
+        char exponent_digits[8];
+        char* e = exponent_digits;
+        for( int a = exponent < 0 ? -exponent : exponent; a != 0 || e == exponent_digits; a /= 10 )
+            *e++ = char( '0' + a % 10 );
+        while( e != exponent_digits )
+            *s++ = *--e;
+        *s = '\0';
+
+        const Float v = Fast::Parse( digits );
+        bool is_nan;
+        if( IsZero( v ) || IsSpecial( v, is_nan ) )
+            return { p, std::errc::result_out_of_range };
+        value = WithSign( v, negative );
+        return { p, std::errc() };
+    }
+
+    template <typename Integer>
+    FromCharsResult IntegerFromChars( const char* first,
+                                      const char* last,
+                                      Integer& value )
+    {
+        typedef typename std::make_unsigned<Integer>::type Unsigned;
+
+        const char* p = first;
+        const bool negative = std::is_signed<Integer>::value &&
+                              p != last && *p == '-';
+        if( negative )
+            ++p;
+
+        const Unsigned limit = negative ?
+                    Unsigned( std::numeric_limits<Integer>::max() ) + 1 :
+                    Unsigned( std::numeric_limits<Integer>::max() );
+
+        const char* const digits_begin = p;
+        Unsigned magnitude = 0;
+        bool out_of_range = false;
+        for( ; p != last && IsDigit( *p ); ++p )
+        {
+            const Unsigned d = Unsigned( *p - '0' );
+            if( magnitude > ( limit - d ) / 10 )
+                out_of_range = true;
+            else
+                magnitude = Unsigned( magnitude * 10 + d );
+        }
+
+        if( p == digits_begin )
+            return { first, std::errc::invalid_argument };
+        if( out_of_range )
+            return { p, std::errc::result_out_of_range };
+
+        value = negative ? Integer( Unsigned( 0 ) - magnitude ) :
+                           Integer( magnitude );
+        return { p, std::errc() };
+    }
+
+    //
+    // Big enough for two of the longest elements, so that a whole one is
+    // always in the buffer once it's refilled
+    //
+    template <typename T>
+    struct stream_buffer_size
+    : public std::integral_constant<std::size_t,
+                                    ( 2 * ( max_chars<T>::value + 1 ) > 4096 ) ?
+                                    2 * ( max_chars<T>::value + 1 ) : 4096>
+    { };
+}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Writing
+////////////////////////////////////////////////////////////////////////////////
+
+inline ToCharsResult ToChars( char* first, char* last, float value )
+{
+    return detail::charconv::FloatToChars( first, last, value );
+}
+
+inline ToCharsResult ToChars( char* first, char* last, double value )
+{
+    return detail::charconv::FloatToChars( first, last, value );
+}
+
+template <typename Integer, typename>
+ToCharsResult ToChars( char* first, char* last, Integer value )
+{
+    return detail::charconv::IntegerToChars( first, last, value );
+}
+
+template <typename Scalar, u32 Rows, u32 Columns>
+ToCharsResult ToChars( char* first,
+                       char* last,
+                       const Matrix<Scalar, Rows, Columns>& m )
+{
+    for( u32 i = 0; i < Rows * Columns; ++i )
+    {
+        if( i != 0 )
+        {
+            if( first == last )
+                return { last, std::errc::value_too_large };
+            *first++ = ' ';
+        }
+
+        const ToCharsResult r = ToChars( first, last, m.m_elements[0][i] );
+        if( r.ec != std::errc() )
+            return r;
+        first = r.ptr;
+    }
+    return { first, std::errc() };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Reading
+////////////////////////////////////////////////////////////////////////////////
+
+inline FromCharsResult FromChars( const char* first,
+                                  const char* last,
+                                  float& value )
+{
+    return detail::charconv::FloatFromChars( first, last, value );
+}
+
+inline FromCharsResult FromChars( const char* first,
+                                  const char* last,
+                                  double& value )
+{
+    return detail::charconv::FloatFromChars( first, last, value );
+}
+
+template <typename Integer, typename>
+FromCharsResult FromChars( const char* first,
+                           const char* last,
+                           Integer& value )
+{
+    return detail::charconv::IntegerFromChars( first, last, value );
+}
+
+template <typename Scalar, u32 Rows, u32 Columns>
+FromCharsResult FromChars( const char* first,
+                           const char* last,
+                           Matrix<Scalar, Rows, Columns>& m )
+{
+    Matrix<Scalar, Rows, Columns> ret;
+    const char* p = first;
+    for( u32 i = 0; i < Rows * Columns; ++i )
+    {
+        while( p != last && detail::charconv::IsSpace( *p ) )
+            ++p;
+
+        const FromCharsResult r = FromChars( p, last, ret.m_elements[0][i] );
+        if( r.ec == std::errc::invalid_argument )
+            return { first, r.ec };
+        if( r.ec != std::errc() )
+            return r;
+        p = r.ptr;
+    }
+    m = ret;
+    return { p, std::errc() };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Streaming
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+std::ostream& WriteArray( std::ostream& out,
+                          const T* data,
+                          std::size_t count )
+{
+    char buffer[detail::charconv::stream_buffer_size<T>::value];
+    char* const end = buffer + sizeof(buffer);
+    char* p = buffer;
+
+    for( std::size_t i = 0; i < count; ++i )
+    {
+        if( std::size_t( end - p ) < max_chars<T>::value + 1 )
+        {
+            out.write( buffer, p - buffer );
+            p = buffer;
+        }
+        p = ToChars( p, end, data[i] ).ptr;
+        *p++ = '\n';
+    }
+    return out.write( buffer, p - buffer );
+}
+
+template <typename T>
+std::size_t ReadArray( std::istream& in,
+                       T* data,
+                       std::size_t count )
+{
+    const std::size_t size = detail::charconv::stream_buffer_size<T>::value;
+    char buffer[size];
+    std::size_t begin = 0;
+    std::size_t end   = 0;
+    bool        eof   = false;
+    std::size_t read  = 0;
+
+    //
+    // Moves the unread characters to the front of the buffer and fills the
+    // rest from the stream
+    //
+    const auto refill = [&]()
+    {
+        std::memmove( buffer, buffer + begin, end - begin );
+        end -= begin;
+        begin = 0;
+        in.read( buffer + end, size - end );
+        end += std::size_t( in.gcount() );
+        eof = in.eof();
+    };
+
+    while( read < count )
+    {
+        while( begin != end && detail::charconv::IsSpace( buffer[begin] ) )
+            ++begin;
+        if( begin == end )
+        {
+            if( eof )
+                break;
+            refill();
+            continue;
+        }
+
+        T value;
+        const FromCharsResult r = FromChars( buffer + begin, buffer + end,
+                                             value );
+
+        //
+        // If it reached the end of the buffer the element may continue in the
+        // stream
+        //
+        const bool partial = r.ec != std::errc() || r.ptr == buffer + end;
+        if( partial && !eof && ( begin != 0 || end != size ) )
+        {
+            refill();
+            continue;
+        }
+
+        if( r.ec != std::errc() )
+        {
+            in.setstate( std::ios::failbit );
+            return read;
+        }
+
+        data[read++] = value;
+        begin = r.ptr - buffer;
+    }
+
+    //
+    // Give back what was read past the last element
+    //
+    if( begin != end )
+    {
+        in.clear( in.rdstate() & ~std::ios::eofbit & ~std::ios::failbit );
+        in.seekg( -std::streamoff( end - begin ), std::ios::cur );
+    }
+    else if( eof )
+        in.clear( in.rdstate() & ~std::ios::failbit );
+
+    return read;
+}
+}
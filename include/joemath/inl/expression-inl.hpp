@@ -0,0 +1,255 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#pragma once
+
+#include <type_traits>
+
+#include <joemath/expression.hpp>
+#include <joemath/matrix.hpp>
+
+namespace JoeMath
+{
+
+//
+// Expression nodes
+//
+
+template <typename Scalar, u32 Rows, u32 Columns>
+MatrixReference<Scalar, Rows, Columns>::MatrixReference (
+                                        const Matrix<Scalar, Rows, Columns>& m )
+    :m_matrix( m )
+{
+}
+
+template <typename Scalar, u32 Rows, u32 Columns>
+const Scalar& MatrixReference<Scalar, Rows, Columns>::operator [] (
+                                                                 u32 i ) const
+{
+    return m_matrix.m_elements[0][i];
+}
+
+template <typename Scalar, u32 Rows, u32 Columns>
+ScalarExpression<Scalar, Rows, Columns>::ScalarExpression ( Scalar s )
+    :m_scalar( s )
+{
+}
+
+template <typename Scalar, u32 Rows, u32 Columns>
+const Scalar& ScalarExpression<Scalar, Rows, Columns>::operator [] (
+                                                                 u32 ) const
+{
+    return m_scalar;
+}
+
+template <typename Op, typename Operand>
+UnaryExpression<Op, Operand>::UnaryExpression ( const Operand& operand )
+    :m_operand( operand )
+{
+}
+
+template <typename Op, typename Operand>
+typename UnaryExpression<Op, Operand>::scalar_type
+                  UnaryExpression<Op, Operand>::operator [] ( u32 i ) const
+{
+    return Op()( m_operand[i] );
+}
+
+template <typename Op, typename Left, typename Right>
+BinaryExpression<Op, Left, Right>::BinaryExpression ( const Left& left,
+                                                      const Right& right )
+    :m_left( left )
+    ,m_right( right )
+{
+}
+
+template <typename Op, typename Left, typename Right>
+typename BinaryExpression<Op, Left, Right>::scalar_type
+                  BinaryExpression<Op, Left, Right>::operator [] ( u32 i ) const
+{
+    return Op()( m_left[i], m_right[i] );
+}
+
+//
+// Construction and evaluation
+//
+
+template <typename Scalar, u32 Rows, u32 Columns>
+MatrixReference<Scalar, Rows, Columns> Lazy (
+                                        const Matrix<Scalar, Rows, Columns>& m )
+{
+    return MatrixReference<Scalar, Rows, Columns>( m );
+}
+
+template <typename Expression, typename>
+Matrix<typename Expression::scalar_type, Expression::rows, Expression::columns>
+                                        Evaluate ( const Expression& e )
+{
+    return Matrix<typename Expression::scalar_type,
+                  Expression::rows,
+                  Expression::columns>( e );
+}
+
+//
+// Unary Operators
+//
+
+template <typename Expression, typename>
+const Expression& operator + ( const Expression& e )
+{
+    return e;
+}
+
+template <typename Expression, typename>
+UnaryExpression<detail::Negate, Expression> operator - ( const Expression& e )
+{
+    return UnaryExpression<detail::Negate, Expression>( e );
+}
+
+//
+// Arithmetic
+//
+
+template <typename L, typename R>
+typename detail::binary_expression<detail::Add, L, R,
+                                   !std::is_arithmetic<L>::value>::type
+                                   operator + ( const L& l, const R& r )
+{
+    using node = detail::binary_expression<detail::Add, L, R,
+                                           !std::is_arithmetic<L>::value>;
+    return typename node::type( node::left_type::Make( l ),
+                                node::right_type::Make( r ) );
+}
+
+template <typename L, typename R>
+typename detail::binary_expression<detail::Subtract, L, R,
+                                   !std::is_arithmetic<L>::value>::type
+                                   operator - ( const L& l, const R& r )
+{
+    using node = detail::binary_expression<detail::Subtract, L, R,
+                                           !std::is_arithmetic<L>::value>;
+    return typename node::type( node::left_type::Make( l ),
+                                node::right_type::Make( r ) );
+}
+
+template <typename L, typename R>
+typename detail::binary_expression<detail::Multiply, L, R>::type
+                                   operator * ( const L& l, const R& r )
+{
+    using node = detail::binary_expression<detail::Multiply, L, R>;
+    return typename node::type( node::left_type::Make( l ),
+                                node::right_type::Make( r ) );
+}
+
+template <typename L, typename R>
+typename detail::binary_expression<detail::Divide, L, R, false>::type
+                                   operator / ( const L& l, const R& r )
+{
+    using node = detail::binary_expression<detail::Divide, L, R, false>;
+    return typename node::type( node::left_type::Make( l ),
+                                node::right_type::Make( r ) );
+}
+
+template <typename L, typename Scalar, typename>
+BinaryExpression<detail::Multiply, L,
+                 ScalarExpression<decltype( typename L::scalar_type{1} /
+                                            std::declval<Scalar>() ),
+                                  L::rows, L::columns>>
+                                   operator / ( const L& l, const Scalar s )
+{
+    using reciprocal_type = decltype( typename L::scalar_type{1} /
+                                      std::declval<Scalar>() );
+    using scalar_expression = ScalarExpression<reciprocal_type,
+                                               L::rows,
+                                               L::columns>;
+    return BinaryExpression<detail::Multiply, L, scalar_expression>(
+                  l,
+                  scalar_expression( typename L::scalar_type{1} / s ) );
+}
+
+//
+// Assignment operators
+//
+
+template <typename Scalar, u32 Rows, u32 Columns, typename Expression,
+          typename>
+Matrix<Scalar, Rows, Columns>&  operator += ( Matrix<Scalar, Rows, Columns>& m,
+                                              const Expression& e )
+{
+    static_assert( Expression::rows == Rows && Expression::columns == Columns,
+                   "Trying to assign an expression of a different size" );
+
+    for( u32 i = 0; i < Columns*Rows; ++i )
+        m.m_elements[0][i] = m.m_elements[0][i] + e[i];
+
+    return m;
+}
+
+template <typename Scalar, u32 Rows, u32 Columns, typename Expression,
+          typename>
+Matrix<Scalar, Rows, Columns>&  operator -= ( Matrix<Scalar, Rows, Columns>& m,
+                                              const Expression& e )
+{
+    static_assert( Expression::rows == Rows && Expression::columns == Columns,
+                   "Trying to assign an expression of a different size" );
+
+    for( u32 i = 0; i < Columns*Rows; ++i )
+        m.m_elements[0][i] = m.m_elements[0][i] - e[i];
+
+    return m;
+}
+
+template <typename Scalar, u32 Rows, u32 Columns, typename Expression,
+          typename>
+Matrix<Scalar, Rows, Columns>&  operator *= ( Matrix<Scalar, Rows, Columns>& m,
+                                              const Expression& e )
+{
+    static_assert( Expression::rows == Rows && Expression::columns == Columns,
+                   "Trying to assign an expression of a different size" );
+
+    for( u32 i = 0; i < Columns*Rows; ++i )
+        m.m_elements[0][i] = m.m_elements[0][i] * e[i];
+
+    return m;
+}
+
+template <typename Scalar, u32 Rows, u32 Columns, typename Expression,
+          typename>
+Matrix<Scalar, Rows, Columns>&  operator /= ( Matrix<Scalar, Rows, Columns>& m,
+                                              const Expression& e )
+{
+    static_assert( Expression::rows == Rows && Expression::columns == Columns,
+                   "Trying to assign an expression of a different size" );
+
+    for( u32 i = 0; i < Columns*Rows; ++i )
+        m.m_elements[0][i] = m.m_elements[0][i] / e[i];
+
+    return m;
+}
+
+}
@@ -0,0 +1,181 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#include <joemath/hierarchy.hpp>
+#include <joemath/matrix.hpp>
+
+namespace JoeMath
+{
+
+template <typename Scalar>
+const u32 TransformHierarchy<Scalar>::no_parent;
+
+template <typename Scalar>
+u32 TransformHierarchy<Scalar>::AddNode( const matrix_type& local, u32 parent )
+{
+    const u32 node = GetSize();
+    //
+    // Update finds the world transforms in node order, so the parent's has
+    // to be found first
+    //
+    assert( ( parent == no_parent || parent < node ) &&
+            "Trying to add a node before its parent" );
+    m_local.push_back( local );
+    m_world.push_back( local );
+    m_inverse_world.emplace_back();
+    m_parent.push_back( parent );
+    m_flags.push_back( DIRTY );
+    m_first_dirty = std::min( m_first_dirty, node );
+    return node;
+}
+
+template <typename Scalar>
+u32 TransformHierarchy<Scalar>::GetSize( ) const
+{
+    return m_local.size();
+}
+
+template <typename Scalar>
+void TransformHierarchy<Scalar>::Reserve( u32 size )
+{
+    m_local.reserve( size );
+    m_world.reserve( size );
+    m_inverse_world.reserve( size );
+    m_parent.reserve( size );
+    m_flags.reserve( size );
+}
+
+template <typename Scalar>
+void TransformHierarchy<Scalar>::Clear( )
+{
+    m_local.clear();
+    m_world.clear();
+    m_inverse_world.clear();
+    m_parent.clear();
+    m_flags.clear();
+    m_first_dirty = 0;
+}
+
+template <typename Scalar>
+u32 TransformHierarchy<Scalar>::GetParent( u32 node ) const
+{
+    return m_parent[node];
+}
+
+template <typename Scalar>
+const typename TransformHierarchy<Scalar>::matrix_type&
+                        TransformHierarchy<Scalar>::GetLocal( u32 node ) const
+{
+    return m_local[node];
+}
+
+template <typename Scalar>
+void TransformHierarchy<Scalar>::SetLocal( u32 node, const matrix_type& local )
+{
+    m_local[node] = local;
+    m_flags[node] |= DIRTY;
+    m_first_dirty = std::min( m_first_dirty, node );
+}
+
+template <typename Scalar>
+bool TransformHierarchy<Scalar>::IsDirty( u32 node ) const
+{
+    return m_flags[node] & DIRTY;
+}
+
+//
+// Nodes before the first dirty one are untouched. After it, a node changes if
+// it's dirty or if its parent changed in this pass, a parent before the first
+// dirty node can't have changed so its stale CHANGED flag is ignored.
+//
+template <typename Scalar>
+void TransformHierarchy<Scalar>::Update( )
+{
+    const u32 size  = GetSize();
+    const u32 first = m_first_dirty;
+
+    for( u32 node = first; node < size; ++node )
+    {
+        const u32 parent = m_parent[node];
+        const bool parent_changed = parent != no_parent &&
+                                    parent >= first &&
+                                    ( m_flags[parent] & CHANGED );
+
+        if( !( m_flags[node] & DIRTY ) && !parent_changed )
+        {
+            m_flags[node] &= ~CHANGED;
+            continue;
+        }
+
+        if( parent == no_parent )
+            m_world[node] = m_local[node];
+        else
+            m_world[node] = Mul( m_world[parent], m_local[node] );
+
+        //
+        // This also clears DIRTY and INVERSE_VALID
+        //
+        m_flags[node] = CHANGED;
+    }
+
+    m_first_dirty = size;
+}
+
+template <typename Scalar>
+const typename TransformHierarchy<Scalar>::matrix_type&
+                        TransformHierarchy<Scalar>::GetWorld( u32 node ) const
+{
+    return m_world[node];
+}
+
+template <typename Scalar>
+const typename TransformHierarchy<Scalar>::matrix_type*
+                        TransformHierarchy<Scalar>::GetWorldData( ) const
+{
+    return m_world.data();
+}
+
+template <typename Scalar>
+const typename TransformHierarchy<Scalar>::matrix_type&
+                 TransformHierarchy<Scalar>::GetInverseWorld( u32 node ) const
+{
+    if( !( m_flags[node] & INVERSE_VALID ) )
+    {
+        m_inverse_world[node] = Inverted( m_world[node] );
+        m_flags[node] |= INVERSE_VALID;
+    }
+    return m_inverse_world[node];
+}
+
+}
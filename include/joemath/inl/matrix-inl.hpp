@@ -31,11 +31,14 @@
 #include <cassert>
 #include <cmath>
 #include <initializer_list>
+#include <limits>
 #include <type_traits>
+#include <utility>
 
+#include <joemath/functional.hpp>
 #include <joemath/matrix.hpp>
 #include <joemath/scalar.hpp>
-
+#include <joemath/simd.hpp>
 
 namespace JoeMath
 {
@@ -48,16 +51,16 @@ namespace JoeMath
 namespace detail
 {
     template <typename Scalar, u32 Rows, u32 Columns>
-    auto Determinant( const Matrix<Scalar, Rows, Columns>& m,
-                      std::integral_constant<u32, 1> ) ->
+    constexpr auto Determinant( const Matrix<Scalar, Rows, Columns>& m,
+                                std::integral_constant<u32, 1> ) ->
                      decltype( std::declval<Scalar>() * std::declval<Scalar>() )
     {
         return m.m_elements[0][0];
     }
 
     template <typename Scalar, u32 Rows, u32 Columns>
-    auto Determinant( const Matrix<Scalar, Rows, Columns>& m,
-                      std::integral_constant<u32, 2> ) ->
+    constexpr auto Determinant( const Matrix<Scalar, Rows, Columns>& m,
+                                std::integral_constant<u32, 2> ) ->
                      decltype( std::declval<Scalar>() * std::declval<Scalar>() )
     {
        return m.m_elements[0][0] * m.m_elements[1][1] -
@@ -65,8 +68,8 @@ namespace detail
     }
 
     template <typename Scalar, u32 Rows, u32 Columns>
-    auto Determinant( const Matrix<Scalar, Rows, Columns>& m,
-                      std::integral_constant<u32, 3> ) ->
+    constexpr auto Determinant( const Matrix<Scalar, Rows, Columns>& m,
+                                std::integral_constant<u32, 3> ) ->
                      decltype( std::declval<Scalar>() * std::declval<Scalar>() )
     {
         return m.m_elements[0][0] * (m.m_elements[1][1]*m.m_elements[2][2] -
@@ -78,8 +81,8 @@ namespace detail
     }
 
     template <typename Scalar, u32 Rows, u32 Columns>
-    auto Determinant( const Matrix<Scalar, Rows, Columns>& m,
-                      std::integral_constant<u32, 4> ) ->
+    constexpr auto Determinant( const Matrix<Scalar, Rows, Columns>& m,
+                                std::integral_constant<u32, 4> ) ->
                      decltype( std::declval<Scalar>() * std::declval<Scalar>() )
     {
         return m.m_elements[0][3] * m.m_elements[1][2] *
@@ -132,9 +135,13 @@ namespace detail
                 m.m_elements[2][2] * m.m_elements[3][3];
     }
 
+    //
+    // Integer matrices can't be factorized without division, so use cofactor
+    // expansion for them
+    //
     template <typename Scalar, u32 Rows, u32 Columns>
     auto Determinant( const Matrix<Scalar, Rows, Columns>& m,
-                      std::integral_constant<u32, 0> ) ->
+                      std::false_type ) ->
                      decltype( std::declval<Scalar>() * std::declval<Scalar>() )
     {
         using ReturnScalar = decltype( std::declval<Scalar>() *
@@ -148,6 +155,35 @@ namespace detail
         return det;
     }
 
+    //
+    // The determinant is the product of the diagonal of U
+    //
+    template <typename Scalar, u32 Rows, u32 Columns>
+    auto Determinant( const Matrix<Scalar, Rows, Columns>& m,
+                      std::true_type ) ->
+                     decltype( std::declval<Scalar>() * std::declval<Scalar>() )
+    {
+        using ReturnScalar = decltype( std::declval<Scalar>() *
+                                       std::declval<Scalar>() );
+
+        const LUDecomposition<Scalar, Rows> lu = LU( m );
+
+        ReturnScalar det = lu.m_parity;
+
+        for( u32 i = 0; i < Rows; ++i )
+            det *= lu.m_factors.m_elements[i][i];
+
+        return det;
+    }
+
+    template <typename Scalar, u32 Rows, u32 Columns>
+    auto Determinant( const Matrix<Scalar, Rows, Columns>& m,
+                      std::integral_constant<u32, 0> ) ->
+                     decltype( std::declval<Scalar>() * std::declval<Scalar>() )
+    {
+        return Determinant( m, std::is_floating_point<Scalar>() );
+    }
+
 
     template <typename Scalar, u32 Rows, u32 Columns>
     Matrix<Scalar, 1, 1> Inverted( const Matrix<Scalar, Rows, Columns>& m,
@@ -296,7 +332,7 @@ namespace detail
     template <typename Scalar, u32 Rows, u32 Columns>
     Matrix<Scalar, Rows, Columns> Inverted(
                                      const Matrix<Scalar, Rows, Columns>& m,
-                                     std::integral_constant<u32, 0> )
+                                     std::false_type )
     {
         Matrix<Scalar, Columns, Rows> ret;
 
@@ -316,25 +352,661 @@ namespace detail
         return ret / det;
     }
 
+    //
+    // Solve LU * x = P * e for every column e of the identity
+    //
+    template <typename Scalar, u32 Rows, u32 Columns>
+    Matrix<Scalar, Rows, Columns> Inverted(
+                                     const Matrix<Scalar, Rows, Columns>& m,
+                                     std::true_type )
+    {
+        const LUDecomposition<Scalar, Rows> lu = LU( m );
+        const auto& a = lu.m_factors.m_elements;
+
+        Matrix<Scalar, Rows, Columns> ret;
+
+        for( u32 column = 0; column < Columns; ++column )
+        {
+            auto& x = ret.m_elements[column];
+
+            //
+            // Forward substitution with the unit lower triangle
+            //
+            for( u32 i = 0; i < Rows; ++i )
+            {
+                Scalar s = lu.m_pivots[i] == column ? Scalar{1} : Scalar{0};
+                for( u32 k = 0; k < i; ++k )
+                    s -= a[k][i] * x[k];
+                x[i] = s;
+            }
+
+            //
+            // Back substitution with the upper triangle
+            //
+            for( u32 i = Rows; i-- > 0; )
+            {
+                Scalar s = x[i];
+                for( u32 k = i + 1; k < Rows; ++k )
+                    s -= a[k][i] * x[k];
+                x[i] = s / a[i][i];
+            }
+        }
+
+        return ret;
+    }
+
+    template <typename Scalar, u32 Rows, u32 Columns>
+    Matrix<Scalar, Rows, Columns> Inverted(
+                                     const Matrix<Scalar, Rows, Columns>& m,
+                                     std::integral_constant<u32, 0> )
+    {
+        return Inverted( m, std::is_floating_point<Scalar>() );
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Linear systems
+    ////////////////////////////////////////////////////////////////////////////
+
+    //
+    // These recurse on the step K with tag dispatch, so the loops inside each
+    // step have constant bounds and the steps themselves are unrolled
+    //
+
+    template <u32 K>
+    using step = std::integral_constant<u32, K>;
+
+    template <typename Scalar, u32 Size, u32 Columns>
+    bool Eliminate( Matrix<Scalar, Size, Size>&,
+                    Matrix<Scalar, Size, Columns>&,
+                    step<Size> )
+    {
+        return true;
+    }
+
+    //
+    // Eliminates column K below the diagonal of a, applying the same row
+    // operations to x. Returns false if a is singular.
+    //
+    template <typename Scalar, u32 Size, u32 Columns, u32 K>
+    bool Eliminate( Matrix<Scalar, Size, Size>& a,
+                    Matrix<Scalar, Size, Columns>& x,
+                    step<K> )
+    {
+        auto& e = a.m_elements;
+        auto& y = x.m_elements;
+
+        u32 pivot = K;
+        for( u32 i = K + 1; i < Size; ++i )
+            if( Length( e[K][i] ) > Length( e[K][pivot] ) )
+                pivot = i;
+
+        if( e[K][pivot] == Scalar{0} )
+            return false;
+
+        if( pivot != K )
+        {
+            for( u32 j = K; j < Size; ++j )
+                std::swap( e[j][K], e[j][pivot] );
+            for( u32 j = 0; j < Columns; ++j )
+                std::swap( y[j][K], y[j][pivot] );
+        }
+
+        for( u32 i = K + 1; i < Size; ++i )
+        {
+            const Scalar f = e[K][i] / e[K][K];
+            for( u32 j = K + 1; j < Size; ++j )
+                e[j][i] -= f * e[j][K];
+            for( u32 j = 0; j < Columns; ++j )
+                y[j][i] -= f * y[j][K];
+        }
+
+        return Eliminate( a, x, step<K + 1>() );
+    }
+
+    template <typename Scalar, u32 Size, u32 Columns, bool UnitDiagonal>
+    void ForwardSubstitute( const Matrix<Scalar, Size, Size>&,
+                            Matrix<Scalar, Size, Columns>&,
+                            std::integral_constant<bool, UnitDiagonal>,
+                            step<Size> )
+    {
+    }
+
+    //
+    // Solves for row K of x with the lower triangle of l, in place
+    //
+    template <typename Scalar, u32 Size, u32 Columns, bool UnitDiagonal,
+              u32 K>
+    void ForwardSubstitute( const Matrix<Scalar, Size, Size>& l,
+                            Matrix<Scalar, Size, Columns>& x,
+                            std::integral_constant<bool, UnitDiagonal> unit,
+                            step<K> )
+    {
+        const auto& e = l.m_elements;
+        for( u32 j = 0; j < Columns; ++j )
+        {
+            auto& y = x.m_elements[j];
+            Scalar s = y[K];
+            for( u32 k = 0; k < K; ++k )
+                s -= e[k][K] * y[k];
+            y[K] = UnitDiagonal ? s : s / e[K][K];
+        }
+        ForwardSubstitute( l, x, unit, step<K + 1>() );
+    }
+
+    template <typename Scalar, u32 Size, u32 Columns, bool Transpose>
+    void BackSubstitute( const Matrix<Scalar, Size, Size>&,
+                         Matrix<Scalar, Size, Columns>&,
+                         std::integral_constant<bool, Transpose>,
+                         step<0> )
+    {
+    }
+
+    //
+    // Solves for row K-1 of x with the upper triangle of u, or with the
+    // transpose of the lower triangle, in place
+    //
+    template <typename Scalar, u32 Size, u32 Columns, bool Transpose, u32 K>
+    void BackSubstitute( const Matrix<Scalar, Size, Size>& u,
+                         Matrix<Scalar, Size, Columns>& x,
+                         std::integral_constant<bool, Transpose> transpose,
+                         step<K> )
+    {
+        const auto& e = u.m_elements;
+        const u32 i = K - 1;
+        for( u32 j = 0; j < Columns; ++j )
+        {
+            auto& y = x.m_elements[j];
+            Scalar s = y[i];
+            for( u32 k = i + 1; k < Size; ++k )
+                s -= ( Transpose ? e[i][k] : e[k][i] ) * y[k];
+            y[i] = s / e[i][i];
+        }
+        BackSubstitute( u, x, transpose, step<K - 1>() );
+    }
+
+    template <typename Scalar, u32 Size>
+    bool Cholesky( Matrix<Scalar, Size, Size>&, step<Size> )
+    {
+        return true;
+    }
+
+    //
+    // Replaces column K of the lower triangle of a with that of l, where
+    // a = l * transpose(l). Returns false if a isn't positive definite.
+    //
+    template <typename Scalar, u32 Size, u32 K>
+    bool Cholesky( Matrix<Scalar, Size, Size>& a, step<K> )
+    {
+        auto& e = a.m_elements;
+
+        Scalar d = e[K][K];
+        for( u32 k = 0; k < K; ++k )
+            d -= e[k][K] * e[k][K];
+        if( !( d > Scalar{0} ) )
+            return false;
+        e[K][K] = std::sqrt( d );
+
+        for( u32 i = K + 1; i < Size; ++i )
+        {
+            Scalar s = e[K][i];
+            for( u32 k = 0; k < K; ++k )
+                s -= e[k][i] * e[k][K];
+            e[K][i] = s / e[K][K];
+        }
+
+        return Cholesky( a, step<K + 1>() );
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    // 3x3 decompositions
+    ////////////////////////////////////////////////////////////////////////////
+
+    //
+    // These work on plain arrays of a type T which is either the scalar or
+    // several lanes of SIMD registers, so they have no branches on the values
+    // and the same code computes one decomposition or several at once. The
+    // arrays are column major like Matrix. The helpers here are overloaded for
+    // the SIMD lanes in batch-inl.hpp.
+    //
+    namespace decompose
+    {
+        template <typename T>
+        struct lane_traits
+        {
+            using scalar_type = T;
+        };
+
+        template <typename T>
+        T Sqrt( T x )
+        {
+            return std::sqrt( x );
+        }
+
+        template <typename T>
+        T Abs( T x )
+        {
+            return std::abs( x );
+        }
+
+        template <typename T>
+        T Max( T a, T b )
+        {
+            return a > b ? a : b;
+        }
+
+        template <typename T>
+        T CopySign( T magnitude, T sign )
+        {
+            return std::copysign( magnitude, sign );
+        }
+
+        template <typename T>
+        bool Less( T a, T b )
+        {
+            return a < b;
+        }
+
+        template <typename T>
+        T Select( bool condition, T a, T b )
+        {
+            return condition ? a : b;
+        }
+
+        //
+        // Rounds x to zero if it's less than epsilon squared. Everything is
+        // scaled to about one, so this doesn't change the results noticeably,
+        // but it stops the converging elements and their products from
+        // becoming denormal, which is very slow.
+        //
+        template <typename T>
+        T Flush( T x )
+        {
+            using Scalar = typename lane_traits<T>::scalar_type;
+            const Scalar epsilon = std::numeric_limits<Scalar>::epsilon();
+            return Select( Less( Abs( x ), T( epsilon * epsilon ) ),
+                           T( Scalar{0} ), x );
+        }
+
+        //
+        // Divides m by its largest element and returns that element, so that
+        // squaring the elements doesn't overflow or underflow
+        //
+        template <typename T>
+        T Scale( T (&m)[3][3] )
+        {
+            using Scalar = typename lane_traits<T>::scalar_type;
+            T scale = T( Scalar{0} );
+            for( u32 j = 0; j < 3; ++j )
+                for( u32 i = 0; i < 3; ++i )
+                    scale = Max( scale, Abs( m[j][i] ) );
+            const T r = T( Scalar{1} ) /
+                        Max( scale, T( std::numeric_limits<Scalar>::min() ) );
+            for( u32 j = 0; j < 3; ++j )
+                for( u32 i = 0; i < 3; ++i )
+                    m[j][i] = m[j][i] * r;
+            return scale;
+        }
+
+        //
+        // Rotates the symmetric matrix s in the p, q plane so that s[p][q]
+        // becomes zero, and applies the same rotation to the columns of v.
+        // This is the rotation from "Numerical Recipes" 11.1, with the tangent
+        // t = two_o / h. The cosine and sine are written in terms of a single
+        // reciprocal square root, and |d| is kept away from zero so that there
+        // is no rotation rather than a NaN when o is zero.
+        //
+        template <u32 p, u32 q, typename T>
+        void JacobiRotate( T (&s)[3][3], T (&v)[3][3] )
+        {
+            using Scalar = typename lane_traits<T>::scalar_type;
+            const u32 r = 3 - p - q;
+
+            const Scalar epsilon = std::numeric_limits<Scalar>::epsilon();
+            const T o = s[p][q];
+            const T d = s[q][q] - s[p][p];
+            const T ad = Max( T( epsilon * epsilon ), Abs( d ) );
+            const T root = Sqrt( ad * ad + T( Scalar{4} ) * o * o );
+            const T h = ad + root;
+            const T two_o = CopySign( T( Scalar{2} ), d ) * o;
+            const T to = two_o * o / h;
+            const T k = T( Scalar{1} ) / Sqrt( T( Scalar{2} ) * h * root );
+            const T c = h * k;
+            const T sn = two_o * k;
+
+            s[p][p] = Flush( s[p][p] - to );
+            s[q][q] = Flush( s[q][q] + to );
+            s[p][q] = s[q][p] = T( Scalar{0} );
+
+            const T rp = s[r][p];
+            const T rq = s[r][q];
+            s[r][p] = s[p][r] = Flush( c * rp - sn * rq );
+            s[r][q] = s[q][r] = Flush( sn * rp + c * rq );
+
+            for( u32 i = 0; i < 3; ++i )
+            {
+                const T vp = v[p][i];
+                const T vq = v[q][i];
+                v[p][i] = Flush( c * vp - sn * vq );
+                v[q][i] = Flush( sn * vp + c * vq );
+            }
+        }
+
+        //
+        // Diagonalizes the symmetric matrix s with a fixed number of cyclic
+        // Jacobi sweeps, v is set to the product of the rotations. The
+        // convergence is quadratic, four sweeps are enough for doubles.
+        //
+        template <typename T>
+        void Jacobi( T (&s)[3][3], T (&v)[3][3] )
+        {
+            using Scalar = typename lane_traits<T>::scalar_type;
+            const u32 sweeps = 4;
+
+            for( u32 j = 0; j < 3; ++j )
+                for( u32 i = 0; i < 3; ++i )
+                {
+                    s[j][i] = Flush( s[j][i] );
+                    v[j][i] = T( i == j ? Scalar{1} : Scalar{0} );
+                }
+
+            for( u32 n = 0; n < sweeps; ++n )
+            {
+                JacobiRotate<0, 1>( s, v );
+                JacobiRotate<0, 2>( s, v );
+                JacobiRotate<1, 2>( s, v );
+            }
+        }
+
+        //
+        // Swaps columns i and j of m where swap is set, and negates the new
+        // column j so that the determinant of m is unchanged
+        //
+        template <u32 i, u32 j, typename T, typename Mask>
+        void SwapColumns( Mask swap, T (&m)[3][3] )
+        {
+            for( u32 k = 0; k < 3; ++k )
+            {
+                const T mi = m[i][k];
+                const T mj = m[j][k];
+                m[i][k] = Select( swap, mj, mi );
+                m[j][k] = Select( swap, T( -mi ), mj );
+            }
+        }
+
+        //
+        // Swaps keys i and j, and those columns of a and b, if key i is less
+        // than key j. Applied to each pair this sorts the keys in descending
+        // order. a and b may be the same.
+        //
+        template <u32 i, u32 j, typename T>
+        void SortPair( T (&keys)[3], T (&a)[3][3], T (&b)[3][3] )
+        {
+            const auto swap = Less( keys[i], keys[j] );
+            const T t = keys[i];
+            keys[i] = Select( swap, keys[j], t );
+            keys[j] = Select( swap, t, keys[j] );
+            SwapColumns<i, j>( swap, a );
+            if( &a != &b )
+                SwapColumns<i, j>( swap, b );
+        }
+
+        //
+        // The eigenvalues of the symmetric matrix s in descending order, and
+        // the corresponding eigenvectors as the columns of a rotation matrix
+        //
+        template <typename T>
+        void EigenSymmetric( T (&s)[3][3], T (&values)[3], T (&vectors)[3][3] )
+        {
+            const T scale = Scale( s );
+            Jacobi( s, vectors );
+            for( u32 i = 0; i < 3; ++i )
+                values[i] = s[i][i] * scale;
+
+            SortPair<0, 1>( values, vectors, vectors );
+            SortPair<0, 2>( values, vectors, vectors );
+            SortPair<1, 2>( values, vectors, vectors );
+        }
+
+        //
+        // Rotates rows j and i of b so that b[j][i] becomes zero, and applies
+        // the inverse rotation to the columns of u so that u * b is unchanged.
+        // The rotation is skipped when column j is too small for its square to
+        // be a normal number.
+        //
+        template <u32 j, u32 i, typename T>
+        void Givens( T (&b)[3][3], T (&u)[3][3] )
+        {
+            using Scalar = typename lane_traits<T>::scalar_type;
+            const T x = b[j][j];
+            const T y = b[j][i];
+            const T r = Sqrt( x * x + y * y );
+            const auto rotate =
+                Less( T( std::sqrt( std::numeric_limits<Scalar>::min() ) ), r );
+            const T inverse = T( Scalar{1} ) /
+                              Select( rotate, r, T( Scalar{1} ) );
+            const T c = Select( rotate, x * inverse, T( Scalar{1} ) );
+            const T sn = Select( rotate, y * inverse, T( Scalar{0} ) );
+
+            for( u32 k = 0; k < 3; ++k )
+            {
+                const T bj = b[k][j];
+                const T bi = b[k][i];
+                b[k][j] = Flush( c * bj + sn * bi );
+                b[k][i] = Flush( c * bi - sn * bj );
+
+                const T uj = u[j][k];
+                const T ui = u[i][k];
+                u[j][k] = Flush( c * uj + sn * ui );
+                u[i][k] = Flush( c * ui - sn * uj );
+            }
+        }
+
+        //
+        // a = u * diag( values ) * transpose( v ) following "Computing the
+        // Singular Value Decomposition of 3x3 matrices with minimal branching
+        // and elementary floating point operations" by McAdams et al. The
+        // eigenvectors of transpose( a ) * a give v, the columns of a * v are
+        // sorted by length and a QR factorization of that gives u and the
+        // values. u and v are rotations, so the last value is negative when
+        // the determinant of a is. a is overwritten.
+        //
+        template <typename T>
+        void SVD( T (&a)[3][3], T (&u)[3][3], T (&values)[3], T (&v)[3][3] )
+        {
+            using Scalar = typename lane_traits<T>::scalar_type;
+            const T scale = Scale( a );
+
+            T s[3][3];
+            for( u32 j = 0; j < 3; ++j )
+                for( u32 i = 0; i < 3; ++i )
+                    s[j][i] = a[i][0] * a[j][0] + a[i][1] * a[j][1] +
+                              a[i][2] * a[j][2];
+            Jacobi( s, v );
+
+            T b[3][3];
+            for( u32 j = 0; j < 3; ++j )
+                for( u32 i = 0; i < 3; ++i )
+                    b[j][i] = Flush( a[0][i] * v[j][0] + a[1][i] * v[j][1] +
+                                     a[2][i] * v[j][2] );
+
+            T lengths[3];
+            for( u32 j = 0; j < 3; ++j )
+                lengths[j] = b[j][0] * b[j][0] + b[j][1] * b[j][1] +
+                             b[j][2] * b[j][2];
+
+            SortPair<0, 1>( lengths, b, v );
+            SortPair<0, 2>( lengths, b, v );
+            SortPair<1, 2>( lengths, b, v );
+
+            for( u32 j = 0; j < 3; ++j )
+                for( u32 i = 0; i < 3; ++i )
+                    u[j][i] = T( i == j ? Scalar{1} : Scalar{0} );
+            Givens<0, 1>( b, u );
+            Givens<0, 2>( b, u );
+            Givens<1, 2>( b, u );
+
+            for( u32 i = 0; i < 3; ++i )
+                values[i] = b[i][i] * scale;
+        }
+
+        template <typename T>
+        inline T Dot( const T (&a)[3], const T (&b)[3] )
+        {
+            return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+        }
+
+        template <typename T>
+        inline void Normalize( T (&c)[3] )
+        {
+            using Scalar = typename lane_traits<T>::scalar_type;
+            const T r = T( Scalar{1} ) / Sqrt( Dot( c, c ) );
+            c[0] = c[0] * r;
+            c[1] = c[1] * r;
+            c[2] = c[2] * r;
+        }
+
+        //
+        // Removes the component of c along the unit vector u
+        //
+        template <typename T>
+        inline void Reject( T (&c)[3], const T (&u)[3] )
+        {
+            const T d = Dot( c, u );
+            c[0] = c[0] - d * u[0];
+            c[1] = c[1] - d * u[1];
+            c[2] = c[2] - d * u[2];
+        }
+
+        //
+        // Modified Gram-Schmidt, each column is made orthogonal to the
+        // already normalized ones before it
+        //
+        template <typename T>
+        inline void Orthonormalize( T (&m)[3][3] )
+        {
+            Normalize( m[0] );
+            Reject( m[1], m[0] );
+            Normalize( m[1] );
+            Reject( m[2], m[0] );
+            Reject( m[2], m[1] );
+            Normalize( m[2] );
+        }
+
+        //
+        // Orthonormalizes the upper 3x3 of m into out, the columns are
+        // spelled out so that they can stay in registers
+        //
+        template <typename Scalar, u32 Size>
+        inline void Orthonormalize( const Matrix<Scalar, Size, Size>& m,
+                                    Matrix<Scalar, Size, Size>& out )
+        {
+            Scalar a[3][3] = {
+                { m.m_elements[0][0], m.m_elements[0][1], m.m_elements[0][2] },
+                { m.m_elements[1][0], m.m_elements[1][1], m.m_elements[1][2] },
+                { m.m_elements[2][0], m.m_elements[2][1], m.m_elements[2][2] } };
+
+            Orthonormalize( a );
+
+            for( u32 j = 0; j < 3; ++j )
+            {
+                out.m_elements[j][0] = a[j][0];
+                out.m_elements[j][1] = a[j][1];
+                out.m_elements[j][2] = a[j][2];
+            }
+        }
+
+        //
+        // The orthogonal factor of m by Newton's iteration
+        // x <- ( g * x + inverse( transpose( g * x ) ) ) / 2, with the scale g
+        // from "Computing the Polar Decomposition - with Applications" by
+        // Higham. The inverse transpose is the matrix of cofactors divided by
+        // the determinant. The convergence is quadratic once the singular
+        // values are near one, and the scaling gets them there quickly, so a
+        // fixed number of iterations is enough for all but nearly singular m.
+        //
+        template <typename T>
+        void Polar( const T (&m)[3][3], T (&rotation)[3][3],
+                    T (&stretch)[3][3] )
+        {
+            using Scalar = typename lane_traits<T>::scalar_type;
+            const u32 iterations = sizeof(Scalar) > sizeof(float) ? 7 : 5;
+
+            T (&x)[3][3] = rotation;
+            for( u32 j = 0; j < 3; ++j )
+                for( u32 i = 0; i < 3; ++i )
+                    x[j][i] = m[j][i];
+            Scale( x );
+
+            for( u32 n = 0; n < iterations; ++n )
+            {
+                T c[3][3];
+                for( u32 j = 0; j < 3; ++j )
+                    for( u32 i = 0; i < 3; ++i )
+                    {
+                        const u32 j1 = ( j + 1 ) % 3;
+                        const u32 j2 = ( j + 2 ) % 3;
+                        const u32 i1 = ( i + 1 ) % 3;
+                        const u32 i2 = ( i + 2 ) % 3;
+                        c[j][i] = x[j1][i1] * x[j2][i2] -
+                                  x[j2][i1] * x[j1][i2];
+                    }
+                const T det = Dot( x[0], c[0] );
+                const T x2 = Dot( x[0], x[0] ) + Dot( x[1], x[1] ) +
+                             Dot( x[2], x[2] );
+                const T c2 = Dot( c[0], c[0] ) + Dot( c[1], c[1] ) +
+                             Dot( c[2], c[2] );
+
+                //
+                // g is the square root of the ratio of the Frobenius norms of
+                // the inverse and x
+                //
+                const T g = Sqrt( Sqrt( c2 / ( det * det * x2 ) ) );
+                const T a = g * T( Scalar{0.5} );
+                const T b = T( Scalar{0.5} ) / ( g * det );
+                for( u32 j = 0; j < 3; ++j )
+                    for( u32 i = 0; i < 3; ++i )
+                        x[j][i] = a * x[j][i] + b * c[j][i];
+            }
+
+            //
+            // stretch = transpose( rotation ) * m, made exactly symmetric
+            //
+            for( u32 j = 0; j < 3; ++j )
+                for( u32 i = 0; i < 3; ++i )
+                    stretch[j][i] = Dot( rotation[i], m[j] );
+            for( u32 j = 0; j < 3; ++j )
+                for( u32 i = 0; i < j; ++i )
+                    stretch[j][i] = stretch[i][j] =
+                      ( stretch[j][i] + stretch[i][j] ) * T( Scalar{0.5} );
+        }
+    }
+
     ////////////////////////////////////////////////////////////////////////////
     // Template metaprogramming gubbins
     ////////////////////////////////////////////////////////////////////////////
 
     template<size_t... Indexes> struct index_tuple {};
 
-    template<typename T, size_t Size> struct index_tuple_helper;
+    template<typename T, typename U> struct index_tuple_concat;
 
-    template<size_t... Indexes, size_t Size>
-    struct index_tuple_helper<index_tuple<Indexes...>, Size>
+    template<size_t... IndexesA, size_t... IndexesB>
+    struct index_tuple_concat<index_tuple<IndexesA...>,
+                              index_tuple<IndexesB...>>
     {
-       using type = index_tuple<Indexes..., Size>;
+       using type =
+            index_tuple<IndexesA..., sizeof...(IndexesA) + IndexesB...>;
     };
 
+    //
+    // This splits the range in half so that the instantiation depth is
+    // logarithmic in Size
+    //
     template<size_t Size> struct make_index_tuple
     {
        using type =
-        typename index_tuple_helper<
-            typename make_index_tuple<Size-1>::type, Size-1>::type;
+        typename index_tuple_concat<
+            typename make_index_tuple<Size/2>::type,
+            typename make_index_tuple<Size - Size/2>::type>::type;
     };
 
     template<>
@@ -343,6 +1015,316 @@ namespace detail
        using type = index_tuple<>;
     };
 
+    template<>
+    struct make_index_tuple<1>
+    {
+       using type = index_tuple<0>;
+    };
+
+    template<size_t Size>
+    using make_indices = typename make_index_tuple<Size>::type;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Unrolled loops
+    //
+    // These are the loops over the elements of a matrix written as pack
+    // expansions over make_indices, so that they're unrolled whatever the
+    // optimization level. The elements of an initializer list are evaluated
+    // in order, so the elements are visited in the same order as they would
+    // be by a loop.
+    ////////////////////////////////////////////////////////////////////////////
+
+    using swallow = int[];
+
+    template <typename Scalar, u32 Rows, u32 Columns, typename Scalar2,
+              size_t... I>
+    void Set( Matrix<Scalar, Rows, Columns>& m, const Scalar2 s,
+              index_tuple<I...> )
+    {
+        Scalar* e = m.m_elements[0].data();
+        (void)swallow{ 0, ( e[I] = s, 0 )... };
+    }
+
+    //
+    // Copies from a matrix, starting at element Offset in m
+    //
+    template <size_t Offset = 0, typename Scalar, u32 Rows, u32 Columns,
+              typename Scalar2, u32 Rows2, u32 Columns2, size_t... I>
+    void Copy( Matrix<Scalar, Rows, Columns>& m,
+               const Matrix<Scalar2, Rows2, Columns2>& m2,
+               index_tuple<I...> )
+    {
+        Scalar*        e  = m.m_elements[0].data();
+        const Scalar2* e2 = m2.m_elements[0].data();
+        (void)swallow{ 0, ( e[Offset+I] = e2[I], 0 )... };
+    }
+
+    //
+    // Copies from anything with operator [], arrays and expressions
+    //
+    template <typename Scalar, u32 Rows, u32 Columns, typename Source,
+              size_t... I>
+    void CopyIndexed( Matrix<Scalar, Rows, Columns>& m, const Source& source,
+                      index_tuple<I...> )
+    {
+        Scalar* e = m.m_elements[0].data();
+        (void)swallow{ 0, ( e[I] = source[I], 0 )... };
+    }
+
+    template <typename Scalar, u32 Rows, u32 Columns, size_t... I>
+    Matrix<Scalar, Rows, Columns> NegateElements(
+                                         const Matrix<Scalar, Rows, Columns>& m,
+                                         index_tuple<I...> )
+    {
+        Matrix<Scalar, Rows, Columns> ret;
+        Scalar*       r = ret.m_elements[0].data();
+        const Scalar* e = m.m_elements[0].data();
+        (void)swallow{ 0, ( r[I] = -e[I], 0 )... };
+        return ret;
+    }
+
+    template <typename Scalar, u32 Rows, u32 Columns,
+              typename Scalar2, size_t... I>
+    bool Equal( const Matrix<Scalar, Rows, Columns>& m1,
+                const Matrix<Scalar2, Rows, Columns>& m2,
+                index_tuple<I...> )
+    {
+        const Scalar*  e1 = m1.m_elements[0].data();
+        const Scalar2* e2 = m2.m_elements[0].data();
+        bool ret = true;
+        (void)swallow{ 0, ( ret = ret && e1[I] == e2[I], 0 )... };
+        return ret;
+    }
+
+    //
+    // Element wise assignment operators with a scalar or with a matrix
+    //
+
+    template <typename Scalar, u32 Rows, u32 Columns, typename Scalar2,
+              size_t... I>
+    void AddAssign( Matrix<Scalar, Rows, Columns>& m, const Scalar2 s,
+                    index_tuple<I...> )
+    {
+        Scalar* e = m.m_elements[0].data();
+        (void)swallow{ 0, ( e[I] += s, 0 )... };
+    }
+
+    template <typename Scalar, u32 Rows, u32 Columns, typename Scalar2,
+              size_t... I>
+    void AddAssign( Matrix<Scalar, Rows, Columns>& m,
+                    const Matrix<Scalar2, Rows, Columns>& m2,
+                    index_tuple<I...> )
+    {
+        Scalar*        e  = m.m_elements[0].data();
+        const Scalar2* e2 = m2.m_elements[0].data();
+        (void)swallow{ 0, ( e[I] += e2[I], 0 )... };
+    }
+
+    template <typename Scalar, u32 Rows, u32 Columns, typename Scalar2,
+              size_t... I>
+    void SubtractAssign( Matrix<Scalar, Rows, Columns>& m, const Scalar2 s,
+                         index_tuple<I...> )
+    {
+        Scalar* e = m.m_elements[0].data();
+        (void)swallow{ 0, ( e[I] -= s, 0 )... };
+    }
+
+    template <typename Scalar, u32 Rows, u32 Columns, typename Scalar2,
+              size_t... I>
+    void SubtractAssign( Matrix<Scalar, Rows, Columns>& m,
+                         const Matrix<Scalar2, Rows, Columns>& m2,
+                         index_tuple<I...> )
+    {
+        Scalar*        e  = m.m_elements[0].data();
+        const Scalar2* e2 = m2.m_elements[0].data();
+        (void)swallow{ 0, ( e[I] -= e2[I], 0 )... };
+    }
+
+    template <typename Scalar, u32 Rows, u32 Columns, typename Scalar2,
+              size_t... I>
+    void MultiplyAssign( Matrix<Scalar, Rows, Columns>& m, const Scalar2 s,
+                         index_tuple<I...> )
+    {
+        Scalar* e = m.m_elements[0].data();
+        (void)swallow{ 0, ( e[I] *= s, 0 )... };
+    }
+
+    template <typename Scalar, u32 Rows, u32 Columns, typename Scalar2,
+              size_t... I>
+    void MultiplyAssign( Matrix<Scalar, Rows, Columns>& m,
+                         const Matrix<Scalar2, Rows, Columns>& m2,
+                         index_tuple<I...> )
+    {
+        Scalar*        e  = m.m_elements[0].data();
+        const Scalar2* e2 = m2.m_elements[0].data();
+        (void)swallow{ 0, ( e[I] *= e2[I], 0 )... };
+    }
+
+    template <typename Scalar, u32 Rows, u32 Columns, typename Scalar2,
+              size_t... I>
+    void DivideAssign( Matrix<Scalar, Rows, Columns>& m,
+                       const Matrix<Scalar2, Rows, Columns>& m2,
+                       index_tuple<I...> )
+    {
+        Scalar*        e  = m.m_elements[0].data();
+        const Scalar2* e2 = m2.m_elements[0].data();
+        (void)swallow{ 0, ( e[I] /= e2[I], 0 )... };
+    }
+
+    //
+    // Element wise binary operators with a scalar or with a matrix
+    //
+
+    template <typename ReturnScalar, typename Scalar, u32 Rows, u32 Columns,
+              typename Scalar2, size_t... I>
+    Matrix<ReturnScalar, Rows, Columns> AddElements(
+                                         const Matrix<Scalar, Rows, Columns>& m,
+                                         const Scalar2 s,
+                                         index_tuple<I...> )
+    {
+        Matrix<ReturnScalar, Rows, Columns> ret;
+        ReturnScalar* r = ret.m_elements[0].data();
+        const Scalar* e = m.m_elements[0].data();
+        (void)swallow{ 0, ( r[I] = e[I] + s, 0 )... };
+        return ret;
+    }
+
+    template <typename ReturnScalar, typename Scalar, u32 Rows, u32 Columns,
+              typename Scalar2, size_t... I>
+    Matrix<ReturnScalar, Rows, Columns> AddElements(
+                                     const Matrix<Scalar, Rows, Columns>& m1,
+                                     const Matrix<Scalar2, Rows, Columns>& m2,
+                                     index_tuple<I...> )
+    {
+        Matrix<ReturnScalar, Rows, Columns> ret;
+        ReturnScalar*  r  = ret.m_elements[0].data();
+        const Scalar*  e1 = m1.m_elements[0].data();
+        const Scalar2* e2 = m2.m_elements[0].data();
+        (void)swallow{ 0, ( r[I] = e1[I] + e2[I], 0 )... };
+        return ret;
+    }
+
+    template <typename ReturnScalar, typename Scalar, u32 Rows, u32 Columns,
+              typename Scalar2, size_t... I>
+    Matrix<ReturnScalar, Rows, Columns> SubtractElements(
+                                         const Matrix<Scalar, Rows, Columns>& m,
+                                         const Scalar2 s,
+                                         index_tuple<I...> )
+    {
+        Matrix<ReturnScalar, Rows, Columns> ret;
+        ReturnScalar* r = ret.m_elements[0].data();
+        const Scalar* e = m.m_elements[0].data();
+        (void)swallow{ 0, ( r[I] = e[I] - s, 0 )... };
+        return ret;
+    }
+
+    template <typename ReturnScalar, typename Scalar, u32 Rows, u32 Columns,
+              typename Scalar2, size_t... I>
+    Matrix<ReturnScalar, Rows, Columns> SubtractElements(
+                                     const Matrix<Scalar, Rows, Columns>& m1,
+                                     const Matrix<Scalar2, Rows, Columns>& m2,
+                                     index_tuple<I...> )
+    {
+        Matrix<ReturnScalar, Rows, Columns> ret;
+        ReturnScalar*  r  = ret.m_elements[0].data();
+        const Scalar*  e1 = m1.m_elements[0].data();
+        const Scalar2* e2 = m2.m_elements[0].data();
+        (void)swallow{ 0, ( r[I] = e1[I] - e2[I], 0 )... };
+        return ret;
+    }
+
+    template <typename ReturnScalar, typename Scalar, u32 Rows, u32 Columns,
+              typename Scalar2, size_t... I>
+    Matrix<ReturnScalar, Rows, Columns> MultiplyElements(
+                                         const Matrix<Scalar, Rows, Columns>& m,
+                                         const Scalar2 s,
+                                         index_tuple<I...> )
+    {
+        Matrix<ReturnScalar, Rows, Columns> ret;
+        ReturnScalar* r = ret.m_elements[0].data();
+        const Scalar* e = m.m_elements[0].data();
+        (void)swallow{ 0, ( r[I] = e[I] * s, 0 )... };
+        return ret;
+    }
+
+    template <typename ReturnScalar, typename Scalar, u32 Rows, u32 Columns,
+              typename Scalar2, size_t... I>
+    Matrix<ReturnScalar, Rows, Columns> MultiplyElements(
+                                     const Matrix<Scalar, Rows, Columns>& m1,
+                                     const Matrix<Scalar2, Rows, Columns>& m2,
+                                     index_tuple<I...> )
+    {
+        Matrix<ReturnScalar, Rows, Columns> ret;
+        ReturnScalar*  r  = ret.m_elements[0].data();
+        const Scalar*  e1 = m1.m_elements[0].data();
+        const Scalar2* e2 = m2.m_elements[0].data();
+        (void)swallow{ 0, ( r[I] = e1[I] * e2[I], 0 )... };
+        return ret;
+    }
+
+    template <typename ReturnScalar, typename Scalar, u32 Rows, u32 Columns,
+              typename Scalar2, size_t... I>
+    Matrix<ReturnScalar, Rows, Columns> DivideElements(
+                                     const Matrix<Scalar, Rows, Columns>& m1,
+                                     const Matrix<Scalar2, Rows, Columns>& m2,
+                                     index_tuple<I...> )
+    {
+        Matrix<ReturnScalar, Rows, Columns> ret;
+        ReturnScalar*  r  = ret.m_elements[0].data();
+        const Scalar*  e1 = m1.m_elements[0].data();
+        const Scalar2* e2 = m2.m_elements[0].data();
+        (void)swallow{ 0, ( r[I] = e1[I] / e2[I], 0 )... };
+        return ret;
+    }
+
+    //
+    // One term of the product for every index, the indices go through the
+    // columns of ret, then the rows, then the sum, which is the order of the
+    // triple loop
+    //
+    template <typename ReturnScalar, typename Scalar, u32 Rows, u32 Columns,
+              typename Scalar2, u32 Columns2, size_t... I>
+    Matrix<ReturnScalar, Rows, Columns2> Mul(
+                                   const Matrix<Scalar, Rows, Columns>& m1,
+                                   const Matrix<Scalar2, Columns, Columns2>& m2,
+                                   index_tuple<I...> )
+    {
+        Matrix<ReturnScalar, Rows, Columns2> ret( ReturnScalar{0} );
+        ReturnScalar*  r  = ret.m_elements[0].data();
+        const Scalar*  e1 = m1.m_elements[0].data();
+        const Scalar2* e2 = m2.m_elements[0].data();
+        (void)swallow{ 0, ( r[I / Columns] +=
+                                e1[I % Columns * Rows + I / Columns % Rows] *
+                                e2[I / Columns / Rows * Columns + I % Columns],
+                            0 )... };
+        return ret;
+    }
+
+    template <typename Scalar, u32 Rows, u32 Columns, size_t... I>
+    Matrix<Scalar, Columns, Rows> Transposed(
+                                        const Matrix<Scalar, Rows, Columns>& m,
+                                        index_tuple<I...> )
+    {
+        Matrix<Scalar, Columns, Rows> ret;
+        Scalar*       r = ret.m_elements[0].data();
+        const Scalar* e = m.m_elements[0].data();
+        (void)swallow{ 0, ( r[I % Rows * Columns + I / Rows] = e[I], 0 )... };
+        return ret;
+    }
+
+    template <typename ReturnScalar, typename Scalar, u32 Rows, u32 Columns,
+              typename Scalar2, size_t... I>
+    ReturnScalar Dot( const Matrix<Scalar, Rows, Columns>& m0,
+                      const Matrix<Scalar2, Rows, Columns>& m1,
+                      index_tuple<I...> )
+    {
+        const Scalar*  e0 = m0.m_elements[0].data();
+        const Scalar2* e1 = m1.m_elements[0].data();
+        ReturnScalar ret{0};
+        (void)swallow{ 0, ( ret += e0[I] * e1[I], 0 )... };
+        return ret;
+    }
+
     template< typename Scalar, std::size_t A, std::size_t B,
               std::size_t... IndicesA, template <std::size_t...> class T,
               std::size_t... IndicesB, template <std::size_t...> class V>
@@ -377,7 +1359,7 @@ namespace detail
     };
 
     template<typename Scalar, std::size_t N>
-    constexpr std::array<Scalar, 0> Concatenate(
+    constexpr std::array<Scalar, N> Concatenate(
                                                 const std::array<Scalar, N>& a )
     {
         return a;
@@ -406,20 +1388,30 @@ namespace detail
         return Concatenate( first, Concatenate( second, third, rest... ) );
     }
 
-    template<typename Scalar, u32 Rows, u32 Columns>
-    constexpr std::array<Scalar, Rows*Columns> Expand(
+    template<typename Target, typename Scalar, u32 Rows, u32 Columns,
+             std::size_t... I>
+    constexpr std::array<Target, Rows*Columns> Expander(
+                                        const Matrix<Scalar, Rows, Columns>& m,
+                                        index_tuple<I...> )
+    {
+        return std::array<Target, Rows*Columns>{{
+                        Target( m.m_elements[I / Rows][I % Rows] )... }};
+    }
+
+    //
+    // The elements of a matrix, or a scalar, as an array of Targets
+    //
+    template<typename Target, typename Scalar, u32 Rows, u32 Columns>
+    constexpr std::array<Target, Rows*Columns> Expand(
                                         const Matrix<Scalar, Rows, Columns>& m )
     {
-        static_assert( is_vector<Matrix<Scalar, Rows, Columns>>::value,
-                       "Can only expand vectors" );
-        return *reinterpret_cast<const std::array<Scalar, Rows*Columns>*>(
-                                                          &m.m_elements[0][0] );
+        return Expander<Target>( m, make_indices<Rows*Columns>{} );
     }
 
-    template<typename Scalar>
-    constexpr std::array<Scalar, 1> Expand( Scalar s )
+    template<typename Target, typename Scalar>
+    constexpr std::array<Target, 1> Expand( const Scalar& s )
     {
-        return {{s}};
+        return {{ Target( s ) }};
     }
 
     template< u32 N, typename Scalar, std::size_t A,
@@ -475,8 +1467,7 @@ namespace detail
     void Fill( Matrix<Scalar, Rows, Columns>& m,
                Matrix<Scalar2, Rows2, Columns2> first, Rest... rest )
     {
-        for( u32 i = 0; i < Rows2 * Columns2; ++i )
-            m.m_elements[0][Index+i] = first.m_elements[0][i];
+        Copy<Index>( m, first, make_indices<Rows2*Columns2>{} );
         Fill<Index+Rows2*Columns2>( m, rest... );
     }
 
@@ -488,8 +1479,297 @@ namespace detail
         Fill<Index+1>( m, rest... );
     }
 
+    ////////////////////////////////////////////////////////////////////////////
+    // Constant expressions
+    //
+    // A C++11 constexpr function can't modify anything, so these build all
+    // the elements of their result in a single initializer list. They give
+    // the same results as the unrolled loops above, and the constexpr
+    // functions only use them when JOEMATH_CONSTANT_EVALUATED is true because
+    // they're much slower in debug builds.
+    ////////////////////////////////////////////////////////////////////////////
+
+    namespace constant
+    {
+        template <typename Scalar, u32 Rows, u32 Columns>
+        using Elements = std::array<std::array<Scalar, Rows>, Columns>;
+
+        //
+        // Element i in column major order. The columns are contiguous, but
+        // indexing past the end of one isn't allowed in a constant expression
+        //
+        template <typename Scalar, u32 Rows, u32 Columns>
+        constexpr const Scalar& Get( const Matrix<Scalar, Rows, Columns>& m,
+                                     std::size_t i )
+        {
+            return m.m_elements[i / Rows][i % Rows];
+        }
+
+        template <typename Scalar, std::size_t N>
+        constexpr const Scalar& Get( const std::array<Scalar, N>& a,
+                                     std::size_t i )
+        {
+            return a[i];
+        }
+
+        //
+        // A scalar has the same value at every index
+        //
+        template <typename Scalar>
+        constexpr const Scalar& Get( const Scalar& s, std::size_t )
+        {
+            return s;
+        }
+
+        template <typename Scalar, u32 Rows, u32 Columns, typename... Values>
+        constexpr Elements<Scalar, Rows, Columns> MakeElements(
+                                                      const Values&... values )
+        {
+            return {{ Scalar( values )... }};
+        }
+
+        template <typename Scalar, u32 Rows, u32 Columns, typename Source,
+                  std::size_t... I>
+        constexpr Elements<Scalar, Rows, Columns> ElementsOf(
+                                                         const Source& source,
+                                                         index_tuple<I...> )
+        {
+            return {{ Scalar( Get( source, I ) )... }};
+        }
+
+        constexpr bool All( )
+        {
+            return true;
+        }
+
+        template <typename... Rest>
+        constexpr bool All( bool first, Rest... rest )
+        {
+            return first && All( rest... );
+        }
+
+        //
+        // This adds from left to right, like the loops do
+        //
+        template <typename Scalar>
+        constexpr Scalar Sum( const Scalar& s )
+        {
+            return s;
+        }
+
+        template <typename Scalar, typename... Rest>
+        constexpr Scalar Sum( const Scalar& s0, const Scalar& s1,
+                              const Rest&... rest )
+        {
+            return Sum( Scalar( s0 + s1 ), rest... );
+        }
+
+        template <typename ReturnScalar, u32 Rows, u32 Columns, typename A,
+                  typename Op, std::size_t... I>
+        constexpr Matrix<ReturnScalar, Rows, Columns> Map( const A& a, Op op,
+                                                          index_tuple<I...> )
+        {
+            return Matrix<ReturnScalar, Rows, Columns>(
+                                         ReturnScalar( op( Get( a, I ) ) )... );
+        }
+
+        template <typename ReturnScalar, u32 Rows, u32 Columns, typename A,
+                  typename B, typename Op, std::size_t... I>
+        constexpr Matrix<ReturnScalar, Rows, Columns> Map( const A& a,
+                                                          const B& b,
+                                                          Op op,
+                                                          index_tuple<I...> )
+        {
+            return Matrix<ReturnScalar, Rows, Columns>(
+                           ReturnScalar( op( Get( a, I ), Get( b, I ) ) )... );
+        }
+
+        template <typename Scalar, u32 Rows, u32 Columns,
+                  typename Scalar2, std::size_t... I>
+        constexpr bool Equal( const Matrix<Scalar, Rows, Columns>& m1,
+                              const Matrix<Scalar2, Rows, Columns>& m2,
+                              index_tuple<I...> )
+        {
+            return All( Get( m1, I ) == Get( m2, I )... );
+        }
+
+        template <typename ReturnScalar, typename A, typename B,
+                  std::size_t... I>
+        constexpr ReturnScalar Dot( const A& a, const B& b,
+                                    index_tuple<I...> )
+        {
+            return Sum( ReturnScalar{0},
+                        ReturnScalar( Get( a, I ) * Get( b, I ) )... );
+        }
+
+        //
+        // The element of m1 * m2 in row and column
+        //
+        template <typename ReturnScalar, typename A, typename B,
+                  std::size_t... K>
+        constexpr ReturnScalar Product( const A& m1, const B& m2,
+                                        std::size_t row, std::size_t column,
+                                        index_tuple<K...> )
+        {
+            return Sum( ReturnScalar{0},
+                        ReturnScalar( m1.m_elements[K][row] *
+                                      m2.m_elements[column][K] )... );
+        }
+
+        template <typename ReturnScalar, typename Scalar, u32 Rows,
+                  u32 Columns, typename Scalar2, u32 Columns2, size_t... I>
+        constexpr Matrix<ReturnScalar, Rows, Columns2> Mul(
+                                   const Matrix<Scalar, Rows, Columns>& m1,
+                                   const Matrix<Scalar2, Columns, Columns2>& m2,
+                                   index_tuple<I...> )
+        {
+            return Matrix<ReturnScalar, Rows, Columns2>(
+                          Product<ReturnScalar>( m1, m2, I % Rows, I / Rows,
+                                                 make_indices<Columns>{} )... );
+        }
+
+        template <typename Scalar, u32 Rows, u32 Columns, size_t... I>
+        constexpr Matrix<Scalar, Columns, Rows> Transposed(
+                                        const Matrix<Scalar, Rows, Columns>& m,
+                                        index_tuple<I...> )
+        {
+            return Matrix<Scalar, Columns, Rows>(
+                                   m.m_elements[I % Columns][I / Columns]... );
+        }
+
+        template <u32 Rows2, u32 Columns2, u32 i, u32 j,
+                  typename Scalar, u32 Rows, u32 Columns, size_t... I>
+        constexpr Matrix<Scalar, Rows2, Columns2> SubMatrix(
+                                        const Matrix<Scalar, Rows, Columns>& m,
+                                        index_tuple<I...> )
+        {
+            return Matrix<Scalar, Rows2, Columns2>(
+                              m.m_elements[I / Rows2 + i][I % Rows2 + j]... );
+        }
+
+        template <typename Scalar, u32 Rows, u32 Columns, size_t... I>
+        constexpr Matrix<Scalar, 1, Columns> Row(
+                                        const Matrix<Scalar, Rows, Columns>& m,
+                                        u32 row,
+                                        index_tuple<I...> )
+        {
+            return Matrix<Scalar, 1, Columns>( m.m_elements[I][row]... );
+        }
+
+        template <typename ReturnScalar, u32 Rows, u32 Columns,
+                  typename A, typename B, size_t... I>
+        constexpr Matrix<ReturnScalar, Rows, Columns> Outer( const A& m0,
+                                                            const B& m1,
+                                                            index_tuple<I...> )
+        {
+            return Matrix<ReturnScalar, Rows, Columns>(
+                 ReturnScalar( Get( m0, I % Rows ) * Get( m1, I / Rows ) )... );
+        }
+
+        template <typename Scalar, u32 Size, size_t... I>
+        constexpr Matrix<Scalar, Size, Size> Identity( index_tuple<I...> )
+        {
+            return Matrix<Scalar, Size, Size>(
+                    ( I % ( Size + 1 ) == 0 ? Scalar(1) : Scalar(0) )... );
+        }
+
+        template <typename Scalar, u32 Size, size_t... I>
+        constexpr Matrix<Scalar, Size, Size> Scale(
+                                                const Vector<Scalar, Size>& s,
+                                                index_tuple<I...> )
+        {
+            return Matrix<Scalar, Size, Size>(
+                              ( I % ( Size + 1 ) == 0 ?
+                                    Get( s, I / ( Size + 1 ) ) :
+                                    Scalar(0) )... );
+        }
+
+        //
+        // The identity with position in the last column
+        //
+        template <typename Scalar, u32 Size, size_t... I>
+        constexpr Matrix<Scalar, Size, Size> Translate(
+                                         const Vector<Scalar, Size>& position,
+                                         index_tuple<I...> )
+        {
+            return Matrix<Scalar, Size, Size>(
+                              ( I / Size == Size - 1 ?
+                                    Get( position, I % Size ) :
+                                    I / Size == I % Size ?
+                                        Scalar(1) :
+                                        Scalar(0) )... );
+        }
+    }
+
+    template <typename... Types>
+    struct any_matrix
+    : public std::false_type
+    { };
+
+    template <typename First, typename... Rest>
+    struct any_matrix <First, Rest...>
+    : public std::integral_constant<bool, is_matrix<First>::value ||
+                                          any_matrix<Rest...>::value>
+    { };
+
+    template <typename Scalar, u32 Rows, u32 Columns, typename... Values>
+    constant::Elements<Scalar, Rows, Columns> FilledElements(
+                                                      const Values&... values )
+    {
+        Matrix<Scalar, Rows, Columns> ret;
+        Fill( ret, values... );
+        return ret.m_elements;
+    }
+
+    //
+    // The elements for the mixed list constructor. A list of scalars can be
+    // used as is, lists containing matrices are flattened first.
+    //
+    template <typename Scalar, u32 Rows, u32 Columns, typename... Values>
+    constexpr constant::Elements<Scalar, Rows, Columns> ListElements(
+                                                      std::false_type,
+                                                      const Values&... values )
+    {
+        return constant::MakeElements<Scalar, Rows, Columns>( values... );
+    }
+
+    template <typename Scalar, u32 Rows, u32 Columns, typename... Values>
+    constexpr constant::Elements<Scalar, Rows, Columns> ListElements(
+                                                      std::true_type,
+                                                      const Values&... values )
+    {
+        return JOEMATH_CONSTANT_EVALUATED ?
+               constant::ElementsOf<Scalar, Rows, Columns>(
+                   Concatenate( Expand<Scalar>( values )... ),
+                   make_indices<Rows*Columns>{} ) :
+               FilledElements<Scalar, Rows, Columns>( values... );
+    }
+
+    //
+    // A rotation in the plane of axes i and j, from i towards j
+    //
+    template <typename Scalar, u32 Size>
+    Matrix<Scalar, Size, Size> PlaneRotation( u32 i, u32 j,
+                                              Scalar sin, Scalar cos )
+    {
+        Matrix<Scalar, Size, Size> ret = Identity<Scalar, Size>();
+        ret.m_elements[i][i] = cos;
+        ret.m_elements[j][i] = -sin;
+        ret.m_elements[i][j] = sin;
+        ret.m_elements[j][j] = cos;
+        return ret;
+    }
+}
 }
 
+//
+// The SIMD overloads use the helpers in detail
+//
+#include <joemath/inl/matrix_simd-inl.hpp>
+
+namespace JoeMath
+{
+
 ////////////////////////////////////////////////////////////////////////////////
 // Members of Matrix
 ////////////////////////////////////////////////////////////////////////////////
@@ -506,10 +1786,11 @@ Matrix<Scalar, Rows, Columns>::Matrix             ( )
 
 // Initialize every value to s
 template <typename Scalar, u32 Rows, u32 Columns>
-Matrix<Scalar, Rows, Columns>::Matrix             ( Scalar s )
+constexpr Matrix<Scalar, Rows, Columns>::Matrix   ( Scalar s )
+    : m_elements( detail::constant::ElementsOf<Scalar, Rows, Columns>(
+                                       s,
+                                       detail::make_indices<Rows*Columns>{} ) )
 {
-    for( u32 i = 0; i < rows*columns; ++i )
-        m_elements[0][i] = s;
 }
 
 // Initialize every value to s
@@ -522,34 +1803,38 @@ Matrix<Scalar, Rows, Columns>::Matrix             ( Scalar s )
 
 template <typename Scalar, u32 Rows, u32 Columns>
 template <std::size_t N>
-Matrix<Scalar, Rows, Columns>::Matrix
+constexpr Matrix<Scalar, Rows, Columns>::Matrix
                                   ( const std::array<scalar_type, N>& elements )
+    : m_elements( detail::constant::ElementsOf<Scalar, Rows, Columns>(
+                                elements,
+                                detail::make_indices<Rows*Columns>{} ) )
 {
     static_assert( N == rows*columns,
                    "Wrong number of elements passed to Matrix constructor" );
-    for( u32 i = 0; i < rows*columns; ++i )
-        m_elements[0][i] = elements[i];
 }
 
 template <typename Scalar, u32 Rows, u32 Columns>
 template <typename First, typename Second, typename... Rest>
-Matrix<Scalar, Rows, Columns>::Matrix( First first,
-                                       Second second,
-                                       Rest... rest )
+constexpr Matrix<Scalar, Rows, Columns>::Matrix( First first,
+                                                 Second second,
+                                                 Rest... rest )
+    : m_elements( detail::ListElements<Scalar, Rows, Columns>(
+                        detail::any_matrix<First, Second, Rest...>(),
+                        first, second, rest... ) )
 {
     static_assert( detail::CountElements( first, second, rest... ) ==
                                                                  Rows * Columns,
                    "Incorrect number of elements in Matrix constructor" );
-    detail::Fill( *this, first, second, rest... );
 }
 
 template <typename Scalar, u32 Rows, u32 Columns>
 template <typename Scalar2>
-Matrix<Scalar, Rows, Columns>::Matrix
-                        ( const Matrix<Scalar2, Rows, Columns> m)
+constexpr Matrix<Scalar, Rows, Columns>::Matrix
+                        ( const Matrix<Scalar2, Rows, Columns>& m )
+    : m_elements( detail::constant::ElementsOf<Scalar, Rows, Columns>(
+                                       m,
+                                       detail::make_indices<Rows*Columns>{} ) )
 {
-    for( u32 i = 0; i < rows*columns; ++i )
-        m_elements[0][i] = m.m_elements[0][i];
 }
 
 template <typename Scalar, u32 Rows, u32 Columns>
@@ -558,8 +1843,27 @@ Matrix<Scalar, Rows, Columns>&
 Matrix<Scalar, Rows, Columns>::operator =
                         ( const Matrix<Scalar2, Rows, Columns>& m )
 {
-    for( u32 i = 0; i < rows*columns; ++i )
-        m_elements[0][i] = m.m_elements[0][i];
+    detail::Copy( *this, m, detail::make_indices<Rows*Columns>{} );
+
+    return *this;
+}
+
+template <typename Scalar, u32 Rows, u32 Columns>
+template <typename Expression, typename>
+Matrix<Scalar, Rows, Columns>::Matrix( const Expression& e )
+{
+    *this = e;
+}
+
+template <typename Scalar, u32 Rows, u32 Columns>
+template <typename Expression, typename>
+Matrix<Scalar, Rows, Columns>&
+Matrix<Scalar, Rows, Columns>::operator = ( const Expression& e )
+{
+    static_assert( Expression::rows == Rows && Expression::columns == Columns,
+                   "Trying to assign an expression of a different size" );
+
+    detail::CopyIndexed( *this, e, detail::make_indices<Rows*Columns>{} );
 
     return *this;
 }
@@ -587,8 +1891,8 @@ void Matrix<Scalar, Rows, Columns>::SetSubMatrix(
 
 template <typename Scalar, u32 Rows, u32 Columns>
 template <u32 Rows2, u32 Columns2, u32 i, u32 j>
-Matrix<Scalar, Rows2, Columns2> Matrix<Scalar, Rows, Columns>::GetSubMatrix()
-                                                                           const
+constexpr Matrix<Scalar, Rows2, Columns2>
+                          Matrix<Scalar, Rows, Columns>::GetSubMatrix() const
 {
     static_assert(Columns2 + j <= Columns,
                   "The source Matrix doesn't have enough columns to "
@@ -597,25 +1901,16 @@ Matrix<Scalar, Rows2, Columns2> Matrix<Scalar, Rows, Columns>::GetSubMatrix()
                   "The source Matrix doesn't have enough rows to contain "
                   " this submatrix");
 
-    Matrix<Scalar, Rows2, Columns2> ret;
-
-    for( u32 column = 0; column < Columns2; ++column )
-        for( u32 row = 0; row < Rows2; ++row )
-            ret.m_elements[column][row] = m_elements[column+i][row+j];
-
-    return ret;
+    return detail::constant::SubMatrix<Rows2, Columns2, i, j>(
+                               *this, detail::make_indices<Rows2*Columns2>{} );
 }
 
 template <typename Scalar, u32 Rows, u32 Columns>
-auto Matrix<Scalar, Rows, Columns>::GetRow( u32 row ) const -> row_type
+constexpr auto Matrix<Scalar, Rows, Columns>::GetRow( u32 row ) const ->
+                                                                       row_type
 {
-    assert( row < rows && "Trying to get an out of bounds row" );
-
-    row_type ret;
-    for( u32 i = 0; i < columns; ++i )
-        ret[i] = m_elements[i][row];
-
-    return ret;
+    return assert( row < rows && "Trying to get an out of bounds row" ),
+           detail::constant::Row( *this, row, detail::make_indices<Columns>{} );
 }
 
 template <typename Scalar, u32 Rows, u32 Columns>
@@ -742,9 +2037,10 @@ void Matrix<Scalar, Rows, Columns>::SetTranslation( const column_type& m )
 
 template <typename Scalar, u32 Rows, u32 Columns>
 template <bool, typename>
-const Scalar& Matrix<Scalar, Rows, Columns>::operator []  ( u32 i ) const
+constexpr const Scalar& Matrix<Scalar, Rows, Columns>::operator [] ( u32 i )
+                                                                           const
 {
-    return m_elements[0][i];
+    return detail::constant::Get( *this, i );
 }
 
 template <typename Scalar, u32 Rows, u32 Columns>
@@ -770,7 +2066,7 @@ auto Matrix<Scalar, Rows, Columns>::operator [] ( u32 i ) -> column_type&
 }
 
 template <typename Scalar, u32 Rows, u32 Columns>
-const Scalar& Matrix<Scalar, Rows, Columns>::x() const
+constexpr const Scalar& Matrix<Scalar, Rows, Columns>::x() const
 {
     static_assert( is_vector,
                    "Trying to get the x component of a non-vector");
@@ -786,13 +2082,13 @@ Scalar& Matrix<Scalar, Rows, Columns>::x()
 }
 
 template <typename Scalar, u32 Rows, u32 Columns>
-const Scalar& Matrix<Scalar, Rows, Columns>::y() const
+constexpr const Scalar& Matrix<Scalar, Rows, Columns>::y() const
 {
     static_assert( is_vector,
                    "Trying to get the y component of a non-vector");
     static_assert( vector_size >= 2,
                    "Trying to get the y component of a vector of size < 2");
-    return m_elements[0][1];
+    return detail::constant::Get( *this, 1 );
 }
 
 template <typename Scalar, u32 Rows, u32 Columns>
@@ -806,13 +2102,13 @@ Scalar& Matrix<Scalar, Rows, Columns>::y()
 }
 
 template <typename Scalar, u32 Rows, u32 Columns>
-const Scalar& Matrix<Scalar, Rows, Columns>::z() const
+constexpr const Scalar& Matrix<Scalar, Rows, Columns>::z() const
 {
     static_assert( is_vector,
                    "Trying to get the z component of a non-vector");
     static_assert( vector_size >= 3,
                    "Trying to get the z component of a vector of size < 3");
-    return m_elements[0][2];
+    return detail::constant::Get( *this, 2 );
 }
 
 template <typename Scalar, u32 Rows, u32 Columns>
@@ -826,13 +2122,13 @@ Scalar& Matrix<Scalar, Rows, Columns>::z()
 }
 
 template <typename Scalar, u32 Rows, u32 Columns>
-const Scalar& Matrix<Scalar, Rows, Columns>::w() const
+constexpr const Scalar& Matrix<Scalar, Rows, Columns>::w() const
 {
     static_assert( is_vector,
                    "Trying to get the w component of a non-vector");
     static_assert( vector_size >= 4,
                    "Trying to get the w component of a vector of size < 4");
-    return m_elements[0][3];
+    return detail::constant::Get( *this, 3 );
 }
 
 template <typename Scalar, u32 Rows, u32 Columns>
@@ -897,6 +2193,9 @@ const Vector<Scalar, 4>& Matrix<Scalar, Rows, Columns>::xyzw() const
     static_assert( vector_size >= 4,
                    "Trying to get the xyzw components of a vector of size "
                    "< 4" );
+    static_assert( alignof(type) >= alignof(Vector<Scalar, 4>),
+                   "Trying to get the xyzw components of a vector which "
+                   "isn't as aligned as a four element vector" );
     return *reinterpret_cast<const Vector<Scalar, 4>*>(this);
 }
 
@@ -908,12 +2207,15 @@ Vector<Scalar, 4>& Matrix<Scalar, Rows, Columns>::xyzw()
     static_assert( vector_size >= 4,
                    "Trying to get the xyzw components of a vector of size <"
                    "4" );
+    static_assert( alignof(type) >= alignof(Vector<Scalar, 4>),
+                   "Trying to get the xyzw components of a vector which "
+                   "isn't as aligned as a four element vector" );
     return *reinterpret_cast<Vector<Scalar, 4>*>(this);
 }
 
 template <typename Scalar, u32 Rows, u32 Columns>
 template <typename ReturnScalar>
-ReturnScalar Matrix<Scalar, Rows, Columns>::Determinant()  const
+constexpr ReturnScalar Matrix<Scalar, Rows, Columns>::Determinant() const
 {
     return JoeMath::Determinant( *this );
 }
@@ -942,7 +2244,7 @@ ReturnScalar Matrix<Scalar, Rows, Columns>::Minor( u32 row, u32 column ) const
 
 template <typename Scalar, u32 Rows, u32 Columns>
 template <typename ReturnScalar>
-ReturnScalar     Matrix<Scalar, Rows, Columns>::LengthSq        ( ) const
+constexpr ReturnScalar Matrix<Scalar, Rows, Columns>::LengthSq  ( ) const
 {
     return JoeMath::LengthSq( *this );
 }
@@ -963,7 +2265,7 @@ ReturnScalar    Matrix<Scalar, Rows, Columns>::Length          ( ) const
 //
 
 template <typename Scalar, u32 Rows, u32 Columns>
-Matrix<Scalar, Rows, Columns> operator + (
+constexpr Matrix<Scalar, Rows, Columns> operator + (
                                         const Matrix<Scalar, Rows, Columns>& m )
 {
     return m;
@@ -971,16 +2273,14 @@ Matrix<Scalar, Rows, Columns> operator + (
 
 // the negated vertion of this vector
 template <typename Scalar, u32 Rows, u32 Columns>
-Matrix<Scalar, Rows, Columns> operator - (
+constexpr Matrix<Scalar, Rows, Columns> operator - (
                                         const Matrix<Scalar, Rows, Columns>& m )
 {
-    Matrix<Scalar, Rows, Columns> ret;
-
-    for( u32 i = 0; i < Columns; ++i )
-        for( u32 j = 0; j < Rows; ++j )
-            ret.m_elements[i][j] = -m.m_elements[i][j];
-
-    return ret;
+    return JOEMATH_CONSTANT_EVALUATED ?
+           detail::constant::Map<Scalar, Rows, Columns>(
+                     m, detail::Negate(),
+                     detail::make_indices<Rows*Columns>{} ) :
+           detail::NegateElements( m, detail::make_indices<Rows*Columns>{} );
 }
 
 //
@@ -988,38 +2288,82 @@ Matrix<Scalar, Rows, Columns> operator - (
 //
 
 // Scalar addition
-template <typename Scalar, u32 Rows, u32 Columns, typename Scalar2>
+template <typename Scalar, u32 Rows, u32 Columns, typename Scalar2, typename>
 Matrix<Scalar, Rows, Columns>&  operator += ( Matrix<Scalar, Rows, Columns>& m,
                                               const Scalar2 s )
 {
-    m = m + s;
+    detail::AddAssign( m, s, detail::make_indices<Rows*Columns>{} );
+
+    return m;
+}
+
+template <typename Scalar, u32 Rows, u32 Columns>
+Matrix<Scalar, Rows, Columns>&  operator += ( Matrix<Scalar, Rows, Columns>& m,
+                                              const Scalar s )
+{
+    detail::AddAssign( m, s, detail::make_indices<Rows*Columns>{} );
+
     return m;
 }
 
 // Scalar subtraction
-template <typename Scalar, u32 Rows, u32 Columns, typename Scalar2>
+template <typename Scalar, u32 Rows, u32 Columns, typename Scalar2, typename>
 Matrix<Scalar, Rows, Columns>&  operator -= ( Matrix<Scalar, Rows, Columns>& m,
                                               const Scalar2 s )
 {
-    m = m - s;
+    detail::SubtractAssign( m, s, detail::make_indices<Rows*Columns>{} );
+
+    return m;
+}
+
+template <typename Scalar, u32 Rows, u32 Columns>
+Matrix<Scalar, Rows, Columns>&  operator -= ( Matrix<Scalar, Rows, Columns>& m,
+                                              const Scalar s )
+{
+    detail::SubtractAssign( m, s, detail::make_indices<Rows*Columns>{} );
+
     return m;
 }
 
 // Scalar multiplication
-template <typename Scalar, u32 Rows, u32 Columns, typename Scalar2>
+template <typename Scalar, u32 Rows, u32 Columns, typename Scalar2, typename>
 Matrix<Scalar, Rows, Columns>&  operator *= ( Matrix<Scalar, Rows, Columns>& m,
                                               const Scalar2 s )
 {
-    m = m * s;
+    detail::MultiplyAssign( m, s, detail::make_indices<Rows*Columns>{} );
+
+    return m;
+}
+
+template <typename Scalar, u32 Rows, u32 Columns>
+Matrix<Scalar, Rows, Columns>&  operator *= ( Matrix<Scalar, Rows, Columns>& m,
+                                              const Scalar s )
+{
+    detail::MultiplyAssign( m, s, detail::make_indices<Rows*Columns>{} );
+
     return m;
 }
 
 // Scalar division
-template <typename Scalar, u32 Rows, u32 Columns, typename Scalar2>
+template <typename Scalar, u32 Rows, u32 Columns, typename Scalar2, typename>
 Matrix<Scalar, Rows, Columns>&  operator /= ( Matrix<Scalar, Rows, Columns>& m,
                                               const Scalar2 s )
 {
-    m = m / s;
+    auto inv = Scalar{1} / s;
+
+    detail::MultiplyAssign( m, inv, detail::make_indices<Rows*Columns>{} );
+
+    return m;
+}
+
+template <typename Scalar, u32 Rows, u32 Columns>
+Matrix<Scalar, Rows, Columns>&  operator /= ( Matrix<Scalar, Rows, Columns>& m,
+                                              const Scalar s )
+{
+    const Scalar inv = Scalar{1} / s;
+
+    detail::MultiplyAssign( m, inv, detail::make_indices<Rows*Columns>{} );
+
     return m;
 }
 
@@ -1029,7 +2373,18 @@ Matrix<Scalar, Rows, Columns>&  operator += (
                                 Matrix<Scalar, Rows, Columns>& m1,
                                 const Matrix<Scalar2, Rows, Columns>& m2 )
 {
-    m1 = m1 + m2;
+    detail::AddAssign( m1, m2, detail::make_indices<Rows*Columns>{} );
+
+    return m1;
+}
+
+template <typename Scalar, u32 Rows, u32 Columns>
+Matrix<Scalar, Rows, Columns>&  operator += (
+                                Matrix<Scalar, Rows, Columns>& m1,
+                                const Matrix<Scalar, Rows, Columns>& m2 )
+{
+    detail::AddAssign( m1, m2, detail::make_indices<Rows*Columns>{} );
+
     return m1;
 }
 
@@ -1039,7 +2394,18 @@ Matrix<Scalar, Rows, Columns>&  operator -= (
                                 Matrix<Scalar, Rows, Columns>& m1,
                                 const Matrix<Scalar2, Rows, Columns>& m2 )
 {
-    m1 = m1 - m2;
+    detail::SubtractAssign( m1, m2, detail::make_indices<Rows*Columns>{} );
+
+    return m1;
+}
+
+template <typename Scalar, u32 Rows, u32 Columns>
+Matrix<Scalar, Rows, Columns>&  operator -= (
+                                Matrix<Scalar, Rows, Columns>& m1,
+                                const Matrix<Scalar, Rows, Columns>& m2 )
+{
+    detail::SubtractAssign( m1, m2, detail::make_indices<Rows*Columns>{} );
+
     return m1;
 }
 
@@ -1049,7 +2415,18 @@ Matrix<Scalar, Rows, Columns>&  operator *= (
                                 Matrix<Scalar, Rows, Columns>& m1,
                                 const Matrix<Scalar2, Rows, Columns>& m2 )
 {
-    m1 = m1 * m2;
+    detail::MultiplyAssign( m1, m2, detail::make_indices<Rows*Columns>{} );
+
+    return m1;
+}
+
+template <typename Scalar, u32 Rows, u32 Columns>
+Matrix<Scalar, Rows, Columns>&  operator *= (
+                                Matrix<Scalar, Rows, Columns>& m1,
+                                const Matrix<Scalar, Rows, Columns>& m2 )
+{
+    detail::MultiplyAssign( m1, m2, detail::make_indices<Rows*Columns>{} );
+
     return m1;
 }
 
@@ -1059,7 +2436,18 @@ Matrix<Scalar, Rows, Columns>&  operator /= (
                                 Matrix<Scalar, Rows, Columns>& m1,
                                 const Matrix<Scalar2, Rows, Columns>& m2 )
 {
-    m1 = m1 / m2;
+    detail::DivideAssign( m1, m2, detail::make_indices<Rows*Columns>{} );
+
+    return m1;
+}
+
+template <typename Scalar, u32 Rows, u32 Columns>
+Matrix<Scalar, Rows, Columns>&  operator /= (
+                                Matrix<Scalar, Rows, Columns>& m1,
+                                const Matrix<Scalar, Rows, Columns>& m2 )
+{
+    detail::DivideAssign( m1, m2, detail::make_indices<Rows*Columns>{} );
+
     return m1;
 }
 
@@ -1076,21 +2464,21 @@ Matrix<Scalar, Rows, Columns>&  operator /= (
   * Returns true iff all the elements compare equal
   */
 template <typename Scalar, u32 Rows, u32 Columns, typename Scalar2>
-bool    operator == ( const Matrix<Scalar, Rows, Columns>& m1,
-                      const Matrix<Scalar2, Rows, Columns>& m2 )
+constexpr bool  operator == ( const Matrix<Scalar, Rows, Columns>& m1,
+                              const Matrix<Scalar2, Rows, Columns>& m2 )
 {
-    for( u32 i = 0; i < Columns * Rows; ++i )
-        if ( m1.m_elements[0][i] != m2.m_elements[0][i] )
-            return false;
-    return true;
+    return JOEMATH_CONSTANT_EVALUATED ?
+           detail::constant::Equal( m1, m2,
+                                    detail::make_indices<Rows*Columns>{} ) :
+           detail::Equal( m1, m2, detail::make_indices<Rows*Columns>{} );
 }
 
 /**
   * Returns false iff all the elements compare equal
   */
 template <typename Scalar, u32 Rows, u32 Columns, typename Scalar2>
-bool    operator != ( const Matrix<Scalar, Rows, Columns>& m1,
-                      const Matrix<Scalar2, Rows, Columns>& m2 )
+constexpr bool  operator != ( const Matrix<Scalar, Rows, Columns>& m1,
+                              const Matrix<Scalar2, Rows, Columns>& m2 )
 {
     return !(m1 == m2);
 }
@@ -1104,17 +2492,17 @@ bool    operator != ( const Matrix<Scalar, Rows, Columns>& m1,
   */
 template <typename Scalar, u32 Rows, u32 Columns,
           typename Scalar2,
+          typename,
           typename ReturnScalar>
-Matrix<ReturnScalar, Rows, Columns> operator + (
+constexpr Matrix<ReturnScalar, Rows, Columns> operator + (
                                          const Matrix<Scalar, Rows, Columns>& m,
                                          const Scalar2 s )
 {
-    Matrix<ReturnScalar, Rows, Columns> ret;
-
-    for( u32 i = 0; i < Columns*Rows; ++i )
-            ret.m_elements[0][i] = m.m_elements[0][i] + s;
-
-    return ret;
+    return JOEMATH_CONSTANT_EVALUATED ?
+           detail::constant::Map<ReturnScalar, Rows, Columns>(
+                  m, s, detail::Add(), detail::make_indices<Rows*Columns>{} ) :
+           detail::AddElements<ReturnScalar>(
+                  m, s, detail::make_indices<Rows*Columns>{} );
 }
 
 /**
@@ -1122,17 +2510,18 @@ Matrix<ReturnScalar, Rows, Columns> operator + (
   */
 template <typename Scalar, u32 Rows, u32 Columns,
           typename Scalar2,
+          typename,
           typename ReturnScalar>
-Matrix<ReturnScalar, Rows, Columns> operator - (
+constexpr Matrix<ReturnScalar, Rows, Columns> operator - (
                                          const Matrix<Scalar, Rows, Columns>& m,
                                          const Scalar2 s )
 {
-    Matrix<ReturnScalar, Rows, Columns> ret;
-
-    for( u32 i = 0; i < Columns*Rows; ++i )
-            ret.m_elements[0][i] = m.m_elements[0][i] - s;
-
-    return ret;
+    return JOEMATH_CONSTANT_EVALUATED ?
+           detail::constant::Map<ReturnScalar, Rows, Columns>(
+                  m, s, detail::Subtract(),
+                  detail::make_indices<Rows*Columns>{} ) :
+           detail::SubtractElements<ReturnScalar>(
+                  m, s, detail::make_indices<Rows*Columns>{} );
 }
 
 /**
@@ -1140,8 +2529,9 @@ Matrix<ReturnScalar, Rows, Columns> operator - (
   */
 template <typename Scalar, u32 Rows, u32 Columns,
           typename Scalar2,
+          typename,
           typename ReturnScalar>
-Matrix<ReturnScalar, Rows, Columns> operator * (
+constexpr Matrix<ReturnScalar, Rows, Columns> operator * (
                                        const Scalar2 s,
                                        const Matrix<Scalar, Rows, Columns>& m )
 {
@@ -1150,17 +2540,18 @@ Matrix<ReturnScalar, Rows, Columns> operator * (
 
 template <typename Scalar, u32 Rows, u32 Columns,
           typename Scalar2,
+          typename,
           typename ReturnScalar>
-Matrix<ReturnScalar, Rows, Columns> operator * (
+constexpr Matrix<ReturnScalar, Rows, Columns> operator * (
                                          const Matrix<Scalar, Rows, Columns>& m,
                                          const Scalar2 s )
 {
-    Matrix<ReturnScalar, Rows, Columns> ret;
-
-    for( u32 i = 0; i < Columns*Rows; ++i )
-            ret.m_elements[0][i] = m.m_elements[0][i] * s;
-
-    return ret;
+    return JOEMATH_CONSTANT_EVALUATED ?
+           detail::constant::Map<ReturnScalar, Rows, Columns>(
+                  m, s, detail::Multiply(),
+                  detail::make_indices<Rows*Columns>{} ) :
+           detail::MultiplyElements<ReturnScalar>(
+                  m, s, detail::make_indices<Rows*Columns>{} );
 }
 
 /**
@@ -1168,18 +2559,19 @@ Matrix<ReturnScalar, Rows, Columns> operator * (
   */
 template <typename Scalar, u32 Rows, u32 Columns,
           typename Scalar2,
+          typename,
           typename ReturnScalar>
-Matrix<ReturnScalar, Rows, Columns> operator / (
+constexpr Matrix<ReturnScalar, Rows, Columns> operator / (
                                          const Matrix<Scalar, Rows, Columns>& m,
                                          const Scalar2 s )
 {
-    Matrix<ReturnScalar, Rows, Columns> ret;
-    auto inv = Scalar{1} / s;
-
-    for( u32 i = 0; i < Columns*Rows; ++i )
-            ret.m_elements[0][i] = m.m_elements[0][i] * inv;
-
-    return ret;
+    return JOEMATH_CONSTANT_EVALUATED ?
+           detail::constant::Map<ReturnScalar, Rows, Columns>(
+                            m, Scalar{1} / s, detail::Multiply(),
+                            detail::make_indices<Rows*Columns>{} ) :
+           detail::MultiplyElements<ReturnScalar>(
+                            m, Scalar{1} / s,
+                            detail::make_indices<Rows*Columns>{} );
 }
 
 /**
@@ -1188,16 +2580,15 @@ Matrix<ReturnScalar, Rows, Columns> operator / (
 template <typename Scalar, u32 Rows, u32 Columns,
           typename Scalar2,
           typename ReturnScalar>
-Matrix<ReturnScalar, Rows, Columns> operator + (
+constexpr Matrix<ReturnScalar, Rows, Columns> operator + (
                                      const Matrix<Scalar, Rows, Columns>& m1,
                                      const Matrix<Scalar2, Rows, Columns>& m2 )
 {
-    Matrix<ReturnScalar, Rows, Columns> ret;
-
-    for( u32 i = 0; i < Columns*Rows; ++i )
-            ret.m_elements[0][i] = m1.m_elements[0][i] + m2.m_elements[0][i];
-
-    return ret;
+    return JOEMATH_CONSTANT_EVALUATED ?
+           detail::constant::Map<ReturnScalar, Rows, Columns>(
+                m1, m2, detail::Add(), detail::make_indices<Rows*Columns>{} ) :
+           detail::AddElements<ReturnScalar>(
+                m1, m2, detail::make_indices<Rows*Columns>{} );
 }
 
 /**
@@ -1206,16 +2597,16 @@ Matrix<ReturnScalar, Rows, Columns> operator + (
 template <typename Scalar, u32 Rows, u32 Columns,
           typename Scalar2,
           typename ReturnScalar>
-Matrix<ReturnScalar, Rows, Columns> operator - (
+constexpr Matrix<ReturnScalar, Rows, Columns> operator - (
                                      const Matrix<Scalar, Rows, Columns>& m1,
                                      const Matrix<Scalar2, Rows, Columns>& m2 )
 {
-    Matrix<ReturnScalar, Rows, Columns> ret;
-
-    for( u32 i = 0; i < Columns*Rows; ++i )
-            ret.m_elements[0][i] = m1.m_elements[0][i] - m2.m_elements[0][i];
-
-    return ret;
+    return JOEMATH_CONSTANT_EVALUATED ?
+           detail::constant::Map<ReturnScalar, Rows, Columns>(
+                m1, m2, detail::Subtract(),
+                detail::make_indices<Rows*Columns>{} ) :
+           detail::SubtractElements<ReturnScalar>(
+                m1, m2, detail::make_indices<Rows*Columns>{} );
 }
 
 /**
@@ -1224,16 +2615,16 @@ Matrix<ReturnScalar, Rows, Columns> operator - (
 template <typename Scalar, u32 Rows, u32 Columns,
           typename Scalar2,
           typename ReturnScalar>
-Matrix<ReturnScalar, Rows, Columns> operator * (
+constexpr Matrix<ReturnScalar, Rows, Columns> operator * (
                                      const Matrix<Scalar, Rows, Columns>& m1,
                                      const Matrix<Scalar2, Rows, Columns>& m2 )
 {
-    Matrix<ReturnScalar, Rows, Columns> ret;
-
-    for( u32 i = 0; i < Columns*Rows; ++i )
-            ret.m_elements[0][i] = m1.m_elements[0][i] * m2.m_elements[0][i];
-
-    return ret;
+    return JOEMATH_CONSTANT_EVALUATED ?
+           detail::constant::Map<ReturnScalar, Rows, Columns>(
+                m1, m2, detail::Multiply(),
+                detail::make_indices<Rows*Columns>{} ) :
+           detail::MultiplyElements<ReturnScalar>(
+                m1, m2, detail::make_indices<Rows*Columns>{} );
 }
 
 /**
@@ -1242,16 +2633,16 @@ Matrix<ReturnScalar, Rows, Columns> operator * (
 template <typename Scalar, u32 Rows, u32 Columns,
           typename Scalar2,
           typename ReturnScalar>
-Matrix<ReturnScalar, Rows, Columns> operator / (
+constexpr Matrix<ReturnScalar, Rows, Columns> operator / (
                                      const Matrix<Scalar, Rows, Columns>& m1,
                                      const Matrix<Scalar2, Rows, Columns>& m2 )
 {
-    Matrix<ReturnScalar, Rows, Columns> ret;
-
-    for( u32 i = 0; i < Columns*Rows; ++i )
-            ret.m_elements[0][i] = m1.m_elements[0][i] / m2.m_elements[0][i];
-
-    return ret;
+    return JOEMATH_CONSTANT_EVALUATED ?
+           detail::constant::Map<ReturnScalar, Rows, Columns>(
+                m1, m2, detail::Divide(),
+                detail::make_indices<Rows*Columns>{} ) :
+           detail::DivideElements<ReturnScalar>(
+                m1, m2, detail::make_indices<Rows*Columns>{} );
 }
 
 //
@@ -1261,23 +2652,19 @@ Matrix<ReturnScalar, Rows, Columns> operator / (
 template <typename Scalar, u32 Rows, u32 Columns,
           typename Scalar2, u32 Columns2,
           typename ReturnScalar>
-Matrix<ReturnScalar, Rows, Columns2> Mul(
+constexpr Matrix<ReturnScalar, Rows, Columns2> Mul(
                               const Matrix<Scalar, Rows, Columns>& m1,
                               const Matrix<Scalar2, Columns, Columns2>& m2 )
 {
-    Matrix<ReturnScalar, Rows, Columns2> ret{0};
-
-    for( u32 i = 0; i < Columns2; ++i )
-        for( u32 j = 0; j < Rows; ++j )
-            for( u32 k = 0; k < Columns; ++k )
-                ret.m_elements[i][j] += m1.m_elements[k][j] *
-                                        m2.m_elements[i][k];
-
-    return ret;
+    return JOEMATH_CONSTANT_EVALUATED ?
+           detail::constant::Mul<ReturnScalar>(
+                      m1, m2, detail::make_indices<Rows*Columns2>{} ) :
+           detail::Mul<ReturnScalar>(
+                      m1, m2, detail::make_indices<Rows*Columns*Columns2>{} );
 }
 
 template <typename Scalar, u32 Rows, u32 Columns>
-auto Determinant( const Matrix<Scalar, Rows, Columns>& m ) ->
+constexpr auto Determinant( const Matrix<Scalar, Rows, Columns>& m ) ->
                  decltype( std::declval<Scalar>() * std::declval<Scalar>() )
 {
     static_assert( Rows == Columns,
@@ -1288,18 +2675,256 @@ auto Determinant( const Matrix<Scalar, Rows, Columns>& m ) ->
 }
 
 template <typename Scalar, u32 Rows, u32 Columns>
-Matrix<Scalar, Columns, Rows> Transposed (
-                                        const Matrix<Scalar, Rows, Columns>& m )
+LUDecomposition<Scalar, Rows> LU( const Matrix<Scalar, Rows, Columns>& m )
 {
-    Matrix<Scalar, Columns, Rows> ret;
+    static_assert( Rows == Columns,
+                   "Trying to factorize a non-square matrix" );
 
-    for( u32 i = 0; i < Columns; ++i )
-        for( u32 j = 0; j < Rows; ++j )
-            ret.m_elements[j][i] = m.m_elements[i][j];
+    LUDecomposition<Scalar, Rows> ret;
+    ret.m_factors  = m;
+    ret.m_parity   = Scalar{1};
+    ret.m_singular = false;
+    for( u32 i = 0; i < Rows; ++i )
+        ret.m_pivots[i] = i;
+
+    auto& a = ret.m_factors.m_elements;
+
+    for( u32 k = 0; k < Columns; ++k )
+    {
+        //
+        // Find the largest pivot in this column
+        //
+        u32 pivot = k;
+        for( u32 i = k + 1; i < Rows; ++i )
+            if( Length( a[k][i] ) > Length( a[k][pivot] ) )
+                pivot = i;
+
+        if( a[k][pivot] == Scalar{0} )
+        {
+            ret.m_singular = true;
+            continue;
+        }
+
+        if( pivot != k )
+        {
+            for( u32 j = 0; j < Columns; ++j )
+                std::swap( a[j][k], a[j][pivot] );
+            std::swap( ret.m_pivots[k], ret.m_pivots[pivot] );
+            ret.m_parity = -ret.m_parity;
+        }
+
+        //
+        // Store the multipliers in L and eliminate the rest of the submatrix
+        // one column at a time
+        //
+        const Scalar inv = Scalar{1} / a[k][k];
+        for( u32 i = k + 1; i < Rows; ++i )
+            a[k][i] *= inv;
+
+        for( u32 j = k + 1; j < Columns; ++j )
+            for( u32 i = k + 1; i < Rows; ++i )
+                a[j][i] -= a[k][i] * a[j][k];
+    }
+
+    return ret;
+}
+
+template <typename Scalar, u32 Size, u32 Columns>
+Solution<Scalar, Size, Columns> Solve(
+                                     const Matrix<Scalar, Size, Size>& a,
+                                     const Matrix<Scalar, Size, Columns>& b )
+{
+    static_assert( std::is_floating_point<Scalar>::value,
+                   "Trying to solve a system of integers" );
+
+    Matrix<Scalar, Size, Size> u = a;
+    Solution<Scalar, Size, Columns> ret;
+    ret.m_x = b;
+    if( !detail::Eliminate( u, ret.m_x, detail::step<0>() ) )
+    {
+        ret.m_x = Matrix<Scalar, Size, Columns>( Scalar{0} );
+        ret.m_status = SolveStatus::Singular;
+        return ret;
+    }
+
+    detail::BackSubstitute( u, ret.m_x, std::false_type(),
+                            detail::step<Size>() );
+    ret.m_status = SolveStatus::Success;
+    return ret;
+}
+
+template <typename Scalar, u32 Size, u32 Columns>
+Solution<Scalar, Size, Columns> Solve(
+                                     const LUDecomposition<Scalar, Size>& lu,
+                                     const Matrix<Scalar, Size, Columns>& b )
+{
+    Solution<Scalar, Size, Columns> ret;
+    if( lu.m_singular )
+    {
+        ret.m_x = Matrix<Scalar, Size, Columns>( Scalar{0} );
+        ret.m_status = SolveStatus::Singular;
+        return ret;
+    }
+
+    //
+    // Row i of LU is row m_pivots[i] of a
+    //
+    for( u32 j = 0; j < Columns; ++j )
+        for( u32 i = 0; i < Size; ++i )
+            ret.m_x.m_elements[j][i] = b.m_elements[j][lu.m_pivots[i]];
+
+    detail::ForwardSubstitute( lu.m_factors, ret.m_x, std::true_type(),
+                               detail::step<0>() );
+    detail::BackSubstitute( lu.m_factors, ret.m_x, std::false_type(),
+                            detail::step<Size>() );
+    ret.m_status = SolveStatus::Success;
+    return ret;
+}
+
+template <typename Scalar, u32 Size, u32 Columns>
+Solution<Scalar, Size, Columns> SolveCholesky(
+                                     const Matrix<Scalar, Size, Size>& a,
+                                     const Matrix<Scalar, Size, Columns>& b )
+{
+    static_assert( std::is_floating_point<Scalar>::value,
+                   "Trying to solve a system of integers" );
+
+    Matrix<Scalar, Size, Size> l = a;
+    Solution<Scalar, Size, Columns> ret;
+    if( !detail::Cholesky( l, detail::step<0>() ) )
+    {
+        ret.m_x = Matrix<Scalar, Size, Columns>( Scalar{0} );
+        ret.m_status = SolveStatus::NotPositiveDefinite;
+        return ret;
+    }
+
+    ret.m_x = b;
+    detail::ForwardSubstitute( l, ret.m_x, std::false_type(),
+                               detail::step<0>() );
+    detail::BackSubstitute( l, ret.m_x, std::true_type(),
+                            detail::step<Size>() );
+    ret.m_status = SolveStatus::Success;
+    return ret;
+}
+
+template <typename Scalar>
+EigenDecomposition<Scalar> EigenSymmetric( const Matrix<Scalar, 3, 3>& m )
+{
+    static_assert( std::is_floating_point<Scalar>::value,
+                   "Trying to diagonalize a matrix of integers" );
+
+    Scalar s[3][3];
+    for( u32 j = 0; j < 3; ++j )
+        for( u32 i = j; i < 3; ++i )
+            s[j][i] = s[i][j] = m.m_elements[j][i];
+
+    Scalar values[3];
+    Scalar vectors[3][3];
+    detail::decompose::EigenSymmetric( s, values, vectors );
+
+    EigenDecomposition<Scalar> ret;
+    for( u32 j = 0; j < 3; ++j )
+    {
+        ret.m_values.m_elements[0][j] = values[j];
+        for( u32 i = 0; i < 3; ++i )
+            ret.m_vectors.m_elements[j][i] = vectors[j][i];
+    }
+    return ret;
+}
+
+template <typename Scalar>
+SingularValueDecomposition<Scalar> SVD( const Matrix<Scalar, 3, 3>& m )
+{
+    static_assert( std::is_floating_point<Scalar>::value,
+                   "Trying to decompose a matrix of integers" );
+
+    Scalar a[3][3];
+    for( u32 j = 0; j < 3; ++j )
+        for( u32 i = 0; i < 3; ++i )
+            a[j][i] = m.m_elements[j][i];
+
+    Scalar u[3][3];
+    Scalar values[3];
+    Scalar v[3][3];
+    detail::decompose::SVD( a, u, values, v );
+
+    SingularValueDecomposition<Scalar> ret;
+    for( u32 j = 0; j < 3; ++j )
+    {
+        ret.m_values.m_elements[0][j] = values[j];
+        for( u32 i = 0; i < 3; ++i )
+        {
+            ret.m_u.m_elements[j][i] = u[j][i];
+            ret.m_v.m_elements[j][i] = v[j][i];
+        }
+    }
+    return ret;
+}
+
+template <typename Scalar, u32 Size>
+void Orthonormalize( Matrix<Scalar, Size, Size>& m )
+{
+    static_assert( std::is_floating_point<Scalar>::value,
+                   "Trying to orthonormalize a matrix of integers" );
+    static_assert( Size == 3 || Size == 4,
+                   "Trying to orthonormalize a matrix which isn't 3x3 or 4x4" );
+
+    detail::decompose::Orthonormalize( m, m );
+}
+
+template <typename Scalar, u32 Size>
+Matrix<Scalar, Size, Size> Orthonormalized(
+                                         const Matrix<Scalar, Size, Size>& m )
+{
+    static_assert( std::is_floating_point<Scalar>::value,
+                   "Trying to orthonormalize a matrix of integers" );
+    static_assert( Size == 3 || Size == 4,
+                   "Trying to orthonormalize a matrix which isn't 3x3 or 4x4" );
+
+    //
+    // Reading from m rather than from the copy avoids loading values which
+    // have only just been stored
+    //
+    Matrix<Scalar, Size, Size> ret = m;
+    detail::decompose::Orthonormalize( m, ret );
+    return ret;
+}
+
+template <typename Scalar>
+PolarDecomposition<Scalar> PolarDecompose( const Matrix<Scalar, 3, 3>& m )
+{
+    static_assert( std::is_floating_point<Scalar>::value,
+                   "Trying to decompose a matrix of integers" );
+
+    Scalar a[3][3];
+    for( u32 j = 0; j < 3; ++j )
+        for( u32 i = 0; i < 3; ++i )
+            a[j][i] = m.m_elements[j][i];
+
+    Scalar rotation[3][3];
+    Scalar stretch[3][3];
+    detail::decompose::Polar( a, rotation, stretch );
 
+    PolarDecomposition<Scalar> ret;
+    for( u32 j = 0; j < 3; ++j )
+        for( u32 i = 0; i < 3; ++i )
+        {
+            ret.m_rotation.m_elements[j][i] = rotation[j][i];
+            ret.m_stretch.m_elements[j][i] = stretch[j][i];
+        }
     return ret;
 }
 
+template <typename Scalar, u32 Rows, u32 Columns>
+constexpr Matrix<Scalar, Columns, Rows> Transposed (
+                                        const Matrix<Scalar, Rows, Columns>& m )
+{
+    return JOEMATH_CONSTANT_EVALUATED ?
+           detail::constant::Transposed(
+                                     m, detail::make_indices<Rows*Columns>{} ) :
+           detail::Transposed( m, detail::make_indices<Rows*Columns>{} );
+}
+
 template <typename Scalar, u32 Rows, u32 Columns>
 void Transpose( Matrix<Scalar, Rows, Columns>& m )
 {
@@ -1340,9 +2965,36 @@ void Normalize( Matrix<Scalar, Rows, Columns>& m )
     m = Normalized( m );
 }
 
+template <typename Scalar, u32 Rows, u32 Columns>
+Matrix<Scalar, Rows, Columns> NormalizedPrecise (
+                                        const Matrix<Scalar, Rows, Columns>& m )
+{
+    return Normalized( m );
+}
+
+template <typename Scalar, u32 Rows, u32 Columns>
+Matrix<Scalar, Rows, Columns> NormalizedFast (
+                                        const Matrix<Scalar, Rows, Columns>& m )
+{
+    static_assert( Matrix<Scalar, Rows, Columns>::is_vector,
+                  "Trying to normalize a non-vector" );
+    return m * InverseSqrtFast( LengthSq( m ) );
+}
+
+template <typename Scalar, u32 Rows, u32 Columns>
+Matrix<Scalar, Rows, Columns> NormalizedSafe (
+                                const Matrix<Scalar, Rows, Columns>& m,
+                                const Matrix<Scalar, Rows, Columns>& fallback )
+{
+    static_assert( Matrix<Scalar, Rows, Columns>::is_vector,
+                  "Trying to normalize a non-vector" );
+    const auto length_sq = LengthSq( m );
+    return std::isnormal( length_sq ) ? m / std::sqrt( length_sq ) : fallback;
+}
+
 template <typename Scalar, u32 Rows, u32 Columns,
           typename ReturnScalar>
-ReturnScalar LengthSq        ( const Matrix<Scalar, Rows, Columns>& m )
+constexpr ReturnScalar LengthSq ( const Matrix<Scalar, Rows, Columns>& m )
 {
     static_assert( Matrix<Scalar, Rows, Columns>::is_vector,
                    "Trying to get the squared length of a non-vector" );
@@ -1359,26 +3011,46 @@ ReturnScalar Length          ( const Matrix<Scalar, Rows, Columns>& m )
 }
 
 template <typename Scalar, u32 Rows, u32 Columns,
-          typename Scalar2,
           typename ReturnScalar>
-ReturnScalar Dot ( const Matrix<Scalar, Rows, Columns>& m0,
-                    const Matrix<Scalar2, Rows, Columns>& m1 )
+ReturnScalar LengthFast      ( const Matrix<Scalar, Rows, Columns>& m )
 {
     static_assert( Matrix<Scalar, Rows, Columns>::is_vector,
-                   "Trying to take the dot product of non-vectors" );
+                   "Trying to get the length of a non-vector" );
+    const ReturnScalar length_sq = LengthSq( m );
+    return length_sq > ReturnScalar{0} ?
+           length_sq * InverseSqrtFast( length_sq ) :
+           ReturnScalar{0};
+}
 
-    ReturnScalar ret{0};
+template <typename Scalar, u32 Rows, u32 Columns,
+          typename ReturnScalar>
+ReturnScalar InverseLength   ( const Matrix<Scalar, Rows, Columns>& m )
+{
+    static_assert( Matrix<Scalar, Rows, Columns>::is_vector,
+                   "Trying to get the length of a non-vector" );
+    return ReturnScalar{1} / std::sqrt( ReturnScalar( LengthSq( m ) ) );
+}
 
-    for( u32 i = 0; i < Rows*Columns; ++i )
-        ret += m0.m_elements[0][i] * m1.m_elements[0][i];
+template <typename Scalar, u32 Rows, u32 Columns,
+          typename Scalar2,
+          typename ReturnScalar>
+constexpr ReturnScalar Dot ( const Matrix<Scalar, Rows, Columns>& m0,
+                             const Matrix<Scalar2, Rows, Columns>& m1 )
+{
+    static_assert( Matrix<Scalar, Rows, Columns>::is_vector,
+                   "Trying to take the dot product of non-vectors" );
 
-    return ret;
+    return JOEMATH_CONSTANT_EVALUATED ?
+           detail::constant::Dot<ReturnScalar>(
+                             m0, m1, detail::make_indices<Rows*Columns>{} ) :
+           detail::Dot<ReturnScalar>(
+                             m0, m1, detail::make_indices<Rows*Columns>{} );
 }
 
 template <typename Scalar, u32 Rows, u32 Columns,
           typename Scalar2,
           typename ReturnScalar>
-Matrix<ReturnScalar, Rows, Columns> Cross   (
+constexpr Matrix<ReturnScalar, Rows, Columns> Cross   (
                             const Matrix<Scalar, Rows, Columns>& m0,
                             const Matrix<Scalar2, Rows, Columns>& m1 )
 {
@@ -1388,19 +3060,16 @@ Matrix<ReturnScalar, Rows, Columns> Cross   (
                    "Trying to take the Cross Product between vectors of "
                    "size != 3" );
 
-    Matrix<ReturnScalar, Rows, Columns> ret;
-
-    ret.x() = m0.y() * m1.z() - m0.z() * m1.y();
-    ret.y() = m0.z() * m1.x() - m0.x() * m1.z();
-    ret.z() = m0.x() * m1.y() - m0.y() * m1.x();
-
-    return ret;
+    return Matrix<ReturnScalar, Rows, Columns>(
+                                    m0.y() * m1.z() - m0.z() * m1.y(),
+                                    m0.z() * m1.x() - m0.x() * m1.z(),
+                                    m0.x() * m1.y() - m0.y() * m1.x() );
 }
 
 template <typename Scalar, u32 Rows, u32 Columns,
           typename Scalar2, u32 Rows2, u32 Columns2,
           typename ReturnScalar>
-Matrix<ReturnScalar, Matrix<Scalar, Rows, Columns>::vector_size,
+constexpr Matrix<ReturnScalar, Matrix<Scalar, Rows, Columns>::vector_size,
                      Matrix<Scalar2, Rows2, Columns2>::vector_size> Outer (
                                     const Matrix<Scalar, Rows, Columns>& m0,
                                     const Matrix<Scalar2, Rows2, Columns2>& m1 )
@@ -1409,15 +3078,23 @@ Matrix<ReturnScalar, Matrix<Scalar, Rows, Columns>::vector_size,
                    Matrix<Scalar2,Rows2,Columns2>::is_vector,
                    "Trying to take the outer product between one or more "
                    "non-vectors" );
-    Matrix<ReturnScalar,
-           Matrix<Scalar,Rows,Columns>::vector_size,
-           Matrix<Scalar2,Rows2,Columns2>::vector_size> ret;
 
-    for( u32 j = 0; j < m1.vector_size; ++j )
-        for( u32 i = 0; i < m0.vector_size; ++i )
-            ret.m_elements[j][i] = m0[i] * m1[j];
+    return detail::constant::Outer<ReturnScalar,
+                               Matrix<Scalar,Rows,Columns>::vector_size,
+                               Matrix<Scalar2,Rows2,Columns2>::vector_size>(
+                 m0, m1, detail::make_indices<Rows*Columns*Rows2*Columns2>{} );
+}
 
-    return ret;
+template <typename Scalar, u32 Rows, u32 Columns>
+void SinCosFast ( const Matrix<Scalar, Rows, Columns>& angles,
+                  Matrix<Scalar, Rows, Columns>& sin,
+                  Matrix<Scalar, Rows, Columns>& cos )
+{
+    for( u32 i = 0; i < Columns; ++i )
+        for( u32 j = 0; j < Rows; ++j )
+            SinCosFast( angles.m_elements[i][j],
+                        sin.m_elements[i][j],
+                        cos.m_elements[i][j] );
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1425,21 +3102,16 @@ Matrix<ReturnScalar, Matrix<Scalar, Rows, Columns>::vector_size,
 ////////////////////////////////////////////////////////////////////////////////
 
 template <typename Scalar, u32 Size>
-Matrix<Scalar, Size, Size> Identity()
+constexpr Matrix<Scalar, Size, Size> Identity()
 {
-    Matrix<Scalar, Size, Size> ret( Scalar{0} );
-    for( u32 i = 0; i < Size; ++i )
-        ret.m_elements[i][i] = Scalar(1);
-    return ret;
+    return detail::constant::Identity<Scalar, Size>(
+                                           detail::make_indices<Size*Size>{} );
 }
 
 template <typename Scalar, u32 Size>
-Matrix<Scalar, Size, Size> Scale( const Matrix<Scalar, 1, Size>& s )
+constexpr Matrix<Scalar, Size, Size> Scale( const Vector<Scalar, Size>& s )
 {
-    Matrix<Scalar, Size, Size> ret( Scalar{0} );
-    for( u32 i = 0; i < Size; ++i )
-        ret.m_elements[i][i] = s[i];
-    return ret;
+    return detail::constant::Scale( s, detail::make_indices<Size*Size>{} );
 }
 
 template <typename Scalar, u32 Size>
@@ -1448,15 +3120,10 @@ Matrix<Scalar, Size, Size>             Rotate2D        ( Scalar angle )
     static_assert( Size >= 2,
                    "Trying to construct a 2d rotation matrix of size 1" );
 
-    auto sin = std::sin( angle );
-    auto cos = std::cos( angle );
-    Matrix<Scalar, Size, Size> ret = Identity<Scalar, Size>();
-    ret.m_elements[0][0] = cos;
-    ret.m_elements[1][0] = -sin;
-    ret.m_elements[0][1] = sin;
-    ret.m_elements[1][1] = cos;
-
-    return ret;
+    Scalar sin;
+    Scalar cos;
+    SinCosFast( angle, sin, cos );
+    return detail::PlaneRotation<Scalar, Size>( 0, 1, sin, cos );
 }
 
 template <typename Scalar, u32 Size>
@@ -1466,15 +3133,10 @@ Matrix<Scalar, Size, Size>             RotateX         ( Scalar angle )
                    "Trying to construct an x axis rotation matrix of size <"
                    " 3" );
 
-    auto sin = std::sin( angle );
-    auto cos = std::cos( angle );
-    Matrix<Scalar, Size, Size> ret = Identity<Scalar, Size>();
-    ret.m_elements[1][1] = cos;
-    ret.m_elements[2][1] = -sin;
-    ret.m_elements[1][2] = sin;
-    ret.m_elements[2][2] = cos;
-
-    return ret;
+    Scalar sin;
+    Scalar cos;
+    SinCosFast( angle, sin, cos );
+    return detail::PlaneRotation<Scalar, Size>( 1, 2, sin, cos );
 }
 
 template <typename Scalar, u32 Size>
@@ -1484,15 +3146,10 @@ Matrix<Scalar, Size, Size>             RotateY         ( Scalar angle )
                    "Trying to construct an y axis rotation matrix of size <"
                    " 3" );
 
-    auto sin = std::sin( angle );
-    auto cos = std::cos( angle );
-    Matrix<Scalar, Size, Size> ret = Identity<Scalar, Size>();
-    ret.m_elements[0][0] = cos;
-    ret.m_elements[2][0] = sin;
-    ret.m_elements[0][2] = -sin;
-    ret.m_elements[2][2] = cos;
-
-    return ret;
+    Scalar sin;
+    Scalar cos;
+    SinCosFast( angle, sin, cos );
+    return detail::PlaneRotation<Scalar, Size>( 2, 0, sin, cos );
 }
 
 template <typename Scalar, u32 Size>
@@ -1502,23 +3159,19 @@ Matrix<Scalar, Size, Size>             RotateZ         ( Scalar angle )
                    "Trying to construct an z axis rotation matrix of size <"
                    " 2" );
 
-    Scalar sin = std::sin( angle );
-    Scalar cos = std::cos( angle );
-    Matrix<Scalar, Size, Size> ret = Identity<Scalar, Size>();
-    ret.m_elements[0][0] = cos;
-    ret.m_elements[1][0] = -sin;
-    ret.m_elements[0][1] = sin;
-    ret.m_elements[1][1] = cos;
-
-    return ret;
+    Scalar sin;
+    Scalar cos;
+    SinCosFast( angle, sin, cos );
+    return detail::PlaneRotation<Scalar, Size>( 0, 1, sin, cos );
 }
 
 template <typename Scalar>
 Matrix<Scalar, 4, 4> RotateAxisAngle( const Vector<Scalar, 3>& axis,
                                       Scalar angle )
 {
-    auto cos = std::cos( angle );
-    auto sin = std::sin( angle );
+    Scalar sin;
+    Scalar cos;
+    SinCosFast( angle, sin, cos );
 
     Matrix<Scalar, 3, 3> rotation{ Scalar{0}, axis.z(), -axis.y(),
                                    -axis.z(), Scalar{0}, axis.x(),
@@ -1534,13 +3187,11 @@ Matrix<Scalar, 4, 4> RotateAxisAngle( const Vector<Scalar, 3>& axis,
 }
 
 template <typename Scalar, u32 Size>
-Matrix<Scalar, Size, Size> Translate( const Vector<Scalar, Size>& position )
+constexpr Matrix<Scalar, Size, Size> Translate(
+                                         const Vector<Scalar, Size>& position )
 {
-    Matrix<Scalar, Size, Size> ret = Identity<Scalar, Size>();
-
-    ret.SetTranslation(position);
-
-    return ret;
+    return detail::constant::Translate( position,
+                                        detail::make_indices<Size*Size>{} );
 }
 
 template <typename Scalar>
@@ -1560,9 +3211,11 @@ Matrix<Scalar, 4, 4> Projection( Scalar vertical_fov,
                                  Scalar near_plane,
                                  Scalar far_plane )
 {
-    auto top = std::tan( Scalar{0.5} * vertical_fov ) * near_plane;
+    Scalar sin;
+    Scalar cos;
+    SinCosFast( Scalar{0.5} * vertical_fov, sin, cos );
 
-    auto y_scale = Scalar{1} / std::tan( Scalar{0.5} * vertical_fov );
+    auto y_scale = cos / sin;
     auto x_scale = y_scale / aspect_ratio;
     auto z_scale = -(far_plane + near_plane) / (far_plane - near_plane);
     auto focus   = -Scalar{2} * far_plane * near_plane /
@@ -1589,18 +3242,17 @@ Matrix<Scalar, 4, 4> View( const Vector<Scalar, 3>& position,
 }
 
 template <typename Scalar>
-Matrix<Scalar, 4, 4> Ortho( Scalar left, Scalar right,
-                            Scalar top, Scalar bottom,
-                            Scalar near_p, Scalar far_p)
+constexpr Matrix<Scalar, 4, 4> Ortho( Scalar left, Scalar right,
+                                      Scalar top, Scalar bottom,
+                                      Scalar near_p, Scalar far_p)
 {
-    auto x_size = right - left;
-    auto y_size = top - bottom;
-    auto z_size = far_p- near_p;
-
     return Matrix<Scalar, 4, 4>
-    { 2 / x_size, 0,          0,          0,
-      0,          2 / y_size, 0,          0,
-      0,          0,          2 / z_size, 0,
-      -(right+left)/x_size, -(top+bottom)/y_size, -(near_p+far_p)/z_size, 1 };
+    { 2 / (right - left), 0,                  0,                    0,
+      0,                  2 / (top - bottom), 0,                    0,
+      0,                  0,                  2 / (far_p - near_p), 0,
+      -(right + left) / (right - left),
+      -(top + bottom) / (top - bottom),
+      -(near_p + far_p) / (far_p - near_p),
+      1 };
 }
 }
@@ -0,0 +1,839 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#pragma once
+
+#include <joemath/matrix.hpp>
+#include <joemath/simd.hpp>
+
+//
+// These are non-template overloads of the generic Matrix functions for float4
+// and float4x4. Overload resolution prefers them to the templates in
+// matrix-inl.hpp, so nothing needs to be done by the caller to use them.
+//
+// The loads and stores here are all unaligned ones. They're as fast as aligned
+// ones when the address is aligned, which float4 and float4x4 are when
+// JOEMATH_ALIGNMENT is defined, and they also work for the strided arrays in
+// batch.hpp
+//
+
+#if defined( JOEMATH_SSE )
+
+namespace JoeMath
+{
+namespace detail
+{
+namespace sse
+{
+    inline __m128 Load( const float* p )
+    {
+        return _mm_loadu_ps( p );
+    }
+
+    inline void Store( float* p, __m128 v )
+    {
+        _mm_storeu_ps( p, v );
+    }
+
+    //
+    // Loads two floats into the low half. This goes through __m64, which may
+    // alias anything, rather than _mm_load_sd and a double
+    //
+    inline __m128 LoadLow( const float* p )
+    {
+        return _mm_loadl_pi( _mm_setzero_ps(),
+                             reinterpret_cast<const __m64*>( p ) );
+    }
+
+#if defined( JOEMATH_AVX )
+    inline __m256 Load8( const float* p )
+    {
+        return _mm256_loadu_ps( p );
+    }
+
+    inline void Store8( float* p, __m256 v )
+    {
+        _mm256_storeu_ps( p, v );
+    }
+#endif
+
+    struct Add
+    {
+        __m128 operator () ( __m128 a, __m128 b ) const
+        { return _mm_add_ps( a, b ); }
+#if defined( JOEMATH_AVX )
+        __m256 operator () ( __m256 a, __m256 b ) const
+        { return _mm256_add_ps( a, b ); }
+#endif
+    };
+
+    struct Sub
+    {
+        __m128 operator () ( __m128 a, __m128 b ) const
+        { return _mm_sub_ps( a, b ); }
+#if defined( JOEMATH_AVX )
+        __m256 operator () ( __m256 a, __m256 b ) const
+        { return _mm256_sub_ps( a, b ); }
+#endif
+    };
+
+    struct Mul
+    {
+        __m128 operator () ( __m128 a, __m128 b ) const
+        { return _mm_mul_ps( a, b ); }
+#if defined( JOEMATH_AVX )
+        __m256 operator () ( __m256 a, __m256 b ) const
+        { return _mm256_mul_ps( a, b ); }
+#endif
+    };
+
+    struct Xor
+    {
+        __m128 operator () ( __m128 a, __m128 b ) const
+        { return _mm_xor_ps( a, b ); }
+#if defined( JOEMATH_AVX )
+        __m256 operator () ( __m256 a, __m256 b ) const
+        { return _mm256_xor_ps( a, b ); }
+#endif
+    };
+
+    struct Div
+    {
+        __m128 operator () ( __m128 a, __m128 b ) const
+        { return _mm_div_ps( a, b ); }
+#if defined( JOEMATH_AVX )
+        __m256 operator () ( __m256 a, __m256 b ) const
+        { return _mm256_div_ps( a, b ); }
+#endif
+    };
+
+    //
+    // Apply op to every column of m0 and m1 and store the result in ret. Each
+    // column is loaded before it's stored, so ret may be either operand.
+    //
+    template <u32 Columns, typename Op>
+    inline void Map( Matrix<float, 4, Columns>& ret,
+                     const Matrix<float, 4, Columns>& m0,
+                     const Matrix<float, 4, Columns>& m1,
+                     Op op )
+    {
+        u32 i = 0;
+#if defined( JOEMATH_AVX )
+        for( ; i + 2 <= Columns; i += 2 )
+            Store8( &ret.m_elements[i][0],
+                    op( Load8( &m0.m_elements[i][0] ),
+                        Load8( &m1.m_elements[i][0] ) ) );
+#endif
+        for( ; i < Columns; ++i )
+            Store( &ret.m_elements[i][0],
+                   op( Load( &m0.m_elements[i][0] ),
+                       Load( &m1.m_elements[i][0] ) ) );
+    }
+
+    //
+    // Apply op to every column of m and s and store the result in ret, which
+    // may be m
+    //
+    template <u32 Columns, typename Op>
+    inline void Map( Matrix<float, 4, Columns>& ret,
+                     const Matrix<float, 4, Columns>& m,
+                     float s,
+                     Op op )
+    {
+        u32 i = 0;
+#if defined( JOEMATH_AVX )
+        const __m256 s8 = _mm256_set1_ps( s );
+        for( ; i + 2 <= Columns; i += 2 )
+            Store8( &ret.m_elements[i][0],
+                    op( Load8( &m.m_elements[i][0] ), s8 ) );
+#endif
+        const __m128 s4 = _mm_set1_ps( s );
+        for( ; i < Columns; ++i )
+            Store( &ret.m_elements[i][0],
+                   op( Load( &m.m_elements[i][0] ), s4 ) );
+    }
+
+    template <u32 Columns, typename Op>
+    inline Matrix<float, 4, Columns> Map( const Matrix<float, 4, Columns>& m0,
+                                          const Matrix<float, 4, Columns>& m1,
+                                          Op op )
+    {
+        Matrix<float, 4, Columns> ret;
+        Map( ret, m0, m1, op );
+        return ret;
+    }
+
+    template <u32 Columns, typename Op>
+    inline Matrix<float, 4, Columns> Map( const Matrix<float, 4, Columns>& m,
+                                          float s,
+                                          Op op )
+    {
+        Matrix<float, 4, Columns> ret;
+        Map( ret, m, s, op );
+        return ret;
+    }
+
+    template <u32 I>
+    inline __m128 Splat( __m128 v )
+    {
+        return _mm_shuffle_ps( v, v, _MM_SHUFFLE( I, I, I, I ) );
+    }
+
+    //
+    // The linear combination of the columns of m by the elements of v
+    //
+    inline __m128 LinearCombination( const float4x4& m, __m128 v )
+    {
+        __m128 ret = _mm_mul_ps( Load( &m.m_elements[0][0] ), Splat<0>( v ) );
+        ret = _mm_add_ps( ret, _mm_mul_ps( Load( &m.m_elements[1][0] ),
+                                           Splat<1>( v ) ) );
+        ret = _mm_add_ps( ret, _mm_mul_ps( Load( &m.m_elements[2][0] ),
+                                           Splat<2>( v ) ) );
+        ret = _mm_add_ps( ret, _mm_mul_ps( Load( &m.m_elements[3][0] ),
+                                           Splat<3>( v ) ) );
+        return ret;
+    }
+
+    //
+    // Loads the matrix as four registers, each containing pairs of rows
+    // shuffled into the order that Inverted and Determinant expect
+    //
+    inline void LoadForCofactors( const float4x4& m,
+                                  __m128& row0, __m128& row1,
+                                  __m128& row2, __m128& row3 )
+    {
+        const float* src = &m.m_elements[0][0];
+        __m128 tmp;
+        tmp  = _mm_loadh_pi( LoadLow( src ),
+                             reinterpret_cast<const __m64*>( src + 4 ) );
+        row1 = _mm_loadh_pi( LoadLow( src + 8 ),
+                             reinterpret_cast<const __m64*>( src + 12 ) );
+        row0 = _mm_shuffle_ps( tmp, row1, 0x88 );
+        row1 = _mm_shuffle_ps( row1, tmp, 0xDD );
+        tmp  = _mm_loadh_pi( LoadLow( src + 2 ),
+                             reinterpret_cast<const __m64*>( src + 6 ) );
+        row3 = _mm_loadh_pi( LoadLow( src + 10 ),
+                             reinterpret_cast<const __m64*>( src + 14 ) );
+        row2 = _mm_shuffle_ps( tmp, row3, 0x88 );
+        row3 = _mm_shuffle_ps( row3, tmp, 0xDD );
+    }
+
+    inline __m128 HorizontalSum( __m128 v )
+    {
+        v = _mm_add_ps( _mm_shuffle_ps( v, v, 0x4E ), v );
+        return _mm_add_ss( _mm_shuffle_ps( v, v, 0xB1 ), v );
+    }
+}
+}
+
+//
+// Unary Operators
+//
+
+//
+// Flipping the sign bit is the same as negating every element
+//
+
+inline JOEMATH_SIMD_CONSTEXPR
+float4 operator - ( const float4& m )
+{
+    return JOEMATH_SIMD_CONSTANT_EVALUATED ?
+           detail::constant::Map<float, 4, 1>(
+                         m, detail::Negate(), detail::make_indices<4>{} ) :
+           detail::sse::Map( m, -0.f, detail::sse::Xor() );
+}
+
+inline JOEMATH_SIMD_CONSTEXPR
+float4x4 operator - ( const float4x4& m )
+{
+    return JOEMATH_SIMD_CONSTANT_EVALUATED ?
+           detail::constant::Map<float, 4, 4>(
+                         m, detail::Negate(), detail::make_indices<16>{} ) :
+           detail::sse::Map( m, -0.f, detail::sse::Xor() );
+}
+
+//
+// Arithmetic
+//
+
+inline JOEMATH_SIMD_CONSTEXPR
+float4 operator + ( const float4& m, const float s )
+{
+    return JOEMATH_SIMD_CONSTANT_EVALUATED ?
+           detail::constant::Map<float, 4, 1>(
+                         m, s, detail::Add(), detail::make_indices<4>{} ) :
+           detail::sse::Map( m, s, detail::sse::Add() );
+}
+
+inline JOEMATH_SIMD_CONSTEXPR
+float4x4 operator + ( const float4x4& m, const float s )
+{
+    return JOEMATH_SIMD_CONSTANT_EVALUATED ?
+           detail::constant::Map<float, 4, 4>(
+                         m, s, detail::Add(), detail::make_indices<16>{} ) :
+           detail::sse::Map( m, s, detail::sse::Add() );
+}
+
+inline JOEMATH_SIMD_CONSTEXPR
+float4 operator - ( const float4& m, const float s )
+{
+    return JOEMATH_SIMD_CONSTANT_EVALUATED ?
+           detail::constant::Map<float, 4, 1>(
+                         m, s, detail::Subtract(), detail::make_indices<4>{} ) :
+           detail::sse::Map( m, s, detail::sse::Sub() );
+}
+
+inline JOEMATH_SIMD_CONSTEXPR
+float4x4 operator - ( const float4x4& m, const float s )
+{
+    return JOEMATH_SIMD_CONSTANT_EVALUATED ?
+           detail::constant::Map<float, 4, 4>(
+                         m, s, detail::Subtract(),
+                         detail::make_indices<16>{} ) :
+           detail::sse::Map( m, s, detail::sse::Sub() );
+}
+
+inline JOEMATH_SIMD_CONSTEXPR
+float4 operator * ( const float4& m, const float s )
+{
+    return JOEMATH_SIMD_CONSTANT_EVALUATED ?
+           detail::constant::Map<float, 4, 1>(
+                         m, s, detail::Multiply(), detail::make_indices<4>{} ) :
+           detail::sse::Map( m, s, detail::sse::Mul() );
+}
+
+inline JOEMATH_SIMD_CONSTEXPR
+float4x4 operator * ( const float4x4& m, const float s )
+{
+    return JOEMATH_SIMD_CONSTANT_EVALUATED ?
+           detail::constant::Map<float, 4, 4>(
+                         m, s, detail::Multiply(),
+                         detail::make_indices<16>{} ) :
+           detail::sse::Map( m, s, detail::sse::Mul() );
+}
+
+inline JOEMATH_SIMD_CONSTEXPR
+float4 operator * ( const float s, const float4& m )
+{
+    return m * s;
+}
+
+inline JOEMATH_SIMD_CONSTEXPR
+float4x4 operator * ( const float s, const float4x4& m )
+{
+    return m * s;
+}
+
+inline JOEMATH_SIMD_CONSTEXPR
+float4 operator / ( const float4& m, const float s )
+{
+    return JOEMATH_SIMD_CONSTANT_EVALUATED ?
+           detail::constant::Map<float, 4, 1>(
+                         m, 1.f / s, detail::Multiply(),
+                         detail::make_indices<4>{} ) :
+           detail::sse::Map( m, 1.f / s, detail::sse::Mul() );
+}
+
+inline JOEMATH_SIMD_CONSTEXPR
+float4x4 operator / ( const float4x4& m, const float s )
+{
+    return JOEMATH_SIMD_CONSTANT_EVALUATED ?
+           detail::constant::Map<float, 4, 4>(
+                         m, 1.f / s, detail::Multiply(),
+                         detail::make_indices<16>{} ) :
+           detail::sse::Map( m, 1.f / s, detail::sse::Mul() );
+}
+
+inline JOEMATH_SIMD_CONSTEXPR
+float4 operator + ( const float4& m1, const float4& m2 )
+{
+    return JOEMATH_SIMD_CONSTANT_EVALUATED ?
+           detail::constant::Map<float, 4, 1>(
+                         m1, m2, detail::Add(), detail::make_indices<4>{} ) :
+           detail::sse::Map( m1, m2, detail::sse::Add() );
+}
+
+inline JOEMATH_SIMD_CONSTEXPR
+float4x4 operator + ( const float4x4& m1, const float4x4& m2 )
+{
+    return JOEMATH_SIMD_CONSTANT_EVALUATED ?
+           detail::constant::Map<float, 4, 4>(
+                         m1, m2, detail::Add(), detail::make_indices<16>{} ) :
+           detail::sse::Map( m1, m2, detail::sse::Add() );
+}
+
+inline JOEMATH_SIMD_CONSTEXPR
+float4 operator - ( const float4& m1, const float4& m2 )
+{
+    return JOEMATH_SIMD_CONSTANT_EVALUATED ?
+           detail::constant::Map<float, 4, 1>(
+                         m1, m2, detail::Subtract(),
+                         detail::make_indices<4>{} ) :
+           detail::sse::Map( m1, m2, detail::sse::Sub() );
+}
+
+inline JOEMATH_SIMD_CONSTEXPR
+float4x4 operator - ( const float4x4& m1, const float4x4& m2 )
+{
+    return JOEMATH_SIMD_CONSTANT_EVALUATED ?
+           detail::constant::Map<float, 4, 4>(
+                         m1, m2, detail::Subtract(),
+                         detail::make_indices<16>{} ) :
+           detail::sse::Map( m1, m2, detail::sse::Sub() );
+}
+
+inline JOEMATH_SIMD_CONSTEXPR
+float4 operator * ( const float4& m1, const float4& m2 )
+{
+    return JOEMATH_SIMD_CONSTANT_EVALUATED ?
+           detail::constant::Map<float, 4, 1>(
+                         m1, m2, detail::Multiply(),
+                         detail::make_indices<4>{} ) :
+           detail::sse::Map( m1, m2, detail::sse::Mul() );
+}
+
+inline JOEMATH_SIMD_CONSTEXPR
+float4x4 operator * ( const float4x4& m1, const float4x4& m2 )
+{
+    return JOEMATH_SIMD_CONSTANT_EVALUATED ?
+           detail::constant::Map<float, 4, 4>(
+                         m1, m2, detail::Multiply(),
+                         detail::make_indices<16>{} ) :
+           detail::sse::Map( m1, m2, detail::sse::Mul() );
+}
+
+inline JOEMATH_SIMD_CONSTEXPR
+float4 operator / ( const float4& m1, const float4& m2 )
+{
+    return JOEMATH_SIMD_CONSTANT_EVALUATED ?
+           detail::constant::Map<float, 4, 1>(
+                         m1, m2, detail::Divide(), detail::make_indices<4>{} ) :
+           detail::sse::Map( m1, m2, detail::sse::Div() );
+}
+
+inline JOEMATH_SIMD_CONSTEXPR
+float4x4 operator / ( const float4x4& m1, const float4x4& m2 )
+{
+    return JOEMATH_SIMD_CONSTANT_EVALUATED ?
+           detail::constant::Map<float, 4, 4>(
+                         m1, m2, detail::Divide(),
+                         detail::make_indices<16>{} ) :
+           detail::sse::Map( m1, m2, detail::sse::Div() );
+}
+
+//
+// Assignment operators
+//
+
+inline float4& operator += ( float4& m, const float s )
+{
+    detail::sse::Map( m, m, s, detail::sse::Add() );
+    return m;
+}
+
+inline float4& operator -= ( float4& m, const float s )
+{
+    detail::sse::Map( m, m, s, detail::sse::Sub() );
+    return m;
+}
+
+inline float4& operator *= ( float4& m, const float s )
+{
+    detail::sse::Map( m, m, s, detail::sse::Mul() );
+    return m;
+}
+
+inline float4& operator /= ( float4& m, const float s )
+{
+    detail::sse::Map( m, m, 1.f / s, detail::sse::Mul() );
+    return m;
+}
+
+inline float4x4& operator += ( float4x4& m, const float s )
+{
+    detail::sse::Map( m, m, s, detail::sse::Add() );
+    return m;
+}
+
+inline float4x4& operator -= ( float4x4& m, const float s )
+{
+    detail::sse::Map( m, m, s, detail::sse::Sub() );
+    return m;
+}
+
+inline float4x4& operator *= ( float4x4& m, const float s )
+{
+    detail::sse::Map( m, m, s, detail::sse::Mul() );
+    return m;
+}
+
+inline float4x4& operator /= ( float4x4& m, const float s )
+{
+    detail::sse::Map( m, m, 1.f / s, detail::sse::Mul() );
+    return m;
+}
+
+inline float4& operator += ( float4& m1, const float4& m2 )
+{
+    detail::sse::Map( m1, m1, m2, detail::sse::Add() );
+    return m1;
+}
+
+inline float4& operator -= ( float4& m1, const float4& m2 )
+{
+    detail::sse::Map( m1, m1, m2, detail::sse::Sub() );
+    return m1;
+}
+
+inline float4& operator *= ( float4& m1, const float4& m2 )
+{
+    detail::sse::Map( m1, m1, m2, detail::sse::Mul() );
+    return m1;
+}
+
+inline float4& operator /= ( float4& m1, const float4& m2 )
+{
+    detail::sse::Map( m1, m1, m2, detail::sse::Div() );
+    return m1;
+}
+
+inline float4x4& operator += ( float4x4& m1, const float4x4& m2 )
+{
+    detail::sse::Map( m1, m1, m2, detail::sse::Add() );
+    return m1;
+}
+
+inline float4x4& operator -= ( float4x4& m1, const float4x4& m2 )
+{
+    detail::sse::Map( m1, m1, m2, detail::sse::Sub() );
+    return m1;
+}
+
+inline float4x4& operator *= ( float4x4& m1, const float4x4& m2 )
+{
+    detail::sse::Map( m1, m1, m2, detail::sse::Mul() );
+    return m1;
+}
+
+inline float4x4& operator /= ( float4x4& m1, const float4x4& m2 )
+{
+    detail::sse::Map( m1, m1, m2, detail::sse::Div() );
+    return m1;
+}
+
+//
+// Other things
+//
+
+namespace detail
+{
+namespace sse
+{
+    inline float4x4 MulMatrix( const float4x4& m1, const float4x4& m2 )
+    {
+        float4x4 ret;
+    #if defined( JOEMATH_AVX )
+        const __m256 c0 = _mm256_broadcast_ps(
+                    reinterpret_cast<const __m128*>( &m1.m_elements[0][0] ) );
+        const __m256 c1 = _mm256_broadcast_ps(
+                    reinterpret_cast<const __m128*>( &m1.m_elements[1][0] ) );
+        const __m256 c2 = _mm256_broadcast_ps(
+                    reinterpret_cast<const __m128*>( &m1.m_elements[2][0] ) );
+        const __m256 c3 = _mm256_broadcast_ps(
+                    reinterpret_cast<const __m128*>( &m1.m_elements[3][0] ) );
+
+        //
+        // Compute two columns of the result at a time
+        //
+        for( u32 i = 0; i < 4; i += 2 )
+        {
+            const __m256 v = detail::sse::Load8( &m2.m_elements[i][0] );
+            __m256 r = _mm256_mul_ps( c0, _mm256_permute_ps( v, 0x00 ) );
+            r = _mm256_add_ps( r, _mm256_mul_ps( c1,
+                                             _mm256_permute_ps( v, 0x55 ) ) );
+            r = _mm256_add_ps( r, _mm256_mul_ps( c2,
+                                             _mm256_permute_ps( v, 0xAA ) ) );
+            r = _mm256_add_ps( r, _mm256_mul_ps( c3,
+                                             _mm256_permute_ps( v, 0xFF ) ) );
+            detail::sse::Store8( &ret.m_elements[i][0], r );
+        }
+    #else
+        for( u32 i = 0; i < 4; ++i )
+            detail::sse::Store( &ret.m_elements[i][0],
+                                detail::sse::LinearCombination( m1,
+                                  detail::sse::Load( &m2.m_elements[i][0] ) ) );
+    #endif
+        return ret;
+    }
+
+    inline float4 MulVector( const float4x4& m, const float4& v )
+    {
+        float4 ret;
+        detail::sse::Store( &ret.m_elements[0][0],
+                            detail::sse::LinearCombination(
+                                m, detail::sse::Load( &v.m_elements[0][0] ) ) );
+        return ret;
+    }
+
+    inline float Determinant( const float4x4& m )
+    {
+        //
+        // This is the first column of cofactors from Inverted below,
+        // followed by the dot product with the first row
+        //
+        __m128 row0, row1, row2, row3;
+        detail::sse::LoadForCofactors( m, row0, row1, row2, row3 );
+
+        __m128 tmp;
+        __m128 minor0;
+
+        tmp    = _mm_mul_ps( row2, row3 );
+        tmp    = _mm_shuffle_ps( tmp, tmp, 0xB1 );
+        minor0 = _mm_mul_ps( row1, tmp );
+        tmp    = _mm_shuffle_ps( tmp, tmp, 0x4E );
+        minor0 = _mm_sub_ps( _mm_mul_ps( row1, tmp ), minor0 );
+
+        tmp    = _mm_mul_ps( row1, row2 );
+        tmp    = _mm_shuffle_ps( tmp, tmp, 0xB1 );
+        minor0 = _mm_add_ps( _mm_mul_ps( row3, tmp ), minor0 );
+        tmp    = _mm_shuffle_ps( tmp, tmp, 0x4E );
+        minor0 = _mm_sub_ps( minor0, _mm_mul_ps( row3, tmp ) );
+
+        tmp    = _mm_mul_ps( _mm_shuffle_ps( row1, row1, 0x4E ), row3 );
+        tmp    = _mm_shuffle_ps( tmp, tmp, 0xB1 );
+        row2   = _mm_shuffle_ps( row2, row2, 0x4E );
+        minor0 = _mm_add_ps( _mm_mul_ps( row2, tmp ), minor0 );
+        tmp    = _mm_shuffle_ps( tmp, tmp, 0x4E );
+        minor0 = _mm_sub_ps( minor0, _mm_mul_ps( row2, tmp ) );
+
+        return _mm_cvtss_f32(
+                    detail::sse::HorizontalSum( _mm_mul_ps( row0, minor0 ) ) );
+    }
+
+    inline float4x4 Transposed( const float4x4& m )
+    {
+        __m128 c0 = detail::sse::Load( &m.m_elements[0][0] );
+        __m128 c1 = detail::sse::Load( &m.m_elements[1][0] );
+        __m128 c2 = detail::sse::Load( &m.m_elements[2][0] );
+        __m128 c3 = detail::sse::Load( &m.m_elements[3][0] );
+
+        _MM_TRANSPOSE4_PS( c0, c1, c2, c3 );
+
+        float4x4 ret;
+        detail::sse::Store( &ret.m_elements[0][0], c0 );
+        detail::sse::Store( &ret.m_elements[1][0], c1 );
+        detail::sse::Store( &ret.m_elements[2][0], c2 );
+        detail::sse::Store( &ret.m_elements[3][0], c3 );
+        return ret;
+    }
+
+    inline float Dot( const float4& m0, const float4& m1 )
+    {
+        //
+        // The products are summed in order so that the result is identical to
+        // the generic Dot and Mul of a row and column vector
+        //
+        const __m128 p = _mm_mul_ps(
+                                  detail::sse::Load( &m0.m_elements[0][0] ),
+                                  detail::sse::Load( &m1.m_elements[0][0] ) );
+        __m128 ret = _mm_add_ss( p, _mm_shuffle_ps( p, p, 0x55 ) );
+        ret = _mm_add_ss( ret, _mm_movehl_ps( p, p ) );
+        ret = _mm_add_ss( ret, _mm_shuffle_ps( p, p, 0xFF ) );
+        return _mm_cvtss_f32( ret );
+    }
+
+    inline float3 Cross( const float3& m0, const float3& m1 )
+    {
+        //
+        // float3 is only 12 bytes, so load the xy pair and z separately to
+        // avoid reading past the end
+        //
+        const __m128 a = _mm_movelh_ps(
+                     detail::sse::LoadLow( &m0.m_elements[0][0] ),
+                     _mm_load_ss( &m0.m_elements[0][2] ) );
+        const __m128 b = _mm_movelh_ps(
+                     detail::sse::LoadLow( &m1.m_elements[0][0] ),
+                     _mm_load_ss( &m1.m_elements[0][2] ) );
+
+        //
+        // a * b.yzx - a.yzx * b gives the cross product in zxy order
+        //
+        const __m128 a_yzx = _mm_shuffle_ps( a, a, _MM_SHUFFLE( 3, 0, 2, 1 ) );
+        const __m128 b_yzx = _mm_shuffle_ps( b, b, _MM_SHUFFLE( 3, 0, 2, 1 ) );
+        __m128 c = _mm_sub_ps( _mm_mul_ps( a, b_yzx ), _mm_mul_ps( a_yzx, b ) );
+        c = _mm_shuffle_ps( c, c, _MM_SHUFFLE( 3, 0, 2, 1 ) );
+
+        float3 ret;
+        _mm_storel_pi( reinterpret_cast<__m64*>( &ret.m_elements[0][0] ), c );
+        _mm_store_ss( &ret.m_elements[0][2], _mm_movehl_ps( c, c ) );
+        return ret;
+    }
+}
+}
+
+inline JOEMATH_SIMD_CONSTEXPR
+float4x4 Mul( const float4x4& m1, const float4x4& m2 )
+{
+    return JOEMATH_SIMD_CONSTANT_EVALUATED ?
+           detail::constant::Mul<float>( m1, m2, detail::make_indices<16>{} ) :
+           detail::sse::MulMatrix( m1, m2 );
+}
+
+inline JOEMATH_SIMD_CONSTEXPR
+float4 Mul( const float4x4& m, const float4& v )
+{
+    return JOEMATH_SIMD_CONSTANT_EVALUATED ?
+           detail::constant::Mul<float>( m, v, detail::make_indices<4>{} ) :
+           detail::sse::MulVector( m, v );
+}
+
+inline JOEMATH_SIMD_CONSTEXPR
+float Determinant( const float4x4& m )
+{
+    return JOEMATH_SIMD_CONSTANT_EVALUATED ?
+           detail::Determinant( m, std::integral_constant<u32, 4>() ) :
+           detail::sse::Determinant( m );
+}
+
+inline JOEMATH_SIMD_CONSTEXPR
+float4x4 Transposed( const float4x4& m )
+{
+    return JOEMATH_SIMD_CONSTANT_EVALUATED ?
+           detail::constant::Transposed( m, detail::make_indices<16>{} ) :
+           detail::sse::Transposed( m );
+}
+
+inline float4x4 Inverted( const float4x4& m )
+{
+    //
+    // This is the cofactor expansion from Intel's "Streaming SIMD Extensions -
+    // Inverse of 4x4 Matrix". Because the inverse of the transpose is the
+    // transpose of the inverse, it works on our column major storage as is.
+    //
+    __m128 row0, row1, row2, row3;
+    detail::sse::LoadForCofactors( m, row0, row1, row2, row3 );
+
+    __m128 tmp;
+    __m128 minor0, minor1, minor2, minor3;
+
+    tmp    = _mm_mul_ps( row2, row3 );
+    tmp    = _mm_shuffle_ps( tmp, tmp, 0xB1 );
+    minor0 = _mm_mul_ps( row1, tmp );
+    minor1 = _mm_mul_ps( row0, tmp );
+    tmp    = _mm_shuffle_ps( tmp, tmp, 0x4E );
+    minor0 = _mm_sub_ps( _mm_mul_ps( row1, tmp ), minor0 );
+    minor1 = _mm_sub_ps( _mm_mul_ps( row0, tmp ), minor1 );
+    minor1 = _mm_shuffle_ps( minor1, minor1, 0x4E );
+
+    tmp    = _mm_mul_ps( row1, row2 );
+    tmp    = _mm_shuffle_ps( tmp, tmp, 0xB1 );
+    minor0 = _mm_add_ps( _mm_mul_ps( row3, tmp ), minor0 );
+    minor3 = _mm_mul_ps( row0, tmp );
+    tmp    = _mm_shuffle_ps( tmp, tmp, 0x4E );
+    minor0 = _mm_sub_ps( minor0, _mm_mul_ps( row3, tmp ) );
+    minor3 = _mm_sub_ps( _mm_mul_ps( row0, tmp ), minor3 );
+    minor3 = _mm_shuffle_ps( minor3, minor3, 0x4E );
+
+    tmp    = _mm_mul_ps( _mm_shuffle_ps( row1, row1, 0x4E ), row3 );
+    tmp    = _mm_shuffle_ps( tmp, tmp, 0xB1 );
+    row2   = _mm_shuffle_ps( row2, row2, 0x4E );
+    minor0 = _mm_add_ps( _mm_mul_ps( row2, tmp ), minor0 );
+    minor2 = _mm_mul_ps( row0, tmp );
+    tmp    = _mm_shuffle_ps( tmp, tmp, 0x4E );
+    minor0 = _mm_sub_ps( minor0, _mm_mul_ps( row2, tmp ) );
+    minor2 = _mm_sub_ps( _mm_mul_ps( row0, tmp ), minor2 );
+    minor2 = _mm_shuffle_ps( minor2, minor2, 0x4E );
+
+    tmp    = _mm_mul_ps( row0, row1 );
+    tmp    = _mm_shuffle_ps( tmp, tmp, 0xB1 );
+    minor2 = _mm_add_ps( _mm_mul_ps( row3, tmp ), minor2 );
+    minor3 = _mm_sub_ps( _mm_mul_ps( row2, tmp ), minor3 );
+    tmp    = _mm_shuffle_ps( tmp, tmp, 0x4E );
+    minor2 = _mm_sub_ps( _mm_mul_ps( row3, tmp ), minor2 );
+    minor3 = _mm_sub_ps( minor3, _mm_mul_ps( row2, tmp ) );
+
+    tmp    = _mm_mul_ps( row0, row3 );
+    tmp    = _mm_shuffle_ps( tmp, tmp, 0xB1 );
+    minor1 = _mm_sub_ps( minor1, _mm_mul_ps( row2, tmp ) );
+    minor2 = _mm_add_ps( _mm_mul_ps( row1, tmp ), minor2 );
+    tmp    = _mm_shuffle_ps( tmp, tmp, 0x4E );
+    minor1 = _mm_add_ps( _mm_mul_ps( row2, tmp ), minor1 );
+    minor2 = _mm_sub_ps( minor2, _mm_mul_ps( row1, tmp ) );
+
+    tmp    = _mm_mul_ps( row0, row2 );
+    tmp    = _mm_shuffle_ps( tmp, tmp, 0xB1 );
+    minor1 = _mm_add_ps( _mm_mul_ps( row3, tmp ), minor1 );
+    minor3 = _mm_sub_ps( minor3, _mm_mul_ps( row1, tmp ) );
+    tmp    = _mm_shuffle_ps( tmp, tmp, 0x4E );
+    minor1 = _mm_sub_ps( minor1, _mm_mul_ps( row3, tmp ) );
+    minor3 = _mm_add_ps( _mm_mul_ps( row1, tmp ), minor3 );
+
+    //
+    // Like the scalar version this multiplies by the reciprocal of the
+    // determinant rather than dividing every element
+    //
+    __m128 det = detail::sse::HorizontalSum( _mm_mul_ps( row0, minor0 ) );
+    det = _mm_div_ss( _mm_set_ss( 1.f ), det );
+    det = _mm_shuffle_ps( det, det, 0x00 );
+
+    float4x4 ret;
+    detail::sse::Store( &ret.m_elements[0][0], _mm_mul_ps( det, minor0 ) );
+    detail::sse::Store( &ret.m_elements[1][0], _mm_mul_ps( det, minor1 ) );
+    detail::sse::Store( &ret.m_elements[2][0], _mm_mul_ps( det, minor2 ) );
+    detail::sse::Store( &ret.m_elements[3][0], _mm_mul_ps( det, minor3 ) );
+    return ret;
+}
+
+inline JOEMATH_SIMD_CONSTEXPR
+float Dot( const float4& m0, const float4& m1 )
+{
+    return JOEMATH_SIMD_CONSTANT_EVALUATED ?
+           detail::constant::Dot<float>( m0, m1, detail::make_indices<4>{} ) :
+           detail::sse::Dot( m0, m1 );
+}
+
+inline JOEMATH_SIMD_CONSTEXPR
+float3 Cross( const float3& m0, const float3& m1 )
+{
+    return JOEMATH_SIMD_CONSTANT_EVALUATED ?
+           JoeMath::Cross<float, 3, 1, float>( m0, m1 ) :
+           detail::sse::Cross( m0, m1 );
+}
+
+inline void SinCosFast( const float4& angles, float4& sin, float4& cos )
+{
+    __m128 s;
+    __m128 c;
+    detail::sse::SinCosFast( detail::sse::Load( &angles.m_elements[0][0] ),
+                             s, c );
+    detail::sse::Store( &sin.m_elements[0][0], s );
+    detail::sse::Store( &cos.m_elements[0][0], c );
+}
+}
+
+#endif
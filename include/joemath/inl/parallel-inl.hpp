@@ -0,0 +1,628 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include <joemath/alignment.hpp>
+#include <joemath/batch.hpp>
+#include <joemath/parallel.hpp>
+
+namespace JoeMath
+{
+
+////////////////////////////////////////////////////////////////////////////////
+// ThreadPool
+////////////////////////////////////////////////////////////////////////////////
+
+namespace detail
+{
+    //
+    // The pool whose worker is running on this thread and the worker's index,
+    // these are only read by the pool they point to
+    //
+    inline const void*& CurrentPool( )
+    {
+        static thread_local const void* pool = nullptr;
+        return pool;
+    }
+
+    inline u32& CurrentWorker( )
+    {
+        static thread_local u32 index = 0;
+        return index;
+    }
+}
+
+inline ThreadPool::ThreadPool ( u32 thread_count )
+    :m_pending( 0 )
+{
+    //
+    // The last queue is shared by the threads outside the pool
+    //
+    for( u32 i = 0; i < thread_count + 1; ++i )
+        m_queues.emplace_back( new Queue );
+
+    m_threads.reserve( thread_count );
+    for( u32 i = 0; i < thread_count; ++i )
+        m_threads.emplace_back( &ThreadPool::WorkerMain, this, i );
+}
+
+inline ThreadPool::~ThreadPool ( )
+{
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for( std::thread& thread : m_threads )
+        thread.join();
+}
+
+inline u32 ThreadPool::GetThreadCount ( ) const
+{
+    return m_threads.size();
+}
+
+inline u32 ThreadPool::DefaultThreadCount ( )
+{
+    const u32 hardware = std::thread::hardware_concurrency();
+    return hardware > 1 ? hardware - 1 : 0;
+}
+
+template <typename F>
+void ThreadPool::Run ( const void* f, u32 begin, u32 end )
+{
+    ( *static_cast<const F*>( f ) )( begin, end );
+}
+
+template <typename F>
+void ThreadPool::ParallelFor ( u32 begin, u32 end, u32 grain, const F& f )
+{
+    if( begin >= end )
+        return;
+    grain = std::max( grain, 1u );
+
+    if( m_threads.empty() || end - begin <= grain )
+    {
+        f( begin, end );
+        return;
+    }
+
+    Job job;
+    job.m_run   = &Run<F>;
+    job.m_f     = &f;
+    job.m_grain = grain;
+    job.m_remaining.store( end - begin, std::memory_order_relaxed );
+
+    Execute( Task{ &job, begin, end } );
+
+    //
+    // Help with whatever is queued until every chunk of this job is done,
+    // the job is on this stack so nothing may touch it after that
+    //
+    while( job.m_remaining.load( std::memory_order_acquire ) != 0 )
+    {
+        Task task;
+        if( Pop( task ) || Steal( task ) )
+            Execute( task );
+        else
+            std::this_thread::yield();
+    }
+}
+
+inline void ThreadPool::WorkerMain ( u32 index )
+{
+    detail::CurrentPool()   = this;
+    detail::CurrentWorker() = index;
+
+    for( ;; )
+    {
+        Task task;
+        if( Pop( task ) || Steal( task ) )
+        {
+            Execute( task );
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock( m_mutex );
+        m_wake.wait( lock, [this]
+        {
+            return m_stop || m_pending.load( std::memory_order_relaxed ) != 0;
+        } );
+        if( m_stop )
+            return;
+    }
+}
+
+inline u32 ThreadPool::GetQueueIndex ( ) const
+{
+    return detail::CurrentPool() == this ? detail::CurrentWorker() :
+                                           u32( m_threads.size() );
+}
+
+//
+// m_pending is incremented before the task is visible, so a worker can never
+// go to sleep while there's a task in a queue. It's incremented under m_mutex
+// so that the wake up can't be missed between the check and the wait.
+//
+inline void ThreadPool::Push ( const Task& task )
+{
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        m_pending.fetch_add( 1, std::memory_order_relaxed );
+    }
+
+    Queue& queue = *m_queues[GetQueueIndex()];
+    {
+        std::lock_guard<std::mutex> lock( queue.m_mutex );
+        queue.m_tasks.push_back( task );
+    }
+    m_wake.notify_one();
+}
+
+inline bool ThreadPool::Pop ( Task& task )
+{
+    Queue& queue = *m_queues[GetQueueIndex()];
+    std::lock_guard<std::mutex> lock( queue.m_mutex );
+    if( queue.m_tasks.empty() )
+        return false;
+    task = queue.m_tasks.back();
+    queue.m_tasks.pop_back();
+    m_pending.fetch_sub( 1, std::memory_order_relaxed );
+    return true;
+}
+
+inline bool ThreadPool::Steal ( Task& task )
+{
+    const u32 size  = m_queues.size();
+    const u32 index = GetQueueIndex();
+    for( u32 i = 1; i < size; ++i )
+    {
+        Queue& queue = *m_queues[( index + i ) % size];
+        std::lock_guard<std::mutex> lock( queue.m_mutex );
+        if( queue.m_tasks.empty() )
+            continue;
+        task = queue.m_tasks.front();
+        queue.m_tasks.pop_front();
+        m_pending.fetch_sub( 1, std::memory_order_relaxed );
+        return true;
+    }
+    return false;
+}
+
+//
+// The task is halved at a multiple of the grain until it's no bigger than
+// the grain, pushing the upper halves for other threads to steal
+//
+inline void ThreadPool::Execute ( Task task )
+{
+    Job& job = *task.m_job;
+    while( task.m_end - task.m_begin > job.m_grain )
+    {
+        const u32 chunks = ( task.m_end - task.m_begin + job.m_grain - 1 ) /
+                           job.m_grain;
+        const u32 middle = task.m_begin + chunks / 2 * job.m_grain;
+        Push( Task{ &job, middle, task.m_end } );
+        task.m_end = middle;
+    }
+
+    job.m_run( job.m_f, task.m_begin, task.m_end );
+    job.m_remaining.fetch_sub( task.m_end - task.m_begin,
+                               std::memory_order_release );
+}
+
+inline ThreadPool& GetThreadPool ( )
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+template <typename F>
+void ParallelFor ( u32 begin, u32 end, u32 grain, const F& f )
+{
+    GetThreadPool().ParallelFor( begin, end, grain, f );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Batch functions with execution policies
+////////////////////////////////////////////////////////////////////////////////
+
+namespace detail
+{
+    //
+    // Chunks smaller than this aren't worth handing to another thread
+    //
+    const u32 min_parallel_bytes = 16 * 1024;
+
+    //
+    // Runs the chunks of a parallel batch writing to out. The grain is
+    // rounded up to a whole number of cache lines of out, and the chunks are
+    // skewed so that their boundaries fall on cache line boundaries when the
+    // alignment of out allows it.
+    //
+    template <typename T, typename F>
+    void ParallelBatch( const execution::ParallelSimdPolicy& policy,
+                        u32 count,
+                        const T* out,
+                        u32 out_stride,
+                        const F& f )
+    {
+        if( count == 0 )
+            return;
+
+        ThreadPool& pool = policy.m_pool ? *policy.m_pool : GetThreadPool();
+
+        //
+        // The smallest number of elements which covers whole cache lines
+        //
+        const std::size_t line = cache_line_size;
+        u32 unit = 1;
+        while( unit * std::size_t( out_stride ) % line != 0 )
+            ++unit;
+
+        u32 grain = policy.m_grain;
+        if( grain == 0 )
+            grain = std::max( count / ( 4 * ( pool.GetThreadCount() + 1 ) ),
+                              min_parallel_bytes / out_stride );
+        grain = ( std::max( grain, 1u ) + unit - 1 ) / unit * unit;
+
+        //
+        // The first element to start on a cache line, the chunks are run over
+        // [0, count + skew) so that their boundaries are at first plus a
+        // multiple of unit
+        //
+        const std::size_t offset = reinterpret_cast<std::uintptr_t>( out ) %
+                                   line;
+        u32 first = 0;
+        while( first < unit &&
+               ( offset + first * std::size_t( out_stride ) ) % line != 0 )
+            ++first;
+        const u32 skew = first == unit ? 0 : ( unit - first ) % unit;
+
+        pool.ParallelFor( 0, count + skew, grain, [&]( u32 begin, u32 end )
+        {
+            f( begin > skew ? begin - skew : 0, end - skew );
+        } );
+    }
+
+    //
+    // seq runs the generic batch function, simd the batch function which
+    // uses SSE for the types it can, and par_simd the latter in parallel
+    //
+    template <typename T, typename Generic, typename Simd>
+    void RunBatch( execution::SequentialPolicy,
+                   u32 count,
+                   const T*,
+                   u32,
+                   const Generic& generic,
+                   const Simd& )
+    {
+        generic( 0, count );
+    }
+
+    template <typename T, typename Generic, typename Simd>
+    void RunBatch( execution::SimdPolicy,
+                   u32 count,
+                   const T*,
+                   u32,
+                   const Generic&,
+                   const Simd& simd )
+    {
+        simd( 0, count );
+    }
+
+    template <typename T, typename Generic, typename Simd>
+    void RunBatch( const execution::ParallelSimdPolicy& policy,
+                   u32 count,
+                   const T* out,
+                   u32 out_stride,
+                   const Generic&,
+                   const Simd& simd )
+    {
+        ParallelBatch( policy, count, out, out_stride, simd );
+    }
+}
+
+template <typename Policy, typename Scalar, u32 Size, typename>
+void    TransformPoints     ( const Policy& policy,
+                              const Matrix<Scalar, Size, Size>& m,
+                              const Vector<Scalar, Size-1>* in,
+                              Vector<Scalar, Size-1>* out,
+                              u32 count,
+                              u32 in_stride,
+                              u32 out_stride )
+{
+    detail::RunBatch( policy, count, out, out_stride,
+        [&]( u32 begin, u32 end )
+        {
+            TransformPoints<Scalar, Size>(
+                m, detail::Advance( in, begin, in_stride ),
+                detail::Advance( out, begin, out_stride ),
+                end - begin, in_stride, out_stride );
+        },
+        [&]( u32 begin, u32 end )
+        {
+            TransformPoints( m, detail::Advance( in, begin, in_stride ),
+                    detail::Advance( out, begin, out_stride ),
+                    end - begin, in_stride, out_stride );
+        } );
+}
+
+template <typename Policy, typename Scalar, u32 Size, typename>
+void    TransformVectors    ( const Policy& policy,
+                              const Matrix<Scalar, Size, Size>& m,
+                              const Vector<Scalar, Size-1>* in,
+                              Vector<Scalar, Size-1>* out,
+                              u32 count,
+                              u32 in_stride,
+                              u32 out_stride )
+{
+    detail::RunBatch( policy, count, out, out_stride,
+        [&]( u32 begin, u32 end )
+        {
+            TransformVectors<Scalar, Size>(
+                m, detail::Advance( in, begin, in_stride ),
+                detail::Advance( out, begin, out_stride ),
+                end - begin, in_stride, out_stride );
+        },
+        [&]( u32 begin, u32 end )
+        {
+            TransformVectors( m, detail::Advance( in, begin, in_stride ),
+                    detail::Advance( out, begin, out_stride ),
+                    end - begin, in_stride, out_stride );
+        } );
+}
+
+template <typename Policy, typename Scalar, u32 Size, typename>
+void    TransformHomogeneous( const Policy& policy,
+                              const Matrix<Scalar, Size, Size>& m,
+                              const Vector<Scalar, Size>* in,
+                              Vector<Scalar, Size>* out,
+                              u32 count,
+                              u32 in_stride,
+                              u32 out_stride )
+{
+    detail::RunBatch( policy, count, out, out_stride,
+        [&]( u32 begin, u32 end )
+        {
+            TransformHomogeneous<Scalar, Size>(
+                m, detail::Advance( in, begin, in_stride ),
+                detail::Advance( out, begin, out_stride ),
+                end - begin, in_stride, out_stride );
+        },
+        [&]( u32 begin, u32 end )
+        {
+            TransformHomogeneous( m, detail::Advance( in, begin, in_stride ),
+                    detail::Advance( out, begin, out_stride ),
+                    end - begin, in_stride, out_stride );
+        } );
+}
+
+template <typename Policy, typename Scalar, u32 Size, typename>
+void    InvertBatch         ( const Policy& policy,
+                              const Matrix<Scalar, Size, Size>* in,
+                              Matrix<Scalar, Size, Size>* out,
+                              u32 count,
+                              bool* singular )
+{
+    detail::RunBatch( policy, count, out, sizeof(*out),
+        [&]( u32 begin, u32 end )
+        {
+            InvertBatch<Scalar, Size>( in + begin, out + begin, end - begin,
+                                       singular ? singular + begin : nullptr );
+        },
+        [&]( u32 begin, u32 end )
+        {
+            InvertBatch( in + begin, out + begin, end - begin,
+                         singular ? singular + begin : nullptr );
+        } );
+}
+
+template <typename Policy, typename Scalar, u32 Size, typename>
+void    NormalizedPrecise   ( const Policy& policy,
+                              const Vector<Scalar, Size>* in,
+                              Vector<Scalar, Size>* out,
+                              u32 count )
+{
+    detail::RunBatch( policy, count, out, sizeof(*out),
+        [&]( u32 begin, u32 end )
+        {
+            NormalizedPrecise<Scalar, Size>( in + begin, out + begin,
+                                             end - begin );
+        },
+        [&]( u32 begin, u32 end )
+        {
+            NormalizedPrecise( in + begin, out + begin, end - begin );
+        } );
+}
+
+template <typename Policy, typename Scalar, u32 Size, typename>
+void    NormalizedFast      ( const Policy& policy,
+                              const Vector<Scalar, Size>* in,
+                              Vector<Scalar, Size>* out,
+                              u32 count )
+{
+    detail::RunBatch( policy, count, out, sizeof(*out),
+        [&]( u32 begin, u32 end )
+        {
+            NormalizedFast<Scalar, Size>( in + begin, out + begin,
+                                          end - begin );
+        },
+        [&]( u32 begin, u32 end )
+        {
+            NormalizedFast( in + begin, out + begin, end - begin );
+        } );
+}
+
+template <typename Policy, typename Scalar, u32 Size, typename>
+void    NormalizedSafe      ( const Policy& policy,
+                              const Vector<Scalar, Size>* in,
+                              Vector<Scalar, Size>* out,
+                              u32 count,
+                              const Vector<Scalar, Size>& fallback )
+{
+    detail::RunBatch( policy, count, out, sizeof(*out),
+        [&]( u32 begin, u32 end )
+        {
+            NormalizedSafe<Scalar, Size>( in + begin, out + begin, end - begin,
+                                          fallback );
+        },
+        [&]( u32 begin, u32 end )
+        {
+            NormalizedSafe( in + begin, out + begin, end - begin, fallback );
+        } );
+}
+
+template <typename Policy, typename Scalar, u32 Size, typename>
+void    LengthFast          ( const Policy& policy,
+                              const Vector<Scalar, Size>* in,
+                              Scalar* out,
+                              u32 count )
+{
+    detail::RunBatch( policy, count, out, sizeof(*out),
+        [&]( u32 begin, u32 end )
+        {
+            LengthFast<Scalar, Size>( in + begin, out + begin, end - begin );
+        },
+        [&]( u32 begin, u32 end )
+        {
+            LengthFast( in + begin, out + begin, end - begin );
+        } );
+}
+
+template <typename Policy, typename Scalar, u32 Size, typename>
+void    InverseLength       ( const Policy& policy,
+                              const Vector<Scalar, Size>* in,
+                              Scalar* out,
+                              u32 count )
+{
+    detail::RunBatch( policy, count, out, sizeof(*out),
+        [&]( u32 begin, u32 end )
+        {
+            InverseLength<Scalar, Size>( in + begin, out + begin, end - begin );
+        },
+        [&]( u32 begin, u32 end )
+        {
+            InverseLength( in + begin, out + begin, end - begin );
+        } );
+}
+
+template <typename Policy, typename Scalar, u32 Size, typename>
+void    RotateZBatch        ( const Policy& policy,
+                              const Scalar* angles,
+                              Matrix<Scalar, Size, Size>* out,
+                              u32 count )
+{
+    detail::RunBatch( policy, count, out, sizeof(*out),
+        [&]( u32 begin, u32 end )
+        {
+            RotateZBatch<Scalar, Size>( angles + begin, out + begin,
+                                        end - begin );
+        },
+        [&]( u32 begin, u32 end )
+        {
+            RotateZBatch( angles + begin, out + begin, end - begin );
+        } );
+}
+
+template <typename Policy, typename Scalar, typename>
+void    EigenSymmetricBatch ( const Policy& policy,
+                              const Matrix<Scalar, 3, 3>* in,
+                              EigenDecomposition<Scalar>* out,
+                              u32 count )
+{
+    detail::RunBatch( policy, count, out, sizeof(*out),
+        [&]( u32 begin, u32 end )
+        {
+            EigenSymmetricBatch<Scalar>( in + begin, out + begin, end - begin );
+        },
+        [&]( u32 begin, u32 end )
+        {
+            EigenSymmetricBatch( in + begin, out + begin, end - begin );
+        } );
+}
+
+template <typename Policy, typename Scalar, typename>
+void    SVDBatch            ( const Policy& policy,
+                              const Matrix<Scalar, 3, 3>* in,
+                              SingularValueDecomposition<Scalar>* out,
+                              u32 count )
+{
+    detail::RunBatch( policy, count, out, sizeof(*out),
+        [&]( u32 begin, u32 end )
+        {
+            SVDBatch<Scalar>( in + begin, out + begin, end - begin );
+        },
+        [&]( u32 begin, u32 end )
+        {
+            SVDBatch( in + begin, out + begin, end - begin );
+        } );
+}
+
+template <typename Policy, typename Scalar, u32 Size, typename>
+void    OrthonormalizeBatch ( const Policy& policy,
+                              const Matrix<Scalar, Size, Size>* in,
+                              Matrix<Scalar, Size, Size>* out,
+                              u32 count )
+{
+    detail::RunBatch( policy, count, out, sizeof(*out),
+        [&]( u32 begin, u32 end )
+        {
+            OrthonormalizeBatch<Scalar, Size>( in + begin, out + begin,
+                                               end - begin );
+        },
+        [&]( u32 begin, u32 end )
+        {
+            OrthonormalizeBatch( in + begin, out + begin, end - begin );
+        } );
+}
+
+template <typename Policy, typename Scalar, typename>
+void    PolarDecomposeBatch ( const Policy& policy,
+                              const Matrix<Scalar, 3, 3>* in,
+                              PolarDecomposition<Scalar>* out,
+                              u32 count )
+{
+    detail::RunBatch( policy, count, out, sizeof(*out),
+        [&]( u32 begin, u32 end )
+        {
+            PolarDecomposeBatch<Scalar>( in + begin, out + begin, end - begin );
+        },
+        [&]( u32 begin, u32 end )
+        {
+            PolarDecomposeBatch( in + begin, out + begin, end - begin );
+        } );
+}
+
+}
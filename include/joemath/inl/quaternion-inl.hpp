@@ -0,0 +1,620 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <joemath/matrix.hpp>
+#include <joemath/quaternion.hpp>
+#include <joemath/simd.hpp>
+
+namespace JoeMath
+{
+////////////////////////////////////////
+////////////////////////////////////////
+// Quaternion members
+////////////////////////////////////////
+////////////////////////////////////////
+
+template <typename Scalar>
+Quaternion<Scalar>::Quaternion( )
+{
+}
+
+template <typename Scalar>
+Quaternion<Scalar>::Quaternion( Scalar x, Scalar y, Scalar z, Scalar w )
+    :m_xyzw( x, y, z, w )
+{
+}
+
+template <typename Scalar>
+Quaternion<Scalar>::Quaternion( const Vector<Scalar, 3>& xyz, Scalar w )
+    :m_xyzw( xyz, w )
+{
+}
+
+template <typename Scalar>
+Quaternion<Scalar>::Quaternion( const Vector<Scalar, 4>& xyzw )
+    :m_xyzw( xyzw )
+{
+}
+
+template <typename Scalar>
+const Scalar& Quaternion<Scalar>::x( ) const
+{
+    return m_xyzw.x();
+}
+
+template <typename Scalar>
+Scalar& Quaternion<Scalar>::x( )
+{
+    return m_xyzw.x();
+}
+
+template <typename Scalar>
+const Scalar& Quaternion<Scalar>::y( ) const
+{
+    return m_xyzw.y();
+}
+
+template <typename Scalar>
+Scalar& Quaternion<Scalar>::y( )
+{
+    return m_xyzw.y();
+}
+
+template <typename Scalar>
+const Scalar& Quaternion<Scalar>::z( ) const
+{
+    return m_xyzw.z();
+}
+
+template <typename Scalar>
+Scalar& Quaternion<Scalar>::z( )
+{
+    return m_xyzw.z();
+}
+
+template <typename Scalar>
+const Scalar& Quaternion<Scalar>::w( ) const
+{
+    return m_xyzw.w();
+}
+
+template <typename Scalar>
+Scalar& Quaternion<Scalar>::w( )
+{
+    return m_xyzw.w();
+}
+
+template <typename Scalar>
+const Vector<Scalar, 3>& Quaternion<Scalar>::xyz( ) const
+{
+    return m_xyzw.xyz();
+}
+
+template <typename Scalar>
+Vector<Scalar, 3>& Quaternion<Scalar>::xyz( )
+{
+    return m_xyzw.xyz();
+}
+
+template <typename Scalar>
+const Vector<Scalar, 4>& Quaternion<Scalar>::xyzw( ) const
+{
+    return m_xyzw;
+}
+
+template <typename Scalar>
+Vector<Scalar, 4>& Quaternion<Scalar>::xyzw( )
+{
+    return m_xyzw;
+}
+
+////////////////////////////////////////
+////////////////////////////////////////
+// Operators on quaternions
+////////////////////////////////////////
+////////////////////////////////////////
+
+template <typename Scalar>
+Quaternion<Scalar>  operator -  ( const Quaternion<Scalar>& q )
+{
+    return Quaternion<Scalar>( -q.m_xyzw );
+}
+
+template <typename Scalar>
+Quaternion<Scalar>  operator +  ( const Quaternion<Scalar>& q0,
+                                  const Quaternion<Scalar>& q1 )
+{
+    return Quaternion<Scalar>( q0.m_xyzw + q1.m_xyzw );
+}
+
+template <typename Scalar>
+Quaternion<Scalar>  operator -  ( const Quaternion<Scalar>& q0,
+                                  const Quaternion<Scalar>& q1 )
+{
+    return Quaternion<Scalar>( q0.m_xyzw - q1.m_xyzw );
+}
+
+template <typename Scalar>
+Quaternion<Scalar>  operator *  ( const Quaternion<Scalar>& q0,
+                                  const Quaternion<Scalar>& q1 )
+{
+    const Vector<Scalar, 3>& v0 = q0.xyz();
+    const Vector<Scalar, 3>& v1 = q1.xyz();
+    return Quaternion<Scalar>( q0.w() * v1 + q1.w() * v0 + Cross( v0, v1 ),
+                               q0.w() * q1.w() - Dot( v0, v1 ) );
+}
+
+template <typename Scalar, typename Scalar2, typename>
+Quaternion<Scalar>  operator *  ( const Quaternion<Scalar>& q, Scalar2 s )
+{
+    return Quaternion<Scalar>( q.m_xyzw * Scalar( s ) );
+}
+
+template <typename Scalar, typename Scalar2, typename>
+Quaternion<Scalar>  operator *  ( Scalar2 s, const Quaternion<Scalar>& q )
+{
+    return Quaternion<Scalar>( Scalar( s ) * q.m_xyzw );
+}
+
+template <typename Scalar>
+Quaternion<Scalar>& operator += ( Quaternion<Scalar>& q0,
+                                  const Quaternion<Scalar>& q1 )
+{
+    q0.m_xyzw += q1.m_xyzw;
+    return q0;
+}
+
+template <typename Scalar>
+Quaternion<Scalar>& operator -= ( Quaternion<Scalar>& q0,
+                                  const Quaternion<Scalar>& q1 )
+{
+    q0.m_xyzw -= q1.m_xyzw;
+    return q0;
+}
+
+template <typename Scalar>
+Quaternion<Scalar>& operator *= ( Quaternion<Scalar>& q0,
+                                  const Quaternion<Scalar>& q1 )
+{
+    q0 = q0 * q1;
+    return q0;
+}
+
+template <typename Scalar>
+bool                operator == ( const Quaternion<Scalar>& q0,
+                                  const Quaternion<Scalar>& q1 )
+{
+    return q0.m_xyzw == q1.m_xyzw;
+}
+
+template <typename Scalar>
+bool                operator != ( const Quaternion<Scalar>& q0,
+                                  const Quaternion<Scalar>& q1 )
+{
+    return !( q0 == q1 );
+}
+
+////////////////////////////////////////
+////////////////////////////////////////
+// Functions on quaternions
+////////////////////////////////////////
+////////////////////////////////////////
+
+template <typename Scalar>
+Scalar              Dot         ( const Quaternion<Scalar>& q0,
+                                  const Quaternion<Scalar>& q1 )
+{
+    return Dot( q0.m_xyzw, q1.m_xyzw );
+}
+
+template <typename Scalar>
+Scalar              LengthSq    ( const Quaternion<Scalar>& q )
+{
+    return LengthSq( q.m_xyzw );
+}
+
+template <typename Scalar>
+Scalar              Length      ( const Quaternion<Scalar>& q )
+{
+    return std::sqrt( LengthSq( q ) );
+}
+
+template <typename Scalar>
+void                Normalize   ( Quaternion<Scalar>& q )
+{
+    q = Normalized( q );
+}
+
+template <typename Scalar>
+Quaternion<Scalar>  Normalized  ( const Quaternion<Scalar>& q )
+{
+    return q * ( Scalar{1} / Length( q ) );
+}
+
+template <typename Scalar>
+void                Conjugate   ( Quaternion<Scalar>& q )
+{
+    q.xyz() = -q.xyz();
+}
+
+template <typename Scalar>
+Quaternion<Scalar>  Conjugated  ( const Quaternion<Scalar>& q )
+{
+    return Quaternion<Scalar>( -q.xyz(), q.w() );
+}
+
+template <typename Scalar>
+void                Invert      ( Quaternion<Scalar>& q )
+{
+    q = Inverted( q );
+}
+
+template <typename Scalar>
+Quaternion<Scalar>  Inverted    ( const Quaternion<Scalar>& q )
+{
+    return Conjugated( q ) * ( Scalar{1} / LengthSq( q ) );
+}
+
+template <typename Scalar>
+Vector<Scalar, 3>   Rotate      ( const Quaternion<Scalar>& q,
+                                  const Vector<Scalar, 3>& v )
+{
+    //
+    // q * v * q^-1 expanded for a normalized q
+    //
+    const Vector<Scalar, 3> t = Scalar{2} * Cross( q.xyz(), v );
+    return v + q.w() * t + Cross( q.xyz(), t );
+}
+
+template <typename Scalar, typename U>
+Quaternion<Scalar>  Nlerp       ( const Quaternion<Scalar>& q0,
+                                  const Quaternion<Scalar>& q1,
+                                  U t )
+{
+    const Quaternion<Scalar> end = Dot( q0, q1 ) < Scalar{0} ? -q1 : q1;
+    return Normalized( q0 + ( end - q0 ) * Scalar( t ) );
+}
+
+template <typename Scalar, typename U>
+Quaternion<Scalar>  Slerp       ( const Quaternion<Scalar>& q0,
+                                  const Quaternion<Scalar>& q1,
+                                  U t )
+{
+    Scalar cos_angle = Dot( q0, q1 );
+    Quaternion<Scalar> end = q1;
+    if( cos_angle < Scalar{0} )
+    {
+        cos_angle = -cos_angle;
+        end = -q1;
+    }
+
+    //
+    // The weights are sin( (1-t) * angle ) / sin( angle ) and
+    // sin( t * angle ) / sin( angle ), which can't be calculated when the
+    // quaternions are the same. They're indistinguishable from lerping well
+    // before then.
+    //
+    const Scalar angle = std::acos( std::min( cos_angle, Scalar{1} ) );
+    const Scalar sin_angle = std::sin( angle );
+    if( sin_angle <= std::numeric_limits<Scalar>::epsilon() )
+        return Nlerp( q0, end, t );
+
+    const Scalar w0 = std::sin( ( Scalar{1} - Scalar( t ) ) * angle ) /
+                      sin_angle;
+    const Scalar w1 = std::sin( Scalar( t ) * angle ) / sin_angle;
+    return q0 * w0 + end * w1;
+}
+
+template <typename Scalar>
+void                Slerp       ( const Quaternion<Scalar>* q0,
+                                  const Quaternion<Scalar>* q1,
+                                  Scalar t,
+                                  Quaternion<Scalar>* out,
+                                  u32 count )
+{
+    for( u32 i = 0; i < count; ++i )
+        out[i] = Slerp( q0[i], q1[i], t );
+}
+
+namespace detail
+{
+    //
+    // The coefficients of the polynomial approximation of the slerp weights
+    // from "A Fast and Accurate Algorithm for Computing SLERP" by David
+    // Eberly. The last pair is scaled to minimize the error of truncating the
+    // series, with 12 terms the weights are within 1e-6 of the exact ones for
+    // any pair of normalized quaternions.
+    //
+    const u32 SLERP_TERMS = 12;
+    const float SLERP_MU = 1.894f;
+
+    const float slerp_u[SLERP_TERMS] = { 1.f / (1 * 3),   1.f / (2 * 5),
+                                         1.f / (3 * 7),   1.f / (4 * 9),
+                                         1.f / (5 * 11),  1.f / (6 * 13),
+                                         1.f / (7 * 15),  1.f / (8 * 17),
+                                         1.f / (9 * 19),  1.f / (10 * 21),
+                                         1.f / (11 * 23),
+                                         SLERP_MU / (12 * 25) };
+    const float slerp_v[SLERP_TERMS] = { 1.f / 3,   2.f / 5,
+                                         3.f / 7,   4.f / 9,
+                                         5.f / 11,  6.f / 13,
+                                         7.f / 15,  8.f / 17,
+                                         9.f / 19,  10.f / 21,
+                                         11.f / 23,
+                                         SLERP_MU * 12 / 25 };
+
+    //
+    // sin( t * angle ) / sin( angle ) for 0 <= cos( angle ) <= 1
+    //
+    inline float SlerpWeight( float cos_angle_minus_1, float t )
+    {
+        const float t_sq = t * t;
+        float c = 1;
+        for( u32 i = SLERP_TERMS; i-- > 0; )
+            c = 1 + ( slerp_u[i] * t_sq - slerp_v[i] ) *
+                    cos_angle_minus_1 * c;
+        return c * t;
+    }
+
+    inline Quaternion<float> SlerpApproximate( const Quaternion<float>& q0,
+                                               const Quaternion<float>& q1,
+                                               float t )
+    {
+        //
+        // This is written out so that the SSE version does the same
+        // operations in the same order
+        //
+        float cos_angle = q0.x() * q1.x() + q0.y() * q1.y() +
+                          q0.z() * q1.z() + q0.w() * q1.w();
+        float sign = 1;
+        if( cos_angle < 0 )
+        {
+            cos_angle = -cos_angle;
+            sign = -1;
+        }
+
+        const float w0 = SlerpWeight( cos_angle - 1, 1 - t );
+        const float w1 = SlerpWeight( cos_angle - 1, t ) * sign;
+
+        Quaternion<float> ret;
+        for( u32 i = 0; i < 4; ++i )
+            ret.m_xyzw[i] = q0.m_xyzw[i] * w0 + q1.m_xyzw[i] * w1;
+        return ret;
+    }
+
+#if defined( JOEMATH_SSE )
+namespace sse
+{
+    inline __m128 SlerpWeight( __m128 cos_angle_minus_1, __m128 t )
+    {
+        const __m128 t_sq = _mm_mul_ps( t, t );
+        const __m128 one = _mm_set1_ps( 1 );
+        __m128 c = one;
+        for( u32 i = SLERP_TERMS; i-- > 0; )
+        {
+            __m128 b = _mm_sub_ps( _mm_mul_ps( _mm_set1_ps( slerp_u[i] ), t_sq ),
+                                   _mm_set1_ps( slerp_v[i] ) );
+            b = _mm_mul_ps( _mm_mul_ps( b, cos_angle_minus_1 ), c );
+            c = _mm_add_ps( one, b );
+        }
+        return _mm_mul_ps( c, t );
+    }
+}
+#endif
+}
+
+inline void         Slerp       ( const Quaternion<float>* q0,
+                                  const Quaternion<float>* q1,
+                                  float t,
+                                  Quaternion<float>* out,
+                                  u32 count )
+{
+    static_assert( sizeof( Quaternion<float> ) == 4 * sizeof( float ),
+                   "Quaternion<float> isn't packed" );
+
+    u32 i = 0;
+
+#if defined( JOEMATH_SSE )
+    //
+    // Four quaternions at a time, transposed so that each register holds one
+    // component of all four
+    //
+    const __m128 one = _mm_set1_ps( 1 );
+    const __m128 sign_bit = _mm_set1_ps( -0.f );
+    const __m128 t0 = _mm_set1_ps( 1 - t );
+    const __m128 t1 = _mm_set1_ps( t );
+
+    for( ; i + 4 <= count; i += 4 )
+    {
+        const float* a = &q0[i].m_xyzw[0];
+        const float* b = &q1[i].m_xyzw[0];
+
+        __m128 ax = detail::sse::Load( a );
+        __m128 ay = detail::sse::Load( a + 4 );
+        __m128 az = detail::sse::Load( a + 8 );
+        __m128 aw = detail::sse::Load( a + 12 );
+        _MM_TRANSPOSE4_PS( ax, ay, az, aw );
+
+        __m128 bx = detail::sse::Load( b );
+        __m128 by = detail::sse::Load( b + 4 );
+        __m128 bz = detail::sse::Load( b + 8 );
+        __m128 bw = detail::sse::Load( b + 12 );
+        _MM_TRANSPOSE4_PS( bx, by, bz, bw );
+
+        __m128 cos_angle = _mm_add_ps( _mm_add_ps( _mm_add_ps(
+                                            _mm_mul_ps( ax, bx ),
+                                            _mm_mul_ps( ay, by ) ),
+                                            _mm_mul_ps( az, bz ) ),
+                                            _mm_mul_ps( aw, bw ) );
+
+        //
+        // Take the shortest path by negating the weight of q1 where the dot
+        // product is negative
+        //
+        const __m128 sign = _mm_and_ps( _mm_cmplt_ps( cos_angle,
+                                                      _mm_setzero_ps() ),
+                                        sign_bit );
+        cos_angle = _mm_xor_ps( cos_angle, sign );
+
+        const __m128 x = _mm_sub_ps( cos_angle, one );
+        const __m128 w0 = detail::sse::SlerpWeight( x, t0 );
+        const __m128 w1 = _mm_xor_ps( detail::sse::SlerpWeight( x, t1 ), sign );
+
+        __m128 rx = _mm_add_ps( _mm_mul_ps( ax, w0 ), _mm_mul_ps( bx, w1 ) );
+        __m128 ry = _mm_add_ps( _mm_mul_ps( ay, w0 ), _mm_mul_ps( by, w1 ) );
+        __m128 rz = _mm_add_ps( _mm_mul_ps( az, w0 ), _mm_mul_ps( bz, w1 ) );
+        __m128 rw = _mm_add_ps( _mm_mul_ps( aw, w0 ), _mm_mul_ps( bw, w1 ) );
+        _MM_TRANSPOSE4_PS( rx, ry, rz, rw );
+
+        float* r = &out[i].m_xyzw[0];
+        detail::sse::Store( r, rx );
+        detail::sse::Store( r + 4, ry );
+        detail::sse::Store( r + 8, rz );
+        detail::sse::Store( r + 12, rw );
+    }
+#endif
+
+    for( ; i < count; ++i )
+        out[i] = detail::SlerpApproximate( q0[i], q1[i], t );
+}
+
+////////////////////////////////////////
+////////////////////////////////////////
+// Useful quaternions
+////////////////////////////////////////
+////////////////////////////////////////
+
+template <typename Scalar>
+Quaternion<Scalar>  IdentityQuaternion  ( )
+{
+    return Quaternion<Scalar>( Scalar{0}, Scalar{0}, Scalar{0}, Scalar{1} );
+}
+
+template <typename Scalar>
+Quaternion<Scalar>  QuaternionAxisAngle ( const Vector<Scalar, 3>& axis,
+                                          Scalar angle )
+{
+    Scalar sin;
+    Scalar cos;
+    SinCosFast( angle / Scalar{2}, sin, cos );
+    return Quaternion<Scalar>( axis * sin, cos );
+}
+
+template <u32 Size, typename Scalar>
+Matrix<Scalar, Size, Size>  ToMatrix    ( const Quaternion<Scalar>& q )
+{
+    static_assert( Size == 3 || Size == 4,
+                   "Trying to convert a quaternion to a matrix which isn't "
+                   "3x3 or 4x4" );
+
+    const Scalar x2 = q.x() + q.x();
+    const Scalar y2 = q.y() + q.y();
+    const Scalar z2 = q.z() + q.z();
+    const Scalar xx = q.x() * x2;
+    const Scalar yy = q.y() * y2;
+    const Scalar zz = q.z() * z2;
+    const Scalar xy = q.x() * y2;
+    const Scalar xz = q.x() * z2;
+    const Scalar yz = q.y() * z2;
+    const Scalar wx = q.w() * x2;
+    const Scalar wy = q.w() * y2;
+    const Scalar wz = q.w() * z2;
+
+    Matrix<Scalar, Size, Size> ret = Identity<Scalar, Size>();
+
+    ret.m_elements[0][0] = Scalar{1} - ( yy + zz );
+    ret.m_elements[0][1] = xy + wz;
+    ret.m_elements[0][2] = xz - wy;
+
+    ret.m_elements[1][0] = xy - wz;
+    ret.m_elements[1][1] = Scalar{1} - ( xx + zz );
+    ret.m_elements[1][2] = yz + wx;
+
+    ret.m_elements[2][0] = xz + wy;
+    ret.m_elements[2][1] = yz - wx;
+    ret.m_elements[2][2] = Scalar{1} - ( xx + yy );
+
+    return ret;
+}
+
+template <typename Scalar, u32 Size>
+Quaternion<Scalar>          ToQuaternion( const Matrix<Scalar, Size, Size>& m )
+{
+    static_assert( Size >= 3,
+                   "Trying to convert a matrix smaller than 3x3 to a "
+                   "quaternion" );
+
+    //
+    // m_elements is indexed by column then row
+    //
+    const auto& e = m.m_elements;
+    const Scalar trace = e[0][0] + e[1][1] + e[2][2];
+
+    //
+    // Divide by the largest of the four components to keep this accurate
+    //
+    if( trace > Scalar{0} )
+    {
+        const Scalar s = std::sqrt( trace + Scalar{1} ) * Scalar{2};
+        return Quaternion<Scalar>( ( e[1][2] - e[2][1] ) / s,
+                                   ( e[2][0] - e[0][2] ) / s,
+                                   ( e[0][1] - e[1][0] ) / s,
+                                   s / Scalar{4} );
+    }
+    if( e[0][0] > e[1][1] && e[0][0] > e[2][2] )
+    {
+        const Scalar s = std::sqrt( Scalar{1} + e[0][0] - e[1][1] - e[2][2] ) *
+                         Scalar{2};
+        return Quaternion<Scalar>( s / Scalar{4},
+                                   ( e[1][0] + e[0][1] ) / s,
+                                   ( e[2][0] + e[0][2] ) / s,
+                                   ( e[1][2] - e[2][1] ) / s );
+    }
+    if( e[1][1] > e[2][2] )
+    {
+        const Scalar s = std::sqrt( Scalar{1} + e[1][1] - e[0][0] - e[2][2] ) *
+                         Scalar{2};
+        return Quaternion<Scalar>( ( e[1][0] + e[0][1] ) / s,
+                                   s / Scalar{4},
+                                   ( e[2][1] + e[1][2] ) / s,
+                                   ( e[2][0] - e[0][2] ) / s );
+    }
+    const Scalar s = std::sqrt( Scalar{1} + e[2][2] - e[0][0] - e[1][1] ) *
+                     Scalar{2};
+    return Quaternion<Scalar>( ( e[2][0] + e[0][2] ) / s,
+                               ( e[2][1] + e[1][2] ) / s,
+                               s / Scalar{4},
+                               ( e[0][1] - e[1][0] ) / s );
+}
+}
@@ -29,8 +29,11 @@
 #pragma once
 
 #include <joemath/scalar.hpp>
+#include <joemath/simd.hpp>
 
 #include <cassert>
+#include <cmath>
+#include <cstring>
 
 namespace JoeMath
 {
@@ -137,4 +140,204 @@ namespace JoeMath
     {
         return Length(v1 - v0);
     }
+
+#if defined( JOEMATH_SSE )
+    namespace detail
+    {
+    namespace sse
+    {
+        //
+        // The rsqrt estimate is good to 12 bits, one Newton-Raphson step,
+        // y * ( 1.5 - 0.5 * v * y * y ), doubles that. v * y * y is close to 1,
+        // so it's computed first to avoid halving v into a denormal. The
+        // batched functions use this too, so that they give the same results.
+        //
+        inline __m128 InverseSqrtFast( __m128 v )
+        {
+            const __m128 y = _mm_rsqrt_ps( v );
+            const __m128 t = _mm_mul_ps( _mm_mul_ps( _mm_mul_ps( v, y ), y ),
+                                         _mm_set1_ps( 0.5f ) );
+            return _mm_mul_ps( y, _mm_sub_ps( _mm_set1_ps( 1.5f ), t ) );
+        }
+    }
+    }
+#endif
+
+    template <typename T>
+    inline T    InverseSqrtFast ( const T v )
+    {
+        return T{1} / std::sqrt( v );
+    }
+
+    inline float InverseSqrtFast ( const float v )
+    {
+#if defined( JOEMATH_SSE )
+        return _mm_cvtss_f32( detail::sse::InverseSqrtFast( _mm_set_ss( v ) ) );
+#else
+        //
+        // Without rsqrt the estimate comes from halving the exponent in the
+        // bit pattern, which is only good to 4 bits, so this takes three steps
+        //
+        u32 i;
+        std::memcpy( &i, &v, sizeof(i) );
+        i = 0x5f375a86 - ( i >> 1 );
+        float y;
+        std::memcpy( &y, &i, sizeof(y) );
+        for( u32 step = 0; step < 3; ++step )
+            y = y * ( 1.5f - v * y * y * 0.5f );
+        return y;
+#endif
+    }
+
+    template <typename T>
+    inline void SinCos          ( const T angle, T& sin, T& cos )
+    {
+        sin = std::sin( angle );
+        cos = std::cos( angle );
+    }
+
+    template <typename T>
+    inline void SinCosFast      ( const T angle, T& sin, T& cos )
+    {
+        SinCos( angle, sin, cos );
+    }
+
+    namespace detail
+    {
+    namespace sin_cos
+    {
+        //
+        // pi/2 is split into three parts for the Cody-Waite reduction, the
+        // first two have enough trailing zeros that multiplying them by the
+        // quadrant is exact for angles up to limit
+        //
+        constexpr float two_over_pi = 0.636619772367581343f;
+        constexpr float pi_over_2_0 = 1.5703125f;
+        constexpr float pi_over_2_1 = 4.837512969970703125e-4f;
+        constexpr float pi_over_2_2 = 7.54978995489188216e-8f;
+        constexpr float limit       = 8192.f;
+
+        //
+        // The minimax polynomials from Cephes for [-pi/4, pi/4]
+        // sin(r) = r + r*z*(s0 + z*(s1 + z*s2))
+        // cos(r) = 1 - z/2 + z*z*(c0 + z*(c1 + z*c2)) where z = r*r
+        //
+        constexpr float s0 = -1.6666654611e-1f;
+        constexpr float s1 =  8.3321608736e-3f;
+        constexpr float s2 = -1.9515295891e-4f;
+        constexpr float c0 =  4.166664568298827e-2f;
+        constexpr float c1 = -1.388731625493765e-3f;
+        constexpr float c2 =  2.443315711809948e-5f;
+    }
+
+    //
+    // The result is in the quadrant j, sin(x) is sin(r), cos(r), -sin(r) or
+    // -cos(r) and cos(x) is cos(r), -sin(r), -cos(r) or sin(r). This is only
+    // valid for |x| <= limit.
+    //
+    inline void SinCosPolynomial( const float x, float& sin, float& cos )
+    {
+        using namespace sin_cos;
+        const s32 j = s32( x * two_over_pi + std::copysign( 0.5f, x ) );
+        const float fj = float( j );
+        float r = x - fj * pi_over_2_0;
+        r = r - fj * pi_over_2_1;
+        r = r - fj * pi_over_2_2;
+
+        const float z = r * r;
+        const float ps = r + r * z * ( s0 + z * ( s1 + z * s2 ) );
+        const float pc = ( 1.f - 0.5f * z ) +
+                         z * z * ( c0 + z * ( c1 + z * c2 ) );
+
+        sin = ( j & 1 ) ? pc : ps;
+        cos = ( j & 1 ) ? ps : pc;
+        if( j & 2 )
+            sin = -sin;
+        if( ( j + 1 ) & 2 )
+            cos = -cos;
+    }
+
+#if defined( JOEMATH_SSE )
+    namespace sse
+    {
+        //
+        // The same operations as the scalar version, four at a time, so that
+        // the results are identical. Doing one at a time with this is slower
+        // than the scalar version.
+        //
+        inline void SinCosPolynomial( __m128 x, __m128& sin, __m128& cos )
+        {
+            using namespace sin_cos;
+            const __m128 half = _mm_or_ps( _mm_set1_ps( 0.5f ),
+                                  _mm_and_ps( x, _mm_set1_ps( -0.f ) ) );
+            const __m128i j = _mm_cvttps_epi32( _mm_add_ps(
+                    _mm_mul_ps( x, _mm_set1_ps( two_over_pi ) ), half ) );
+            const __m128 fj = _mm_cvtepi32_ps( j );
+            __m128 r = _mm_sub_ps( x,
+                              _mm_mul_ps( fj, _mm_set1_ps( pi_over_2_0 ) ) );
+            r = _mm_sub_ps( r, _mm_mul_ps( fj, _mm_set1_ps( pi_over_2_1 ) ) );
+            r = _mm_sub_ps( r, _mm_mul_ps( fj, _mm_set1_ps( pi_over_2_2 ) ) );
+
+            const __m128 z = _mm_mul_ps( r, r );
+            __m128 ps = _mm_add_ps( _mm_set1_ps( s1 ),
+                                    _mm_mul_ps( z, _mm_set1_ps( s2 ) ) );
+            ps = _mm_add_ps( _mm_set1_ps( s0 ), _mm_mul_ps( z, ps ) );
+            ps = _mm_add_ps( r, _mm_mul_ps( _mm_mul_ps( r, z ), ps ) );
+            __m128 pc = _mm_add_ps( _mm_set1_ps( c1 ),
+                                    _mm_mul_ps( z, _mm_set1_ps( c2 ) ) );
+            pc = _mm_add_ps( _mm_set1_ps( c0 ), _mm_mul_ps( z, pc ) );
+            pc = _mm_add_ps( _mm_sub_ps( _mm_set1_ps( 1.f ),
+                                         _mm_mul_ps( _mm_set1_ps( 0.5f ), z ) ),
+                             _mm_mul_ps( _mm_mul_ps( z, z ), pc ) );
+
+            const __m128i one = _mm_set1_epi32( 1 );
+            const __m128i two = _mm_set1_epi32( 2 );
+            const __m128 swap = _mm_castsi128_ps(
+                             _mm_cmpeq_epi32( _mm_and_si128( j, one ), one ) );
+            const __m128 sin_sign = _mm_castsi128_ps(
+                             _mm_slli_epi32( _mm_and_si128( j, two ), 30 ) );
+            const __m128 cos_sign = _mm_castsi128_ps(
+                             _mm_slli_epi32( _mm_and_si128(
+                                       _mm_add_epi32( j, one ), two ), 30 ) );
+            sin = _mm_xor_ps( _mm_blendv_ps( ps, pc, swap ), sin_sign );
+            cos = _mm_xor_ps( _mm_blendv_ps( pc, ps, swap ), cos_sign );
+        }
+
+        //
+        // Lanes outside of the polynomial's range are computed with SinCos
+        //
+        inline void SinCosFast( __m128 x, __m128& sin, __m128& cos )
+        {
+            SinCosPolynomial( x, sin, cos );
+            const __m128 abs = _mm_andnot_ps( _mm_set1_ps( -0.f ), x );
+            const int in_range = _mm_movemask_ps(
+                    _mm_cmple_ps( abs, _mm_set1_ps( sin_cos::limit ) ) );
+            if( in_range == 0xf )
+                return;
+
+            float xs[4];
+            float ss[4];
+            float cs[4];
+            _mm_storeu_ps( xs, x );
+            _mm_storeu_ps( ss, sin );
+            _mm_storeu_ps( cs, cos );
+            for( u32 i = 0; i < 4; ++i )
+                if( !( in_range & ( 1 << i ) ) )
+                    SinCos( xs[i], ss[i], cs[i] );
+            sin = _mm_loadu_ps( ss );
+            cos = _mm_loadu_ps( cs );
+        }
+    }
+#endif
+    }
+
+    inline void SinCosFast      ( const float angle, float& sin, float& cos )
+    {
+        if( !( std::abs( angle ) <= detail::sin_cos::limit ) )
+        {
+            SinCos( angle, sin, cos );
+            return;
+        }
+        detail::SinCosPolynomial( angle, sin, cos );
+    }
 };
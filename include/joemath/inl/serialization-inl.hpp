@@ -0,0 +1,459 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#pragma once
+
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if !defined( _WIN32 )
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include <joemath/alignment.hpp>
+#include <joemath/matrix.hpp>
+#include <joemath/types.hpp>
+
+namespace JoeMath
+{
+
+////////////////////////////////////////////////////////////////////////////////
+// MatrixArrayHeader
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// The magic is a member of a template so that it can be defined in a header
+//
+namespace detail
+{
+namespace serialization
+{
+    template <typename = void>
+    struct Magic
+    {
+        static const char value[8];
+    };
+
+    template <typename T>
+    const char Magic<T>::value[8] = { 'J', 'M', 'M', 'A', 'T', 'A', 'R', 'R' };
+}
+}
+
+template <typename T>
+MatrixArrayHeader MatrixArrayHeader::Make( u64 count )
+{
+    MatrixArrayHeader header;
+    std::memset( &header, 0, sizeof(header) );
+    std::memcpy( header.m_magic,
+                 detail::serialization::Magic<>::value,
+                 sizeof(header.m_magic) );
+    header.m_version        = version;
+    header.m_byte_order     = byte_order_mark;
+    header.m_scalar_type    = scalar_type_of<typename T::scalar_type>::value;
+    header.m_scalar_size    = sizeof(typename T::scalar_type);
+    header.m_rows           = T::rows;
+    header.m_columns        = T::columns;
+    header.m_element_size   = sizeof(T);
+    header.m_alignment      = alignof(T);
+    header.m_count          = count;
+    header.m_data_offset    = sizeof(MatrixArrayHeader);
+    return header;
+}
+
+template <typename T>
+bool MatrixArrayHeader::IsValid( std::size_t file_size ) const
+{
+    //
+    // The alignment is allowed to differ, the data is as aligned as anything
+    // can be when it's mapped and only the size determines the layout
+    //
+    if( std::memcmp( m_magic,
+                     detail::serialization::Magic<>::value,
+                     sizeof(m_magic) ) != 0 ||
+        m_version       != version ||
+        m_byte_order    != byte_order_mark ||
+        m_scalar_type   != scalar_type_of<typename T::scalar_type>::value ||
+        m_scalar_size   != sizeof(typename T::scalar_type) ||
+        m_rows          != T::rows ||
+        m_columns       != T::columns ||
+        m_element_size  != sizeof(T) )
+        return false;
+
+    if( m_data_offset < sizeof(MatrixArrayHeader) ||
+        m_data_offset % alignof(T) != 0 ||
+        m_data_offset > file_size )
+        return false;
+
+    //
+    // Written so that a huge count can't overflow
+    //
+    return m_count <= ( file_size - m_data_offset ) / sizeof(T);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// FileMapping
+////////////////////////////////////////////////////////////////////////////////
+
+namespace detail
+{
+namespace serialization
+{
+    inline FileMapping::~FileMapping( )
+    {
+        Close();
+    }
+
+#if !defined( _WIN32 )
+
+    inline bool FileMapping::Open( const std::string& filename )
+    {
+        Close();
+
+        int fd = open( filename.c_str(), O_RDONLY );
+        if( fd < 0 )
+            return false;
+
+        struct stat info;
+        if( fstat( fd, &info ) != 0 || info.st_size <= 0 )
+        {
+            close( fd );
+            return false;
+        }
+
+        void* data = mmap( nullptr,
+                           static_cast<std::size_t>( info.st_size ),
+                           PROT_READ,
+                           MAP_SHARED,
+                           fd,
+                           0 );
+        //
+        // The mapping keeps the file open
+        //
+        close( fd );
+        if( data == MAP_FAILED )
+            return false;
+
+        m_data = static_cast<const char*>( data );
+        m_size = static_cast<std::size_t>( info.st_size );
+        return true;
+    }
+
+    inline void FileMapping::Close( )
+    {
+        if( m_data )
+            munmap( const_cast<char*>( m_data ), m_size );
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+#else
+
+    inline bool FileMapping::Open( const std::string& filename )
+    {
+        Close();
+
+        std::ifstream file( filename, std::ios::binary | std::ios::ate );
+        if( !file )
+            return false;
+        std::streamoff size = file.tellg();
+        if( size <= 0 )
+            return false;
+
+        m_buffer.resize( static_cast<std::size_t>( size ) );
+        file.seekg( 0 );
+        if( !file.read( m_buffer.data(), size ) )
+        {
+            Close();
+            return false;
+        }
+
+        m_data = m_buffer.data();
+        m_size = m_buffer.size();
+        return true;
+    }
+
+    inline void FileMapping::Close( )
+    {
+        std::vector<char, AlignedAllocator<char>>().swap( m_buffer );
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+#endif
+
+    inline void FileMapping::Swap( FileMapping& other )
+    {
+        std::swap( m_data, other.m_data );
+        std::swap( m_size, other.m_size );
+#if defined( _WIN32 )
+        m_buffer.swap( other.m_buffer );
+#endif
+    }
+
+    inline const char* FileMapping::GetData( ) const
+    {
+        return m_data;
+    }
+
+    inline std::size_t FileMapping::GetSize( ) const
+    {
+        return m_size;
+    }
+}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// MappedMatrixArray
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+MappedMatrixArray<T>::MappedMatrixArray( const std::string& filename )
+{
+    Open( filename );
+}
+
+template <typename T>
+MappedMatrixArray<T>::MappedMatrixArray( MappedMatrixArray&& other )
+{
+    *this = std::move( other );
+}
+
+template <typename T>
+MappedMatrixArray<T>& MappedMatrixArray<T>::operator=(
+                                                     MappedMatrixArray&& other )
+{
+    if( this != &other )
+    {
+        Close();
+        m_file.Swap( other.m_file );
+        std::swap( m_data, other.m_data );
+        std::swap( m_size, other.m_size );
+    }
+    return *this;
+}
+
+template <typename T>
+bool MappedMatrixArray<T>::Open( const std::string& filename )
+{
+    Close();
+
+    if( !m_file.Open( filename ) )
+        return false;
+
+    MatrixArrayHeader header;
+    if( m_file.GetSize() < sizeof(header) )
+    {
+        Close();
+        return false;
+    }
+    std::memcpy( &header, m_file.GetData(), sizeof(header) );
+
+    if( !header.IsValid<T>( m_file.GetSize() ) )
+    {
+        Close();
+        return false;
+    }
+
+    m_data = reinterpret_cast<const T*>( m_file.GetData() +
+                                         header.m_data_offset );
+    m_size = static_cast<std::size_t>( header.m_count );
+    return true;
+}
+
+template <typename T>
+void MappedMatrixArray<T>::Close( )
+{
+    m_file.Close();
+    m_data = nullptr;
+    m_size = 0;
+}
+
+template <typename T>
+bool MappedMatrixArray<T>::IsOpen( ) const
+{
+    return m_data != nullptr;
+}
+
+template <typename T>
+const T* MappedMatrixArray<T>::data( ) const
+{
+    return m_data;
+}
+
+template <typename T>
+std::size_t MappedMatrixArray<T>::size( ) const
+{
+    return m_size;
+}
+
+template <typename T>
+bool MappedMatrixArray<T>::empty( ) const
+{
+    return m_size == 0;
+}
+
+template <typename T>
+const T& MappedMatrixArray<T>::operator [] ( std::size_t i ) const
+{
+    return m_data[i];
+}
+
+template <typename T>
+typename MappedMatrixArray<T>::const_iterator MappedMatrixArray<T>::begin(
+                                                                        ) const
+{
+    return m_data;
+}
+
+template <typename T>
+typename MappedMatrixArray<T>::const_iterator MappedMatrixArray<T>::end( ) const
+{
+    return m_data + m_size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// MatrixArrayWriter
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// The buffer always holds at least one matrix
+//
+template <typename T>
+MatrixArrayWriter<T>::MatrixArrayWriter( std::size_t buffer_size )
+    :m_buffer( buffer_size < sizeof(T) ? sizeof(T)
+                                       : buffer_size - buffer_size % sizeof(T) )
+{
+}
+
+template <typename T>
+MatrixArrayWriter<T>::~MatrixArrayWriter( )
+{
+    Close();
+}
+
+template <typename T>
+bool MatrixArrayWriter<T>::Open( const std::string& filename )
+{
+    Close();
+
+    m_file.open( filename, std::ios::binary | std::ios::trunc );
+    if( !m_file )
+        return false;
+
+    m_buffer_used = 0;
+    m_count       = 0;
+
+    MatrixArrayHeader header = MatrixArrayHeader::Make<T>( 0 );
+    m_file.write( reinterpret_cast<const char*>( &header ), sizeof(header) );
+    return static_cast<bool>( m_file );
+}
+
+template <typename T>
+void MatrixArrayWriter<T>::Write( const T& m )
+{
+    if( m_buffer_used == m_buffer.size() )
+        Flush();
+    std::memcpy( m_buffer.data() + m_buffer_used, &m, sizeof(T) );
+    m_buffer_used += sizeof(T);
+    ++m_count;
+}
+
+//
+// Anything which wouldn't fit in the buffer is written straight to the file
+// rather than being copied through it
+//
+template <typename T>
+void MatrixArrayWriter<T>::Write( const T* data, std::size_t count )
+{
+    std::size_t size = count * sizeof(T);
+    if( m_buffer_used + size > m_buffer.size() )
+    {
+        Flush();
+        if( size >= m_buffer.size() )
+        {
+            m_file.write( reinterpret_cast<const char*>( data ),
+                          static_cast<std::streamsize>( size ) );
+            m_count += count;
+            return;
+        }
+    }
+    std::memcpy( m_buffer.data() + m_buffer_used, data, size );
+    m_buffer_used += size;
+    m_count += count;
+}
+
+template <typename T>
+bool MatrixArrayWriter<T>::Close( )
+{
+    if( !m_file.is_open() )
+        return false;
+
+    Flush();
+
+    MatrixArrayHeader header = MatrixArrayHeader::Make<T>( m_count );
+    m_file.seekp( 0 );
+    m_file.write( reinterpret_cast<const char*>( &header ), sizeof(header) );
+
+    bool good = static_cast<bool>( m_file );
+    m_file.close();
+    return good && !m_file.fail();
+}
+
+template <typename T>
+u64 MatrixArrayWriter<T>::GetCount( ) const
+{
+    return m_count;
+}
+
+template <typename T>
+void MatrixArrayWriter<T>::Flush( )
+{
+    m_file.write( m_buffer.data(),
+                  static_cast<std::streamsize>( m_buffer_used ) );
+    m_buffer_used = 0;
+}
+
+template <typename T>
+bool WriteMatrixArray( const std::string& filename,
+                       const T* data,
+                       std::size_t count )
+{
+    MatrixArrayWriter<T> writer( 0 );
+    if( !writer.Open( filename ) )
+        return false;
+    writer.Write( data, count );
+    return writer.Close();
+}
+}
@@ -0,0 +1,951 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
+#include <joemath/functional.hpp>
+#include <joemath/matrix.hpp>
+#include <joemath/simd.hpp>
+#include <joemath/soa.hpp>
+
+namespace JoeMath
+{
+
+////////////////////////////////////////////////////////////////////////////////
+// SoAReference
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename Container>
+SoAReference<Container>::SoAReference ( Container& container, u32 index )
+    :m_container( container )
+    ,m_index( index )
+{
+}
+
+template <typename Container>
+SoAReference<Container>::operator value_type ( ) const
+{
+    value_type ret;
+    for( u32 c = 0; c < value_type::vector_size; ++c )
+        ret.m_elements[0][c] = m_container.GetComponent( m_index, c );
+    return ret;
+}
+
+template <typename Container>
+SoAReference<Container>& SoAReference<Container>::operator = (
+                                                         const value_type& v )
+{
+    for( u32 c = 0; c < value_type::vector_size; ++c )
+        m_container.GetComponent( m_index, c ) = v.m_elements[0][c];
+    return *this;
+}
+
+template <typename Container>
+SoAReference<Container>& SoAReference<Container>::operator = (
+                                                       const SoAReference& r )
+{
+    return *this = value_type( r );
+}
+
+template <typename Container>
+typename SoAReference<Container>::scalar_type&
+                   SoAReference<Container>::operator [] ( u32 component ) const
+{
+    return m_container.GetComponent( m_index, component );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// VectorSoA
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename Scalar, u32 Size>
+VectorSoA<Scalar, Size>::VectorSoA ( u32 size )
+{
+    Resize( size );
+}
+
+template <typename Scalar, u32 Size>
+VectorSoA<Scalar, Size>::VectorSoA ( u32 size, const value_type& v )
+{
+    for( u32 c = 0; c < Size; ++c )
+        m_components[c].assign( size, v.m_elements[0][c] );
+}
+
+template <typename Scalar, u32 Size>
+VectorSoA<Scalar, Size>::VectorSoA ( const std::vector<value_type>& v )
+{
+    Resize( v.size() );
+    for( u32 i = 0; i < v.size(); ++i )
+        for( u32 c = 0; c < Size; ++c )
+            m_components[c][i] = v[i].m_elements[0][c];
+}
+
+template <typename Scalar, u32 Size>
+std::vector<typename VectorSoA<Scalar, Size>::value_type>
+                                    VectorSoA<Scalar, Size>::ToAoS ( ) const
+{
+    std::vector<value_type> ret( GetSize() );
+    for( u32 i = 0; i < ret.size(); ++i )
+        for( u32 c = 0; c < Size; ++c )
+            ret[i].m_elements[0][c] = m_components[c][i];
+    return ret;
+}
+
+template <typename Scalar, u32 Size>
+u32 VectorSoA<Scalar, Size>::GetSize ( ) const
+{
+    return m_components[0].size();
+}
+
+template <typename Scalar, u32 Size>
+void VectorSoA<Scalar, Size>::Resize ( u32 size )
+{
+    for( auto& component : m_components )
+        component.resize( size );
+}
+
+template <typename Scalar, u32 Size>
+void VectorSoA<Scalar, Size>::PushBack ( const value_type& v )
+{
+    for( u32 c = 0; c < Size; ++c )
+        m_components[c].push_back( v.m_elements[0][c] );
+}
+
+template <typename Scalar, u32 Size>
+typename VectorSoA<Scalar, Size>::reference
+                            VectorSoA<Scalar, Size>::operator [] ( u32 i )
+{
+    return reference( *this, i );
+}
+
+template <typename Scalar, u32 Size>
+typename VectorSoA<Scalar, Size>::value_type
+                            VectorSoA<Scalar, Size>::operator [] ( u32 i ) const
+{
+    value_type ret;
+    for( u32 c = 0; c < Size; ++c )
+        ret.m_elements[0][c] = m_components[c][i];
+    return ret;
+}
+
+template <typename Scalar, u32 Size>
+Scalar& VectorSoA<Scalar, Size>::GetComponent ( u32 i, u32 component )
+{
+    return m_components[component][i];
+}
+
+template <typename Scalar, u32 Size>
+const Scalar& VectorSoA<Scalar, Size>::GetComponent ( u32 i,
+                                                      u32 component ) const
+{
+    return m_components[component][i];
+}
+
+template <typename Scalar, u32 Size>
+u32 VectorSoA<Scalar, Size>::GetSpanCount ( ) const
+{
+    return 1;
+}
+
+template <typename Scalar, u32 Size>
+u32 VectorSoA<Scalar, Size>::GetSpanSize ( u32 ) const
+{
+    return GetSize();
+}
+
+template <typename Scalar, u32 Size>
+std::array<Scalar*, Size> VectorSoA<Scalar, Size>::GetSpan ( u32 )
+{
+    std::array<Scalar*, Size> ret;
+    for( u32 c = 0; c < Size; ++c )
+        ret[c] = m_components[c].data();
+    return ret;
+}
+
+template <typename Scalar, u32 Size>
+std::array<const Scalar*, Size> VectorSoA<Scalar, Size>::GetSpan ( u32 ) const
+{
+    std::array<const Scalar*, Size> ret;
+    for( u32 c = 0; c < Size; ++c )
+        ret[c] = m_components[c].data();
+    return ret;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// AoSoA
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename Scalar, u32 Size, u32 Width>
+AoSoA<Scalar, Size, Width>::AoSoA ( u32 size )
+{
+    Resize( size );
+}
+
+template <typename Scalar, u32 Size, u32 Width>
+AoSoA<Scalar, Size, Width>::AoSoA ( u32 size, const value_type& v )
+{
+    Resize( size );
+    for( u32 i = 0; i < size; ++i )
+        (*this)[i] = v;
+}
+
+template <typename Scalar, u32 Size, u32 Width>
+AoSoA<Scalar, Size, Width>::AoSoA ( const std::vector<value_type>& v )
+{
+    Resize( v.size() );
+    for( u32 i = 0; i < v.size(); ++i )
+        (*this)[i] = v[i];
+}
+
+template <typename Scalar, u32 Size, u32 Width>
+std::vector<typename AoSoA<Scalar, Size, Width>::value_type>
+                                   AoSoA<Scalar, Size, Width>::ToAoS ( ) const
+{
+    std::vector<value_type> ret( GetSize() );
+    for( u32 i = 0; i < ret.size(); ++i )
+        ret[i] = (*this)[i];
+    return ret;
+}
+
+template <typename Scalar, u32 Size, u32 Width>
+u32 AoSoA<Scalar, Size, Width>::GetSize ( ) const
+{
+    return m_size;
+}
+
+template <typename Scalar, u32 Size, u32 Width>
+void AoSoA<Scalar, Size, Width>::Resize ( u32 size )
+{
+    m_blocks.resize( ( size + Width - 1 ) / Width, Block() );
+
+    //
+    // Clear anything left over in the last block from before shrinking
+    //
+    for( u32 i = size; i < m_size && i < m_blocks.size() * Width; ++i )
+        for( u32 c = 0; c < Size; ++c )
+            GetComponent( i, c ) = Scalar{0};
+
+    m_size = size;
+}
+
+template <typename Scalar, u32 Size, u32 Width>
+void AoSoA<Scalar, Size, Width>::PushBack ( const value_type& v )
+{
+    Resize( m_size + 1 );
+    (*this)[m_size - 1] = v;
+}
+
+template <typename Scalar, u32 Size, u32 Width>
+typename AoSoA<Scalar, Size, Width>::reference
+                            AoSoA<Scalar, Size, Width>::operator [] ( u32 i )
+{
+    return reference( *this, i );
+}
+
+template <typename Scalar, u32 Size, u32 Width>
+typename AoSoA<Scalar, Size, Width>::value_type
+                       AoSoA<Scalar, Size, Width>::operator [] ( u32 i ) const
+{
+    value_type ret;
+    for( u32 c = 0; c < Size; ++c )
+        ret.m_elements[0][c] = GetComponent( i, c );
+    return ret;
+}
+
+template <typename Scalar, u32 Size, u32 Width>
+Scalar& AoSoA<Scalar, Size, Width>::GetComponent ( u32 i, u32 component )
+{
+    return m_blocks[i / Width].m_components[component][i % Width];
+}
+
+template <typename Scalar, u32 Size, u32 Width>
+const Scalar& AoSoA<Scalar, Size, Width>::GetComponent ( u32 i,
+                                                         u32 component ) const
+{
+    return m_blocks[i / Width].m_components[component][i % Width];
+}
+
+template <typename Scalar, u32 Size, u32 Width>
+u32 AoSoA<Scalar, Size, Width>::GetSpanCount ( ) const
+{
+    return m_blocks.size();
+}
+
+template <typename Scalar, u32 Size, u32 Width>
+u32 AoSoA<Scalar, Size, Width>::GetSpanSize ( u32 ) const
+{
+    return Width;
+}
+
+template <typename Scalar, u32 Size, u32 Width>
+std::array<Scalar*, Size> AoSoA<Scalar, Size, Width>::GetSpan ( u32 span )
+{
+    std::array<Scalar*, Size> ret;
+    for( u32 c = 0; c < Size; ++c )
+        ret[c] = m_blocks[span].m_components[c].data();
+    return ret;
+}
+
+template <typename Scalar, u32 Size, u32 Width>
+std::array<const Scalar*, Size> AoSoA<Scalar, Size, Width>::GetSpan (
+                                                              u32 span ) const
+{
+    std::array<const Scalar*, Size> ret;
+    for( u32 c = 0; c < Size; ++c )
+        ret[c] = m_blocks[span].m_components[c].data();
+    return ret;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Kernels
+////////////////////////////////////////////////////////////////////////////////
+
+namespace detail
+{
+    //
+    // A pack is a number of scalars which are operated on together. The
+    // kernels are written in terms of packs and instantiated for the widest
+    // one available and for ScalarPack to handle whatever is left over.
+    //
+    template <typename Scalar>
+    struct ScalarPack
+    {
+        static const u32 width = 1;
+
+        static ScalarPack Load( const Scalar* p )
+        { return ScalarPack{ *p }; }
+
+        static ScalarPack Splat( Scalar s )
+        { return ScalarPack{ s }; }
+
+        void Store( Scalar* p ) const
+        { *p = v; }
+
+        Scalar v;
+    };
+
+    template <typename Scalar>
+    ScalarPack<Scalar> operator + ( ScalarPack<Scalar> a, ScalarPack<Scalar> b )
+    { return ScalarPack<Scalar>{ a.v + b.v }; }
+
+    template <typename Scalar>
+    ScalarPack<Scalar> operator - ( ScalarPack<Scalar> a, ScalarPack<Scalar> b )
+    { return ScalarPack<Scalar>{ a.v - b.v }; }
+
+    template <typename Scalar>
+    ScalarPack<Scalar> operator * ( ScalarPack<Scalar> a, ScalarPack<Scalar> b )
+    { return ScalarPack<Scalar>{ a.v * b.v }; }
+
+    template <typename Scalar>
+    ScalarPack<Scalar> operator / ( ScalarPack<Scalar> a, ScalarPack<Scalar> b )
+    { return ScalarPack<Scalar>{ a.v / b.v }; }
+
+    template <typename Scalar>
+    ScalarPack<Scalar> Sqrt( ScalarPack<Scalar> a )
+    { return ScalarPack<Scalar>{ std::sqrt( a.v ) }; }
+
+#if defined( JOEMATH_SSE )
+    struct FloatPack4
+    {
+        static const u32 width = 4;
+
+        static FloatPack4 Load( const float* p )
+        { return FloatPack4{ _mm_loadu_ps( p ) }; }
+
+        static FloatPack4 Splat( float s )
+        { return FloatPack4{ _mm_set1_ps( s ) }; }
+
+        void Store( float* p ) const
+        { _mm_storeu_ps( p, v ); }
+
+        __m128 v;
+    };
+
+    inline FloatPack4 operator + ( FloatPack4 a, FloatPack4 b )
+    { return FloatPack4{ _mm_add_ps( a.v, b.v ) }; }
+
+    inline FloatPack4 operator - ( FloatPack4 a, FloatPack4 b )
+    { return FloatPack4{ _mm_sub_ps( a.v, b.v ) }; }
+
+    inline FloatPack4 operator * ( FloatPack4 a, FloatPack4 b )
+    { return FloatPack4{ _mm_mul_ps( a.v, b.v ) }; }
+
+    inline FloatPack4 operator / ( FloatPack4 a, FloatPack4 b )
+    { return FloatPack4{ _mm_div_ps( a.v, b.v ) }; }
+
+    inline FloatPack4 Sqrt( FloatPack4 a )
+    { return FloatPack4{ _mm_sqrt_ps( a.v ) }; }
+#endif
+
+#if defined( JOEMATH_AVX )
+    struct FloatPack8
+    {
+        static const u32 width = 8;
+
+        static FloatPack8 Load( const float* p )
+        { return FloatPack8{ _mm256_loadu_ps( p ) }; }
+
+        static FloatPack8 Splat( float s )
+        { return FloatPack8{ _mm256_set1_ps( s ) }; }
+
+        void Store( float* p ) const
+        { _mm256_storeu_ps( p, v ); }
+
+        __m256 v;
+    };
+
+    inline FloatPack8 operator + ( FloatPack8 a, FloatPack8 b )
+    { return FloatPack8{ _mm256_add_ps( a.v, b.v ) }; }
+
+    inline FloatPack8 operator - ( FloatPack8 a, FloatPack8 b )
+    { return FloatPack8{ _mm256_sub_ps( a.v, b.v ) }; }
+
+    inline FloatPack8 operator * ( FloatPack8 a, FloatPack8 b )
+    { return FloatPack8{ _mm256_mul_ps( a.v, b.v ) }; }
+
+    inline FloatPack8 operator / ( FloatPack8 a, FloatPack8 b )
+    { return FloatPack8{ _mm256_div_ps( a.v, b.v ) }; }
+
+    inline FloatPack8 Sqrt( FloatPack8 a )
+    { return FloatPack8{ _mm256_sqrt_ps( a.v ) }; }
+#endif
+
+    //
+    // The widest pack of Scalar no wider than MaxWidth
+    //
+    template <typename Scalar, u32 MaxWidth>
+    struct pack_type
+    {
+        using type = ScalarPack<Scalar>;
+    };
+
+#if defined( JOEMATH_SSE )
+    template <u32 MaxWidth>
+    struct pack_type <float, MaxWidth>
+    {
+#if defined( JOEMATH_AVX )
+        using type = typename std::conditional<
+                       ( MaxWidth >= 8 ),
+                       FloatPack8,
+                       typename std::conditional<( MaxWidth >= 4 ),
+                                                 FloatPack4,
+                                                 ScalarPack<float>>::type>::type;
+#else
+        using type = typename std::conditional<( MaxWidth >= 4 ),
+                                               FloatPack4,
+                                               ScalarPack<float>>::type;
+#endif
+    };
+#endif
+
+    //
+    // Calls kernel.Apply for every pack in [0, count)
+    //
+    template <typename Scalar, u32 MaxWidth, typename Kernel>
+    void RunKernel( u32 count, const Kernel& kernel )
+    {
+        using Pack = typename pack_type<Scalar, MaxWidth>::type;
+
+        u32 i = 0;
+        for( ; i + Pack::width <= count; i += Pack::width )
+            kernel.template Apply<Pack>( i );
+        for( ; i < count; ++i )
+            kernel.template Apply<ScalarPack<Scalar>>( i );
+    }
+
+    //
+    // Calls RunKernel on every span of out, make_kernel is given the span
+    // index and returns the kernel for it
+    //
+    template <typename Container, typename MakeKernel>
+    void ForEachSpan( Container& out, MakeKernel make_kernel )
+    {
+        for( u32 s = 0; s < out.GetSpanCount(); ++s )
+            RunKernel<typename Container::scalar_type,
+                      Container::max_pack_width>( out.GetSpanSize( s ),
+                                                  make_kernel( s ) );
+    }
+
+    //
+    // Each kernel loads everything it needs for an element before storing
+    // anything, so the output may be one of the inputs
+    //
+
+    template <typename Scalar, u32 Size, typename Op>
+    struct MapKernel
+    {
+        template <typename Pack>
+        void Apply( u32 i ) const
+        {
+            for( u32 c = 0; c < Size; ++c )
+                op( Pack::Load( a[c] + i ),
+                    Pack::Load( b[c] + i ) ).Store( out[c] + i );
+        }
+
+        std::array<const Scalar*, Size> a;
+        std::array<const Scalar*, Size> b;
+        std::array<Scalar*, Size>       out;
+        Op                              op;
+    };
+
+    template <typename Scalar, u32 Size, typename Op>
+    struct MapScalarKernel
+    {
+        template <typename Pack>
+        void Apply( u32 i ) const
+        {
+            const Pack p = Pack::Splat( s );
+            for( u32 c = 0; c < Size; ++c )
+                op( Pack::Load( a[c] + i ), p ).Store( out[c] + i );
+        }
+
+        std::array<const Scalar*, Size> a;
+        Scalar                          s;
+        std::array<Scalar*, Size>       out;
+        Op                              op;
+    };
+
+    template <typename Pack, typename Scalar, u32 Size>
+    Pack DotPack( const std::array<const Scalar*, Size>& a,
+                  const std::array<const Scalar*, Size>& b,
+                  u32 i )
+    {
+        Pack ret = Pack::Load( a[0] + i ) * Pack::Load( b[0] + i );
+        for( u32 c = 1; c < Size; ++c )
+            ret = ret + Pack::Load( a[c] + i ) * Pack::Load( b[c] + i );
+        return ret;
+    }
+
+    template <typename Scalar, u32 Size>
+    struct DotKernel
+    {
+        template <typename Pack>
+        void Apply( u32 i ) const
+        {
+            DotPack<Pack, Scalar, Size>( a, b, i ).Store( out + i );
+        }
+
+        std::array<const Scalar*, Size> a;
+        std::array<const Scalar*, Size> b;
+        Scalar*                         out;
+    };
+
+    template <typename Scalar, u32 Size>
+    struct LengthKernel
+    {
+        template <typename Pack>
+        void Apply( u32 i ) const
+        {
+            Sqrt( DotPack<Pack, Scalar, Size>( v, v, i ) ).Store( out + i );
+        }
+
+        std::array<const Scalar*, Size> v;
+        Scalar*                         out;
+    };
+
+    template <typename Scalar, u32 Size>
+    struct NormalizeKernel
+    {
+        template <typename Pack>
+        void Apply( u32 i ) const
+        {
+            const Pack inv = Pack::Splat( Scalar{1} ) /
+                             Sqrt( DotPack<Pack, Scalar, Size>( v, v, i ) );
+            for( u32 c = 0; c < Size; ++c )
+                ( Pack::Load( v[c] + i ) * inv ).Store( out[c] + i );
+        }
+
+        std::array<const Scalar*, Size> v;
+        std::array<Scalar*, Size>       out;
+    };
+
+    template <typename Scalar>
+    struct CrossKernel
+    {
+        template <typename Pack>
+        void Apply( u32 i ) const
+        {
+            const Pack ax = Pack::Load( a[0] + i );
+            const Pack ay = Pack::Load( a[1] + i );
+            const Pack az = Pack::Load( a[2] + i );
+            const Pack bx = Pack::Load( b[0] + i );
+            const Pack by = Pack::Load( b[1] + i );
+            const Pack bz = Pack::Load( b[2] + i );
+            ( ay * bz - az * by ).Store( out[0] + i );
+            ( az * bx - ax * bz ).Store( out[1] + i );
+            ( ax * by - ay * bx ).Store( out[2] + i );
+        }
+
+        std::array<const Scalar*, 3> a;
+        std::array<const Scalar*, 3> b;
+        std::array<Scalar*, 3>       out;
+    };
+
+    template <typename Scalar, u32 Size>
+    struct LerpKernel
+    {
+        template <typename Pack>
+        void Apply( u32 i ) const
+        {
+            const Pack pt = Pack::Splat( t );
+            for( u32 c = 0; c < Size; ++c )
+            {
+                const Pack p0 = Pack::Load( v0[c] + i );
+                const Pack p1 = Pack::Load( v1[c] + i );
+                ( p0 + pt * ( p1 - p0 ) ).Store( out[c] + i );
+            }
+        }
+
+        std::array<const Scalar*, Size> v0;
+        std::array<const Scalar*, Size> v1;
+        Scalar                          t;
+        std::array<Scalar*, Size>       out;
+    };
+
+    template <typename Container, typename Op>
+    void SoAMap( Container& out, const Container& a, const Container& b, Op op )
+    {
+        using Scalar = typename Container::scalar_type;
+        const u32 Size = Container::vector_size;
+        assert( a.GetSize() == b.GetSize() && out.GetSize() == a.GetSize() &&
+                "Trying to combine containers of different sizes" );
+
+        ForEachSpan( out, [&]( u32 s )
+        {
+            return MapKernel<Scalar, Size, Op>{ { a.GetSpan( s ) },
+                                                { b.GetSpan( s ) },
+                                                { out.GetSpan( s ) },
+                                                op };
+        } );
+    }
+
+    template <typename Container, typename Op>
+    void SoAMap( Container& out, const Container& a,
+                 typename Container::scalar_type s, Op op )
+    {
+        using Scalar = typename Container::scalar_type;
+        const u32 Size = Container::vector_size;
+        assert( out.GetSize() == a.GetSize() &&
+                "Trying to combine containers of different sizes" );
+
+        ForEachSpan( out, [&]( u32 span )
+        {
+            return MapScalarKernel<Scalar, Size, Op>{ { a.GetSpan( span ) },
+                                                      s,
+                                                      { out.GetSpan( span ) },
+                                                      op };
+        } );
+    }
+
+    template <typename Container>
+    typename Container::template rebind<1> SoALength( const Container& v )
+    {
+        using Scalar = typename Container::scalar_type;
+        static_assert( std::is_floating_point<Scalar>::value,
+                       "Trying to get the length of integer vectors" );
+
+        typename Container::template rebind<1> ret( v.GetSize() );
+        ForEachSpan( ret, [&]( u32 s )
+        {
+            return LengthKernel<Scalar, Container::vector_size>{
+                                            { v.GetSpan( s ) },
+                                            ret.GetSpan( s )[0] };
+        } );
+        return ret;
+    }
+
+    template <typename Container, typename T>
+    Container SoALerp( const Container& v0, const Container& v1, T t )
+    {
+        using Scalar = typename Container::scalar_type;
+        assert( v0.GetSize() == v1.GetSize() &&
+                "Trying to lerp between containers of different sizes" );
+
+        Container ret( v0.GetSize() );
+        ForEachSpan( ret, [&]( u32 s )
+        {
+            return LerpKernel<Scalar, Container::vector_size>{
+                                            { v0.GetSpan( s ) },
+                                            { v1.GetSpan( s ) },
+                                            Scalar( t ),
+                                            { ret.GetSpan( s ) } };
+        } );
+        return ret;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Arithmetic
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename Container, typename>
+Container   operator +  ( const Container& a, const Container& b )
+{
+    Container ret( a.GetSize() );
+    detail::SoAMap( ret, a, b, detail::Add() );
+    return ret;
+}
+
+template <typename Container, typename>
+Container   operator -  ( const Container& a, const Container& b )
+{
+    Container ret( a.GetSize() );
+    detail::SoAMap( ret, a, b, detail::Subtract() );
+    return ret;
+}
+
+template <typename Container, typename>
+Container   operator *  ( const Container& a, const Container& b )
+{
+    Container ret( a.GetSize() );
+    detail::SoAMap( ret, a, b, detail::Multiply() );
+    return ret;
+}
+
+template <typename Container, typename>
+Container   operator /  ( const Container& a, const Container& b )
+{
+    Container ret( a.GetSize() );
+    detail::SoAMap( ret, a, b, detail::Divide() );
+    return ret;
+}
+
+template <typename Container, typename>
+Container   operator +  ( const Container& a,
+                          const typename Container::scalar_type s )
+{
+    Container ret( a.GetSize() );
+    detail::SoAMap( ret, a, s, detail::Add() );
+    return ret;
+}
+
+template <typename Container, typename>
+Container   operator -  ( const Container& a,
+                          const typename Container::scalar_type s )
+{
+    Container ret( a.GetSize() );
+    detail::SoAMap( ret, a, s, detail::Subtract() );
+    return ret;
+}
+
+template <typename Container, typename>
+Container   operator *  ( const Container& a,
+                          const typename Container::scalar_type s )
+{
+    Container ret( a.GetSize() );
+    detail::SoAMap( ret, a, s, detail::Multiply() );
+    return ret;
+}
+
+template <typename Container, typename>
+Container   operator *  ( const typename Container::scalar_type s,
+                          const Container& a )
+{
+    return a * s;
+}
+
+template <typename Container, typename>
+Container   operator /  ( const Container& a,
+                          const typename Container::scalar_type s )
+{
+    using Scalar = typename Container::scalar_type;
+    Container ret( a.GetSize() );
+    detail::SoAMap( ret, a, Scalar{1} / s, detail::Multiply() );
+    return ret;
+}
+
+template <typename Container, typename>
+Container&  operator += ( Container& a, const Container& b )
+{
+    detail::SoAMap( a, a, b, detail::Add() );
+    return a;
+}
+
+template <typename Container, typename>
+Container&  operator -= ( Container& a, const Container& b )
+{
+    detail::SoAMap( a, a, b, detail::Subtract() );
+    return a;
+}
+
+template <typename Container, typename>
+Container&  operator *= ( Container& a, const Container& b )
+{
+    detail::SoAMap( a, a, b, detail::Multiply() );
+    return a;
+}
+
+template <typename Container, typename>
+Container&  operator /= ( Container& a, const Container& b )
+{
+    detail::SoAMap( a, a, b, detail::Divide() );
+    return a;
+}
+
+template <typename Container, typename>
+Container&  operator += ( Container& a,
+                          const typename Container::scalar_type s )
+{
+    detail::SoAMap( a, a, s, detail::Add() );
+    return a;
+}
+
+template <typename Container, typename>
+Container&  operator -= ( Container& a,
+                          const typename Container::scalar_type s )
+{
+    detail::SoAMap( a, a, s, detail::Subtract() );
+    return a;
+}
+
+template <typename Container, typename>
+Container&  operator *= ( Container& a,
+                          const typename Container::scalar_type s )
+{
+    detail::SoAMap( a, a, s, detail::Multiply() );
+    return a;
+}
+
+template <typename Container, typename>
+Container&  operator /= ( Container& a,
+                          const typename Container::scalar_type s )
+{
+    using Scalar = typename Container::scalar_type;
+    detail::SoAMap( a, a, Scalar{1} / s, detail::Multiply() );
+    return a;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Vector functions
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename Container, typename>
+typename Container::template rebind<1>  Dot         ( const Container& a,
+                                                      const Container& b )
+{
+    using Scalar = typename Container::scalar_type;
+    assert( a.GetSize() == b.GetSize() &&
+            "Trying to dot containers of different sizes" );
+
+    typename Container::template rebind<1> ret( a.GetSize() );
+    detail::ForEachSpan( ret, [&]( u32 s )
+    {
+        return detail::DotKernel<Scalar, Container::vector_size>{
+                                            { a.GetSpan( s ) },
+                                            { b.GetSpan( s ) },
+                                            ret.GetSpan( s )[0] };
+    } );
+    return ret;
+}
+
+template <typename Container, typename>
+Container                               Cross       ( const Container& a,
+                                                      const Container& b )
+{
+    using Scalar = typename Container::scalar_type;
+    static_assert( Container::vector_size == 3,
+                   "Trying to take the Cross Product between vectors of "
+                   "size != 3" );
+    assert( a.GetSize() == b.GetSize() &&
+            "Trying to cross containers of different sizes" );
+
+    Container ret( a.GetSize() );
+    detail::ForEachSpan( ret, [&]( u32 s )
+    {
+        return detail::CrossKernel<Scalar>{ { a.GetSpan( s ) },
+                                            { b.GetSpan( s ) },
+                                            { ret.GetSpan( s ) } };
+    } );
+    return ret;
+}
+
+template <typename Container, typename>
+typename Container::template rebind<1>  LengthSq    ( const Container& v )
+{
+    return Dot( v, v );
+}
+
+template <typename Container, typename>
+void                                    Normalize   ( Container& v )
+{
+    using Scalar = typename Container::scalar_type;
+    static_assert( std::is_floating_point<Scalar>::value,
+                   "Trying to normalize integer vectors" );
+
+    const Container& in = v;
+    detail::ForEachSpan( v, [&]( u32 s )
+    {
+        return detail::NormalizeKernel<Scalar, Container::vector_size>{
+                                            { in.GetSpan( s ) },
+                                            { v.GetSpan( s ) } };
+    } );
+}
+
+template <typename Container, typename>
+Container                               Normalized  ( const Container& v )
+{
+    Container ret( v );
+    Normalize( ret );
+    return ret;
+}
+
+template <typename Scalar, u32 Size>
+VectorSoA<Scalar, 1>        Length  ( const VectorSoA<Scalar, Size>& v )
+{
+    return detail::SoALength( v );
+}
+
+template <typename Scalar, u32 Size, u32 Width>
+AoSoA<Scalar, 1, Width>     Length  ( const AoSoA<Scalar, Size, Width>& v )
+{
+    return detail::SoALength( v );
+}
+
+template <typename Scalar, u32 Size, typename T>
+VectorSoA<Scalar, Size>     Lerp    ( const VectorSoA<Scalar, Size>& v0,
+                                      const VectorSoA<Scalar, Size>& v1,
+                                      const T t )
+{
+    return detail::SoALerp( v0, v1, t );
+}
+
+template <typename Scalar, u32 Size, u32 Width, typename T>
+AoSoA<Scalar, Size, Width>  Lerp    ( const AoSoA<Scalar, Size, Width>& v0,
+                                      const AoSoA<Scalar, Size, Width>& v1,
+                                      const T t )
+{
+    return detail::SoALerp( v0, v1, t );
+}
+
+}
@@ -28,7 +28,13 @@
 
 #pragma once
 
+#include <joemath/affine.hpp>
+#include <joemath/alignment.hpp>
+#include <joemath/batch.hpp>
+#include <joemath/charconv.hpp>
+#include <joemath/hierarchy.hpp>
 #include <joemath/matrix.hpp>
+#include <joemath/quaternion.hpp>
 #include <joemath/scalar.hpp>
 #include <joemath/types.hpp>
 
@@ -47,6 +47,7 @@ class Matrix
 {
 public:
     //Scalar m_elements[Columns][Rows];
+    alignas( matrix_alignment<Matrix<Scalar, Rows, Columns>>::value )
     std::array<std::array<Scalar, Rows>, Columns> m_elements;
 
     static const u32 rows = Rows;
@@ -76,7 +77,7 @@ public:
     /**
       * Initializes every value to s
       */
-    explicit Matrix     ( Scalar s );
+    constexpr explicit Matrix ( Scalar s );
 
     //explicit Matrix     ( Scalar ss[Rows * Columns] );
 
@@ -88,7 +89,7 @@ public:
     // Rows*Columns is that we can generate our own error using static_assert
     //
     template <std::size_t N>
-    explicit Matrix     ( const std::array<scalar_type, N>& elements );
+    constexpr explicit Matrix ( const std::array<scalar_type, N>& elements );
 
     /**
       * Initialize from initializer list of vectors
@@ -99,13 +100,13 @@ public:
       * Initialize from a mixed list
       */
     template <typename First, typename Second, typename... Types>
-    Matrix              ( First first, Second second, Types... elements );
+    constexpr Matrix    ( First first, Second second, Types... elements );
 
     /**
       * Convert from another matrix type
       */
     template <typename Scalar2>
-    Matrix              ( const Matrix<Scalar2, Rows, Columns> m );
+    constexpr Matrix    ( const Matrix<Scalar2, Rows, Columns>& m );
 
     /**
       * Assign from another matrix type
@@ -114,6 +115,22 @@ public:
     Matrix<Scalar, Rows, Columns>& operator =
                                     ( const Matrix<Scalar2, Rows, Columns>& m );
 
+    /**
+      * Evaluate a lazy expression from expression.hpp in a single pass
+      */
+    template <typename Expression,
+              typename = typename std::enable_if<
+                                      is_expression<Expression>::value>::type>
+    Matrix              ( const Expression& e );
+
+    /**
+      * Assign the result of a lazy expression in a single pass
+      */
+    template <typename Expression,
+              typename = typename std::enable_if<
+                                      is_expression<Expression>::value>::type>
+    Matrix<Scalar, Rows, Columns>& operator = ( const Expression& e );
+
     //
     // Setters and Getters
     //
@@ -122,9 +139,9 @@ public:
     void SetSubMatrix ( const Matrix<Scalar, Rows2, Columns2>& m );
 
     template <u32 Rows2, u32 Columns2, u32 i = 0, u32 j = 0>
-    Matrix<Scalar, Rows2, Columns2>     GetSubMatrix  ( ) const;
+    constexpr Matrix<Scalar, Rows2, Columns2> GetSubMatrix ( ) const;
 
-          row_type                      GetRow        ( u32 row )     const;
+    constexpr row_type                  GetRow        ( u32 row )     const;
 
     const column_type&                  GetColumn     ( u32 column )  const;
           column_type&                  GetColumn     ( u32 column );
@@ -155,7 +172,7 @@ public:
 
     template <bool IsVector = is_vector,
               typename = typename std::enable_if<IsVector, void>::type>
-    const scalar_type& operator    []  ( u32 i )   const;
+    constexpr const scalar_type& operator [] ( u32 i ) const;
 
     template <bool IsVector = is_vector,
               typename = typename std::enable_if<IsVector, void>::type>
@@ -174,16 +191,16 @@ public:
     // Get elements of vectors
     //
 
-    const Scalar&                   x               ( ) const;
+    constexpr const Scalar&         x               ( ) const;
     Scalar&                         x               ( );
 
-    const Scalar&                   y               ( ) const;
+    constexpr const Scalar&         y               ( ) const;
     Scalar&                         y               ( );
 
-    const Scalar&                   z               ( ) const;
+    constexpr const Scalar&         z               ( ) const;
     Scalar&                         z               ( );
 
-    const Scalar&                   w               ( ) const;
+    constexpr const Scalar&         w               ( ) const;
     Scalar&                         w               ( );
 
     const Vector<Scalar, 2>&        xy              ( ) const;
@@ -201,7 +218,7 @@ public:
 
     template <typename ReturnScalar =
                 decltype( std::declval<Scalar>() * std::declval<Scalar>() )>
-    ReturnScalar Determinant     () const;
+    constexpr ReturnScalar Determinant () const;
 
     template <typename ReturnScalar =
                     decltype( std::declval<Scalar>() * std::declval<Scalar>() )>
@@ -213,13 +230,27 @@ public:
 
     template <typename ReturnScalar =
                 decltype( std::declval<Scalar>() * std::declval<Scalar>() )>
-    ReturnScalar                             LengthSq        ( ) const;
+    constexpr ReturnScalar                   LengthSq        ( ) const;
 
     template <typename ReturnScalar =
                 decltype( std::sqrt( std::declval<type>().LengthSq() ) )>
     ReturnScalar                             Length          ( ) const;
 };
 
+//
+// The alignment never adds padding, so arrays of matrices are dense
+//
+static_assert( sizeof(float4)   == 16 && alignof(float4)   ==
+               matrix_alignment<float4>::value,
+               "float4 has the wrong layout" );
+static_assert( sizeof(float4x4) == 64 && alignof(float4x4) ==
+               matrix_alignment<float4x4>::value,
+               "float4x4 has the wrong layout" );
+static_assert( sizeof(float3)   == 12 && alignof(float3)   == alignof(float),
+               "float3 has the wrong layout" );
+static_assert( sizeof(float3x3) == 36 && alignof(float3x3) == alignof(float),
+               "float3x3 has the wrong layout" );
+
 ////////////////////////////////////////
 ////////////////////////////////////////
 ////////////////////////////////////////
@@ -234,63 +265,111 @@ public:
 //
 
 template <typename Scalar, u32 Rows, u32 Columns>
-Matrix<Scalar, Rows, Columns> operator + (
+constexpr Matrix<Scalar, Rows, Columns> operator + (
                                        const Matrix<Scalar, Rows, Columns>& m );
 
 // the negated vertion of this vector
 template <typename Scalar, u32 Rows, u32 Columns>
-Matrix<Scalar, Rows, Columns> operator - (
+constexpr Matrix<Scalar, Rows, Columns> operator - (
                                        const Matrix<Scalar, Rows, Columns>& m );
 
 
 //
 // Assignment operators
 //
+// These operate on the elements of the left hand side in place. The same
+// scalar versions don't have to convert anything, so the compiler is free to
+// vectorize them.
+//
 
 // Scalar addition
-template <typename Scalar, u32 Rows, u32 Columns, typename Scalar2>
+template <typename Scalar, u32 Rows, u32 Columns, typename Scalar2,
+          typename = typename std::enable_if<
+                                      !is_expression<Scalar2>::value>::type>
 Matrix<Scalar, Rows, Columns>&  operator += ( Matrix<Scalar, Rows, Columns>& m,
                                               const Scalar2 s );
 
+template <typename Scalar, u32 Rows, u32 Columns>
+Matrix<Scalar, Rows, Columns>&  operator += ( Matrix<Scalar, Rows, Columns>& m,
+                                              const Scalar s );
+
 // Scalar subtraction
-template <typename Scalar, u32 Rows, u32 Columns, typename Scalar2>
+template <typename Scalar, u32 Rows, u32 Columns, typename Scalar2,
+          typename = typename std::enable_if<
+                                      !is_expression<Scalar2>::value>::type>
 Matrix<Scalar, Rows, Columns>&  operator -= ( Matrix<Scalar, Rows, Columns>& m,
                                               const Scalar2 s );
 
+template <typename Scalar, u32 Rows, u32 Columns>
+Matrix<Scalar, Rows, Columns>&  operator -= ( Matrix<Scalar, Rows, Columns>& m,
+                                              const Scalar s );
+
 // Scalar multiplication
-template <typename Scalar, u32 Rows, u32 Columns, typename Scalar2>
+template <typename Scalar, u32 Rows, u32 Columns, typename Scalar2,
+          typename = typename std::enable_if<
+                                      !is_expression<Scalar2>::value>::type>
 Matrix<Scalar, Rows, Columns>&  operator *= ( Matrix<Scalar, Rows, Columns>& m,
                                               const Scalar2 s );
 
+template <typename Scalar, u32 Rows, u32 Columns>
+Matrix<Scalar, Rows, Columns>&  operator *= ( Matrix<Scalar, Rows, Columns>& m,
+                                              const Scalar s );
+
 // Scalar division
-template <typename Scalar, u32 Rows, u32 Columns, typename Scalar2>
+template <typename Scalar, u32 Rows, u32 Columns, typename Scalar2,
+          typename = typename std::enable_if<
+                                      !is_expression<Scalar2>::value>::type>
 Matrix<Scalar, Rows, Columns>&  operator /= ( Matrix<Scalar, Rows, Columns>& m,
                                               const Scalar2 s );
 
+template <typename Scalar, u32 Rows, u32 Columns>
+Matrix<Scalar, Rows, Columns>&  operator /= ( Matrix<Scalar, Rows, Columns>& m,
+                                              const Scalar s );
+
 // Component wise addition
 template <typename Scalar, u32 Rows, u32 Columns, typename Scalar2>
 Matrix<Scalar, Rows, Columns>&  operator += (
                                 Matrix<Scalar, Rows, Columns>& m1,
                                 const Matrix<Scalar2, Rows, Columns>& m2 );
 
+template <typename Scalar, u32 Rows, u32 Columns>
+Matrix<Scalar, Rows, Columns>&  operator += (
+                                Matrix<Scalar, Rows, Columns>& m1,
+                                const Matrix<Scalar, Rows, Columns>& m2 );
+
 // Component wise subtraction
 template <typename Scalar, u32 Rows, u32 Columns, typename Scalar2>
 Matrix<Scalar, Rows, Columns>&  operator -= (
                                 Matrix<Scalar, Rows, Columns>& m1,
                                 const Matrix<Scalar2, Rows, Columns>& m2 );
 
+template <typename Scalar, u32 Rows, u32 Columns>
+Matrix<Scalar, Rows, Columns>&  operator -= (
+                                Matrix<Scalar, Rows, Columns>& m1,
+                                const Matrix<Scalar, Rows, Columns>& m2 );
+
 // Component wise multiplication
 template <typename Scalar, u32 Rows, u32 Columns, typename Scalar2>
 Matrix<Scalar, Rows, Columns>&  operator *= (
                                 Matrix<Scalar, Rows, Columns>& m1,
                                 const Matrix<Scalar2, Rows, Columns>& m2 );
 
+template <typename Scalar, u32 Rows, u32 Columns>
+Matrix<Scalar, Rows, Columns>&  operator *= (
+                                Matrix<Scalar, Rows, Columns>& m1,
+                                const Matrix<Scalar, Rows, Columns>& m2 );
+
 // Component wise division
 template <typename Scalar, u32 Rows, u32 Columns, typename Scalar2>
 Matrix<Scalar, Rows, Columns>&  operator /= (
                                 Matrix<Scalar, Rows, Columns>& m1,
                                 const Matrix<Scalar2, Rows, Columns>& m2 );
 
+template <typename Scalar, u32 Rows, u32 Columns>
+Matrix<Scalar, Rows, Columns>&  operator /= (
+                                Matrix<Scalar, Rows, Columns>& m1,
+                                const Matrix<Scalar, Rows, Columns>& m2 );
+
 //
 // Binary Operators
 //
@@ -299,14 +378,14 @@ Matrix<Scalar, Rows, Columns>&  operator /= (
   * Returns true iff all the elements compare equal
   */
 template <typename Scalar, u32 Rows, u32 Columns, typename Scalar2>
-bool    operator == ( const Matrix<Scalar, Rows, Columns>& m1,
+constexpr bool    operator == ( const Matrix<Scalar, Rows, Columns>& m1,
                       const Matrix<Scalar2, Rows, Columns>& m2 );
 
 /**
   * Returns false iff all the elements compare equal
   */
 template <typename Scalar, u32 Rows, u32 Columns, typename Scalar2>
-bool    operator != ( const Matrix<Scalar, Rows, Columns>& m1,
+constexpr bool    operator != ( const Matrix<Scalar, Rows, Columns>& m1,
                       const Matrix<Scalar2, Rows, Columns>& m2 );
 
 //
@@ -318,9 +397,11 @@ bool    operator != ( const Matrix<Scalar, Rows, Columns>& m1,
   */
 template <typename Scalar, u32 Rows, u32 Columns,
           typename Scalar2,
+          typename = typename std::enable_if<
+                                      !is_expression<Scalar2>::value>::type,
           typename ReturnScalar =
               decltype(std::declval<Scalar>()+std::declval<Scalar2>())>
-Matrix<ReturnScalar, Rows, Columns> operator + (
+constexpr Matrix<ReturnScalar, Rows, Columns> operator + (
                                          const Matrix<Scalar, Rows, Columns>& m,
                                          const Scalar2 s );
 
@@ -329,9 +410,11 @@ Matrix<ReturnScalar, Rows, Columns> operator + (
   */
 template <typename Scalar, u32 Rows, u32 Columns,
           typename Scalar2,
+          typename = typename std::enable_if<
+                                      !is_expression<Scalar2>::value>::type,
           typename ReturnScalar =
               decltype(std::declval<Scalar>()-std::declval<Scalar2>())>
-Matrix<ReturnScalar, Rows, Columns> operator - (
+constexpr Matrix<ReturnScalar, Rows, Columns> operator - (
                                          const Matrix<Scalar, Rows, Columns>& m,
                                          const Scalar2 s );
 
@@ -340,17 +423,21 @@ Matrix<ReturnScalar, Rows, Columns> operator - (
   */
 template <typename Scalar, u32 Rows, u32 Columns,
           typename Scalar2,
+          typename = typename std::enable_if<
+                                      !is_expression<Scalar2>::value>::type,
           typename ReturnScalar =
               decltype(std::declval<Scalar>()*std::declval<Scalar2>())>
-Matrix<ReturnScalar, Rows, Columns> operator * (
+constexpr Matrix<ReturnScalar, Rows, Columns> operator * (
                                        const Scalar2 s,
                                        const Matrix<Scalar, Rows, Columns>& m );
 
 template <typename Scalar, u32 Rows, u32 Columns,
           typename Scalar2,
+          typename = typename std::enable_if<
+                                      !is_expression<Scalar2>::value>::type,
           typename ReturnScalar =
               decltype(std::declval<Scalar>()*std::declval<Scalar2>())>
-Matrix<ReturnScalar, Rows, Columns> operator * (
+constexpr Matrix<ReturnScalar, Rows, Columns> operator * (
                                          const Matrix<Scalar, Rows, Columns>& m,
                                          const Scalar2 s );
 
@@ -359,9 +446,11 @@ Matrix<ReturnScalar, Rows, Columns> operator * (
   */
 template <typename Scalar, u32 Rows, u32 Columns,
           typename Scalar2,
+          typename = typename std::enable_if<
+                                      !is_expression<Scalar2>::value>::type,
           typename ReturnScalar =
               decltype(std::declval<Scalar>()/std::declval<Scalar2>())>
-Matrix<ReturnScalar, Rows, Columns> operator / (
+constexpr Matrix<ReturnScalar, Rows, Columns> operator / (
                                          const Matrix<Scalar, Rows, Columns>& m,
                                          const Scalar2 s );
 
@@ -372,7 +461,7 @@ template <typename Scalar, u32 Rows, u32 Columns,
           typename Scalar2,
           typename ReturnScalar =
               decltype(std::declval<Scalar>()+std::declval<Scalar2>())>
-Matrix<ReturnScalar, Rows, Columns> operator + (
+constexpr Matrix<ReturnScalar, Rows, Columns> operator + (
                                      const Matrix<Scalar, Rows, Columns>& m1,
                                      const Matrix<Scalar2, Rows, Columns>& m2 );
 
@@ -383,7 +472,7 @@ template <typename Scalar, u32 Rows, u32 Columns,
           typename Scalar2,
           typename ReturnScalar =
               decltype(std::declval<Scalar>()-std::declval<Scalar2>())>
-Matrix<ReturnScalar, Rows, Columns> operator - (
+constexpr Matrix<ReturnScalar, Rows, Columns> operator - (
                                      const Matrix<Scalar, Rows, Columns>& m1,
                                      const Matrix<Scalar2, Rows, Columns>& m2 );
 
@@ -394,7 +483,7 @@ template <typename Scalar, u32 Rows, u32 Columns,
           typename Scalar2,
           typename ReturnScalar =
               decltype(std::declval<Scalar>()*std::declval<Scalar2>())>
-Matrix<ReturnScalar, Rows, Columns> operator * (
+constexpr Matrix<ReturnScalar, Rows, Columns> operator * (
                                      const Matrix<Scalar, Rows, Columns>& m1,
                                      const Matrix<Scalar2, Rows, Columns>& m2 );
 
@@ -405,7 +494,7 @@ template <typename Scalar, u32 Rows, u32 Columns,
           typename Scalar2,
           typename ReturnScalar =
               decltype(std::declval<Scalar>()/std::declval<Scalar2>())>
-Matrix<ReturnScalar, Rows, Columns> operator / (
+constexpr Matrix<ReturnScalar, Rows, Columns> operator / (
                                      const Matrix<Scalar, Rows, Columns>& m1,
                                      const Matrix<Scalar2, Rows, Columns>& m2 );
 
@@ -420,14 +509,168 @@ template <typename Scalar, u32 Rows, u32 Columns,
           typename Scalar2, u32 Columns2,
           typename ReturnScalar =
             decltype( std::declval<Scalar>() * std::declval<Scalar2>() )>
-inline Matrix<ReturnScalar, Rows, Columns2> Mul(
+constexpr Matrix<ReturnScalar, Rows, Columns2> Mul(
                              const Matrix<Scalar, Rows, Columns>& m1,
                              const Matrix<Scalar2, Columns, Columns2>& m2 );
 
 template <typename Scalar, u32 Rows, u32 Columns>
-auto Determinant ( const Matrix<Scalar, Rows, Columns>& m ) ->
+constexpr auto Determinant ( const Matrix<Scalar, Rows, Columns>& m ) ->
                 decltype( std::declval<Scalar>() * std::declval<Scalar>() );
 
+/**
+  * The LU factorization of a square matrix with partial pivoting
+  * m_factors holds L below the diagonal, with an implicit unit diagonal, and U
+  * on and above it. Row i of LU is row m_pivots[i] of the original matrix.
+  */
+template <typename Scalar, u32 Size>
+struct LUDecomposition
+{
+    Matrix<Scalar, Size, Size> m_factors;
+    std::array<u32, Size>      m_pivots;
+    /** The sign of the permutation, 1 or -1 */
+    Scalar                     m_parity;
+    /** True iff a zero pivot was found */
+    bool                       m_singular;
+};
+
+/**
+  * Factorizes a square matrix with partial pivoting, this is O(n^3)
+  */
+template <typename Scalar, u32 Rows, u32 Columns>
+LUDecomposition<Scalar, Rows> LU ( const Matrix<Scalar, Rows, Columns>& m );
+
+/**
+  * How solving a linear system went
+  */
+enum class SolveStatus
+{
+    /** m_x holds the solution */
+    Success,
+    /** A zero pivot was found, m_x is zero */
+    Singular,
+    /** SolveCholesky found a pivot which wasn't positive, m_x is zero */
+    NotPositiveDefinite
+};
+
+/**
+  * The solution x of a x = b, with a column for each column of b
+  */
+template <typename Scalar, u32 Size, u32 Columns>
+struct Solution
+{
+    Matrix<Scalar, Size, Columns> m_x;
+    SolveStatus                   m_status;
+};
+
+/**
+  * Solves a x = b by Gaussian elimination with partial pivoting, without
+  * forming the inverse of a. The elimination steps are unrolled for Size.
+  * Every size is pivoted: up to 4x4 Mul( Inverted( a ), b ) is faster for
+  * a single b, but it loses accuracy when a is ill conditioned.
+  */
+template <typename Scalar, u32 Size, u32 Columns>
+Solution<Scalar, Size, Columns> Solve (
+                                  const Matrix<Scalar, Size, Size>& a,
+                                  const Matrix<Scalar, Size, Columns>& b );
+
+/**
+  * Solves a x = b with the LU factorization of a, to reuse it for several b
+  */
+template <typename Scalar, u32 Size, u32 Columns>
+Solution<Scalar, Size, Columns> Solve (
+                                  const LUDecomposition<Scalar, Size>& lu,
+                                  const Matrix<Scalar, Size, Columns>& b );
+
+/**
+  * Solves a x = b for a symmetric positive definite by Cholesky factorization,
+  * this is about half the work of Solve and needs no pivoting. Only the lower
+  * triangle of a is read.
+  */
+template <typename Scalar, u32 Size, u32 Columns>
+Solution<Scalar, Size, Columns> SolveCholesky (
+                                  const Matrix<Scalar, Size, Size>& a,
+                                  const Matrix<Scalar, Size, Columns>& b );
+
+/**
+  * The eigenvalues of a symmetric matrix in descending order, and the unit
+  * eigenvectors as the columns of m_vectors, column i for value i. m_vectors is
+  * a rotation.
+  */
+template <typename Scalar>
+struct EigenDecomposition
+{
+    Vector<Scalar, 3>    m_values;
+    Matrix<Scalar, 3, 3> m_vectors;
+};
+
+/**
+  * Diagonalizes a symmetric 3x3 matrix such as an inertia tensor or a
+  * covariance matrix with Jacobi rotations, so that
+  * m = m_vectors * diag( m_values ) * transpose( m_vectors ). Only the lower
+  * triangle of m is read. There are no branches on the values of m, the
+  * batched version in batch.hpp gives the same results.
+  */
+template <typename Scalar>
+EigenDecomposition<Scalar> EigenSymmetric( const Matrix<Scalar, 3, 3>& m );
+
+/**
+  * m = m_u * diag( m_values ) * transpose( m_v ), where m_u and m_v are
+  * rotations. The values are sorted by descending magnitude, and only the
+  * last can be negative, when the determinant of m is.
+  */
+template <typename Scalar>
+struct SingularValueDecomposition
+{
+    Matrix<Scalar, 3, 3> m_u;
+    Vector<Scalar, 3>    m_values;
+    Matrix<Scalar, 3, 3> m_v;
+};
+
+/**
+  * The singular value decomposition of a 3x3 matrix, by the branch free method
+  * of McAdams et al. The values are accurate relative to the largest one. The
+  * batched version in batch.hpp gives the same results.
+  */
+template <typename Scalar>
+SingularValueDecomposition<Scalar> SVD( const Matrix<Scalar, 3, 3>& m );
+
+/**
+  * Makes the columns of a 3x3 matrix, or of the upper left 3x3 of a 4x4
+  * matrix, orthonormal by modified Gram-Schmidt in the order x, y, z. The rest
+  * of a 4x4 matrix, such as a translation, is unchanged. This is for removing
+  * the drift from rotation matrices after many multiplications.
+  */
+template <typename Scalar, u32 Size>
+void Orthonormalize( Matrix<Scalar, Size, Size>& m );
+
+/**
+  * Returns an orthonormalized copy of m, see Orthonormalize
+  */
+template <typename Scalar, u32 Size>
+Matrix<Scalar, Size, Size> Orthonormalized(
+                                        const Matrix<Scalar, Size, Size>& m );
+
+/**
+  * m = m_rotation * m_stretch, where m_rotation is orthogonal and m_stretch is
+  * symmetric positive definite. m_rotation is the closest orthogonal matrix to
+  * m, it's a rotation when the determinant of m is positive and a reflection
+  * otherwise.
+  */
+template <typename Scalar>
+struct PolarDecomposition
+{
+    Matrix<Scalar, 3, 3> m_rotation;
+    Matrix<Scalar, 3, 3> m_stretch;
+};
+
+/**
+  * The polar decomposition of an invertible 3x3 matrix by a fixed number of
+  * scaled Newton iterations, the results are accurate for condition numbers up
+  * to at least 1e5. The batched version in batch.hpp gives the same results.
+  */
+template <typename Scalar>
+PolarDecomposition<Scalar> PolarDecompose( const Matrix<Scalar, 3, 3>& m );
+
 /**
   * Transposes a square matrix in place
   */
@@ -438,7 +681,7 @@ void Transpose ( Matrix<Scalar, Rows, Columns>& m );
   * Returns the transposed version of a matrix
   */
 template< typename Scalar, u32 Rows, u32 Columns >
-inline Matrix<Scalar, Columns, Rows> Transposed (
+constexpr Matrix<Scalar, Columns, Rows> Transposed (
                                 const Matrix<Scalar, Rows, Columns>& m );
 
 /**
@@ -467,28 +710,78 @@ template <typename Scalar, u32 Rows, u32 Columns>
 inline Matrix<Scalar, Rows, Columns> Normalized (
                                 const Matrix<Scalar, Rows, Columns>& m );
 
+//
+// Normalized divides by the length, this is one square root and one division.
+// These variants trade accuracy for speed or check the length first. The ulp
+// errors are measured for each element of float vectors of up to four
+// elements whose squared length is a normal float, against the exact result.
+// On processors with a fast square root the single vector Fast variants are
+// no quicker than the exact ones, the array versions in batch.hpp are.
+//
+
+/**
+  * The same as Normalized, within 3 ulp
+  */
+template <typename Scalar, u32 Rows, u32 Columns>
+Matrix<Scalar, Rows, Columns> NormalizedPrecise (
+                                const Matrix<Scalar, Rows, Columns>& m );
+
+/**
+  * Multiplies by InverseSqrtFast of the squared length, within 5 ulp
+  */
+template <typename Scalar, u32 Rows, u32 Columns>
+Matrix<Scalar, Rows, Columns> NormalizedFast (
+                                const Matrix<Scalar, Rows, Columns>& m );
+
+/**
+  * Returns fallback if the squared length of m is zero, subnormal, infinite
+  * or NaN, and NormalizedPrecise( m ) otherwise
+  */
+template <typename Scalar, u32 Rows, u32 Columns>
+Matrix<Scalar, Rows, Columns> NormalizedSafe (
+                const Matrix<Scalar, Rows, Columns>& m,
+                const Matrix<Scalar, Rows, Columns>& fallback =
+                                 Matrix<Scalar, Rows, Columns>( Scalar{0} ) );
+
 template <typename Scalar, u32 Rows, u32 Columns,
           typename ReturnScalar =
             decltype( std::declval<Scalar>() * std::declval<Scalar>() )>
-ReturnScalar LengthSq        ( const Matrix<Scalar, Rows, Columns>& m );
+constexpr ReturnScalar LengthSq ( const Matrix<Scalar, Rows, Columns>& m );
 
 template <typename Scalar, u32 Rows, u32 Columns,
           typename ReturnScalar =
             decltype( std::sqrt(LengthSq(Matrix<Scalar,Rows,Columns>())) )>
 ReturnScalar Length          ( const Matrix<Scalar, Rows, Columns>& m );
 
+/**
+  * The squared length multiplied by InverseSqrtFast of itself, this is within
+  * 4 ulp for float vectors whose squared length is a normal float
+  */
+template <typename Scalar, u32 Rows, u32 Columns,
+          typename ReturnScalar =
+            decltype( std::sqrt(LengthSq(Matrix<Scalar,Rows,Columns>())) )>
+ReturnScalar LengthFast      ( const Matrix<Scalar, Rows, Columns>& m );
+
+/**
+  * One over the length, within 3 ulp for float vectors
+  */
+template <typename Scalar, u32 Rows, u32 Columns,
+          typename ReturnScalar =
+            decltype( std::sqrt(LengthSq(Matrix<Scalar,Rows,Columns>())) )>
+ReturnScalar InverseLength   ( const Matrix<Scalar, Rows, Columns>& m );
+
 template <typename Scalar, u32 Rows, u32 Columns,
           typename Scalar2,
           typename ReturnScalar =
             decltype( std::declval<Scalar>() * std::declval<Scalar2>() )>
-ReturnScalar Dot ( const Matrix<Scalar,  Rows, Columns>& m0,
+constexpr ReturnScalar Dot ( const Matrix<Scalar,  Rows, Columns>& m0,
                    const Matrix<Scalar2, Rows, Columns>& m1 );
 
 template <typename Scalar, u32 Rows, u32 Columns,
           typename Scalar2,
           typename ReturnScalar =
             decltype( std::declval<Scalar>() * std::declval<Scalar2>() )>
-Matrix<ReturnScalar, Rows, Columns> Cross (
+constexpr Matrix<ReturnScalar, Rows, Columns> Cross (
                                 const Matrix<Scalar,  Rows, Columns>& m0,
                                 const Matrix<Scalar2, Rows, Columns>& m1 );
 
@@ -496,24 +789,36 @@ template <typename Scalar, u32 Rows, u32 Columns,
           typename Scalar2, u32 Rows2, u32 Columns2,
           typename ReturnScalar =
             decltype( std::declval<Scalar>( ) * std::declval<Scalar2>( ) )>
-Matrix<ReturnScalar, Matrix<Scalar, Rows, Columns>::vector_size,
-                     Matrix<Scalar2, Rows2, Columns2>::vector_size>
+constexpr Matrix<ReturnScalar, Matrix<Scalar, Rows, Columns>::vector_size,
+                               Matrix<Scalar2, Rows2, Columns2>::vector_size>
                                         Outer   (
                                const Matrix<Scalar, Rows, Columns>& m0,
                                const Matrix<Scalar2, Rows2, Columns2>& m1 );
 
+/**
+  * Computes SinCosFast of each element, float4 is done four at a time
+  */
+template <typename Scalar, u32 Rows, u32 Columns>
+void SinCosFast ( const Matrix<Scalar, Rows, Columns>& angles,
+                  Matrix<Scalar, Rows, Columns>& sin,
+                  Matrix<Scalar, Rows, Columns>& cos );
+
 
 ////////////////////////////////////////////////////////////////////////////////
 // Useful matrices
 ////////////////////////////////////////////////////////////////////////////////
 
 template <typename Scalar = float, u32 Size = 4>
-Matrix<Scalar, Size, Size>             Identity  ( );
+constexpr Matrix<Scalar, Size, Size>             Identity  ( );
 
 template <typename Scalar = float, u32 Size = 4>
-Matrix<Scalar, Size, Size>             Scale     (
+constexpr Matrix<Scalar, Size, Size>             Scale     (
                                          const Vector<Scalar, Size>& s );
 
+//
+// The rotations use SinCosFast
+//
+
 template <typename Scalar = float, u32 Size = 3>
 Matrix<Scalar, Size, Size>             Rotate2D  ( Scalar angle );
 
@@ -532,7 +837,7 @@ Matrix<Scalar, 4, 4>             RotateAxisAngle  (
                                               Scalar angle );
 
 template <typename Scalar, u32 Size>
-Matrix<Scalar, Size, Size>          Translate (
+constexpr Matrix<Scalar, Size, Size>          Translate (
                                         const Vector<Scalar, Size>& position );
 
 //
@@ -555,7 +860,7 @@ Matrix<Scalar, 4, 4>                   View      (
                                          const Vector<Scalar, 3>& up );
 
 template <typename Scalar = float>
-Matrix<Scalar, 4, 4>                   Ortho     ( Scalar left,
+constexpr Matrix<Scalar, 4, 4>                   Ortho     ( Scalar left,
                                                    Scalar right,
                                                    Scalar top,
                                                    Scalar bottom,
@@ -28,8 +28,10 @@
 
 #pragma once
 
+#include <cstddef>
 #include <type_traits>
 
+#include <joemath/alignment.hpp>
 #include <joemath/types.hpp>
 
 namespace JoeMath
@@ -130,4 +132,52 @@ namespace JoeMath
     struct vector_size <Matrix<Scalar, Rows, Columns>>
     : public std::integral_constant<u32,  (Rows > Columns) ? Rows : Columns>
     { };  
+
+    namespace detail
+    {
+        //
+        // The largest power of two no greater than limit which divides size
+        //
+        constexpr std::size_t AlignmentDividing( std::size_t size,
+                                                 std::size_t limit )
+        {
+            return limit <= 1 || size % limit == 0 ?
+                       limit :
+                       AlignmentDividing( size, limit / 2 );
+        }
+
+        template <typename Scalar>
+        constexpr std::size_t MaxAlignment( std::size_t alignment )
+        {
+            return alignment > alignof(Scalar) ? alignment : alignof(Scalar);
+        }
+    }
+
+    //
+    // The alignment of a Matrix, see alignment.hpp
+    //
+    template <typename T>
+    struct matrix_alignment
+    { };
+
+    template <typename Scalar, u32 Rows, u32 Columns>
+    struct matrix_alignment <Matrix<Scalar, Rows, Columns>>
+    : public std::integral_constant<std::size_t,
+        ( JOEMATH_ALIGNMENT == 0 ||
+          sizeof(Scalar) * Rows * Columns % 16 != 0 ||
+          ( is_vector<Matrix<Scalar, Rows, Columns>>::value &&
+            vector_size<Matrix<Scalar, Rows, Columns>>::value % 4 != 0 ) ) ?
+            alignof(Scalar) :
+            detail::MaxAlignment<Scalar>( detail::AlignmentDividing(
+                               sizeof(Scalar) * Rows * Columns,
+                               JOEMATH_ALIGNMENT ) )>
+    { };
+
+    //
+    // This is specialized for the lazy expression types in expression.hpp
+    //
+    template <typename T>
+    struct is_expression
+    : public std::false_type
+    { };
 };
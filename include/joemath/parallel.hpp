@@ -0,0 +1,369 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <joemath/batch.hpp>
+#include <joemath/matrix.hpp>
+#include <joemath/types.hpp>
+
+//
+// Parallel batches
+//
+// ThreadPool runs the chunks of a ParallelFor on its worker threads and on
+// the thread which called it. Each thread has a queue of chunks, it splits the
+// chunk it's working on in half and pushes the upper half to the back of its
+// queue, then continues with the lower half. Threads take work from the back
+// of their own queue and steal from the front of the others', so stolen
+// chunks are the largest ones left and each thread works on contiguous
+// memory.
+//
+// The batch functions in batch.hpp are overloaded here to take an execution
+// policy as their first argument:
+//
+//   execution::seq       calls the single element function on each element
+//   execution::simd      the batch function, processing several elements at a
+//                        time with SSE where it can
+//   execution::par_simd  splits the batch into chunks and runs the batch
+//                        function on each of them in parallel
+//
+// The chunks are whole numbers of cache lines of the output array so that
+// threads never write to the same cache line. The results are the same with
+// every policy except seq, which is the same as the generic batch functions.
+//
+// This header isn't included by joemath.hpp, and programs which include it
+// must be linked with the thread library.
+//
+
+namespace JoeMath
+{
+class ThreadPool
+{
+public:
+    /**
+      * Starts thread_count worker threads. The thread calling ParallelFor
+      * works as well, so with no workers everything runs on the caller.
+      */
+    explicit ThreadPool             ( u32 thread_count = DefaultThreadCount() );
+
+    /**
+      * Stops the workers, this mustn't be called while a ParallelFor is
+      * running
+      */
+    ~ThreadPool                     ( );
+
+    ThreadPool                      ( const ThreadPool& ) = delete;
+    ThreadPool& operator =          ( const ThreadPool& ) = delete;
+
+    /**
+      * The number of worker threads, not counting callers of ParallelFor
+      */
+    u32             GetThreadCount  ( ) const;
+
+    /**
+      * Calls f( chunk_begin, chunk_end ) over chunks covering [begin, end)
+      * and returns once they have all finished. Every chunk boundary is begin
+      * plus a multiple of grain. f may be called from several threads at once,
+      * may call ParallelFor itself and mustn't throw.
+      */
+    template <typename F>
+    void            ParallelFor     ( u32 begin,
+                                      u32 end,
+                                      u32 grain,
+                                      const F& f );
+
+    /**
+      * One worker for every hardware thread but the caller's
+      */
+    static u32      DefaultThreadCount ( );
+
+private:
+    struct Job
+    {
+        void        (*m_run)( const void* f, u32 begin, u32 end );
+        const void* m_f;
+        u32         m_grain;
+        //
+        // The number of elements not yet processed, the caller waits for
+        // this to reach zero
+        //
+        std::atomic<u32> m_remaining;
+    };
+
+    struct Task
+    {
+        Job* m_job;
+        u32  m_begin;
+        u32  m_end;
+    };
+
+    struct Queue
+    {
+        std::mutex       m_mutex;
+        std::deque<Task> m_tasks;
+    };
+
+    template <typename F>
+    static void     Run             ( const void* f, u32 begin, u32 end );
+
+    void            WorkerMain      ( u32 index );
+
+    /**
+      * The queue of the calling thread, threads outside the pool share the
+      * last one
+      */
+    u32             GetQueueIndex   ( ) const;
+
+    void            Push            ( const Task& task );
+    bool            Pop             ( Task& task );
+    bool            Steal           ( Task& task );
+    void            Execute         ( Task task );
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread>            m_threads;
+
+    //
+    // The workers sleep on m_wake while there are no tasks in any queue
+    //
+    std::mutex                          m_mutex;
+    std::condition_variable             m_wake;
+    std::atomic<u32>                    m_pending;
+    bool                                m_stop = false;
+};
+
+/**
+  * The pool used by ParallelFor and execution::par_simd by default, it's
+  * started on the first call
+  */
+ThreadPool&     GetThreadPool   ( );
+
+/**
+  * ThreadPool::ParallelFor on GetThreadPool()
+  */
+template <typename F>
+void            ParallelFor     ( u32 begin,
+                                  u32 end,
+                                  u32 grain,
+                                  const F& f );
+
+namespace execution
+{
+    struct SequentialPolicy
+    {
+    };
+
+    struct SimdPolicy
+    {
+    };
+
+    struct ParallelSimdPolicy
+    {
+        /**
+          * A null pool means GetThreadPool(). A grain of zero chooses one
+          * which gives each thread a few chunks of at least a few kilobytes.
+          * Either way the grain is rounded up to whole cache lines of output.
+          */
+        constexpr ParallelSimdPolicy ( ThreadPool* pool = nullptr,
+                                       u32 grain = 0 )
+            :m_pool( pool )
+            ,m_grain( grain )
+        {
+        }
+
+        ThreadPool* m_pool;
+        u32         m_grain;
+    };
+
+    constexpr SequentialPolicy   seq{};
+    constexpr SimdPolicy         simd{};
+    constexpr ParallelSimdPolicy par_simd{};
+}
+
+template <typename T>
+struct is_execution_policy
+: public std::false_type
+{ };
+
+template <>
+struct is_execution_policy <execution::SequentialPolicy>
+: public std::true_type
+{ };
+
+template <>
+struct is_execution_policy <execution::SimdPolicy>
+: public std::true_type
+{ };
+
+template <>
+struct is_execution_policy <execution::ParallelSimdPolicy>
+: public std::true_type
+{ };
+
+//
+// Batch functions with execution policies
+//
+// These have the same parameters and results as the functions in batch.hpp.
+// With par_simd each element is still read before its result is written, so
+// out may be the same as in.
+//
+
+template <typename Policy, typename Scalar, u32 Size,
+          typename = typename std::enable_if<
+                                  is_execution_policy<Policy>::value>::type>
+void    TransformPoints     ( const Policy& policy,
+                              const Matrix<Scalar, Size, Size>& m,
+                              const Vector<Scalar, Size-1>* in,
+                              Vector<Scalar, Size-1>* out,
+                              u32 count,
+                              u32 in_stride  = sizeof(Vector<Scalar, Size-1>),
+                              u32 out_stride = sizeof(Vector<Scalar, Size-1>) );
+
+template <typename Policy, typename Scalar, u32 Size,
+          typename = typename std::enable_if<
+                                  is_execution_policy<Policy>::value>::type>
+void    TransformVectors    ( const Policy& policy,
+                              const Matrix<Scalar, Size, Size>& m,
+                              const Vector<Scalar, Size-1>* in,
+                              Vector<Scalar, Size-1>* out,
+                              u32 count,
+                              u32 in_stride  = sizeof(Vector<Scalar, Size-1>),
+                              u32 out_stride = sizeof(Vector<Scalar, Size-1>) );
+
+template <typename Policy, typename Scalar, u32 Size,
+          typename = typename std::enable_if<
+                                  is_execution_policy<Policy>::value>::type>
+void    TransformHomogeneous( const Policy& policy,
+                              const Matrix<Scalar, Size, Size>& m,
+                              const Vector<Scalar, Size>* in,
+                              Vector<Scalar, Size>* out,
+                              u32 count,
+                              u32 in_stride  = sizeof(Vector<Scalar, Size>),
+                              u32 out_stride = sizeof(Vector<Scalar, Size>) );
+
+template <typename Policy, typename Scalar, u32 Size,
+          typename = typename std::enable_if<
+                                  is_execution_policy<Policy>::value>::type>
+void    InvertBatch         ( const Policy& policy,
+                              const Matrix<Scalar, Size, Size>* in,
+                              Matrix<Scalar, Size, Size>* out,
+                              u32 count,
+                              bool* singular = nullptr );
+
+template <typename Policy, typename Scalar, u32 Size,
+          typename = typename std::enable_if<
+                                  is_execution_policy<Policy>::value>::type>
+void    NormalizedPrecise   ( const Policy& policy,
+                              const Vector<Scalar, Size>* in,
+                              Vector<Scalar, Size>* out,
+                              u32 count );
+
+template <typename Policy, typename Scalar, u32 Size,
+          typename = typename std::enable_if<
+                                  is_execution_policy<Policy>::value>::type>
+void    NormalizedFast      ( const Policy& policy,
+                              const Vector<Scalar, Size>* in,
+                              Vector<Scalar, Size>* out,
+                              u32 count );
+
+template <typename Policy, typename Scalar, u32 Size,
+          typename = typename std::enable_if<
+                                  is_execution_policy<Policy>::value>::type>
+void    NormalizedSafe      ( const Policy& policy,
+                              const Vector<Scalar, Size>* in,
+                              Vector<Scalar, Size>* out,
+                              u32 count,
+                              const Vector<Scalar, Size>& fallback =
+                                            Vector<Scalar, Size>( Scalar{0} ) );
+
+template <typename Policy, typename Scalar, u32 Size,
+          typename = typename std::enable_if<
+                                  is_execution_policy<Policy>::value>::type>
+void    LengthFast          ( const Policy& policy,
+                              const Vector<Scalar, Size>* in,
+                              Scalar* out,
+                              u32 count );
+
+template <typename Policy, typename Scalar, u32 Size,
+          typename = typename std::enable_if<
+                                  is_execution_policy<Policy>::value>::type>
+void    InverseLength       ( const Policy& policy,
+                              const Vector<Scalar, Size>* in,
+                              Scalar* out,
+                              u32 count );
+
+template <typename Policy, typename Scalar, u32 Size,
+          typename = typename std::enable_if<
+                                  is_execution_policy<Policy>::value>::type>
+void    RotateZBatch        ( const Policy& policy,
+                              const Scalar* angles,
+                              Matrix<Scalar, Size, Size>* out,
+                              u32 count );
+
+template <typename Policy, typename Scalar,
+          typename = typename std::enable_if<
+                                  is_execution_policy<Policy>::value>::type>
+void    EigenSymmetricBatch ( const Policy& policy,
+                              const Matrix<Scalar, 3, 3>* in,
+                              EigenDecomposition<Scalar>* out,
+                              u32 count );
+
+template <typename Policy, typename Scalar,
+          typename = typename std::enable_if<
+                                  is_execution_policy<Policy>::value>::type>
+void    SVDBatch            ( const Policy& policy,
+                              const Matrix<Scalar, 3, 3>* in,
+                              SingularValueDecomposition<Scalar>* out,
+                              u32 count );
+
+template <typename Policy, typename Scalar, u32 Size,
+          typename = typename std::enable_if<
+                                  is_execution_policy<Policy>::value>::type>
+void    OrthonormalizeBatch ( const Policy& policy,
+                              const Matrix<Scalar, Size, Size>* in,
+                              Matrix<Scalar, Size, Size>* out,
+                              u32 count );
+
+template <typename Policy, typename Scalar,
+          typename = typename std::enable_if<
+                                  is_execution_policy<Policy>::value>::type>
+void    PolarDecomposeBatch ( const Policy& policy,
+                              const Matrix<Scalar, 3, 3>* in,
+                              PolarDecomposition<Scalar>* out,
+                              u32 count );
+}
+
+#include "inl/parallel-inl.hpp"
@@ -0,0 +1,280 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#pragma once
+
+#include <type_traits>
+
+#include <joemath/matrix.hpp>
+#include <joemath/types.hpp>
+
+//
+// Quaternions
+//
+// A quaternion is stored as a Vector<Scalar, 4> with the vector part in x, y
+// and z and the scalar part in w, so the arithmetic which is the same as for
+// vectors uses the float4 kernels. Rotations follow the same conventions as
+// the rotation matrices: Rotate( a * b, v ) is the same as
+// Mul( Mul( ToMatrix( a ), ToMatrix( b ) ), v ).
+//
+// The rotation functions assume that quaternions are normalized.
+//
+
+namespace JoeMath
+{
+template <typename Scalar>
+class Quaternion
+{
+public:
+    Vector<Scalar, 4> m_xyzw;
+
+    using scalar_type = Scalar;
+    using vector_type = Vector<Scalar, 3>;
+
+    //
+    // Constructors
+    //
+
+    /**
+      * Doesn't initialize the data
+      */
+    Quaternion          ( );
+
+    Quaternion          ( Scalar x, Scalar y, Scalar z, Scalar w );
+
+    /**
+      * Initialize from a vector part and a scalar part
+      */
+    Quaternion          ( const Vector<Scalar, 3>& xyz, Scalar w );
+
+    explicit Quaternion ( const Vector<Scalar, 4>& xyzw );
+
+    //
+    // Getters
+    //
+
+    const Scalar&                   x               ( ) const;
+    Scalar&                         x               ( );
+
+    const Scalar&                   y               ( ) const;
+    Scalar&                         y               ( );
+
+    const Scalar&                   z               ( ) const;
+    Scalar&                         z               ( );
+
+    const Scalar&                   w               ( ) const;
+    Scalar&                         w               ( );
+
+    /**
+      * The vector part
+      */
+    const Vector<Scalar, 3>&        xyz             ( ) const;
+    Vector<Scalar, 3>&              xyz             ( );
+
+    const Vector<Scalar, 4>&        xyzw            ( ) const;
+    Vector<Scalar, 4>&              xyzw            ( );
+};
+
+////////////////////////////////////////
+////////////////////////////////////////
+// Operators on quaternions
+////////////////////////////////////////
+////////////////////////////////////////
+
+template <typename Scalar>
+Quaternion<Scalar>  operator -  ( const Quaternion<Scalar>& q );
+
+template <typename Scalar>
+Quaternion<Scalar>  operator +  ( const Quaternion<Scalar>& q0,
+                                  const Quaternion<Scalar>& q1 );
+
+template <typename Scalar>
+Quaternion<Scalar>  operator -  ( const Quaternion<Scalar>& q0,
+                                  const Quaternion<Scalar>& q1 );
+
+/**
+  * The Hamilton product, the rotation by q1 followed by the rotation by q0
+  */
+template <typename Scalar>
+Quaternion<Scalar>  operator *  ( const Quaternion<Scalar>& q0,
+                                  const Quaternion<Scalar>& q1 );
+
+template <typename Scalar, typename Scalar2,
+          typename = typename std::enable_if<
+                                  std::is_arithmetic<Scalar2>::value>::type>
+Quaternion<Scalar>  operator *  ( const Quaternion<Scalar>& q, Scalar2 s );
+
+template <typename Scalar, typename Scalar2,
+          typename = typename std::enable_if<
+                                  std::is_arithmetic<Scalar2>::value>::type>
+Quaternion<Scalar>  operator *  ( Scalar2 s, const Quaternion<Scalar>& q );
+
+template <typename Scalar>
+Quaternion<Scalar>& operator += ( Quaternion<Scalar>& q0,
+                                  const Quaternion<Scalar>& q1 );
+
+template <typename Scalar>
+Quaternion<Scalar>& operator -= ( Quaternion<Scalar>& q0,
+                                  const Quaternion<Scalar>& q1 );
+
+/**
+  * q0 = q0 * q1
+  */
+template <typename Scalar>
+Quaternion<Scalar>& operator *= ( Quaternion<Scalar>& q0,
+                                  const Quaternion<Scalar>& q1 );
+
+template <typename Scalar>
+bool                operator == ( const Quaternion<Scalar>& q0,
+                                  const Quaternion<Scalar>& q1 );
+
+template <typename Scalar>
+bool                operator != ( const Quaternion<Scalar>& q0,
+                                  const Quaternion<Scalar>& q1 );
+
+////////////////////////////////////////
+////////////////////////////////////////
+// Functions on quaternions
+////////////////////////////////////////
+////////////////////////////////////////
+
+template <typename Scalar>
+Scalar              Dot         ( const Quaternion<Scalar>& q0,
+                                  const Quaternion<Scalar>& q1 );
+
+template <typename Scalar>
+Scalar              LengthSq    ( const Quaternion<Scalar>& q );
+
+template <typename Scalar>
+Scalar              Length      ( const Quaternion<Scalar>& q );
+
+template <typename Scalar>
+void                Normalize   ( Quaternion<Scalar>& q );
+
+template <typename Scalar>
+Quaternion<Scalar>  Normalized  ( const Quaternion<Scalar>& q );
+
+/**
+  * Negates the vector part of q in place. For a normalized quaternion this
+  * is the inverse rotation.
+  */
+template <typename Scalar>
+void                Conjugate   ( Quaternion<Scalar>& q );
+
+template <typename Scalar>
+Quaternion<Scalar>  Conjugated  ( const Quaternion<Scalar>& q );
+
+/**
+  * Inverts q in place, q needn't be normalized
+  */
+template <typename Scalar>
+void                Invert      ( Quaternion<Scalar>& q );
+
+template <typename Scalar>
+Quaternion<Scalar>  Inverted    ( const Quaternion<Scalar>& q );
+
+/**
+  * Rotates v by q without building a matrix
+  */
+template <typename Scalar>
+Vector<Scalar, 3>   Rotate      ( const Quaternion<Scalar>& q,
+                                  const Vector<Scalar, 3>& v );
+
+/**
+  * Linearly interpolates between q0 and q1 and normalizes the result. This
+  * takes the shortest path, but doesn't have a constant angular velocity.
+  */
+template <typename Scalar, typename U>
+Quaternion<Scalar>  Nlerp       ( const Quaternion<Scalar>& q0,
+                                  const Quaternion<Scalar>& q1,
+                                  U t );
+
+/**
+  * Spherical linear interpolation between q0 and q1 along the shortest path
+  */
+template <typename Scalar, typename U>
+Quaternion<Scalar>  Slerp       ( const Quaternion<Scalar>& q0,
+                                  const Quaternion<Scalar>& q1,
+                                  U t );
+
+/**
+  * Slerps count pairs of quaternions by t, out[i] = Slerp( q0[i], q1[i], t ).
+  * out may be the same as q0 or q1.
+  */
+template <typename Scalar>
+void                Slerp       ( const Quaternion<Scalar>* q0,
+                                  const Quaternion<Scalar>* q1,
+                                  Scalar t,
+                                  Quaternion<Scalar>* out,
+                                  u32 count );
+
+/**
+  * The float version uses a polynomial approximation of slerp which is
+  * accurate to within 1e-6 for normalized inputs and doesn't call any
+  * trigonometric functions, so it processes four quaternions at a time with
+  * SSE. See "A Fast and Accurate Algorithm for Computing SLERP" by David
+  * Eberly.
+  */
+inline void         Slerp       ( const Quaternion<float>* q0,
+                                  const Quaternion<float>* q1,
+                                  float t,
+                                  Quaternion<float>* out,
+                                  u32 count );
+
+////////////////////////////////////////
+////////////////////////////////////////
+// Useful quaternions
+////////////////////////////////////////
+////////////////////////////////////////
+
+template <typename Scalar = float>
+Quaternion<Scalar>  IdentityQuaternion  ( );
+
+/**
+  * The rotation by angle radians around the normalized axis, the same rotation
+  * as RotateAxisAngle
+  */
+template <typename Scalar>
+Quaternion<Scalar>  QuaternionAxisAngle ( const Vector<Scalar, 3>& axis,
+                                          Scalar angle );
+
+/**
+  * Converts q to a 3x3 or 4x4 rotation matrix
+  */
+template <u32 Size = 4, typename Scalar>
+Matrix<Scalar, Size, Size>  ToMatrix    ( const Quaternion<Scalar>& q );
+
+/**
+  * Converts the rotation in the upper 3x3 of m to a quaternion. m shouldn't
+  * contain any scale.
+  */
+template <typename Scalar, u32 Size>
+Quaternion<Scalar>          ToQuaternion( const Matrix<Scalar, Size, Size>& m );
+}
+
+#include "inl/quaternion-inl.hpp"
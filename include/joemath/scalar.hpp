@@ -257,6 +257,57 @@ namespace JoeMath
       */
     template <typename T>
     T   Distance        ( const T v0, const T v1 );
+
+    /**
+      * Returns an approximation of the reciprocal square root of a value
+      * The float overload refines an estimate with Newton-Raphson and is
+      * within 4 ulp of the exact result, other types are exact.
+      * \tparam T
+      * The type of the value
+      * \param v
+      * The value to take the reciprocal square root of, this must be positive
+      * \returns 1 / sqrt(v)
+      */
+    template <typename T>
+    T   InverseSqrtFast ( const T v );
+
+    inline float InverseSqrtFast ( const float v );
+
+    /**
+      * Computes the sine and cosine of an angle
+      * \tparam T
+      * The type of the angle
+      * \param angle
+      * The angle in radians
+      * \param sin
+      * Set to std::sin( angle )
+      * \param cos
+      * Set to std::cos( angle )
+      */
+    template <typename T>
+    void SinCos          ( const T angle, T& sin, T& cos );
+
+    /**
+      * Computes an approximation of the sine and cosine of an angle together
+      * The float overload reduces the angle to [-pi/4, pi/4] and evaluates a
+      * minimax polynomial for each. For |angle| <= pi the results are within
+      * 2 ulp, and for |angle| <= 8192 they are within 1e-7 of the exact
+      * results. Larger angles use SinCos, as do other types. For one float
+      * this is about as fast as glibc's sincosf, the float4 and array versions
+      * are around three times faster.
+      * \tparam T
+      * The type of the angle
+      * \param angle
+      * The angle in radians
+      * \param sin
+      * Set to the sine of angle
+      * \param cos
+      * Set to the cosine of angle
+      */
+    template <typename T>
+    void SinCosFast      ( const T angle, T& sin, T& cos );
+
+    inline void SinCosFast ( const float angle, float& sin, float& cos );
 };
 
 #include "inl/scalar-inl.hpp"
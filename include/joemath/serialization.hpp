@@ -0,0 +1,312 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <joemath/alignment.hpp>
+#include <joemath/matrix.hpp>
+#include <joemath/matrix_traits.hpp>
+#include <joemath/types.hpp>
+
+//
+// Binary matrix arrays
+//
+// A matrix array file is a MatrixArrayHeader followed by the matrices as
+// they're laid out in memory, each stored column by column in the byte order
+// of the machine which wrote it. The header records the scalar type, the
+// dimensions, the byte order and the alignment of the matrices so that a
+// file can only be opened as the type it was written from.
+//
+// The matrices start at a multiple of cache_line_size from the start of the
+// file, so a MappedMatrixArray can map the file into memory and use them in
+// place however they're aligned. Opening a file only reads its header, the
+// matrices are paged in as they're used.
+//
+// MatrixArrayWriter writes a file through a buffer of a fixed size and fills
+// in the count in the header when it's closed, so arrays larger than memory
+// can be written a piece at a time.
+//
+// This header isn't included by joemath.hpp. Files are mapped with mmap on
+// POSIX systems and read into memory elsewhere.
+//
+
+namespace JoeMath
+{
+enum class ScalarType : u32
+{
+    Unknown = 0,
+    Float,
+    Double,
+    S8,
+    U8,
+    S16,
+    U16,
+    S32,
+    U32,
+    S64,
+    U64
+};
+
+/**
+  * The ScalarType of a scalar, this is Unknown for types which can't be
+  * stored
+  */
+template <typename Scalar>
+struct scalar_type_of
+: public std::integral_constant<ScalarType, ScalarType::Unknown>
+{ };
+
+template <> struct scalar_type_of<float>
+: public std::integral_constant<ScalarType, ScalarType::Float> { };
+template <> struct scalar_type_of<double>
+: public std::integral_constant<ScalarType, ScalarType::Double> { };
+template <> struct scalar_type_of<s8>
+: public std::integral_constant<ScalarType, ScalarType::S8> { };
+template <> struct scalar_type_of<u8>
+: public std::integral_constant<ScalarType, ScalarType::U8> { };
+template <> struct scalar_type_of<s16>
+: public std::integral_constant<ScalarType, ScalarType::S16> { };
+template <> struct scalar_type_of<u16>
+: public std::integral_constant<ScalarType, ScalarType::U16> { };
+template <> struct scalar_type_of<s32>
+: public std::integral_constant<ScalarType, ScalarType::S32> { };
+template <> struct scalar_type_of<u32>
+: public std::integral_constant<ScalarType, ScalarType::U32> { };
+template <> struct scalar_type_of<s64>
+: public std::integral_constant<ScalarType, ScalarType::S64> { };
+template <> struct scalar_type_of<u64>
+: public std::integral_constant<ScalarType, ScalarType::U64> { };
+
+/**
+  * The first 64 bytes of a matrix array file
+  */
+struct MatrixArrayHeader
+{
+    char        m_magic[8];
+    u32         m_version;
+    //
+    // byte_order_mark as written by the machine which made the file
+    //
+    u32         m_byte_order;
+    ScalarType  m_scalar_type;
+    u32         m_scalar_size;
+    u32         m_rows;
+    u32         m_columns;
+    //
+    // The size and alignment of each matrix when it was written
+    //
+    u32         m_element_size;
+    u32         m_alignment;
+    u64         m_count;
+    //
+    // The offset of the first matrix from the start of the file, a multiple
+    // of cache_line_size
+    //
+    u64         m_data_offset;
+    u8          m_reserved[8];
+
+    static const u32    version         = 1;
+    static const u32    byte_order_mark = 0x01020304;
+
+    /**
+      * A header describing count Ts
+      */
+    template <typename T>
+    static MatrixArrayHeader    Make    ( u64 count );
+
+    /**
+      * Returns true if this describes an array of Ts which fits in a file of
+      * file_size bytes
+      */
+    template <typename T>
+    bool                        IsValid ( std::size_t file_size ) const;
+};
+
+static_assert( sizeof(MatrixArrayHeader) == 64,
+               "MatrixArrayHeader must be 64 bytes" );
+
+namespace detail
+{
+namespace serialization
+{
+    /**
+      * A read only view of a whole file
+      */
+    class FileMapping
+    {
+    public:
+        FileMapping                 ( ) = default;
+        ~FileMapping                ( );
+
+        FileMapping                 ( const FileMapping& ) = delete;
+        FileMapping& operator =     ( const FileMapping& ) = delete;
+
+        bool            Open        ( const std::string& filename );
+        void            Close       ( );
+
+        void            Swap        ( FileMapping& other );
+
+        const char*     GetData     ( ) const;
+        std::size_t     GetSize     ( ) const;
+
+    private:
+        const char*         m_data = nullptr;
+        std::size_t         m_size = 0;
+#if defined( _WIN32 )
+        std::vector<char, AlignedAllocator<char>> m_buffer;
+#endif
+    };
+}
+}
+
+/**
+  * A read only array of Ts in a matrix array file, mapped into memory
+  */
+template <typename T>
+class MappedMatrixArray
+{
+public:
+    static_assert( is_matrix<T>::value,
+                   "Trying to create a MappedMatrixArray of non-matrices" );
+    static_assert( scalar_type_of<typename T::scalar_type>::value !=
+                   ScalarType::Unknown,
+                   "Trying to create a MappedMatrixArray of an unknown scalar "
+                   "type" );
+
+    typedef T           value_type;
+    typedef const T*    const_iterator;
+
+    MappedMatrixArray           ( ) = default;
+
+    /**
+      * Opens filename, check IsOpen to see if it succeeded
+      */
+    explicit MappedMatrixArray  ( const std::string& filename );
+
+    MappedMatrixArray           ( MappedMatrixArray&& other );
+    MappedMatrixArray& operator=( MappedMatrixArray&& other );
+
+    MappedMatrixArray           ( const MappedMatrixArray& ) = delete;
+    MappedMatrixArray& operator=( const MappedMatrixArray& ) = delete;
+
+    /**
+      * Maps filename, returning false and leaving this closed if it can't be
+      * read or isn't an array of Ts written on a machine of the same byte
+      * order
+      */
+    bool                Open        ( const std::string& filename );
+    void                Close       ( );
+    bool                IsOpen      ( ) const;
+
+    const T*            data        ( ) const;
+    std::size_t         size        ( ) const;
+    bool                empty       ( ) const;
+
+    const T&            operator [] ( std::size_t i ) const;
+
+    const_iterator      begin       ( ) const;
+    const_iterator      end         ( ) const;
+
+private:
+    detail::serialization::FileMapping  m_file;
+    const T*                            m_data = nullptr;
+    std::size_t                         m_size = 0;
+};
+
+/**
+  * Writes an array of Ts to a matrix array file a piece at a time
+  */
+template <typename T>
+class MatrixArrayWriter
+{
+public:
+    static_assert( is_matrix<T>::value,
+                   "Trying to create a MatrixArrayWriter of non-matrices" );
+    static_assert( scalar_type_of<typename T::scalar_type>::value !=
+                   ScalarType::Unknown,
+                   "Trying to create a MatrixArrayWriter of an unknown scalar "
+                   "type" );
+
+    /**
+      * Matrices are collected in a buffer of buffer_size bytes before being
+      * written to the file
+      */
+    explicit MatrixArrayWriter  ( std::size_t buffer_size = 1 << 20 );
+
+    /**
+      * Closes the file if it's still open
+      */
+    ~MatrixArrayWriter          ( );
+
+    MatrixArrayWriter           ( const MatrixArrayWriter& ) = delete;
+    MatrixArrayWriter& operator=( const MatrixArrayWriter& ) = delete;
+
+    /**
+      * Creates filename and writes a header for an empty array
+      */
+    bool                Open        ( const std::string& filename );
+
+    void                Write       ( const T& m );
+    void                Write       ( const T* data, std::size_t count );
+
+    /**
+      * Writes what's left in the buffer and the final count, and returns
+      * false if anything couldn't be written
+      */
+    bool                Close       ( );
+
+    /**
+      * The number of matrices written so far
+      */
+    u64                 GetCount    ( ) const;
+
+private:
+    void                Flush       ( );
+
+    std::ofstream       m_file;
+    std::vector<char>   m_buffer;
+    std::size_t         m_buffer_used = 0;
+    u64                 m_count = 0;
+};
+
+/**
+  * Writes an array to filename in one go
+  */
+template <typename T>
+bool    WriteMatrixArray    ( const std::string& filename,
+                              const T* data,
+                              std::size_t count );
+}
+
+#include "inl/serialization-inl.hpp"
@@ -0,0 +1,78 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#pragma once
+
+//
+// SIMD configuration
+//
+// JOEMATH_SSE is defined when the SSE4.1 kernels for float4 and float4x4 are
+// enabled, and JOEMATH_AVX when those kernels may also use 256 bit registers.
+// They are enabled automatically when the compiler is targetting a cpu with
+// the relevant instruction set (-msse4.1 or -mavx). Define JOEMATH_NO_SIMD to
+// fall back to the generic scalar code.
+//
+
+#if !defined( JOEMATH_NO_SIMD ) && defined( __SSE4_1__ )
+    #define JOEMATH_SSE
+    #include <smmintrin.h>
+
+    #if defined( __AVX__ )
+        #define JOEMATH_AVX
+        #include <immintrin.h>
+    #endif
+#endif
+
+//
+// Constant evaluation
+//
+// The SIMD kernels, and the unrolled loops in matrix-inl.hpp which write
+// through pointers, can't be used in constant expressions. The constexpr
+// functions which use them check JOEMATH_CONSTANT_EVALUATED and evaluate an
+// equivalent constant expression instead when it's true.
+//
+// Without __builtin_is_constant_evaluated the generic functions always use
+// the constant expressions, which are just as fast with optimizations but
+// slower in debug builds, and the SIMD overloads aren't constexpr.
+//
+
+#if defined( __has_builtin )
+    #if __has_builtin( __builtin_is_constant_evaluated )
+        #define JOEMATH_HAS_CONSTANT_EVALUATED
+    #endif
+#endif
+
+#if defined( JOEMATH_HAS_CONSTANT_EVALUATED )
+    #define JOEMATH_CONSTANT_EVALUATED      __builtin_is_constant_evaluated()
+    #define JOEMATH_SIMD_CONSTEXPR          constexpr
+    #define JOEMATH_SIMD_CONSTANT_EVALUATED __builtin_is_constant_evaluated()
+#else
+    #define JOEMATH_CONSTANT_EVALUATED      true
+    #define JOEMATH_SIMD_CONSTEXPR
+    #define JOEMATH_SIMD_CONSTANT_EVALUATED false
+#endif
@@ -0,0 +1,355 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#pragma once
+
+#include <array>
+#include <type_traits>
+#include <vector>
+
+#include <joemath/matrix.hpp>
+#include <joemath/types.hpp>
+
+//
+// Structure of arrays containers
+//
+// VectorSoA stores each component of its vectors in a separate array. AoSoA
+// stores its vectors in blocks of Width, with each component of a block stored
+// contiguously. Either way, the same component of neighbouring vectors is
+// adjacent in memory so the functions at the bottom of this file can operate
+// on several vectors with each instruction.
+//
+// Elements are accessed through SoAReference, which converts to and from
+// Vector.
+//
+
+namespace JoeMath
+{
+/**
+  * A reference to a single vector in a VectorSoA or AoSoA
+  */
+template <typename Container>
+class SoAReference
+{
+public:
+    using scalar_type = typename Container::scalar_type;
+    using value_type  = typename Container::value_type;
+
+    SoAReference ( Container& container, u32 index );
+
+    /**
+      * Copies the vector out of the container
+      */
+    operator value_type ( ) const;
+
+    SoAReference& operator = ( const value_type& v );
+
+    /**
+      * Copies the referenced vector, not the reference
+      */
+    SoAReference& operator = ( const SoAReference& r );
+
+    scalar_type&  operator [] ( u32 component ) const;
+
+private:
+    Container& m_container;
+    u32        m_index;
+};
+
+/**
+  * A sequence of vectors with each component stored in its own array
+  */
+template <typename Scalar, u32 Size>
+class VectorSoA
+{
+public:
+    static_assert( Size > 0, "Trying to create a VectorSoA of empty vectors" );
+
+    using scalar_type = Scalar;
+    using value_type  = Vector<Scalar, Size>;
+    using reference   = SoAReference<VectorSoA>;
+
+    /**
+      * The same container holding vectors of a different size
+      */
+    template <u32 Size2>
+    using rebind = VectorSoA<Scalar, Size2>;
+
+    static const u32 vector_size    = Size;
+
+    /**
+      * The largest number of vectors to process at once
+      */
+    static const u32 max_pack_width = 16;
+
+    VectorSoA                        ( ) = default;
+    explicit VectorSoA               ( u32 size );
+    VectorSoA                        ( u32 size, const value_type& v );
+    explicit VectorSoA               ( const std::vector<value_type>& v );
+
+    std::vector<value_type> ToAoS    ( ) const;
+
+    u32             GetSize          ( ) const;
+    void            Resize           ( u32 size );
+    void            PushBack         ( const value_type& v );
+
+    reference       operator []      ( u32 i );
+    value_type      operator []      ( u32 i ) const;
+
+    Scalar&         GetComponent     ( u32 i, u32 component );
+    const Scalar&   GetComponent     ( u32 i, u32 component ) const;
+
+    //
+    // The elements are split into spans, in each of which every component is
+    // contiguous. A VectorSoA only has one.
+    //
+    u32                              GetSpanCount ( ) const;
+    u32                              GetSpanSize  ( u32 span ) const;
+    std::array<Scalar*, Size>        GetSpan      ( u32 span );
+    std::array<const Scalar*, Size>  GetSpan      ( u32 span ) const;
+
+private:
+    std::array<std::vector<Scalar>, Size> m_components;
+};
+
+/**
+  * A sequence of vectors stored in blocks of Width, each of which stores its
+  * components separately. Unused elements of the last block are kept at zero.
+  */
+template <typename Scalar, u32 Size, u32 Width = 8>
+class AoSoA
+{
+public:
+    static_assert( Size > 0, "Trying to create an AoSoA of empty vectors" );
+    static_assert( Width > 0, "Trying to create an AoSoA with empty blocks" );
+
+    using scalar_type = Scalar;
+    using value_type  = Vector<Scalar, Size>;
+    using reference   = SoAReference<AoSoA>;
+
+    template <u32 Size2>
+    using rebind = AoSoA<Scalar, Size2, Width>;
+
+    static const u32 vector_size    = Size;
+    static const u32 block_width    = Width;
+    static const u32 max_pack_width = Width;
+
+    AoSoA                            ( ) = default;
+    explicit AoSoA                   ( u32 size );
+    AoSoA                            ( u32 size, const value_type& v );
+    explicit AoSoA                   ( const std::vector<value_type>& v );
+
+    std::vector<value_type> ToAoS    ( ) const;
+
+    u32             GetSize          ( ) const;
+    void            Resize           ( u32 size );
+    void            PushBack         ( const value_type& v );
+
+    reference       operator []      ( u32 i );
+    value_type      operator []      ( u32 i ) const;
+
+    Scalar&         GetComponent     ( u32 i, u32 component );
+    const Scalar&   GetComponent     ( u32 i, u32 component ) const;
+
+    //
+    // Each block is a span, including the unused part of the last one
+    //
+    u32                              GetSpanCount ( ) const;
+    u32                              GetSpanSize  ( u32 span ) const;
+    std::array<Scalar*, Size>        GetSpan      ( u32 span );
+    std::array<const Scalar*, Size>  GetSpan      ( u32 span ) const;
+
+private:
+    struct Block
+    {
+        std::array<std::array<Scalar, Width>, Size> m_components;
+    };
+
+    std::vector<Block> m_blocks;
+    u32                m_size = 0;
+};
+
+template <typename T>
+struct is_soa
+: public std::false_type
+{ };
+
+template <typename Scalar, u32 Size>
+struct is_soa <VectorSoA<Scalar, Size>>
+: public std::true_type
+{ };
+
+template <typename Scalar, u32 Size, u32 Width>
+struct is_soa <AoSoA<Scalar, Size, Width>>
+: public std::true_type
+{ };
+
+//
+// Arithmetic
+//
+// These work element wise on containers of the same size, like the Matrix
+// operators. Division by a scalar multiplies by its reciprocal.
+//
+
+template <typename Container,
+          typename = typename std::enable_if<is_soa<Container>::value>::type>
+Container   operator +  ( const Container& a, const Container& b );
+
+template <typename Container,
+          typename = typename std::enable_if<is_soa<Container>::value>::type>
+Container   operator -  ( const Container& a, const Container& b );
+
+template <typename Container,
+          typename = typename std::enable_if<is_soa<Container>::value>::type>
+Container   operator *  ( const Container& a, const Container& b );
+
+template <typename Container,
+          typename = typename std::enable_if<is_soa<Container>::value>::type>
+Container   operator /  ( const Container& a, const Container& b );
+
+template <typename Container,
+          typename = typename std::enable_if<is_soa<Container>::value>::type>
+Container   operator +  ( const Container& a,
+                          const typename Container::scalar_type s );
+
+template <typename Container,
+          typename = typename std::enable_if<is_soa<Container>::value>::type>
+Container   operator -  ( const Container& a,
+                          const typename Container::scalar_type s );
+
+template <typename Container,
+          typename = typename std::enable_if<is_soa<Container>::value>::type>
+Container   operator *  ( const Container& a,
+                          const typename Container::scalar_type s );
+
+template <typename Container,
+          typename = typename std::enable_if<is_soa<Container>::value>::type>
+Container   operator *  ( const typename Container::scalar_type s,
+                          const Container& a );
+
+template <typename Container,
+          typename = typename std::enable_if<is_soa<Container>::value>::type>
+Container   operator /  ( const Container& a,
+                          const typename Container::scalar_type s );
+
+template <typename Container,
+          typename = typename std::enable_if<is_soa<Container>::value>::type>
+Container&  operator += ( Container& a, const Container& b );
+
+template <typename Container,
+          typename = typename std::enable_if<is_soa<Container>::value>::type>
+Container&  operator -= ( Container& a, const Container& b );
+
+template <typename Container,
+          typename = typename std::enable_if<is_soa<Container>::value>::type>
+Container&  operator *= ( Container& a, const Container& b );
+
+template <typename Container,
+          typename = typename std::enable_if<is_soa<Container>::value>::type>
+Container&  operator /= ( Container& a, const Container& b );
+
+template <typename Container,
+          typename = typename std::enable_if<is_soa<Container>::value>::type>
+Container&  operator += ( Container& a,
+                          const typename Container::scalar_type s );
+
+template <typename Container,
+          typename = typename std::enable_if<is_soa<Container>::value>::type>
+Container&  operator -= ( Container& a,
+                          const typename Container::scalar_type s );
+
+template <typename Container,
+          typename = typename std::enable_if<is_soa<Container>::value>::type>
+Container&  operator *= ( Container& a,
+                          const typename Container::scalar_type s );
+
+template <typename Container,
+          typename = typename std::enable_if<is_soa<Container>::value>::type>
+Container&  operator /= ( Container& a,
+                          const typename Container::scalar_type s );
+
+//
+// Vector functions
+//
+// These give the same results as calling the Vector functions on each element
+//
+
+/**
+  * The dot product of each pair of vectors
+  */
+template <typename Container,
+          typename = typename std::enable_if<is_soa<Container>::value>::type>
+typename Container::template rebind<1>  Dot         ( const Container& a,
+                                                      const Container& b );
+
+/**
+  * The cross product of each pair of 3 element vectors
+  */
+template <typename Container,
+          typename = typename std::enable_if<is_soa<Container>::value>::type>
+Container                               Cross       ( const Container& a,
+                                                      const Container& b );
+
+template <typename Container,
+          typename = typename std::enable_if<is_soa<Container>::value>::type>
+typename Container::template rebind<1>  LengthSq    ( const Container& v );
+
+template <typename Container,
+          typename = typename std::enable_if<is_soa<Container>::value>::type>
+void                                    Normalize   ( Container& v );
+
+template <typename Container,
+          typename = typename std::enable_if<is_soa<Container>::value>::type>
+Container                               Normalized  ( const Container& v );
+
+//
+// Length and Lerp have unconstrained templates in scalar.hpp, so these are
+// overloaded for each container to be more specialized
+//
+
+template <typename Scalar, u32 Size>
+VectorSoA<Scalar, 1>        Length  ( const VectorSoA<Scalar, Size>& v );
+
+template <typename Scalar, u32 Size, u32 Width>
+AoSoA<Scalar, 1, Width>     Length  ( const AoSoA<Scalar, Size, Width>& v );
+
+/**
+  * v0 + t * (v1 - v0) for each pair of vectors, t is converted to Scalar first
+  */
+template <typename Scalar, u32 Size, typename T>
+VectorSoA<Scalar, Size>     Lerp    ( const VectorSoA<Scalar, Size>& v0,
+                                      const VectorSoA<Scalar, Size>& v1,
+                                      const T t );
+
+template <typename Scalar, u32 Size, u32 Width, typename T>
+AoSoA<Scalar, Size, Width>  Lerp    ( const AoSoA<Scalar, Size, Width>& v0,
+                                      const AoSoA<Scalar, Size, Width>& v1,
+                                      const T t );
+}
+
+#include "inl/soa-inl.hpp"
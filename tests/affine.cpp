@@ -0,0 +1,227 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <joemath/joemath.hpp>
+
+using namespace JoeMath;
+
+namespace
+{
+    template <typename T>
+    T GetRandomMatrix()
+    {
+        static std::uniform_real_distribution<typename T::scalar_type> re(-10,
+                                                                          10);
+        static auto ran = std::bind(re,std::minstd_rand());
+        T ret;
+        for( u32 i = 0; i < T::columns; ++i )
+            for( u32 j = 0; j < T::rows; ++j )
+                ret.m_elements[i][j] = ran();
+        return ret;
+    }
+
+    template <typename Scalar>
+    Affine<Scalar> GetRandomAffine()
+    {
+        return Affine<Scalar>( GetRandomMatrix<Matrix<Scalar, 3, 4>>() );
+    }
+
+    //
+    // The tolerance is relative for elements larger than 1
+    //
+    template <typename Scalar, u32 Rows, u32 Columns>
+    void ExpectNear( const Matrix<Scalar, Rows, Columns>& expected,
+                     const Matrix<Scalar, Rows, Columns>& actual,
+                     Scalar tolerance )
+    {
+        for( u32 i = 0; i < Rows * Columns; ++i )
+            EXPECT_NEAR( expected.m_elements[0][i], actual.m_elements[0][i],
+                         tolerance * std::max( Scalar{1},
+                                        std::abs( expected.m_elements[0][i] ) ) );
+    }
+}
+
+template <typename T>
+class AffineTest : public testing::Test
+{
+};
+
+using testing::Types;
+
+typedef Types<float, double> AffineTypes;
+
+TYPED_TEST_CASE(AffineTest, AffineTypes);
+
+TYPED_TEST(AffineTest, Conversion )
+{
+    typedef TypeParam Scalar;
+
+    EXPECT_EQ( sizeof( Matrix<Scalar, 4, 4> ) * 3 / 4,
+               sizeof( Affine<Scalar> ) );
+
+    Matrix<Scalar, 4, 4> m = GetRandomMatrix<Matrix<Scalar, 4, 4>>();
+    for( u32 j = 0; j < 4; ++j )
+        m.m_elements[j][3] = j == 3 ? 1 : 0;
+    Affine<Scalar> a( m );
+    EXPECT_EQ( m, ToMatrix( a ) );
+    EXPECT_EQ( a, Affine<Scalar>( ToMatrix( a ) ) );
+
+    EXPECT_EQ( m.GetRight().xyz(), a.GetRight() );
+    EXPECT_EQ( m.GetForward().xyz(), a.GetForward() );
+    EXPECT_EQ( m.GetUp().xyz(), a.GetUp() );
+    EXPECT_EQ( m.GetTranslation().xyz(), a.GetTranslation() );
+    EXPECT_EQ( ( m.template GetSubMatrix<3, 3>() ), a.GetLinear() );
+
+    Affine<Scalar> b = GetRandomAffine<Scalar>();
+    b.SetRight( a.GetRight() );
+    b.SetForward( a.GetForward() );
+    b.SetUp( a.GetUp() );
+    b.SetTranslation( a.GetTranslation() );
+    EXPECT_EQ( a, b );
+    EXPECT_EQ( a, Affine<Scalar>( a.GetLinear(), a.GetTranslation() ) );
+
+    b.GetTranslation() += Vector<Scalar, 3>( 1 );
+    EXPECT_NE( a, b );
+
+    EXPECT_EQ( ( Identity<Scalar, 4>() ),
+               ToMatrix( IdentityAffine<Scalar>() ) );
+}
+
+TYPED_TEST(AffineTest, Mul )
+{
+    typedef TypeParam Scalar;
+
+    for( u32 i = 0; i < 100; ++i )
+    {
+        Affine<Scalar> a = GetRandomAffine<Scalar>();
+        Affine<Scalar> b = GetRandomAffine<Scalar>();
+        Vector<Scalar, 3> v = GetRandomMatrix<Vector<Scalar, 3>>();
+
+        //
+        // The terms which are skipped are all exactly zero, so these are the
+        // same
+        //
+        EXPECT_EQ( Mul( ToMatrix( a ), ToMatrix( b ) ), ToMatrix( Mul( a, b ) ) );
+        EXPECT_EQ( Mul( ToMatrix( a ), Vector<Scalar, 4>( v, 1 ) ).xyz(),
+                   TransformPoint( a, v ) );
+        EXPECT_EQ( Mul( ToMatrix( a ), Vector<Scalar, 4>( v, 0 ) ).xyz(),
+                   TransformVector( a, v ) );
+        ExpectNear( TransformPoint( a, TransformPoint( b, v ) ),
+                    TransformPoint( Mul( a, b ), v ), Scalar{1e-2} );
+    }
+
+    Affine<Scalar> a = GetRandomAffine<Scalar>();
+    EXPECT_EQ( a, Mul( IdentityAffine<Scalar>(), a ) );
+    EXPECT_EQ( a, Mul( a, IdentityAffine<Scalar>() ) );
+}
+
+TYPED_TEST(AffineTest, Inverse )
+{
+    typedef TypeParam Scalar;
+    const Scalar tolerance = 1e-3;
+
+    for( u32 i = 0; i < 100; ++i )
+    {
+        Affine<Scalar> a = GetRandomAffine<Scalar>();
+        if( std::abs( Determinant( a ) ) < 1 )
+            continue;
+        EXPECT_NEAR( Determinant( ToMatrix( a ) ), Determinant( a ),
+                     std::abs( Determinant( a ) ) * tolerance );
+
+        ExpectNear( Inverted( ToMatrix( a ) ), ToMatrix( Inverted( a ) ),
+                    tolerance );
+        ExpectNear( Identity<Scalar, 4>(), ToMatrix( Mul( a, Inverted( a ) ) ),
+                    tolerance );
+
+        Affine<Scalar> b = a;
+        Invert( b );
+        EXPECT_EQ( Inverted( a ), b );
+
+        //
+        // A rotation and translation
+        //
+        Affine<Scalar> r( RotateAxisAngle( Normalized( a.GetRight() ),
+                                           a.GetUp().x() ) );
+        r.SetTranslation( a.GetTranslation() );
+        ExpectNear( ToMatrix( Inverted( r ) ), ToMatrix( InvertedRigid( r ) ),
+                    tolerance );
+        ExpectNear( Identity<Scalar, 4>(),
+                    ToMatrix( Mul( InvertedRigid( r ), r ) ), tolerance );
+
+        b = r;
+        InvertRigid( b );
+        EXPECT_EQ( InvertedRigid( r ), b );
+    }
+}
+
+TYPED_TEST(AffineTest, Batch )
+{
+    typedef TypeParam Scalar;
+    typedef Vector<Scalar, 3> Point;
+
+    struct Vertex
+    {
+        u8     pad;
+        Point  position;
+        Scalar weight;
+    };
+
+    const u32 count = 37;
+    Affine<Scalar> a = GetRandomAffine<Scalar>();
+    std::vector<Vertex> in( count );
+    std::vector<Point> points( count );
+    std::vector<Point> vectors( count );
+    for( auto& v : in )
+    {
+        v.position = GetRandomMatrix<Point>();
+        v.weight = 3;
+    }
+
+    TransformPoints( a, &in[0].position, points.data(), count, sizeof(Vertex) );
+    TransformVectors( a, &in[0].position, vectors.data(), count,
+                      sizeof(Vertex) );
+    for( u32 i = 0; i < count; ++i )
+    {
+        ASSERT_EQ( TransformPoint( a, in[i].position ), points[i] );
+        ASSERT_EQ( TransformVector( a, in[i].position ), vectors[i] );
+    }
+
+    TransformPoints( a, points.data(), &in[0].position, count,
+                     sizeof(Point), sizeof(Vertex) );
+    for( u32 i = 0; i < count; ++i )
+    {
+        ASSERT_EQ( TransformPoint( a, points[i] ), in[i].position );
+        ASSERT_EQ( Scalar{3}, in[i].weight );
+    }
+}
@@ -0,0 +1,150 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#include "gtest/gtest.h"
+#include <cstdint>
+#include <list>
+#include <vector>
+
+#include <joemath/joemath.hpp>
+
+using namespace JoeMath;
+
+namespace
+{
+    template <typename T>
+    bool IsAligned( const T* p, std::size_t alignment )
+    {
+        return reinterpret_cast<std::uintptr_t>( p ) % alignment == 0;
+    }
+}
+
+template <typename T>
+class AlignmentTest : public testing::Test
+{
+};
+
+using testing::Types;
+
+typedef Types<Matrix<float, 1, 1>,
+              Matrix<float, 2, 2>,
+              Matrix<float, 3, 3>,
+              Matrix<float, 3, 4>,
+              Matrix<float, 4, 3>,
+              Matrix<float, 4, 4>,
+              Matrix<float, 8, 8>,
+              Matrix<double, 2, 2>,
+              Matrix<double, 3, 3>,
+              Matrix<double, 4, 4>,
+              Vector<float, 2>,
+              Vector<float, 3>,
+              Vector<float, 4>,
+              Vector<float, 7>,
+              Vector<float, 8>,
+              Vector<double, 2>,
+              Vector<double, 3>,
+              Vector<double, 4>,
+              Matrix<float, 1, 4>,
+              Vector<u8, 4>,
+              Vector<s32, 4>  > AlignmentTypes;
+
+TYPED_TEST_CASE(AlignmentTest, AlignmentTypes);
+
+TYPED_TEST(AlignmentTest, Layout )
+{
+    typedef typename TypeParam::scalar_type Scalar;
+    const std::size_t size = sizeof(Scalar) * TypeParam::rows *
+                                              TypeParam::columns;
+
+    EXPECT_EQ( size, sizeof(TypeParam) );
+    EXPECT_EQ( matrix_alignment<TypeParam>::value, alignof(TypeParam) );
+    EXPECT_LE( alignof(Scalar), alignof(TypeParam) );
+    EXPECT_EQ( 0u, sizeof(TypeParam) % alignof(TypeParam) );
+
+    //
+    // The alignment only goes as far as it can without padding
+    //
+    const bool aligned = JOEMATH_ALIGNMENT != 0 && size % 16 == 0 &&
+                         ( !TypeParam::is_vector ||
+                           TypeParam::vector_size % 4 == 0 );
+    if( aligned )
+    {
+        EXPECT_LE( 16u, alignof(TypeParam) );
+        EXPECT_LE( alignof(TypeParam), std::size_t{JOEMATH_ALIGNMENT} );
+    }
+    else
+        EXPECT_EQ( alignof(Scalar), alignof(TypeParam) );
+
+    //
+    // Columns must be at least as aligned as the matrix they're in
+    //
+    typedef typename TypeParam::column_type Column;
+    EXPECT_EQ( 0u, alignof(TypeParam) % alignof(Column) );
+    EXPECT_EQ( 0u, sizeof(Column) % alignof(Column) );
+}
+
+TYPED_TEST(AlignmentTest, Allocator )
+{
+    std::vector<TypeParam, AlignedAllocator<TypeParam>> v;
+    for( u32 i = 0; i < 100; ++i )
+    {
+        v.push_back( TypeParam( typename TypeParam::scalar_type( i ) ) );
+        ASSERT_TRUE( IsAligned( v.data(), cache_line_size ) );
+        ASSERT_TRUE( IsAligned( v.data(), alignof(TypeParam) ) );
+    }
+    for( u32 i = 0; i < 100; ++i )
+        ASSERT_EQ( TypeParam( typename TypeParam::scalar_type( i ) ), v[i] );
+
+    std::vector<TypeParam, AlignedAllocator<TypeParam, 1>> w( 3 );
+    EXPECT_TRUE( IsAligned( w.data(), alignof(TypeParam) ) );
+}
+
+TEST(AlignmentTest, AllocatorRebind )
+{
+    //
+    // list rebinds the allocator to its node type
+    //
+    std::list<float4, AlignedAllocator<float4, 32>> l;
+    for( u32 i = 0; i < 10; ++i )
+        l.push_back( float4( float( i ) ) );
+    u32 i = 0;
+    for( const float4& f : l )
+        EXPECT_EQ( float4( float( i++ ) ), f );
+
+    AlignedAllocator<float4, 32> a;
+    AlignedAllocator<double, 32> b( a );
+    EXPECT_TRUE( a == b );
+    EXPECT_FALSE( a != b );
+    EXPECT_EQ( 32u, ( AlignedAllocator<float, 32>::alignment ) );
+    EXPECT_EQ( alignof(float4x4) > 16 ? alignof(float4x4) : 16,
+               ( AlignedAllocator<float4x4, 16>::alignment ) );
+
+    double* p = b.allocate( 0 );
+    EXPECT_TRUE( IsAligned( p, 32 ) );
+    b.deallocate( p, 0 );
+}
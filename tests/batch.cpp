@@ -0,0 +1,495 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <joemath/joemath.hpp>
+
+using namespace JoeMath;
+
+namespace
+{
+    template <typename T>
+    T GetRandomMatrix()
+    {
+        static std::uniform_real_distribution<typename T::scalar_type> re(-1000,
+                                                                          1000);
+        static auto ran = std::bind(re,std::minstd_rand());
+        T ret;
+        for( u32 i = 0; i < T::columns; ++i )
+            for( u32 j = 0; j < T::rows; ++j )
+                ret.m_elements[i][j] = ran();
+        return ret;
+    }
+
+    //
+    // The vector extended with w, transformed by m and truncated again
+    //
+    template <typename Scalar, u32 Size>
+    Vector<Scalar, Size-1> Transform( const Matrix<Scalar, Size, Size>& m,
+                                      const Vector<Scalar, Size-1>& v,
+                                      Scalar w )
+    {
+        Vector<Scalar, Size> e;
+        for( u32 i = 0; i < Size-1; ++i )
+            e.m_elements[0][i] = v.m_elements[0][i];
+        e.m_elements[0][Size-1] = w;
+        Vector<Scalar, Size> r = Mul( m, e );
+        Vector<Scalar, Size-1> ret;
+        for( u32 i = 0; i < Size-1; ++i )
+            ret.m_elements[0][i] = r.m_elements[0][i];
+        return ret;
+    }
+}
+
+template <typename T>
+class BatchTest : public testing::Test
+{
+};
+
+using testing::Types;
+
+typedef Types<Matrix<float, 3, 3>,
+              Matrix<float, 4, 4>,
+              Matrix<double, 4, 4>,
+              Matrix<float, 5, 5>  > BatchTypes;
+
+TYPED_TEST_CASE(BatchTest, BatchTypes);
+
+TYPED_TEST(BatchTest, TransformPoints )
+{
+    typedef typename TypeParam::scalar_type Scalar;
+    typedef Vector<Scalar, TypeParam::rows-1> Point;
+    const u32 count = 37;
+    TypeParam m = GetRandomMatrix<TypeParam>();
+    std::vector<Point> in( count );
+    std::vector<Point> out( count );
+    for( auto& p : in )
+        p = GetRandomMatrix<Point>();
+
+    TransformPoints( m, in.data(), out.data(), count );
+    for( u32 i = 0; i < count; ++i )
+        ASSERT_EQ( Transform( m, in[i], Scalar{1} ), out[i] );
+}
+
+TYPED_TEST(BatchTest, TransformVectors )
+{
+    typedef typename TypeParam::scalar_type Scalar;
+    typedef Vector<Scalar, TypeParam::rows-1> Point;
+    const u32 count = 37;
+    TypeParam m = GetRandomMatrix<TypeParam>();
+    std::vector<Point> in( count );
+    std::vector<Point> out( count );
+    for( auto& p : in )
+        p = GetRandomMatrix<Point>();
+
+    TransformVectors( m, in.data(), out.data(), count );
+    for( u32 i = 0; i < count; ++i )
+        ASSERT_EQ( Transform( m, in[i], Scalar{0} ), out[i] );
+}
+
+TYPED_TEST(BatchTest, TransformHomogeneous )
+{
+    typedef Vector<typename TypeParam::scalar_type, TypeParam::rows> Point;
+    const u32 count = 37;
+    TypeParam m = GetRandomMatrix<TypeParam>();
+    std::vector<Point> in( count );
+    std::vector<Point> out( count );
+    for( auto& p : in )
+        p = GetRandomMatrix<Point>();
+
+    TransformHomogeneous( m, in.data(), out.data(), count );
+    for( u32 i = 0; i < count; ++i )
+        ASSERT_EQ( Mul( m, in[i] ), out[i] );
+}
+
+TYPED_TEST(BatchTest, Stride )
+{
+    typedef typename TypeParam::scalar_type Scalar;
+    typedef Vector<Scalar, TypeParam::rows-1> Point;
+
+    //
+    // Read positions from the middle of a structure and write them to a
+    // tightly packed array
+    //
+    struct Vertex
+    {
+        u8    pad;
+        Point position;
+        Scalar weight;
+    };
+
+    const u32 count = 19;
+    TypeParam m = GetRandomMatrix<TypeParam>();
+    std::vector<Vertex> in( count );
+    std::vector<Point> out( count + 1, Point( Scalar{7} ) );
+    for( auto& v : in )
+    {
+        v.position = GetRandomMatrix<Point>();
+        v.weight = 3;
+    }
+
+    TransformPoints( m, &in[0].position, out.data(), count, sizeof(Vertex) );
+    for( u32 i = 0; i < count; ++i )
+    {
+        ASSERT_EQ( Transform( m, in[i].position, Scalar{1} ), out[i] );
+        ASSERT_EQ( Scalar{3}, in[i].weight );
+    }
+    ASSERT_EQ( Point( Scalar{7} ), out[count] );
+
+    //
+    // And back again
+    //
+    TransformVectors( m, out.data(), &in[0].position, count,
+                      sizeof(Point), sizeof(Vertex) );
+    for( u32 i = 0; i < count; ++i )
+    {
+        ASSERT_EQ( Transform( m, out[i], Scalar{0} ), in[i].position );
+        ASSERT_EQ( Scalar{3}, in[i].weight );
+    }
+}
+
+TYPED_TEST(BatchTest, InPlace )
+{
+    typedef typename TypeParam::scalar_type Scalar;
+    typedef Vector<Scalar, TypeParam::rows-1> Point;
+    typedef Vector<Scalar, TypeParam::rows> HomogeneousPoint;
+    const u32 count = 23;
+    TypeParam m = GetRandomMatrix<TypeParam>();
+    std::vector<Point> points( count );
+    std::vector<HomogeneousPoint> homogeneous( count );
+    for( auto& p : points )
+        p = GetRandomMatrix<Point>();
+    for( auto& p : homogeneous )
+        p = GetRandomMatrix<HomogeneousPoint>();
+    std::vector<Point> original_points( points );
+    std::vector<HomogeneousPoint> original_homogeneous( homogeneous );
+
+    TransformPoints( m, points.data(), points.data(), count );
+    for( u32 i = 0; i < count; ++i )
+        ASSERT_EQ( Transform( m, original_points[i], Scalar{1} ), points[i] );
+
+    TransformHomogeneous( m, homogeneous.data(), homogeneous.data(), count );
+    for( u32 i = 0; i < count; ++i )
+        ASSERT_EQ( Mul( m, original_homogeneous[i] ), homogeneous[i] );
+}
+
+TEST(BatchTest, Generic )
+{
+    //
+    // The SIMD overloads should agree with the generic versions exactly
+    //
+    const u32 count = 41;
+    float4x4 m = GetRandomMatrix<float4x4>();
+    std::vector<float3> in( count );
+    std::vector<float3> simd( count );
+    std::vector<float3> generic( count );
+    for( auto& p : in )
+        p = GetRandomMatrix<float3>();
+
+    TransformPoints( m, in.data(), simd.data(), count );
+    TransformPoints<float, 4>( m, in.data(), generic.data(), count );
+    ASSERT_EQ( generic, simd );
+
+    TransformVectors( m, in.data(), simd.data(), count );
+    TransformVectors<float, 4>( m, in.data(), generic.data(), count );
+    ASSERT_EQ( generic, simd );
+
+    std::vector<float4> in4( count );
+    std::vector<float4> simd4( count );
+    std::vector<float4> generic4( count );
+    for( auto& p : in4 )
+        p = GetRandomMatrix<float4>();
+
+    TransformHomogeneous( m, in4.data(), simd4.data(), count );
+    TransformHomogeneous<float, 4>( m, in4.data(), generic4.data(), count );
+    ASSERT_EQ( generic4, simd4 );
+}
+
+TYPED_TEST(BatchTest, InvertBatch )
+{
+    typedef typename TypeParam::scalar_type Scalar;
+    const u32 size = TypeParam::rows;
+    const u32 count = 37;
+
+    //
+    // Make the matrices diagonally dominant so that they're well conditioned
+    //
+    const Scalar dominance = Scalar( 1000 ) * size;
+    std::vector<TypeParam> in( count );
+    for( auto& m : in )
+    {
+        m = GetRandomMatrix<TypeParam>();
+        for( u32 i = 0; i < size; ++i )
+            m.m_elements[i][i] += m.m_elements[i][i] < 0 ? -dominance
+                                                          :  dominance;
+    }
+    std::vector<TypeParam> out( count );
+    std::unique_ptr<bool[]> singular( new bool[count] );
+
+    InvertBatch( in.data(), out.data(), count, singular.get() );
+    for( u32 n = 0; n < count; ++n )
+    {
+        ASSERT_FALSE( singular[n] );
+        TypeParam p = Mul( out[n], in[n] ) - Identity<Scalar, size>();
+        for( u32 i = 0; i < size; ++i )
+            for( u32 j = 0; j < size; ++j )
+                ASSERT_NEAR( 0, p.m_elements[i][j], 1e-5f );
+    }
+
+    //
+    // In place, without the mask
+    //
+    InvertBatch( in.data(), in.data(), count );
+    ASSERT_EQ( out, in );
+}
+
+TEST(BatchTest, InvertBatchSingular )
+{
+    const u32 count = 19;
+    std::vector<float4x4> in( count );
+    for( u32 n = 0; n < count; ++n )
+    {
+        in[n] = GetRandomMatrix<float4x4>();
+        if( n % 3 == 0 )
+            in[n].SetColumn( 2, float4( 0.f ) );
+        if( n == 10 )
+            in[n] = float4x4( 0.f );
+    }
+
+    std::vector<float4x4> out( count );
+    std::unique_ptr<bool[]> singular( new bool[count] );
+    InvertBatch( in.data(), out.data(), count, singular.get() );
+
+    for( u32 n = 0; n < count; ++n )
+    {
+        ASSERT_EQ( n % 3 == 0 || n == 10, singular[n] );
+        if( singular[n] )
+            continue;
+
+        //
+        // Compare against Inverted relative to the largest element
+        //
+        const float4x4 expected = Inverted( in[n] );
+        float largest = 0;
+        for( u32 i = 0; i < 4; ++i )
+            for( u32 j = 0; j < 4; ++j )
+                largest = std::max( largest,
+                                    std::abs( expected.m_elements[i][j] ) );
+        for( u32 i = 0; i < 4; ++i )
+            for( u32 j = 0; j < 4; ++j )
+                ASSERT_NEAR( expected.m_elements[i][j], out[n].m_elements[i][j],
+                             largest * 1e-4f );
+    }
+
+    InvertBatch( in.data(), out.data(), 0, singular.get() );
+}
+
+TYPED_TEST(BatchTest, Normalize )
+{
+    //
+    // The batched functions should agree with the single vector ones exactly
+    //
+    typedef typename TypeParam::column_type V;
+    typedef typename TypeParam::scalar_type Scalar;
+    const u32 count = 39;
+    std::vector<V> in( count );
+    for( auto& v : in )
+        v = GetRandomMatrix<V>();
+    in[5] = V( Scalar{0} );
+    in[17] = V( std::numeric_limits<Scalar>::quiet_NaN() );
+    in[22] = V( std::numeric_limits<Scalar>::denorm_min() );
+    const V fallback( Scalar{1} );
+
+    std::vector<V> out( count );
+    NormalizedSafe( in.data(), out.data(), count, fallback );
+    for( u32 n = 0; n < count; ++n )
+        ASSERT_EQ( NormalizedSafe( in[n], fallback ), out[n] );
+    ASSERT_EQ( fallback, out[5] );
+    ASSERT_EQ( fallback, out[17] );
+    ASSERT_EQ( fallback, out[22] );
+
+    NormalizedSafe( in.data(), out.data(), count );
+    ASSERT_EQ( V( Scalar{0} ), out[5] );
+
+    //
+    // The rest are only defined for vectors with a nonzero length
+    //
+    in[5] = in[17] = in[22] = GetRandomMatrix<V>();
+
+    NormalizedPrecise( in.data(), out.data(), count );
+    for( u32 n = 0; n < count; ++n )
+        ASSERT_EQ( NormalizedPrecise( in[n] ), out[n] );
+
+    NormalizedFast( in.data(), out.data(), count );
+    for( u32 n = 0; n < count; ++n )
+        ASSERT_EQ( NormalizedFast( in[n] ), out[n] );
+
+    std::vector<Scalar> lengths( count );
+    LengthFast( in.data(), lengths.data(), count );
+    for( u32 n = 0; n < count; ++n )
+        ASSERT_EQ( LengthFast( in[n] ), lengths[n] );
+
+    InverseLength( in.data(), lengths.data(), count );
+    for( u32 n = 0; n < count; ++n )
+        ASSERT_EQ( InverseLength( in[n] ), lengths[n] );
+
+    //
+    // In place
+    //
+    std::vector<V> expected = out;
+    NormalizedFast( in.data(), in.data(), count );
+    ASSERT_EQ( expected, in );
+}
+
+TEST(BatchTest, SinCosFast )
+{
+    //
+    // Including angles outside of the polynomial's range
+    //
+    const u32 count = 43;
+    std::vector<float> angles( count );
+    for( u32 n = 0; n < count; ++n )
+        angles[n] = GetRandomMatrix<Vector<float, 1>>()[0];
+    angles[6] = 1e5f;
+    angles[13] = -std::numeric_limits<float>::infinity();
+
+    std::vector<float> sin( count );
+    std::vector<float> cos( count );
+    SinCosFast( angles.data(), sin.data(), cos.data(), count );
+    for( u32 n = 0; n < count; ++n )
+    {
+        float s;
+        float c;
+        SinCosFast( angles[n], s, c );
+        if( std::isnan( s ) )
+        {
+            ASSERT_TRUE( std::isnan( sin[n] ) );
+            ASSERT_TRUE( std::isnan( cos[n] ) );
+            continue;
+        }
+        ASSERT_EQ( s, sin[n] );
+        ASSERT_EQ( c, cos[n] );
+    }
+
+    float4 s4;
+    float4 c4;
+    SinCosFast( float4( angles[0], angles[1], angles[6], angles[3] ),
+                s4, c4 );
+    ASSERT_EQ( float4( sin[0], sin[1], sin[6], sin[3] ), s4 );
+    ASSERT_EQ( float4( cos[0], cos[1], cos[6], cos[3] ), c4 );
+
+    Vector<double, 3> sd;
+    Vector<double, 3> cd;
+    SinCosFast( Vector<double, 3>( 1, 2, 3 ), sd, cd );
+    for( u32 i = 0; i < 3; ++i )
+    {
+        ASSERT_EQ( std::sin( double( i + 1 ) ), sd[i] );
+        ASSERT_EQ( std::cos( double( i + 1 ) ), cd[i] );
+    }
+}
+
+TYPED_TEST(BatchTest, RotateZBatch )
+{
+    typedef typename TypeParam::scalar_type Scalar;
+    const u32 count = 150;
+    std::vector<Scalar> angles( count );
+    for( u32 n = 0; n < count; ++n )
+        angles[n] = GetRandomMatrix<Vector<Scalar, 1>>()[0];
+
+    std::vector<TypeParam> out( count );
+    RotateZBatch( angles.data(), out.data(), count );
+    for( u32 n = 0; n < count; ++n )
+        ASSERT_EQ( ( RotateZ<Scalar, TypeParam::rows>( angles[n] ) ), out[n] );
+}
+
+TEST(BatchTest, Decompositions )
+{
+    const u32 count = 27;
+    std::vector<float3x3> in( count );
+    for( u32 n = 0; n < count; ++n )
+        in[n] = GetRandomMatrix<float3x3>();
+    in[5] = float3x3( 0.f );
+    in[9] = Identity<float, 3>();
+    in[10].SetColumn( 2, in[10].GetColumn( 1 ) );
+
+    std::vector<EigenDecomposition<float>> eigen( count );
+    EigenSymmetricBatch( in.data(), eigen.data(), count );
+    std::vector<SingularValueDecomposition<float>> svd( count );
+    SVDBatch( in.data(), svd.data(), count );
+    for( u32 n = 0; n < count; ++n )
+    {
+        const auto e = EigenSymmetric( in[n] );
+        ASSERT_EQ( e.m_values, eigen[n].m_values );
+        ASSERT_EQ( e.m_vectors, eigen[n].m_vectors );
+
+        const auto s = SVD( in[n] );
+        ASSERT_EQ( s.m_u, svd[n].m_u );
+        ASSERT_EQ( s.m_values, svd[n].m_values );
+        ASSERT_EQ( s.m_v, svd[n].m_v );
+    }
+
+    std::vector<PolarDecomposition<float>> polar( count );
+    PolarDecomposeBatch( in.data(), polar.data(), count );
+    std::vector<float3x3> orthonormal( count );
+    OrthonormalizeBatch( in.data(), orthonormal.data(), count );
+    for( u32 n = 0; n < count; ++n )
+    {
+        if( n == 5 || n == 10 )
+            continue;
+        const auto p = PolarDecompose( in[n] );
+        ASSERT_EQ( p.m_rotation, polar[n].m_rotation );
+        ASSERT_EQ( p.m_stretch, polar[n].m_stretch );
+        ASSERT_EQ( Orthonormalized( in[n] ), orthonormal[n] );
+    }
+
+    //
+    // In place, keeping the rest of the 4x4 matrices
+    //
+    std::vector<float4x4> transforms( count );
+    for( u32 n = 0; n < count; ++n )
+        transforms[n] = GetRandomMatrix<float4x4>();
+    std::vector<float4x4> expected = transforms;
+    OrthonormalizeBatch( transforms.data(), transforms.data(), count );
+    for( u32 n = 0; n < count; ++n )
+        ASSERT_EQ( Orthonormalized( expected[n] ), transforms[n] );
+
+    std::vector<Matrix<double, 3, 3>> in_d( count );
+    for( u32 n = 0; n < count; ++n )
+        in_d[n] = GetRandomMatrix<Matrix<double, 3, 3>>();
+    std::vector<SingularValueDecomposition<double>> svd_d( count );
+    SVDBatch( in_d.data(), svd_d.data(), count );
+    for( u32 n = 0; n < count; ++n )
+        ASSERT_EQ( SVD( in_d[n] ).m_values, svd_d[n].m_values );
+}
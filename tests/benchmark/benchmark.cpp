@@ -0,0 +1,269 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+
+#include <joemath/simd.hpp>
+
+namespace Benchmark
+{
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+
+        double Seconds( Clock::duration d )
+        {
+            return std::chrono::duration<double>( d ).count();
+        }
+
+        double TimeIterations( const Function& function, u64 iterations )
+        {
+            ClobberMemory();
+            auto start = Clock::now();
+            function( iterations );
+            ClobberMemory();
+            return Seconds( Clock::now() - start );
+        }
+
+        //
+        // Runs the function until warmup_time has passed and returns the
+        // number of iterations needed for one sample to last at least
+        // min_sample_time
+        //
+        u64 Calibrate( const Function& function, const Options& options )
+        {
+            u64 iterations = 1;
+            double warmed = 0;
+            double elapsed = 0;
+
+            for( ;; )
+            {
+                elapsed = TimeIterations( function, iterations );
+                warmed += elapsed;
+
+                if( elapsed >= options.min_sample_time &&
+                    warmed >= options.warmup_time )
+                    break;
+
+                if( elapsed < options.min_sample_time )
+                {
+                    //
+                    // Aim a little over the minimum, but don't grow too fast
+                    // in case the first few runs were dominated by noise
+                    //
+                    double scale = elapsed > 0 ?
+                                   1.2 * options.min_sample_time / elapsed : 10;
+                    iterations = std::max<u64>( iterations + 1,
+                                   iterations * std::min( scale, 10.0 ) );
+                }
+            }
+
+            return iterations;
+        }
+
+        std::string Escape( const std::string& s )
+        {
+            std::string ret;
+            for( char c : s )
+            {
+                if( c == '"' || c == '\\' )
+                    ret += '\\';
+                ret += c;
+            }
+            return ret;
+        }
+
+        const char* SimdName()
+        {
+#if defined( JOEMATH_AVX )
+            return "AVX";
+#elif defined( JOEMATH_SSE )
+            return "SSE4";
+#else
+            return "NONE";
+#endif
+        }
+    }
+
+    double Result::Median( ) const
+    {
+        return Percentile( 50 );
+    }
+
+    double Result::Percentile( double p ) const
+    {
+        if( samples.empty() )
+            return 0;
+
+        //
+        // Linear interpolation between the closest ranks
+        //
+        double rank = p / 100 * ( samples.size() - 1 );
+        std::size_t lower = static_cast<std::size_t>( std::floor( rank ) );
+        std::size_t upper = std::min( lower + 1, samples.size() - 1 );
+        double t = rank - lower;
+        return samples[lower] + t * ( samples[upper] - samples[lower] );
+    }
+
+    double Result::Mean( ) const
+    {
+        if( samples.empty() )
+            return 0;
+        return std::accumulate( samples.begin(), samples.end(), 0.0 ) /
+               samples.size();
+    }
+
+    double Result::StdDev( ) const
+    {
+        if( samples.size() < 2 )
+            return 0;
+        double mean = Mean();
+        double sum = 0;
+        for( double s : samples )
+            sum += ( s - mean ) * ( s - mean );
+        return std::sqrt( sum / ( samples.size() - 1 ) );
+    }
+
+    void Suite::Add( std::string name, Function function )
+    {
+        m_benchmarks.emplace_back( std::move( name ), std::move( function ) );
+    }
+
+    std::vector<Result> Suite::Run( const Options& options ) const
+    {
+        std::vector<Result> results;
+
+        std::cout << std::left << std::setw( 48 ) << "benchmark" <<
+                     std::right << std::setw( 12 ) << "median ns" <<
+                     std::setw( 12 ) << "p10 ns" <<
+                     std::setw( 12 ) << "p90 ns" <<
+                     std::setw( 14 ) << "iterations" << std::endl;
+
+        for( const auto& benchmark : m_benchmarks )
+        {
+            if( benchmark.first.find( options.filter ) == std::string::npos )
+                continue;
+
+            Result result;
+            result.name = benchmark.first;
+            result.iterations = Calibrate( benchmark.second, options );
+
+            for( u32 i = 0; i < options.samples; ++i )
+                result.samples.push_back(
+                    TimeIterations( benchmark.second, result.iterations ) *
+                    1e9 / result.iterations );
+            std::sort( result.samples.begin(), result.samples.end() );
+
+            std::cout << std::left << std::setw( 48 ) << result.name <<
+                         std::right << std::fixed << std::setprecision( 2 ) <<
+                         std::setw( 12 ) << result.Median() <<
+                         std::setw( 12 ) << result.Percentile( 10 ) <<
+                         std::setw( 12 ) << result.Percentile( 90 ) <<
+                         std::setw( 14 ) << result.iterations << std::endl;
+
+            results.push_back( std::move( result ) );
+        }
+
+        return results;
+    }
+
+    bool ParseOptions( int argc, char** argv, Options& options )
+    {
+        for( int i = 1; i < argc; ++i )
+        {
+            bool has_value = i + 1 < argc;
+            if( !std::strcmp( argv[i], "--filter" ) && has_value )
+                options.filter = argv[++i];
+            else if( !std::strcmp( argv[i], "--json" ) && has_value )
+                options.json_path = argv[++i];
+            else if( !std::strcmp( argv[i], "--samples" ) && has_value )
+                options.samples = std::max( 1, std::atoi( argv[++i] ) );
+            else if( !std::strcmp( argv[i], "--min-time" ) && has_value )
+                options.min_sample_time = std::atof( argv[++i] );
+            else if( !std::strcmp( argv[i], "--warmup" ) && has_value )
+                options.warmup_time = std::atof( argv[++i] );
+            else
+            {
+                std::cerr << "Usage: " << argv[0] <<
+                             " [--filter substring] [--json file]"
+                             " [--samples n] [--min-time seconds]"
+                             " [--warmup seconds]" << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void WriteJson( const std::vector<Result>& results,
+                    const std::string& path )
+    {
+        std::ofstream out( path );
+        out << std::setprecision( 9 );
+
+        out << "{\n";
+        out << "  \"context\": {\n";
+        out << "    \"simd\": \"" << SimdName() << "\",\n";
+#if defined( __VERSION__ )
+        out << "    \"compiler\": \"" << Escape( __VERSION__ ) << "\"\n";
+#else
+        out << "    \"compiler\": \"unknown\"\n";
+#endif
+        out << "  },\n";
+        out << "  \"benchmarks\": [";
+
+        for( std::size_t i = 0; i < results.size(); ++i )
+        {
+            const Result& r = results[i];
+            out << ( i ? ",\n" : "\n" );
+            out << "    {\n";
+            out << "      \"name\": \"" << Escape( r.name ) << "\",\n";
+            out << "      \"iterations\": " << r.iterations << ",\n";
+            out << "      \"samples\": " << r.samples.size() << ",\n";
+            out << "      \"median_ns\": " << r.Median() << ",\n";
+            out << "      \"p10_ns\": " << r.Percentile( 10 ) << ",\n";
+            out << "      \"p90_ns\": " << r.Percentile( 90 ) << ",\n";
+            out << "      \"min_ns\": " << r.samples.front() << ",\n";
+            out << "      \"max_ns\": " << r.samples.back() << ",\n";
+            out << "      \"mean_ns\": " << r.Mean() << ",\n";
+            out << "      \"stddev_ns\": " << r.StdDev() << "\n";
+            out << "    }";
+        }
+
+        out << "\n  ]\n}\n";
+    }
+}
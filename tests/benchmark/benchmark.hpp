@@ -0,0 +1,133 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <joemath/types.hpp>
+
+//
+// A small microbenchmark harness
+//
+// Each benchmark is a function which performs the operation being measured
+// a given number of times. The harness warms it up, picks an iteration count
+// which makes each sample take at least a minimum time and then takes a
+// number of samples, reporting the distribution of the time per operation.
+//
+
+namespace Benchmark
+{
+    using JoeMath::u32;
+    using JoeMath::u64;
+
+    /**
+      * Forces the compiler to assume that value is read, so that the
+      * computation of it can't be removed
+      */
+    template <typename T>
+    inline void DoNotOptimize( const T& value )
+    {
+#if defined( __GNUC__ )
+        asm volatile( "" : : "r"( &value ) : "memory" );
+#else
+        static volatile const void* sink;
+        sink = &value;
+#endif
+    }
+
+    /**
+      * Forces the compiler to assume that all memory has been read and written
+      */
+    inline void ClobberMemory()
+    {
+#if defined( __GNUC__ )
+        asm volatile( "" : : : "memory" );
+#endif
+    }
+
+    /**
+      * The body of a benchmark, it should perform the operation iterations
+      * times
+      */
+    using Function = std::function<void( u64 iterations )>;
+
+    struct Result
+    {
+        std::string name;
+        u64         iterations;
+
+        /**
+          * The time per operation of each sample in nanoseconds, sorted
+          */
+        std::vector<double> samples;
+
+        double Median       ( ) const;
+        double Percentile   ( double p ) const;
+        double Mean         ( ) const;
+        double StdDev       ( ) const;
+    };
+
+    struct Options
+    {
+        /** Only run benchmarks whose names contain this */
+        std::string filter;
+
+        /** Where to write the results as JSON, nothing is written if empty */
+        std::string json_path;
+
+        u32    samples          = 21;
+        double min_sample_time  = 1e-3;
+        double warmup_time      = 5e-3;
+    };
+
+    class Suite
+    {
+    public:
+        void    Add     ( std::string name, Function function );
+
+        /**
+          * Runs all the benchmarks matching the filter, printing each result
+          * as it's finished
+          */
+        std::vector<Result>     Run     ( const Options& options ) const;
+
+    private:
+        std::vector<std::pair<std::string, Function>> m_benchmarks;
+    };
+
+    /**
+      * Parses the command line, returns false if it's invalid
+      */
+    bool    ParseOptions    ( int argc, char** argv, Options& options );
+
+    void    WriteJson       ( const std::vector<Result>& results,
+                              const std::string& path );
+}
@@ -0,0 +1,1083 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#include <iomanip>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <joemath/joemath.hpp>
+#include <joemath/expression.hpp>
+#include <joemath/parallel.hpp>
+#include <joemath/soa.hpp>
+
+#include "benchmark.hpp"
+
+using namespace JoeMath;
+using Benchmark::DoNotOptimize;
+using Benchmark::Suite;
+
+namespace
+{
+    //
+    // Every benchmark cycles through this many random operands, enough to
+    // defeat constant folding while still fitting in cache
+    //
+    const u32 DATA_SIZE = 1024;
+    const u32 DATA_MASK = DATA_SIZE - 1;
+
+    //
+    // The operands are kept cache line aligned so that the timings don't
+    // depend on where the allocator happened to put them
+    //
+    template <typename T>
+    using Data = std::vector<T, AlignedAllocator<T>>;
+
+    std::minstd_rand random_engine{ 0 };
+
+    //
+    // Random operands, these are never zero so that division is always safe
+    //
+    template <typename Scalar>
+    Scalar RandomScalar( std::true_type /* is_floating_point */ )
+    {
+        std::uniform_real_distribution<Scalar> d( 0.5, 2 );
+        return std::bernoulli_distribution()( random_engine ) ?
+               d( random_engine ) : -d( random_engine );
+    }
+
+    template <typename Scalar>
+    Scalar RandomScalar( std::false_type /* is_floating_point */ )
+    {
+        return std::uniform_int_distribution<Scalar>( 1, 9 )( random_engine );
+    }
+
+    template <typename T>
+    T Random( std::false_type /* is_matrix */ )
+    {
+        return RandomScalar<T>( std::is_floating_point<T>() );
+    }
+
+    template <typename T>
+    T Random( std::true_type /* is_matrix */ )
+    {
+        using Scalar = typename T::scalar_type;
+        T ret;
+        for( u32 i = 0; i < T::rows * T::columns; ++i )
+            ret.m_elements[0][i] =
+                           RandomScalar<Scalar>( std::is_floating_point<Scalar>() );
+        return ret;
+    }
+
+    template <>
+    Quaternion<float> Random<Quaternion<float>>( std::false_type )
+    {
+        return Normalized( Quaternion<float>(
+                                       Random<float4>( std::true_type() ) ) );
+    }
+
+    template <>
+    Affine<float> Random<Affine<float>>( std::false_type )
+    {
+        return Affine<float>( Random<Matrix<float, 3, 4>>( std::true_type() ) );
+    }
+
+    template <typename T>
+    std::shared_ptr<const Data<T>> RandomData()
+    {
+        std::shared_ptr<Data<T>> ret =
+                                     std::make_shared<Data<T>>( DATA_SIZE );
+        for( T& t : *ret )
+            t = Random<T>( is_matrix<T>() );
+        return ret;
+    }
+
+    //
+    // Registration helpers, each benchmark iteration performs f once
+    //
+
+    template <typename A, typename F>
+    void AddUnary( Suite& suite, const std::string& name, F f )
+    {
+        auto a = RandomData<A>();
+        suite.Add( name, [a, f]( u64 iterations )
+        {
+            const A* x = a->data();
+            for( u64 i = 0; i < iterations; ++i )
+                DoNotOptimize( f( x[i & DATA_MASK] ) );
+        } );
+    }
+
+    template <typename A, typename B, typename F>
+    void AddBinary( Suite& suite, const std::string& name, F f )
+    {
+        auto a = RandomData<A>();
+        auto b = RandomData<B>();
+        suite.Add( name, [a, b, f]( u64 iterations )
+        {
+            const A* x = a->data();
+            const B* y = b->data();
+            for( u64 i = 0; i < iterations; ++i )
+                DoNotOptimize( f( x[i & DATA_MASK], y[i & DATA_MASK] ) );
+        } );
+    }
+
+    /**
+      * f modifies its first argument in place
+      */
+    template <typename A, typename B, typename F>
+    void AddAssignment( Suite& suite, const std::string& name, F f )
+    {
+        auto a = RandomData<A>();
+        auto b = RandomData<B>();
+        suite.Add( name, [a, b, f]( u64 iterations )
+        {
+            const A* x = a->data();
+            const B* y = b->data();
+            for( u64 i = 0; i < iterations; ++i )
+            {
+                A r = x[i & DATA_MASK];
+                f( r, y[i & DATA_MASK] );
+                DoNotOptimize( r );
+            }
+        } );
+    }
+
+    /**
+      * f processes all DATA_SIZE elements of a at once
+      */
+    template <typename A, typename F>
+    void AddBatch( Suite& suite, const std::string& name, F f )
+    {
+        auto a = RandomData<A>();
+        suite.Add( name, [a, f]( u64 iterations )
+        {
+            for( u64 i = 0; i < iterations; ++i )
+                f( *a );
+        } );
+    }
+
+    //
+    // Operations on vectors
+    //
+
+    template <typename T>
+    void AddFloatingVector( Suite&, const std::string&, std::false_type )
+    { }
+
+    template <typename T>
+    void AddFloatingVector( Suite& suite, const std::string& type,
+                            std::true_type /* is_floating_point */ )
+    {
+        AddUnary<T>( suite, type + " Normalized",
+                     []( const T& v ){ return Normalized( v ); } );
+        AddAssignment<T, T>( suite, type + " Normalize",
+                     []( T& v, const T& ){ Normalize( v ); } );
+        AddUnary<T>( suite, type + " NormalizedPrecise",
+                     []( const T& v ){ return NormalizedPrecise( v ); } );
+        AddUnary<T>( suite, type + " NormalizedFast",
+                     []( const T& v ){ return NormalizedFast( v ); } );
+        AddUnary<T>( suite, type + " NormalizedSafe",
+                     []( const T& v ){ return NormalizedSafe( v ); } );
+        AddUnary<T>( suite, type + " LengthFast",
+                     []( const T& v ){ return LengthFast( v ); } );
+        AddUnary<T>( suite, type + " InverseLength",
+                     []( const T& v ){ return InverseLength( v ); } );
+    }
+
+    template <typename T>
+    void AddCross( Suite&, const std::string&, std::false_type )
+    { }
+
+    template <typename T>
+    void AddCross( Suite& suite, const std::string& type,
+                   std::true_type /* has size 3 */ )
+    {
+        AddBinary<T, T>( suite, type + " Cross",
+                         []( const T& u, const T& v ){ return Cross( u, v ); } );
+    }
+
+    template <typename T>
+    void AddVector( Suite&, const std::string&, std::false_type )
+    { }
+
+    template <typename T>
+    void AddVector( Suite& suite, const std::string& type,
+                    std::true_type /* is_vector */ )
+    {
+        using Scalar = typename T::scalar_type;
+
+        AddBinary<T, T>( suite, type + " Dot",
+                         []( const T& u, const T& v ){ return Dot( u, v ); } );
+        AddBinary<T, T>( suite, type + " Outer",
+                         []( const T& u, const T& v ){ return Outer( u, v ); } );
+        AddUnary<T>( suite, type + " LengthSq",
+                     []( const T& v ){ return LengthSq( v ); } );
+        AddUnary<T>( suite, type + " Length",
+                     []( const T& v ){ return Length( v ); } );
+
+        AddFloatingVector<T>( suite, type, std::is_floating_point<Scalar>() );
+        AddCross<T>( suite, type,
+                     std::integral_constant<bool, T::vector_size == 3>() );
+    }
+
+    //
+    // Operations on square matrices
+    //
+
+    template <typename T>
+    void AddFloatingSquare( Suite&, const std::string&, std::false_type )
+    { }
+
+    template <typename T>
+    void AddFloatingSquare( Suite& suite, const std::string& type,
+                            std::true_type /* is_floating_point */ )
+    {
+        AddUnary<T>( suite, type + " Inverted",
+                     []( const T& m ){ return Inverted( m ); } );
+        AddUnary<T>( suite, type + " LU",
+                     []( const T& m ){ return LU( m ); } );
+
+        using Column = typename T::column_type;
+        AddBinary<T, Column>( suite, type + " Solve",
+                     []( const T& m, const Column& b ){ return Solve( m, b ); } );
+        AddBinary<T, Column>( suite, type + " Solve (Inverted)",
+                     []( const T& m, const Column& b )
+                     {
+                         return Mul( Inverted( m ), b );
+                     } );
+
+        //
+        // Cholesky needs symmetric positive definite matrices
+        //
+        auto spd = std::make_shared<Data<T>>( *RandomData<T>() );
+        for( T& m : *spd )
+            m = Mul( Transposed( m ), m ) +
+                Identity<typename T::scalar_type, T::rows>();
+        auto b = RandomData<Column>();
+        suite.Add( type + " SolveCholesky", [spd, b]( u64 iterations )
+        {
+            const T* x = spd->data();
+            const Column* y = b->data();
+            for( u64 i = 0; i < iterations; ++i )
+                DoNotOptimize( SolveCholesky( x[i & DATA_MASK],
+                                              y[i & DATA_MASK] ) );
+        } );
+    }
+
+    template <typename T>
+    void AddSquare( Suite&, const std::string&, std::false_type )
+    { }
+
+    template <typename T>
+    void AddSquare( Suite& suite, const std::string& type,
+                    std::true_type /* is_square */ )
+    {
+        using Scalar = typename T::scalar_type;
+        using Column = typename T::column_type;
+
+        AddBinary<T, T>( suite, type + " Mul",
+                         []( const T& m, const T& n ){ return Mul( m, n ); } );
+        AddBinary<T, Column>( suite, type + " Mul vector",
+                         []( const T& m, const Column& v ){ return Mul( m, v ); } );
+        AddUnary<T>( suite, type + " Determinant",
+                     []( const T& m ){ return Determinant( m ); } );
+        AddAssignment<T, T>( suite, type + " Transpose",
+                     []( T& m, const T& ){ Transpose( m ); } );
+
+        AddFloatingSquare<T>( suite, type, std::is_floating_point<Scalar>() );
+    }
+
+    //
+    // Operations on every matrix type
+    //
+    template <typename T>
+    void AddMatrix( Suite& suite, const std::string& type )
+    {
+        using Scalar = typename T::scalar_type;
+        using M = const T&;
+
+        AddUnary<T>( suite, type + " -m", []( M m ){ return -m; } );
+        AddUnary<T>( suite, type + " Transposed",
+                     []( M m ){ return Transposed( m ); } );
+
+        AddBinary<T, Scalar>( suite, type + " m + s",
+                              []( M m, Scalar s ){ return m + s; } );
+        AddBinary<T, Scalar>( suite, type + " m - s",
+                              []( M m, Scalar s ){ return m - s; } );
+        AddBinary<T, Scalar>( suite, type + " m * s",
+                              []( M m, Scalar s ){ return m * s; } );
+        AddBinary<T, Scalar>( suite, type + " m / s",
+                              []( M m, Scalar s ){ return m / s; } );
+        AddBinary<Scalar, T>( suite, type + " s * m",
+                              []( Scalar s, M m ){ return s * m; } );
+
+        AddBinary<T, T>( suite, type + " m + m", []( M m, M n ){ return m + n; } );
+        AddBinary<T, T>( suite, type + " m - m", []( M m, M n ){ return m - n; } );
+        AddBinary<T, T>( suite, type + " m * m", []( M m, M n ){ return m * n; } );
+        AddBinary<T, T>( suite, type + " m / m", []( M m, M n ){ return m / n; } );
+        AddBinary<T, T>( suite, type + " m == m",
+                         []( M m, M n ){ return m == n; } );
+
+        AddAssignment<T, Scalar>( suite, type + " m += s",
+                                  []( T& m, Scalar s ){ m += s; } );
+        AddAssignment<T, Scalar>( suite, type + " m -= s",
+                                  []( T& m, Scalar s ){ m -= s; } );
+        AddAssignment<T, Scalar>( suite, type + " m *= s",
+                                  []( T& m, Scalar s ){ m *= s; } );
+        AddAssignment<T, Scalar>( suite, type + " m /= s",
+                                  []( T& m, Scalar s ){ m /= s; } );
+
+        AddAssignment<T, T>( suite, type + " m += m", []( T& m, M n ){ m += n; } );
+        AddAssignment<T, T>( suite, type + " m -= m", []( T& m, M n ){ m -= n; } );
+        AddAssignment<T, T>( suite, type + " m *= m", []( T& m, M n ){ m *= n; } );
+        AddAssignment<T, T>( suite, type + " m /= m", []( T& m, M n ){ m /= n; } );
+
+        AddVector<T>( suite, type,
+                      std::integral_constant<bool, T::is_vector>() );
+        AddSquare<T>( suite, type,
+                      std::integral_constant<bool, T::is_square &&
+                                                   !T::is_vector>() );
+    }
+
+    //
+    // The float4 and float4x4 overloads against the generic templates, which
+    // are called by specifying the template arguments explicitly
+    //
+    void AddGeneric( Suite& suite )
+    {
+        using v = const float4&;
+        using m = const float4x4&;
+        using c = const float3&;
+
+        AddBinary<float4, float4>( suite, "float4 m + m (generic)",
+            []( v x, v y ){ return operator+<float,4,1,float>( x, y ); } );
+        AddBinary<float4, float4>( suite, "float4 m * m (generic)",
+            []( v x, v y ){ return operator*<float,4,1,float>( x, y ); } );
+        AddBinary<float4, float4>( suite, "float4 m / m (generic)",
+            []( v x, v y ){ return operator/<float,4,1,float>( x, y ); } );
+        AddAssignment<float4, float4>( suite, "float4 m += m (generic)",
+            []( float4& x, v y ){ operator+=<float,4,1,float>( x, y ); } );
+        AddBinary<float4, float4>( suite, "float4 Dot (generic)",
+            []( v x, v y ){ return Dot<float,4,1,float>( x, y ); } );
+        AddBinary<float3, float3>( suite, "float3 Cross (generic)",
+            []( c x, c y ){ return Cross<float,3,1,float>( x, y ); } );
+
+        AddBinary<float4x4, float4x4>( suite, "float4x4 m + m (generic)",
+            []( m x, m y ){ return operator+<float,4,4,float>( x, y ); } );
+        AddAssignment<float4x4, float4x4>( suite, "float4x4 m += m (generic)",
+            []( float4x4& x, m y ){ operator+=<float,4,4,float>( x, y ); } );
+        AddBinary<float4x4, float4x4>( suite, "float4x4 Mul (generic)",
+            []( m x, m y ){ return Mul<float,4,4,float,4>( x, y ); } );
+        AddBinary<float4x4, float4>( suite, "float4x4 Mul vector (generic)",
+            []( m x, v y ){ return Mul<float,4,4,float,1>( x, y ); } );
+        AddUnary<float4x4>( suite, "float4x4 Transposed (generic)",
+            []( m x ){ return Transposed<float,4,4>( x ); } );
+        AddUnary<float4x4>( suite, "float4x4 Determinant (generic)",
+            []( m x ){ return Determinant<float,4,4>( x ); } );
+        AddUnary<float4x4>( suite, "float4x4 Inverted (generic)",
+            []( m x ){ return Inverted<float,4,4>( x ); } );
+    }
+
+    //
+    // Assigning the result of the binary operators, which is how the compound
+    // assignment operators used to be implemented, and lazy expressions
+    //
+    void AddTemporaries( Suite& suite )
+    {
+        const float dt = 1.f / 60.f;
+
+        AddAssignment<float3, float3>( suite, "float3 m += m * s",
+            [=]( float3& x, const float3& y ){ x += y * dt; } );
+        AddAssignment<float3, float3>( suite, "float3 m = m + m * s",
+            [=]( float3& x, const float3& y ){ x = x + y * dt; } );
+        AddAssignment<float3, float3>( suite, "float3 m += m * s (lazy)",
+            [=]( float3& x, const float3& y ){ x += Lazy( y ) * dt; } );
+
+        AddBinary<float3x3, float3x3>( suite, "float3x3 m * s + m * t",
+            [=]( const float3x3& x, const float3x3& y )
+            { return x * dt + y * ( 1 - dt ); } );
+        AddBinary<float3x3, float3x3>( suite, "float3x3 m * s + m * t (lazy)",
+            [=]( const float3x3& x, const float3x3& y )
+            { return Evaluate( Lazy( x ) * dt + Lazy( y ) * ( 1 - dt ) ); } );
+    }
+
+    //
+    // The batched transforms against calling Mul in a loop, these time
+    // DATA_SIZE elements per iteration
+    //
+    void AddTransforms( Suite& suite )
+    {
+        const std::string n = " [" + std::to_string( DATA_SIZE ) + "]";
+        const float4x4 m = Random<float4x4>( std::true_type() );
+        auto out3 = std::make_shared<Data<float3>>( DATA_SIZE );
+        auto out4 = std::make_shared<Data<float4>>( DATA_SIZE );
+
+        AddBatch<float3>( suite, "float4x4 TransformPoints" + n,
+            [=]( const Data<float3>& in )
+            {
+                TransformPoints( m, in.data(), out3->data(), DATA_SIZE );
+                DoNotOptimize( out3->front() );
+            } );
+        AddBatch<float3>( suite, "float4x4 TransformPoints (Mul)" + n,
+            [=]( const Data<float3>& in )
+            {
+                for( u32 i = 0; i < DATA_SIZE; ++i )
+                    (*out3)[i] = Mul( m, float4( in[i], 1 ) ).xyz();
+                DoNotOptimize( out3->front() );
+            } );
+        AddBatch<float3>( suite, "float4x4 TransformVectors" + n,
+            [=]( const Data<float3>& in )
+            {
+                TransformVectors( m, in.data(), out3->data(), DATA_SIZE );
+                DoNotOptimize( out3->front() );
+            } );
+        AddBatch<float4>( suite, "float4x4 TransformHomogeneous" + n,
+            [=]( const Data<float4>& in )
+            {
+                TransformHomogeneous( m, in.data(), out4->data(), DATA_SIZE );
+                DoNotOptimize( out4->front() );
+            } );
+        AddBatch<float4>( suite, "float4x4 TransformHomogeneous (Mul)" + n,
+            [=]( const Data<float4>& in )
+            {
+                for( u32 i = 0; i < DATA_SIZE; ++i )
+                    (*out4)[i] = Mul( m, in[i] );
+                DoNotOptimize( out4->front() );
+            } );
+    }
+
+    //
+    // The batched inverse against calling Inverted in a loop
+    //
+    void AddInvertBatch( Suite& suite )
+    {
+        const std::string n = " [" + std::to_string( DATA_SIZE ) + "]";
+        auto out = std::make_shared<Data<float4x4>>( DATA_SIZE );
+        std::shared_ptr<bool> singular( new bool[DATA_SIZE],
+                                        std::default_delete<bool[]>() );
+
+        AddBatch<float4x4>( suite, "float4x4 InvertBatch" + n,
+            [=]( const Data<float4x4>& in )
+            {
+                InvertBatch( in.data(), out->data(), DATA_SIZE );
+                DoNotOptimize( out->front() );
+            } );
+        AddBatch<float4x4>( suite, "float4x4 InvertBatch (mask)" + n,
+            [=]( const Data<float4x4>& in )
+            {
+                InvertBatch( in.data(), out->data(), DATA_SIZE,
+                             singular.get() );
+                DoNotOptimize( out->front() );
+            } );
+        AddBatch<float4x4>( suite, "float4x4 InvertBatch (Inverted)" + n,
+            [=]( const Data<float4x4>& in )
+            {
+                for( u32 i = 0; i < DATA_SIZE; ++i )
+                    (*out)[i] = Inverted( in[i] );
+                DoNotOptimize( out->front() );
+            } );
+    }
+
+    //
+    // The 3x3 decompositions and orthonormalization, singly and batched
+    // against calling them in a loop
+    //
+    void AddDecompositions( Suite& suite )
+    {
+        AddUnary<float3x3>( suite, "float3x3 EigenSymmetric",
+            []( const float3x3& m ){ return EigenSymmetric( m ); } );
+        AddUnary<float3x3>( suite, "float3x3 SVD",
+            []( const float3x3& m ){ return SVD( m ); } );
+        AddUnary<float3x3>( suite, "float3x3 PolarDecompose",
+            []( const float3x3& m ){ return PolarDecompose( m ); } );
+        AddUnary<float3x3>( suite, "float3x3 Orthonormalized",
+            []( const float3x3& m ){ return Orthonormalized( m ); } );
+        AddUnary<float3x3>( suite, "float3x3 Orthonormalized (Cross)",
+            []( const float3x3& m )
+            {
+                const float3 x = Normalized( m.GetColumn( 0 ) );
+                const float3 z = Normalized( Cross( x, m.GetColumn( 1 ) ) );
+                return float3x3( x, Cross( z, x ), z );
+            } );
+
+        const std::string n = " [" + std::to_string( DATA_SIZE ) + "]";
+        auto eigen = std::make_shared<Data<EigenDecomposition<float>>>(
+                                                                  DATA_SIZE );
+        auto svd = std::make_shared<Data<SingularValueDecomposition<float>>>(
+                                                                  DATA_SIZE );
+        auto polar = std::make_shared<Data<PolarDecomposition<float>>>(
+                                                                  DATA_SIZE );
+        auto transforms = std::make_shared<Data<float4x4>>( DATA_SIZE );
+
+        AddBatch<float3x3>( suite, "float3x3 EigenSymmetricBatch" + n,
+            [=]( const Data<float3x3>& in )
+            {
+                EigenSymmetricBatch( in.data(), eigen->data(), DATA_SIZE );
+                DoNotOptimize( eigen->front() );
+            } );
+        AddBatch<float3x3>( suite,
+                            "float3x3 EigenSymmetricBatch (EigenSymmetric)" + n,
+            [=]( const Data<float3x3>& in )
+            {
+                for( u32 i = 0; i < DATA_SIZE; ++i )
+                    (*eigen)[i] = EigenSymmetric( in[i] );
+                DoNotOptimize( eigen->front() );
+            } );
+        AddBatch<float3x3>( suite, "float3x3 SVDBatch" + n,
+            [=]( const Data<float3x3>& in )
+            {
+                SVDBatch( in.data(), svd->data(), DATA_SIZE );
+                DoNotOptimize( svd->front() );
+            } );
+        AddBatch<float3x3>( suite, "float3x3 SVDBatch (SVD)" + n,
+            [=]( const Data<float3x3>& in )
+            {
+                for( u32 i = 0; i < DATA_SIZE; ++i )
+                    (*svd)[i] = SVD( in[i] );
+                DoNotOptimize( svd->front() );
+            } );
+        AddBatch<float3x3>( suite, "float3x3 PolarDecomposeBatch" + n,
+            [=]( const Data<float3x3>& in )
+            {
+                PolarDecomposeBatch( in.data(), polar->data(), DATA_SIZE );
+                DoNotOptimize( polar->front() );
+            } );
+        AddBatch<float3x3>( suite,
+                            "float3x3 PolarDecomposeBatch (PolarDecompose)" + n,
+            [=]( const Data<float3x3>& in )
+            {
+                for( u32 i = 0; i < DATA_SIZE; ++i )
+                    (*polar)[i] = PolarDecompose( in[i] );
+                DoNotOptimize( polar->front() );
+            } );
+        AddBatch<float4x4>( suite, "float4x4 OrthonormalizeBatch" + n,
+            [=]( const Data<float4x4>& in )
+            {
+                OrthonormalizeBatch( in.data(), transforms->data(),
+                                     DATA_SIZE );
+                DoNotOptimize( transforms->front() );
+            } );
+        AddBatch<float4x4>( suite,
+                            "float4x4 OrthonormalizeBatch (Orthonormalized)" + n,
+            [=]( const Data<float4x4>& in )
+            {
+                for( u32 i = 0; i < DATA_SIZE; ++i )
+                    (*transforms)[i] = Orthonormalized( in[i] );
+                DoNotOptimize( transforms->front() );
+            } );
+    }
+
+    //
+    // The batched normalizing and lengths against calling the single vector
+    // functions in a loop
+    //
+    template <typename T>
+    void AddNormalizeBatch( Suite& suite, const std::string& type )
+    {
+        const std::string n = " [" + std::to_string( DATA_SIZE ) + "]";
+        auto out = std::make_shared<Data<T>>( DATA_SIZE );
+        auto lengths = std::make_shared<Data<float>>( DATA_SIZE );
+
+        AddBatch<T>( suite, type + " Normalized (loop)" + n,
+            [=]( const Data<T>& in )
+            {
+                for( u32 i = 0; i < DATA_SIZE; ++i )
+                    (*out)[i] = Normalized( in[i] );
+                DoNotOptimize( out->front() );
+            } );
+        AddBatch<T>( suite, type + " NormalizedPrecise" + n,
+            [=]( const Data<T>& in )
+            {
+                NormalizedPrecise( in.data(), out->data(), DATA_SIZE );
+                DoNotOptimize( out->front() );
+            } );
+        AddBatch<T>( suite, type + " NormalizedFast" + n,
+            [=]( const Data<T>& in )
+            {
+                NormalizedFast( in.data(), out->data(), DATA_SIZE );
+                DoNotOptimize( out->front() );
+            } );
+        AddBatch<T>( suite, type + " NormalizedSafe" + n,
+            [=]( const Data<T>& in )
+            {
+                NormalizedSafe( in.data(), out->data(), DATA_SIZE );
+                DoNotOptimize( out->front() );
+            } );
+        AddBatch<T>( suite, type + " Length (loop)" + n,
+            [=]( const Data<T>& in )
+            {
+                for( u32 i = 0; i < DATA_SIZE; ++i )
+                    (*lengths)[i] = Length( in[i] );
+                DoNotOptimize( lengths->front() );
+            } );
+        AddBatch<T>( suite, type + " LengthFast" + n,
+            [=]( const Data<T>& in )
+            {
+                LengthFast( in.data(), lengths->data(), DATA_SIZE );
+                DoNotOptimize( lengths->front() );
+            } );
+        AddBatch<T>( suite, type + " InverseLength" + n,
+            [=]( const Data<T>& in )
+            {
+                InverseLength( in.data(), lengths->data(), DATA_SIZE );
+                DoNotOptimize( lengths->front() );
+            } );
+    }
+
+    //
+    // SinCosFast against std::sin and std::cos, and the rotation builders
+    // which use it
+    //
+    void AddRotations( Suite& suite )
+    {
+        AddUnary<float>( suite, "float SinCos", []( float a )
+        {
+            float s;
+            float c;
+            SinCos( a, s, c );
+            return s + c;
+        } );
+        AddUnary<float>( suite, "float SinCosFast", []( float a )
+        {
+            float s;
+            float c;
+            SinCosFast( a, s, c );
+            return s + c;
+        } );
+        AddUnary<float>( suite, "float3x3 RotateZ",
+                         []( float a ){ return RotateZ<float, 3>( a ); } );
+        AddUnary<float>( suite, "float4x4 RotateZ",
+                         []( float a ){ return RotateZ<float, 4>( a ); } );
+        AddUnary<float>( suite, "float4x4 RotateAxisAngle", []( float a )
+        {
+            return RotateAxisAngle( float3( 0.f, 0.6f, 0.8f ), a );
+        } );
+        AddUnary<float>( suite, "float4x4 Projection", []( float a )
+        {
+            return Projection( std::abs( a ), 1.5f, 0.1f, 100.f );
+        } );
+
+        const std::string n = " [" + std::to_string( DATA_SIZE ) + "]";
+        auto sin = std::make_shared<Data<float>>( DATA_SIZE );
+        auto cos = std::make_shared<Data<float>>( DATA_SIZE );
+        auto out = std::make_shared<Data<float3x3>>( DATA_SIZE );
+
+        AddBatch<float>( suite, "float SinCos (loop)" + n,
+            [=]( const Data<float>& in )
+            {
+                for( u32 i = 0; i < DATA_SIZE; ++i )
+                    SinCos( in[i], (*sin)[i], (*cos)[i] );
+                DoNotOptimize( sin->front() );
+            } );
+        AddBatch<float>( suite, "float SinCosFast" + n,
+            [=]( const Data<float>& in )
+            {
+                SinCosFast( in.data(), sin->data(), cos->data(), DATA_SIZE );
+                DoNotOptimize( sin->front() );
+            } );
+        AddBatch<float>( suite, "float3x3 RotateZBatch" + n,
+            [=]( const Data<float>& in )
+            {
+                RotateZBatch( in.data(), out->data(), DATA_SIZE );
+                DoNotOptimize( out->front() );
+            } );
+        AddBatch<float>( suite, "float3x3 RotateZBatch (RotateZ)" + n,
+            [=]( const Data<float>& in )
+            {
+                for( u32 i = 0; i < DATA_SIZE; ++i )
+                    (*out)[i] = RotateZ<float, 3>( in[i] );
+                DoNotOptimize( out->front() );
+            } );
+    }
+
+    //
+    // Quaternions, these can be compared against the float3x3 benchmarks
+    //
+    void AddQuaternion( Suite& suite )
+    {
+        using Q = Quaternion<float>;
+        using q = const Q&;
+
+        AddBinary<Q, Q>( suite, "Quaternion<float> q * q",
+                         []( q x, q y ){ return x * y; } );
+        AddBinary<Q, float3>( suite, "Quaternion<float> Rotate",
+                         []( q x, const float3& v ){ return Rotate( x, v ); } );
+        AddUnary<Q>( suite, "Quaternion<float> Inverted",
+                     []( q x ){ return Inverted( x ); } );
+        AddUnary<Q>( suite, "Quaternion<float> Normalized",
+                     []( q x ){ return Normalized( x ); } );
+        AddBinary<Q, Q>( suite, "Quaternion<float> Nlerp",
+                         []( q x, q y ){ return Nlerp( x, y, 0.3f ); } );
+        AddBinary<Q, Q>( suite, "Quaternion<float> Slerp",
+                         []( q x, q y ){ return Slerp( x, y, 0.3f ); } );
+        AddUnary<Q>( suite, "Quaternion<float> ToMatrix<3>",
+                     []( q x ){ return ToMatrix<3>( x ); } );
+        AddUnary<Q>( suite, "Quaternion<float> ToMatrix<4>",
+                     []( q x ){ return ToMatrix<4>( x ); } );
+        AddUnary<float3x3>( suite, "Quaternion<float> ToQuaternion",
+                     []( const float3x3& m ){ return ToQuaternion( m ); } );
+
+        //
+        // The batched slerp against calling Slerp in a loop
+        //
+        const std::string n = " [" + std::to_string( DATA_SIZE ) + "]";
+        auto other = RandomData<Q>();
+        auto out = std::make_shared<Data<Q>>( DATA_SIZE );
+
+        AddBatch<Q>( suite, "Quaternion<float> Slerp" + n,
+            [=]( const Data<Q>& in )
+            {
+                Slerp( in.data(), other->data(), 0.3f, out->data(), DATA_SIZE );
+                DoNotOptimize( out->front() );
+            } );
+        AddBatch<Q>( suite, "Quaternion<float> Slerp (loop)" + n,
+            [=]( const Data<Q>& in )
+            {
+                for( u32 i = 0; i < DATA_SIZE; ++i )
+                    (*out)[i] = Slerp( in[i], (*other)[i], 0.3f );
+                DoNotOptimize( out->front() );
+            } );
+    }
+
+    //
+    // Affine transforms, these can be compared against the float4x4 benchmarks
+    //
+    void AddAffine( Suite& suite )
+    {
+        using A = Affine<float>;
+        using a = const A&;
+
+        AddBinary<A, A>( suite, "Affine<float> Mul",
+                         []( a x, a y ){ return Mul( x, y ); } );
+        AddBinary<A, float3>( suite, "Affine<float> TransformPoint",
+                    []( a x, const float3& v ){ return TransformPoint( x, v ); } );
+        AddUnary<A>( suite, "Affine<float> Inverted",
+                     []( a x ){ return Inverted( x ); } );
+        AddUnary<A>( suite, "Affine<float> InvertedRigid",
+                     []( a x ){ return InvertedRigid( x ); } );
+
+        const std::string n = " [" + std::to_string( DATA_SIZE ) + "]";
+        const A m = Random<A>( std::false_type() );
+        auto out = std::make_shared<Data<float3>>( DATA_SIZE );
+
+        AddBatch<float3>( suite, "Affine<float> TransformPoints" + n,
+            [=]( const Data<float3>& in )
+            {
+                TransformPoints( m, in.data(), out->data(), DATA_SIZE );
+                DoNotOptimize( out->front() );
+            } );
+        AddBatch<float3>( suite, "Affine<float> TransformVectors" + n,
+            [=]( const Data<float3>& in )
+            {
+                TransformVectors( m, in.data(), out->data(), DATA_SIZE );
+                DoNotOptimize( out->front() );
+            } );
+    }
+
+    //
+    // Propagating world transforms through a hierarchy of DATA_SIZE nodes with
+    // all, one or none of them changed, against rebuilding every chain from
+    // the root
+    //
+    void AddHierarchy( Suite& suite )
+    {
+        using H = TransformHierarchy<float>;
+
+        const std::string n = " [" + std::to_string( DATA_SIZE ) + "]";
+        auto locals = RandomData<float4x4>();
+        auto h = std::make_shared<H>();
+        for( u32 i = 0; i < DATA_SIZE; ++i )
+            h->AddNode( (*locals)[i],
+                        i == 0 ? H::no_parent : random_engine() % i );
+        h->Update();
+
+        suite.Add( "TransformHierarchy Update (all dirty)" + n,
+                   [=]( u64 iterations )
+        {
+            for( u64 i = 0; i < iterations; ++i )
+            {
+                h->SetLocal( 0, (*locals)[i & DATA_MASK] );
+                h->Update();
+                DoNotOptimize( *h->GetWorldData() );
+            }
+        } );
+        suite.Add( "TransformHierarchy Update (one dirty)" + n,
+                   [=]( u64 iterations )
+        {
+            for( u64 i = 0; i < iterations; ++i )
+            {
+                h->SetLocal( DATA_SIZE - 1, (*locals)[i & DATA_MASK] );
+                h->Update();
+                DoNotOptimize( *h->GetWorldData() );
+            }
+        } );
+        suite.Add( "TransformHierarchy Update (clean)" + n,
+                   [=]( u64 iterations )
+        {
+            for( u64 i = 0; i < iterations; ++i )
+            {
+                h->Update();
+                DoNotOptimize( *h->GetWorldData() );
+            }
+        } );
+        auto out = std::make_shared<Data<float4x4>>( DATA_SIZE );
+        suite.Add( "TransformHierarchy Update (chains)" + n,
+                   [=]( u64 iterations )
+        {
+            for( u64 i = 0; i < iterations; ++i )
+            {
+                for( u32 node = 0; node < DATA_SIZE; ++node )
+                {
+                    float4x4 world = h->GetLocal( node );
+                    for( u32 p = h->GetParent( node ); p != H::no_parent;
+                         p = h->GetParent( p ) )
+                        world = Mul( h->GetLocal( p ), world );
+                    (*out)[node] = world;
+                }
+                DoNotOptimize( out->front() );
+            }
+        } );
+    }
+
+    //
+    // Large batches with each execution policy, these are big enough to be
+    // worth splitting between threads
+    //
+    void AddPolicies( Suite& suite )
+    {
+        const u32 size = 1 << 20;
+        const std::string n = " [" + std::to_string( size ) + "]";
+        auto points = std::make_shared<Data<float3>>( size );
+        for( float3& p : *points )
+            p = Random<float3>( std::true_type() );
+        auto matrices = std::make_shared<Data<float4x4>>( size / 16 );
+        for( float4x4& m : *matrices )
+            m = Random<float4x4>( std::true_type() );
+        auto out_points = std::make_shared<Data<float3>>( size );
+        auto out_matrices = std::make_shared<Data<float4x4>>( size / 16 );
+        const float4x4 m = Random<float4x4>( std::true_type() );
+
+        suite.Add( "float4x4 TransformPoints (seq)" + n, [=]( u64 iterations )
+        {
+            for( u64 i = 0; i < iterations; ++i )
+                TransformPoints( execution::seq, m, points->data(),
+                                 out_points->data(), size );
+            DoNotOptimize( out_points->front() );
+        } );
+        suite.Add( "float4x4 TransformPoints (simd)" + n, [=]( u64 iterations )
+        {
+            for( u64 i = 0; i < iterations; ++i )
+                TransformPoints( execution::simd, m, points->data(),
+                                 out_points->data(), size );
+            DoNotOptimize( out_points->front() );
+        } );
+        suite.Add( "float4x4 TransformPoints (par_simd)" + n,
+                   [=]( u64 iterations )
+        {
+            for( u64 i = 0; i < iterations; ++i )
+                TransformPoints( execution::par_simd, m, points->data(),
+                                 out_points->data(), size );
+            DoNotOptimize( out_points->front() );
+        } );
+
+        const std::string nm = " [" + std::to_string( size / 16 ) + "]";
+        suite.Add( "float4x4 InvertBatch (seq)" + nm, [=]( u64 iterations )
+        {
+            for( u64 i = 0; i < iterations; ++i )
+                InvertBatch( execution::seq, matrices->data(),
+                             out_matrices->data(), size / 16 );
+            DoNotOptimize( out_matrices->front() );
+        } );
+        suite.Add( "float4x4 InvertBatch (simd)" + nm, [=]( u64 iterations )
+        {
+            for( u64 i = 0; i < iterations; ++i )
+                InvertBatch( execution::simd, matrices->data(),
+                             out_matrices->data(), size / 16 );
+            DoNotOptimize( out_matrices->front() );
+        } );
+        suite.Add( "float4x4 InvertBatch (par_simd)" + nm,
+                   [=]( u64 iterations )
+        {
+            for( u64 i = 0; i < iterations; ++i )
+                InvertBatch( execution::par_simd, matrices->data(),
+                             out_matrices->data(), size / 16 );
+            DoNotOptimize( out_matrices->front() );
+        } );
+    }
+
+    //
+    // Operations on a structure of arrays container, these time DATA_SIZE
+    // elements per iteration so they can be compared against the float3
+    // benchmarks
+    //
+    template <typename Container>
+    void AddSoA( Suite& suite, const std::string& type )
+    {
+        const std::string n = " [" + std::to_string( DATA_SIZE ) + "]";
+        auto a = RandomData<float3>();
+        auto b = RandomData<float3>();
+        auto u = std::make_shared<Container>(
+                                   std::vector<float3>( a->begin(), a->end() ) );
+        auto v = std::make_shared<Container>(
+                                   std::vector<float3>( b->begin(), b->end() ) );
+
+        suite.Add( type + " Dot" + n, [=]( u64 iterations )
+        {
+            for( u64 i = 0; i < iterations; ++i )
+                DoNotOptimize( Dot( *u, *v ) );
+        } );
+        suite.Add( type + " Cross" + n, [=]( u64 iterations )
+        {
+            for( u64 i = 0; i < iterations; ++i )
+                DoNotOptimize( Cross( *u, *v ) );
+        } );
+        suite.Add( type + " Normalized" + n, [=]( u64 iterations )
+        {
+            for( u64 i = 0; i < iterations; ++i )
+                DoNotOptimize( Normalized( *u ) );
+        } );
+        suite.Add( type + " Lerp" + n, [=]( u64 iterations )
+        {
+            for( u64 i = 0; i < iterations; ++i )
+                DoNotOptimize( Lerp( *u, *v, 0.5f ) );
+        } );
+        suite.Add( type + " m += m" + n, [=]( u64 iterations )
+        {
+            Container w = *u;
+            for( u64 i = 0; i < iterations; ++i )
+                w += *v;
+            DoNotOptimize( w );
+        } );
+    }
+
+    //
+    // Text conversion of a float4x4, against the iostream formatting used by
+    // the regression tester
+    //
+    void AddCharConv( Suite& suite )
+    {
+        const float4x4 m = Random<float4x4>( std::true_type() );
+        char text[max_chars<float4x4>::value];
+        const std::string s( text, ToChars( text, text + sizeof(text), m ).ptr );
+
+        suite.Add( "float4x4 ToChars", [=]( u64 iterations )
+        {
+            char buffer[max_chars<float4x4>::value];
+            for( u64 i = 0; i < iterations; ++i )
+                DoNotOptimize( ToChars( buffer, buffer + sizeof(buffer), m ).ptr );
+        } );
+        suite.Add( "float4x4 ostream", [=]( u64 iterations )
+        {
+            for( u64 i = 0; i < iterations; ++i )
+            {
+                std::ostringstream out;
+                for( u32 j = 0; j < 16; ++j )
+                    out << std::setprecision( 8 ) << std::fixed <<
+                           m.m_elements[0][j] << " ";
+                DoNotOptimize( out.tellp() );
+            }
+        } );
+        suite.Add( "float4x4 FromChars", [=]( u64 iterations )
+        {
+            float4x4 r;
+            for( u64 i = 0; i < iterations; ++i )
+                DoNotOptimize( FromChars( s.data(), s.data() + s.size(), r ).ptr );
+            DoNotOptimize( r );
+        } );
+        suite.Add( "float4x4 istream", [=]( u64 iterations )
+        {
+            float4x4 r;
+            for( u64 i = 0; i < iterations; ++i )
+            {
+                std::istringstream in( s );
+                for( u32 j = 0; j < 16; ++j )
+                    in >> r.m_elements[0][j];
+                DoNotOptimize( r );
+            }
+        } );
+    }
+}
+
+int main( int argc, char** argv )
+{
+    Benchmark::Options options;
+    if( !Benchmark::ParseOptions( argc, argv, options ) )
+        return 1;
+
+    Suite suite;
+
+    AddMatrix<float2>( suite, "float2" );
+    AddMatrix<float3>( suite, "float3" );
+    AddMatrix<float4>( suite, "float4" );
+    AddMatrix<float2x2>( suite, "float2x2" );
+    AddMatrix<float3x3>( suite, "float3x3" );
+    AddMatrix<float4x4>( suite, "float4x4" );
+    AddMatrix<int2>( suite, "int2" );
+    AddMatrix<int3>( suite, "int3" );
+    AddMatrix<int4>( suite, "int4" );
+    AddMatrix<uint2>( suite, "uint2" );
+    AddMatrix<uint3>( suite, "uint3" );
+    AddMatrix<uint4>( suite, "uint4" );
+
+    AddMatrix<Vector<float, 5>>( suite, "Vector<float,5>" );
+    AddMatrix<Vector<float, 6>>( suite, "Vector<float,6>" );
+    AddMatrix<Vector<float, 7>>( suite, "Vector<float,7>" );
+    AddMatrix<Vector<float, 8>>( suite, "Vector<float,8>" );
+    AddMatrix<Matrix<float, 5, 5>>( suite, "Matrix<float,5,5>" );
+    AddMatrix<Matrix<float, 6, 6>>( suite, "Matrix<float,6,6>" );
+    AddMatrix<Matrix<float, 7, 7>>( suite, "Matrix<float,7,7>" );
+    AddMatrix<Matrix<float, 8, 8>>( suite, "Matrix<float,8,8>" );
+    AddMatrix<Matrix<double, 4, 4>>( suite, "Matrix<double,4,4>" );
+
+    AddGeneric( suite );
+    AddTemporaries( suite );
+    AddTransforms( suite );
+    AddInvertBatch( suite );
+    AddDecompositions( suite );
+    AddNormalizeBatch<float3>( suite, "float3" );
+    AddNormalizeBatch<float4>( suite, "float4" );
+    AddRotations( suite );
+    AddQuaternion( suite );
+    AddAffine( suite );
+    AddHierarchy( suite );
+    AddPolicies( suite );
+    AddSoA<VectorSoA<float, 3>>( suite, "VectorSoA<float,3>" );
+    AddSoA<AoSoA<float, 3, 8>>( suite, "AoSoA<float,3,8>" );
+    AddCharConv( suite );
+
+    std::vector<Benchmark::Result> results = suite.Run( options );
+
+    if( !options.json_path.empty() )
+        Benchmark::WriteJson( results, options.json_path );
+
+    return 0;
+}
@@ -0,0 +1,375 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#include "gtest/gtest.h"
+#include <cstring>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <joemath/joemath.hpp>
+
+using namespace JoeMath;
+
+namespace
+{
+    template <typename T>
+    std::string ToString( const T& value )
+    {
+        char buffer[max_chars<T>::value];
+        const ToCharsResult r = ToChars( buffer, buffer + sizeof(buffer), value );
+        EXPECT_EQ( std::errc(), r.ec );
+        return std::string( buffer, r.ptr );
+    }
+
+    template <typename T>
+    T FromString( const std::string& s )
+    {
+        T value = T();
+        const FromCharsResult r = FromChars( s.data(), s.data() + s.size(),
+                                             value );
+        EXPECT_EQ( std::errc(), r.ec ) << s;
+        EXPECT_EQ( s.data() + s.size(), r.ptr ) << s;
+        return value;
+    }
+
+    template <typename Float>
+    bool SameBits( Float a, Float b )
+    {
+        return std::memcmp( &a, &b, sizeof(a) ) == 0;
+    }
+
+    //
+    // The value of a positive number written by ToChars is
+    // significand * 10^exponent
+    //
+    void SplitDigits( const std::string& s, u64& significand, int& exponent )
+    {
+        significand = 0;
+        exponent = 0;
+        bool fraction = false;
+        std::size_t i = 0;
+        for( ; i < s.size() && s[i] != 'e'; ++i )
+        {
+            if( s[i] == '.' )
+                fraction = true;
+            else
+            {
+                significand = significand * 10 + u64( s[i] - '0' );
+                exponent -= fraction;
+            }
+        }
+        if( i < s.size() )
+            exponent += std::stoi( s.substr( i + 1 ) );
+        for( ; significand != 0 && significand % 10 == 0; significand /= 10 )
+            ++exponent;
+    }
+}
+
+template <typename T>
+class CharConvTest : public testing::Test
+{
+};
+
+using testing::Types;
+
+typedef Types<float, double> CharConvTypes;
+
+TYPED_TEST_CASE(CharConvTest, CharConvTypes);
+
+TYPED_TEST(CharConvTest, RoundTrip )
+{
+    typedef typename std::conditional<sizeof(TypeParam) == 4,
+                                      u32, u64>::type Bits;
+    std::mt19937_64 random( 1 );
+
+    for( u32 i = 0; i < 10000; ++i )
+    {
+        const Bits bits = Bits( random() );
+        TypeParam value;
+        std::memcpy( &value, &bits, sizeof(value) );
+        if( !std::isfinite( value ) )
+            continue;
+
+        const std::string s = ToString( value );
+        ASSERT_GE( max_chars<TypeParam>::value, s.size() );
+        ASSERT_TRUE( SameBits( value, FromString<TypeParam>( s ) ) ) << s;
+    }
+
+    const TypeParam limits[] = { std::numeric_limits<TypeParam>::min(),
+                                 std::numeric_limits<TypeParam>::max(),
+                                 std::numeric_limits<TypeParam>::lowest(),
+                                 std::numeric_limits<TypeParam>::denorm_min(),
+                                 std::numeric_limits<TypeParam>::epsilon() };
+    for( TypeParam value : limits )
+        EXPECT_TRUE( SameBits( value,
+                               FromString<TypeParam>( ToString( value ) ) ) );
+}
+
+TYPED_TEST(CharConvTest, Shortest )
+{
+    typedef typename std::conditional<sizeof(TypeParam) == 4,
+                                      u32, u64>::type Bits;
+    std::mt19937_64 random( 2 );
+
+    //
+    // If there were a number with fewer digits which reads back to the
+    // value, it would be between the written number and the value, so it
+    // would be the written number with its last digit dropped or that plus
+    // one
+    //
+    for( u32 i = 0; i < 10000; ++i )
+    {
+        const Bits bits = Bits( random() ) >> 1;
+        TypeParam value;
+        std::memcpy( &value, &bits, sizeof(value) );
+        if( !std::isfinite( value ) || value == TypeParam( 0 ) )
+            continue;
+
+        const std::string s = ToString( value );
+        u64 significand;
+        int exponent;
+        SplitDigits( s, significand, exponent );
+        for( u64 shorter = significand / 10;
+             shorter <= significand / 10 + 1;
+             ++shorter )
+        {
+            const std::string t = std::to_string( shorter ) + "e" +
+                                  std::to_string( exponent + 1 );
+            TypeParam parsed;
+            const FromCharsResult r = FromChars( t.data(),
+                                                 t.data() + t.size(),
+                                                 parsed );
+            EXPECT_FALSE( r.ec == std::errc() && SameBits( value, parsed ) )
+                << s << " could be " << t;
+        }
+    }
+}
+
+TYPED_TEST(CharConvTest, Format )
+{
+    EXPECT_EQ( "0", ToString( TypeParam( 0 ) ) );
+    EXPECT_EQ( "-0", ToString( -TypeParam( 0 ) ) );
+    EXPECT_EQ( "1", ToString( TypeParam( 1 ) ) );
+    EXPECT_EQ( "-2.5", ToString( TypeParam( -2.5 ) ) );
+    EXPECT_EQ( "0.1", ToString( TypeParam( 0.1 ) ) );
+    EXPECT_EQ( "0.3", ToString( TypeParam( 0.3 ) ) );
+    EXPECT_EQ( "100", ToString( TypeParam( 100 ) ) );
+    EXPECT_EQ( "0.001", ToString( TypeParam( 0.001 ) ) );
+    EXPECT_EQ( "1e-05", ToString( TypeParam( 1e-5 ) ) );
+    EXPECT_EQ( "1e+10", ToString( TypeParam( 1e10 ) ) );
+    EXPECT_EQ( "1.5e+10", ToString( TypeParam( 1.5e10 ) ) );
+    EXPECT_EQ( "inf", ToString( std::numeric_limits<TypeParam>::infinity() ) );
+    EXPECT_EQ( "-inf", ToString( -std::numeric_limits<TypeParam>::infinity() ) );
+    EXPECT_EQ( "nan", ToString( std::numeric_limits<TypeParam>::quiet_NaN() ) );
+
+    EXPECT_EQ( "3.4028235e+38",
+               ToString( std::numeric_limits<float>::max() ) );
+    EXPECT_EQ( "1.7976931348623157e+308",
+               ToString( std::numeric_limits<double>::max() ) );
+    EXPECT_EQ( "5e-324", ToString( std::numeric_limits<double>::denorm_min() ) );
+
+    //
+    // Doubles where Grisu can't find the shortest or closest digits
+    //
+    EXPECT_EQ( "3.556169393814842e-26", ToString( 3.556169393814842e-26 ) );
+    EXPECT_EQ( "6.137688561080735e-109", ToString( 6.137688561080735e-109 ) );
+    EXPECT_EQ( "0.04325855382074607", ToString( 0.04325855382074607 ) );
+    EXPECT_EQ( "5464018829.121243", ToString( 5464018829.121243 ) );
+    EXPECT_EQ( "1.2635321889364135e+292", ToString( 1.2635321889364135e292 ) );
+    EXPECT_EQ( "1238149735313913.2", ToString( 1238149735313913.2 ) );
+
+    //
+    // Values which don't fit leave the buffer's contents undefined
+    //
+    char buffer[4];
+    const ToCharsResult r = ToChars( buffer, buffer + 4, TypeParam( 0.125 ) );
+    EXPECT_EQ( std::errc::value_too_large, r.ec );
+    EXPECT_EQ( buffer + 4, r.ptr );
+}
+
+TYPED_TEST(CharConvTest, Parse )
+{
+    EXPECT_EQ( TypeParam( 25 ), FromString<TypeParam>( "2.5e1" ) );
+    EXPECT_EQ( TypeParam( 25 ), FromString<TypeParam>( "2.5E+1" ) );
+    EXPECT_EQ( TypeParam( 0.5 ), FromString<TypeParam>( ".5" ) );
+    EXPECT_EQ( TypeParam( 5 ), FromString<TypeParam>( "5." ) );
+    EXPECT_EQ( TypeParam( -0.001 ), FromString<TypeParam>( "-1e-3" ) );
+    EXPECT_EQ( TypeParam( 0.1 ), FromString<TypeParam>( "0.1000000000000000000000000000001" ) );
+    EXPECT_EQ( TypeParam( 123456789 ), FromString<TypeParam>( "00123456789" ) );
+    EXPECT_TRUE( std::signbit( FromString<TypeParam>( "-0.000" ) ) );
+    EXPECT_EQ( std::numeric_limits<TypeParam>::infinity(),
+               FromString<TypeParam>( "INFINITY" ) );
+    EXPECT_EQ( -std::numeric_limits<TypeParam>::infinity(),
+               FromString<TypeParam>( "-inf" ) );
+    EXPECT_TRUE( std::isnan( FromString<TypeParam>( "nan(123)" ) ) );
+
+    //
+    // Halfway between 1 and the next value up rounds to even, unless
+    // there's anything after it
+    //
+    const std::string halfway = sizeof(TypeParam) == 4 ?
+        "1.000000059604644775390625" :
+        "1.00000000000000011102230246251565404236316680908203125";
+    EXPECT_EQ( TypeParam( 1 ), FromString<TypeParam>( halfway ) );
+    EXPECT_EQ( TypeParam( 1 ) + std::numeric_limits<TypeParam>::epsilon(),
+               FromString<TypeParam>( halfway + std::string( 800, '0' ) + "1" ) );
+
+    //
+    // Stops at the first character which isn't part of the number
+    //
+    const std::string s = "1.5e+x";
+    TypeParam value;
+    FromCharsResult r = FromChars( s.data(), s.data() + s.size(), value );
+    EXPECT_EQ( std::errc(), r.ec );
+    EXPECT_EQ( s.data() + 3, r.ptr );
+    EXPECT_EQ( TypeParam( 1.5 ), value );
+
+    const std::string bad[] = { "", "-", ".", "+1", " 1", "e5", "x" };
+    for( const std::string& b : bad )
+    {
+        value = 7;
+        r = FromChars( b.data(), b.data() + b.size(), value );
+        EXPECT_EQ( std::errc::invalid_argument, r.ec ) << b;
+        EXPECT_EQ( b.data(), r.ptr ) << b;
+        EXPECT_EQ( TypeParam( 7 ), value );
+    }
+
+    const std::string out_of_range[] = { "1e400", "-1e-400" };
+    for( const std::string& o : out_of_range )
+    {
+        r = FromChars( o.data(), o.data() + o.size(), value );
+        EXPECT_EQ( std::errc::result_out_of_range, r.ec ) << o;
+        EXPECT_EQ( o.data() + o.size(), r.ptr ) << o;
+        EXPECT_EQ( TypeParam( 7 ), value );
+    }
+}
+
+TEST(CharConvTest, Integers )
+{
+    EXPECT_EQ( "0", ToString( 0 ) );
+    EXPECT_EQ( "-2147483648", ToString( std::numeric_limits<s32>::min() ) );
+    EXPECT_EQ( "18446744073709551615",
+               ToString( std::numeric_limits<u64>::max() ) );
+    EXPECT_EQ( "-128", ToString( s8( -128 ) ) );
+
+    EXPECT_EQ( std::numeric_limits<s64>::min(),
+               FromString<s64>( "-9223372036854775808" ) );
+    EXPECT_EQ( 255, FromString<u8>( "255" ) );
+    EXPECT_EQ( 42u, FromString<u32>( "0042" ) );
+
+    u8 value = 7;
+    const std::string big = "256";
+    FromCharsResult r = FromChars( big.data(), big.data() + big.size(), value );
+    EXPECT_EQ( std::errc::result_out_of_range, r.ec );
+    EXPECT_EQ( big.data() + 3, r.ptr );
+    EXPECT_EQ( 7, value );
+
+    const std::string negative = "-1";
+    r = FromChars( negative.data(), negative.data() + negative.size(), value );
+    EXPECT_EQ( std::errc::invalid_argument, r.ec );
+}
+
+TEST(CharConvTest, Matrices )
+{
+    const Matrix<float, 2, 3> m( 1, 2.5f, -3,
+                                 0.1f, 1e20f, 0 );
+    const std::string s = ToString( m );
+    EXPECT_EQ( "1 2.5 -3 0.1 1e+20 0", s );
+    EXPECT_EQ( m, ( FromString<Matrix<float, 2, 3>>( s ) ) );
+
+    int3 v;
+    const std::string spaced = " \n 1\t-2   3 rest";
+    const FromCharsResult r = FromChars( spaced.data(),
+                                         spaced.data() + spaced.size(), v );
+    EXPECT_EQ( std::errc(), r.ec );
+    EXPECT_EQ( int3( 1, -2, 3 ), v );
+    EXPECT_EQ( " rest", std::string( r.ptr ) );
+
+    //
+    // The matrix is left alone if it can't all be read
+    //
+    const std::string short_input = "4 5";
+    EXPECT_EQ( std::errc::invalid_argument,
+               FromChars( short_input.data(),
+                          short_input.data() + short_input.size(), v ).ec );
+    EXPECT_EQ( int3( 1, -2, 3 ), v );
+
+    char buffer[8];
+    EXPECT_EQ( std::errc::value_too_large,
+               ToChars( buffer, buffer + sizeof(buffer), m ).ec );
+}
+
+TEST(CharConvTest, Streams )
+{
+    std::mt19937 random( 2 );
+    std::uniform_real_distribution<double> d( -1e6, 1e6 );
+
+    //
+    // Enough to go through the stream buffer several times
+    //
+    std::vector<Matrix<double, 4, 4>> matrices( 1000 );
+    for( auto& m : matrices )
+        for( u32 i = 0; i < 16; ++i )
+            m.m_elements[0][i] = d( random ) * std::pow( 10.0, i % 5 - 2 );
+
+    std::stringstream ss;
+    WriteArray( ss, matrices.data(), matrices.size() );
+    ss << "\n 42 trailing";
+
+    std::vector<Matrix<double, 4, 4>> read( matrices.size() );
+    EXPECT_EQ( matrices.size(), ReadArray( ss, read.data(), read.size() ) );
+    EXPECT_EQ( matrices, read );
+
+    //
+    // The stream is left just after the last element
+    //
+    u32 i;
+    EXPECT_EQ( 1u, ReadArray( ss, &i, 1 ) );
+    EXPECT_EQ( 42u, i );
+    std::string rest;
+    ss >> rest;
+    EXPECT_EQ( "trailing", rest );
+
+    //
+    // Reading stops at the end, or at something which isn't a number
+    //
+    std::stringstream floats( "1 2 3 x 4" );
+    float f[5];
+    EXPECT_EQ( 3u, ReadArray( floats, f, 5 ) );
+    EXPECT_TRUE( floats.fail() );
+
+    std::stringstream ints( "1 2\n" );
+    s32 n[5];
+    EXPECT_EQ( 2u, ReadArray( ints, n, 5 ) );
+    EXPECT_FALSE( ints.fail() );
+    EXPECT_TRUE( ints.eof() );
+}
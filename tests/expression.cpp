@@ -0,0 +1,178 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#include "gtest/gtest.h"
+#include <random>
+#include <type_traits>
+
+#include <joemath/joemath.hpp>
+#include <joemath/expression.hpp>
+
+using namespace JoeMath;
+
+//
+// Lazy expressions should give exactly the same results as evaluating each
+// operator eagerly
+//
+
+namespace
+{
+    template <typename T>
+    T GetRandomMatrix()
+    {
+        static std::uniform_real_distribution<typename T::scalar_type> re(-1000,
+                                                                          1000);
+        static auto ran = std::bind(re,std::minstd_rand());
+        T ret;
+        for( u32 i = 0; i < T::columns; ++i )
+            for( u32 j = 0; j < T::rows; ++j )
+                ret.m_elements[i][j] = ran();
+        return ret;
+    }
+}
+
+template <typename T>
+class ExpressionTest : public testing::Test
+{
+};
+
+using testing::Types;
+
+typedef Types<Matrix<float, 1, 1>,
+              Matrix<float, 3, 1>,
+              Matrix<float, 4, 1>,
+              Matrix<float, 2, 3>,
+              Matrix<float, 4, 4>,
+              Matrix<double, 4, 4>,
+              Matrix<float, 8, 8>  > ExpressionTypes;
+
+TYPED_TEST_CASE(ExpressionTest, ExpressionTypes);
+
+TYPED_TEST(ExpressionTest, Evaluate )
+{
+    TypeParam a = GetRandomMatrix<TypeParam>();
+    ASSERT_EQ( a, Evaluate( Lazy( a ) ) );
+    ASSERT_EQ( a, Evaluate( +Lazy( a ) ) );
+    ASSERT_EQ( -a, Evaluate( -Lazy( a ) ) );
+}
+
+TYPED_TEST(ExpressionTest, MatrixArithmetic )
+{
+    TypeParam a = GetRandomMatrix<TypeParam>();
+    TypeParam b = GetRandomMatrix<TypeParam>();
+    TypeParam c = GetRandomMatrix<TypeParam>();
+    TypeParam m;
+
+    m = Lazy( a ) + b;
+    ASSERT_EQ( a + b, m );
+    m = a - Lazy( b );
+    ASSERT_EQ( a - b, m );
+    m = Lazy( a ) * Lazy( b );
+    ASSERT_EQ( a * b, m );
+    m = Lazy( a ) / b;
+    ASSERT_EQ( a / b, m );
+    m = Lazy( a ) * b - c + a / c;
+    ASSERT_EQ( a * b - c + a / c, m );
+}
+
+TYPED_TEST(ExpressionTest, ScalarArithmetic )
+{
+    typedef typename TypeParam::scalar_type Scalar;
+    TypeParam a = GetRandomMatrix<TypeParam>();
+    TypeParam b = GetRandomMatrix<TypeParam>();
+    Scalar s = GetRandomMatrix<Matrix<Scalar, 1, 1>>()[0];
+    Scalar t = GetRandomMatrix<Matrix<Scalar, 1, 1>>()[0];
+
+    ASSERT_EQ( a + s, Evaluate( Lazy( a ) + s ) );
+    ASSERT_EQ( a - s, Evaluate( Lazy( a ) - s ) );
+    ASSERT_EQ( a * s, Evaluate( Lazy( a ) * s ) );
+    ASSERT_EQ( s * a, Evaluate( s * Lazy( a ) ) );
+    ASSERT_EQ( a / s, Evaluate( Lazy( a ) / s ) );
+    ASSERT_EQ( a * s + b * t, Evaluate( Lazy( a ) * s + b * t ) );
+
+    //
+    // The scalar should be stored by value
+    //
+    TypeParam m = s * Lazy( a ) - Scalar{2} * ( b + Lazy( a ) / t );
+    ASSERT_EQ( s * a - Scalar{2} * ( b + a / t ), m );
+}
+
+TYPED_TEST(ExpressionTest, Promotion )
+{
+    typedef typename TypeParam::scalar_type Scalar;
+    typedef Matrix<int, TypeParam::rows, TypeParam::columns> IntMatrix;
+    TypeParam a = GetRandomMatrix<TypeParam>();
+    IntMatrix b( 3 );
+
+    auto eager = a * b + 2.0;
+    auto lazy  = Evaluate( Lazy( a ) * b + 2.0 );
+    static_assert( std::is_same<decltype(eager), decltype(lazy)>::value,
+                   "Lazy expressions should promote like Matrix" );
+    ASSERT_EQ( eager, lazy );
+
+    auto eager_division = b / 2;
+    auto lazy_division  = Evaluate( Lazy( b ) / 2 );
+    static_assert( std::is_same<decltype(eager_division),
+                                decltype(lazy_division)>::value,
+                   "Lazy expressions should promote like Matrix" );
+    ASSERT_EQ( eager_division, lazy_division );
+
+    Matrix<Scalar, TypeParam::rows, TypeParam::columns> c = Lazy( b ) * a;
+    ASSERT_EQ( b * a, c );
+}
+
+TYPED_TEST(ExpressionTest, Assignment )
+{
+    typedef typename TypeParam::scalar_type Scalar;
+    TypeParam a = GetRandomMatrix<TypeParam>();
+    TypeParam b = GetRandomMatrix<TypeParam>();
+    Scalar s = GetRandomMatrix<Matrix<Scalar, 1, 1>>()[0];
+    TypeParam m;
+
+    m = a; m += Lazy( b ) * s;
+    ASSERT_EQ( a + b * s, m );
+    m = a; m -= Lazy( b ) * s;
+    ASSERT_EQ( a - b * s, m );
+    m = a; m *= Lazy( b ) + s;
+    ASSERT_EQ( a * ( b + s ), m );
+    m = a; m /= Lazy( b ) + s;
+    ASSERT_EQ( a / ( b + s ), m );
+}
+
+TYPED_TEST(ExpressionTest, Aliasing )
+{
+    //
+    // Each element only depends on the same element of the operands, so
+    // assigning to an operand is safe
+    //
+    TypeParam a = GetRandomMatrix<TypeParam>();
+    TypeParam b = GetRandomMatrix<TypeParam>();
+    TypeParam expected = a * b + a;
+    a = Lazy( a ) * b + a;
+    ASSERT_EQ( expected, a );
+}
@@ -0,0 +1,257 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <joemath/joemath.hpp>
+
+using namespace JoeMath;
+
+namespace
+{
+    template <typename Scalar>
+    Matrix<Scalar, 4, 4> GetRandomTransform()
+    {
+        static std::uniform_real_distribution<Scalar> re( -1, 1 );
+        static auto ran = std::bind( re, std::minstd_rand() );
+        const Vector<Scalar, 3> axis( ran(), ran(), ran() + 2 );
+        return Mul( Translate( Vector<Scalar, 4>( ran(), ran(), ran(), 1 ) ),
+                    Mul( RotateAxisAngle( Normalized( axis ), ran() * 3 ),
+                         Scale( Vector<Scalar, 4>( ran() + 2, ran() + 2,
+                                                   ran() + 2, 1 ) ) ) );
+    }
+
+    //
+    // The world transform found by walking up to the root
+    //
+    template <typename Scalar>
+    Matrix<Scalar, 4, 4> GetExpectedWorld(
+                                      const TransformHierarchy<Scalar>& h,
+                                      u32 node )
+    {
+        std::vector<u32> chain;
+        for( u32 n = node; n != TransformHierarchy<Scalar>::no_parent;
+             n = h.GetParent( n ) )
+            chain.push_back( n );
+
+        Matrix<Scalar, 4, 4> ret = h.GetLocal( chain.back() );
+        for( auto i = chain.rbegin() + 1; i != chain.rend(); ++i )
+            ret = Mul( ret, h.GetLocal( *i ) );
+        return ret;
+    }
+
+    template <typename Scalar>
+    void ExpectWorlds( const TransformHierarchy<Scalar>& h )
+    {
+        for( u32 n = 0; n < h.GetSize(); ++n )
+        {
+            EXPECT_FALSE( h.IsDirty( n ) );
+            EXPECT_EQ( GetExpectedWorld( h, n ), h.GetWorld( n ) );
+        }
+    }
+
+    //
+    // A random tree, every node's parent is any node before it
+    //
+    template <typename Scalar>
+    TransformHierarchy<Scalar> GetRandomHierarchy( u32 size )
+    {
+        std::minstd_rand ran;
+        TransformHierarchy<Scalar> h;
+        h.Reserve( size );
+        for( u32 n = 0; n < size; ++n )
+        {
+            const u32 parent = n == 0 || ran() % 8 == 0 ?
+                                 TransformHierarchy<Scalar>::no_parent :
+                                 ran() % n;
+            h.AddNode( GetRandomTransform<Scalar>(), parent );
+        }
+        return h;
+    }
+}
+
+template <typename T>
+class HierarchyTest : public testing::Test
+{
+};
+
+using testing::Types;
+
+typedef Types<float, double> HierarchyTypes;
+
+TYPED_TEST_CASE(HierarchyTest, HierarchyTypes);
+
+TYPED_TEST(HierarchyTest, Update )
+{
+    typedef TypeParam Scalar;
+    typedef TransformHierarchy<Scalar> Hierarchy;
+
+    Hierarchy h = GetRandomHierarchy<Scalar>( 100 );
+    EXPECT_EQ( 100u, h.GetSize() );
+    for( u32 n = 0; n < h.GetSize(); ++n )
+        EXPECT_TRUE( h.IsDirty( n ) );
+    h.Update();
+    ExpectWorlds( h );
+
+    //
+    // Nodes added later are dirty until the next update
+    //
+    const u32 child = h.AddNode( GetRandomTransform<Scalar>(), 50 );
+    const u32 root  = h.AddNode( GetRandomTransform<Scalar>() );
+    EXPECT_EQ( 100u, child );
+    EXPECT_EQ( 101u, root );
+    EXPECT_EQ( 50u, h.GetParent( child ) );
+    EXPECT_EQ( Hierarchy::no_parent, h.GetParent( root ) );
+    EXPECT_TRUE( h.IsDirty( child ) );
+    EXPECT_FALSE( h.IsDirty( 50 ) );
+    h.Update();
+    ExpectWorlds( h );
+    EXPECT_EQ( h.GetLocal( root ), h.GetWorld( root ) );
+    EXPECT_EQ( &h.GetWorld( 0 ), h.GetWorldData() );
+
+    h.Clear();
+    EXPECT_EQ( 0u, h.GetSize() );
+    h.Update();
+}
+
+TYPED_TEST(HierarchyTest, Chain )
+{
+    typedef TypeParam Scalar;
+    typedef Vector<Scalar, 4> Vector4;
+
+    //
+    // Each node is scaled by 2 and moved along x by 1 in its parent's space,
+    // so node n is scaled by 2^(n+1) and moved along x by 2^(n+1) - 1
+    //
+    const Matrix<Scalar, 4, 4> local = Mul( Translate( Vector4( 1, 0, 0, 1 ) ),
+                                            Scale( Vector4( 2, 2, 2, 1 ) ) );
+    TransformHierarchy<Scalar> h;
+    u32 parent = TransformHierarchy<Scalar>::no_parent;
+    for( u32 n = 0; n < 8; ++n )
+        parent = h.AddNode( local, parent );
+    h.Update();
+
+    for( u32 n = 0; n < 8; ++n )
+    {
+        const Scalar s = Scalar( 2 << n );
+        EXPECT_EQ( Mul( Translate( Vector4( s - 1, 0, 0, 1 ) ),
+                        Scale( Vector4( s, s, s, 1 ) ) ),
+                   h.GetWorld( n ) );
+    }
+    ExpectWorlds( h );
+}
+
+TYPED_TEST(HierarchyTest, DirtySubtrees )
+{
+    typedef TypeParam Scalar;
+    typedef Matrix<Scalar, 4, 4> Matrix4;
+
+    TransformHierarchy<Scalar> h = GetRandomHierarchy<Scalar>( 200 );
+    h.Update();
+
+    std::minstd_rand ran;
+    for( u32 i = 0; i < 20; ++i )
+    {
+        std::vector<Matrix4> before( h.GetWorldData(),
+                                     h.GetWorldData() + h.GetSize() );
+
+        //
+        // Change a few nodes and find which ones are below them
+        //
+        std::vector<bool> changed( h.GetSize(), false );
+        for( u32 j = 0; j < 3; ++j )
+        {
+            const u32 n = ran() % h.GetSize();
+            h.SetLocal( n, GetRandomTransform<Scalar>() );
+            EXPECT_TRUE( h.IsDirty( n ) );
+            changed[n] = true;
+        }
+        for( u32 n = 0; n < h.GetSize(); ++n )
+            if( h.GetParent( n ) != TransformHierarchy<Scalar>::no_parent &&
+                changed[h.GetParent( n )] )
+                changed[n] = true;
+
+        //
+        // Until the update the old world transforms are kept
+        //
+        for( u32 n = 0; n < h.GetSize(); ++n )
+            EXPECT_EQ( before[n], h.GetWorld( n ) );
+
+        h.Update();
+        ExpectWorlds( h );
+        for( u32 n = 0; n < h.GetSize(); ++n )
+            EXPECT_TRUE( changed[n] || before[n] == h.GetWorld( n ) );
+    }
+}
+
+TYPED_TEST(HierarchyTest, InverseWorld )
+{
+    typedef TypeParam Scalar;
+    typedef Matrix<Scalar, 4, 4> Matrix4;
+
+    const Scalar tolerance = std::is_same<Scalar, float>::value ? 1e-3 : 1e-9;
+
+    TransformHierarchy<Scalar> h;
+    const u32 root  = h.AddNode( GetRandomTransform<Scalar>() );
+    const u32 child = h.AddNode( GetRandomTransform<Scalar>(), root );
+    const u32 leaf  = h.AddNode( GetRandomTransform<Scalar>(), child );
+    h.Update();
+
+    for( u32 n : { root, child, leaf } )
+    {
+        const Matrix4 inverse = h.GetInverseWorld( n );
+        EXPECT_EQ( Inverted( h.GetWorld( n ) ), inverse );
+        //
+        // The cached one is returned the second time
+        //
+        EXPECT_EQ( &h.GetInverseWorld( n ), &h.GetInverseWorld( n ) );
+        EXPECT_EQ( inverse, h.GetInverseWorld( n ) );
+    }
+
+    //
+    // Changing the child invalidates the inverses below it but not the root's
+    //
+    const Matrix4 root_inverse = h.GetInverseWorld( root );
+    const Matrix4 leaf_inverse = h.GetInverseWorld( leaf );
+    h.SetLocal( child, GetRandomTransform<Scalar>() );
+    h.Update();
+    EXPECT_EQ( root_inverse, h.GetInverseWorld( root ) );
+    EXPECT_NE( leaf_inverse, h.GetInverseWorld( leaf ) );
+    EXPECT_EQ( Inverted( h.GetWorld( leaf ) ), h.GetInverseWorld( leaf ) );
+
+    const Matrix4 identity = Mul( h.GetWorld( leaf ),
+                                  h.GetInverseWorld( leaf ) );
+    for( u32 j = 0; j < 4; ++j )
+        for( u32 i = 0; i < 4; ++i )
+            EXPECT_NEAR( i == j ? 1 : 0, identity.m_elements[j][i],
+                         tolerance );
+}
@@ -1,4 +1,7 @@
 #include "gtest/gtest.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <random>
 
 #include <joemath/joemath.hpp>
@@ -41,6 +44,11 @@ class SquareMatrixTest : public testing::Test
 {
 };
 
+template <typename T>
+class DecompositionTest : public testing::Test
+{
+};
+
 using testing::Types;
 
 typedef Types<// float Matrices
@@ -66,10 +74,14 @@ typedef Types<// float square Matrices
               Matrix<float, 3, 3>,
               Matrix<float, 4, 4>,
               Matrix<float, 5, 5>,
-              Matrix<float, 6, 6>  > SquareMatrixTypes;
+              Matrix<float, 6, 6>,
+              Matrix<float, 8, 8>  > SquareMatrixTypes;
+
+typedef Types<float, double> DecompositionTypes;
 
 TYPED_TEST_CASE(MatrixTest, MatrixTypes);
 TYPED_TEST_CASE(SquareMatrixTest, SquareMatrixTypes);
+TYPED_TEST_CASE(DecompositionTest, DecompositionTypes);
 
 TYPED_TEST(MatrixTest, InstantiateDefaultConstructor )
 {
@@ -273,6 +285,60 @@ TYPED_TEST(MatrixTest, ComponentWiseDivision )
                        m.m_elements[i][j] / n.m_elements[i][j] );
 }
 
+TYPED_TEST(MatrixTest, ScalarAssignment )
+{
+    TypeParam m = GetRandomMatrix<TypeParam>();
+    auto t = GetRandomScalar<typename TypeParam::scalar_type>();
+    TypeParam o;
+
+    o = m; o += t;
+    ASSERT_EQ( m + t, o );
+    o = m; o -= t;
+    ASSERT_EQ( m - t, o );
+    o = m; o *= t;
+    ASSERT_EQ( m * t, o );
+    o = m; o /= t;
+    ASSERT_EQ( m / t, o );
+
+    //
+    // Scalars of a different type should give the same result as assigning
+    // the binary operator
+    //
+    double d = GetRandomScalar<double>();
+    o = m; o += d;
+    ASSERT_EQ( TypeParam( m + d ), o );
+    o = m; o *= d;
+    ASSERT_EQ( TypeParam( m * d ), o );
+    o = m; o /= d;
+    ASSERT_EQ( TypeParam( m / d ), o );
+}
+
+TYPED_TEST(MatrixTest, ComponentWiseAssignment )
+{
+    TypeParam m = GetRandomMatrix<TypeParam>();
+    TypeParam n = GetRandomMatrix<TypeParam>();
+    TypeParam o;
+
+    o = m; o += n;
+    ASSERT_EQ( m + n, o );
+    o = m; o -= n;
+    ASSERT_EQ( m - n, o );
+    o = m; o *= n;
+    ASSERT_EQ( m * n, o );
+    o = m; o /= n;
+    ASSERT_EQ( m / n, o );
+
+    //
+    // Assigning to the operand
+    //
+    o = m; o += o;
+    ASSERT_EQ( m + m, o );
+
+    Matrix<double, TypeParam::rows, TypeParam::columns> p( n );
+    o = m; o -= p;
+    ASSERT_EQ( TypeParam( m - p ), o );
+}
+
 TYPED_TEST(SquareMatrixTest, MultiplyIdentity )
 {
     TypeParam m = GetRandomMatrix<TypeParam>();
@@ -289,6 +355,26 @@ TYPED_TEST(SquareMatrixTest, MultiplyZero )
     ASSERT_EQ( TypeParam(0), Mul(z, m) );
 }
 
+TYPED_TEST(SquareMatrixTest, MultiplyLoop )
+{
+    //
+    // The generic Mul is unrolled, it should sum in the same order as the
+    // triple loop
+    //
+    using Scalar = typename TypeParam::scalar_type;
+    const u32 size = TypeParam::rows;
+
+    TypeParam m = GetRandomMatrix<TypeParam>();
+    TypeParam n = GetRandomMatrix<TypeParam>();
+    TypeParam p(0);
+    for( u32 i = 0; i < size; ++i )
+        for( u32 j = 0; j < size; ++j )
+            for( u32 k = 0; k < size; ++k )
+                p.m_elements[i][j] += m.m_elements[k][j] * n.m_elements[i][k];
+
+    ASSERT_EQ( p, ( Mul<Scalar, size, size, Scalar, size>( m, n ) ) );
+}
+
 TYPED_TEST(MatrixTest, Transposed )
 {
     auto m = GetRandomMatrix<TypeParam>();
@@ -320,3 +406,414 @@ TYPED_TEST(SquareMatrixTest, InvertMultiply )
             ASSERT_FLOAT_EQ( 0.f, p.m_elements[i][j] );
 }
 
+
+TYPED_TEST(SquareMatrixTest, LUReconstruct )
+{
+    using Scalar = typename TypeParam::scalar_type;
+    const u32 size = TypeParam::rows;
+
+    auto m = GetRandomMatrix<TypeParam>();
+    auto lu = LU(m);
+
+    TypeParam l = Identity<Scalar, size>();
+    TypeParam u(0);
+    for( u32 i = 0; i < size; ++i )
+        for( u32 j = 0; j < size; ++j )
+            if( j > i )
+                l.m_elements[i][j] = lu.m_factors.m_elements[i][j];
+            else
+                u.m_elements[i][j] = lu.m_factors.m_elements[i][j];
+
+    auto p = Mul( l, u );
+
+    for( u32 i = 0; i < size; ++i )
+        for( u32 j = 0; j < size; ++j )
+            ASSERT_NEAR( m.m_elements[i][lu.m_pivots[j]], p.m_elements[i][j],
+                         1e-2f );
+}
+
+TYPED_TEST(SquareMatrixTest, InvertRandom )
+{
+    using Scalar = typename TypeParam::scalar_type;
+    const u32 size = TypeParam::rows;
+
+    //
+    // Make the matrix diagonally dominant so that it's well conditioned
+    //
+    auto m = GetRandomMatrix<TypeParam>();
+    for( u32 i = 0; i < size; ++i )
+        m.m_elements[i][i] += m.m_elements[i][i] < 0 ? -1000.f * size
+                                                      :  1000.f * size;
+
+    auto p = Mul( Inverted(m), m ) - Identity<Scalar, size>();
+
+    for( u32 i = 0; i < size; ++i )
+        for( u32 j = 0; j < size; ++j )
+            ASSERT_NEAR( 0.f, p.m_elements[i][j], 1e-5f );
+}
+
+TYPED_TEST(SquareMatrixTest, Solve )
+{
+    using Scalar = typename TypeParam::scalar_type;
+    const u32 size = TypeParam::rows;
+
+    auto m = GetRandomMatrix<TypeParam>();
+    for( u32 i = 0; i < size; ++i )
+        m.m_elements[i][i] += m.m_elements[i][i] < 0 ? -1000.f * size
+                                                      :  1000.f * size;
+    auto b = GetRandomMatrix<Matrix<Scalar, size, 3>>();
+
+    auto check = [&]( const Solution<Scalar, size, 3>& s )
+    {
+        ASSERT_EQ( SolveStatus::Success, s.m_status );
+        auto r = Mul( m, s.m_x ) - b;
+        for( u32 i = 0; i < 3; ++i )
+            for( u32 j = 0; j < size; ++j )
+                ASSERT_NEAR( 0.f, r.m_elements[i][j], 1e-2f );
+    };
+    check( Solve( m, b ) );
+    check( Solve( LU( m ), b ) );
+
+    //
+    // A symmetric positive definite matrix for Cholesky
+    //
+    m = Mul( Transposed( m ), m );
+    check( SolveCholesky( m, b ) );
+    check( Solve( m, b ) );
+
+    auto v = Solve( m, b.GetColumn( 0 ) );
+    ASSERT_EQ( SolveStatus::Success, v.m_status );
+    for( u32 j = 0; j < size; ++j )
+        ASSERT_FLOAT_EQ( Solve( m, b ).m_x.m_elements[0][j], v.m_x[j] );
+}
+
+TYPED_TEST(SquareMatrixTest, SolveFailure )
+{
+    using Scalar = typename TypeParam::scalar_type;
+    const u32 size = TypeParam::rows;
+
+    auto m = GetRandomMatrix<TypeParam>();
+    m.SetColumn( 1, typename TypeParam::column_type( Scalar{0} ) );
+    auto b = GetRandomMatrix<typename TypeParam::column_type>();
+    ASSERT_EQ( SolveStatus::Singular, Solve( m, b ).m_status );
+    ASSERT_EQ( SolveStatus::Singular, Solve( LU( m ), b ).m_status );
+    ASSERT_EQ( SolveStatus::NotPositiveDefinite,
+               SolveCholesky( m, b ).m_status );
+    ASSERT_EQ( typename TypeParam::column_type( Scalar{0} ),
+               Solve( m, b ).m_x );
+
+    m = -Identity<Scalar, size>();
+    ASSERT_EQ( SolveStatus::Success, Solve( m, b ).m_status );
+    ASSERT_EQ( SolveStatus::NotPositiveDefinite,
+               SolveCholesky( m, b ).m_status );
+}
+
+TEST(MatrixTest, SolveIllConditioned )
+{
+    //
+    // The 3x3 Hilbert matrix has a condition number of about 500, enough that
+    // the closed form inverse leaves a residual tens of times larger than
+    // pivoted elimination does
+    //
+    float3x3 a;
+    for( u32 i = 0; i < 3; ++i )
+        for( u32 j = 0; j < 3; ++j )
+            a.m_elements[j][i] = 1.f / float( i + j + 1 );
+    const Matrix<float, 3, 1> b( float3( 1, 2, 3 ) );
+
+    //
+    // The residual is found in double so that its own rounding doesn't hide
+    // the error in x
+    //
+    auto residual = [&]( const Matrix<float, 3, 1>& x )
+    {
+        double r = 0;
+        for( u32 i = 0; i < 3; ++i )
+        {
+            double s = -double( b.m_elements[0][i] );
+            for( u32 k = 0; k < 3; ++k )
+                s += double( a.m_elements[k][i] ) * x.m_elements[0][k];
+            r = std::max( r, std::abs( s ) );
+        }
+        return r;
+    };
+
+    const Solution<float, 3, 1> s = Solve( a, b );
+    const Solution<float, 3, 1> lu = Solve( LU( a ), b );
+    ASSERT_EQ( SolveStatus::Success, s.m_status );
+    ASSERT_EQ( SolveStatus::Success, lu.m_status );
+    EXPECT_LE( residual( s.m_x ), 4 * residual( lu.m_x ) );
+}
+
+TYPED_TEST(SquareMatrixTest, DeterminantPermutation )
+{
+    //
+    // Swapping two columns of the identity negates the determinant
+    //
+    using Scalar = typename TypeParam::scalar_type;
+    TypeParam m = Identity<Scalar, TypeParam::rows>();
+    std::swap( m.m_elements[0], m.m_elements[1] );
+    ASSERT_EQ( m.Determinant(), -1 );
+}
+
+namespace
+{
+    //
+    // Checks that Mul( Mul( l, diag( d ) ), r ) is within tolerance of a and
+    // that l is orthogonal to within orthogonality_tolerance. The error in
+    // the product grows with a but the error in l doesn't, so they have
+    // separate tolerances
+    //
+    template <typename Scalar>
+    void CheckDecomposition( const Matrix<Scalar, 3, 3>& a,
+                             const Matrix<Scalar, 3, 3>& l,
+                             const Vector<Scalar, 3>& d,
+                             const Matrix<Scalar, 3, 3>& r,
+                             Scalar tolerance,
+                             Scalar orthogonality_tolerance =
+                                 std::numeric_limits<Scalar>::epsilon() * 16 )
+    {
+        Matrix<Scalar, 3, 3> diag( Scalar{0} );
+        for( u32 i = 0; i < 3; ++i )
+            diag.m_elements[i][i] = d[i];
+        const auto e = Mul( Mul( l, diag ), r ) - a;
+        const auto o = Mul( l, Transposed( l ) ) - Identity<Scalar, 3>();
+        for( u32 i = 0; i < 3; ++i )
+            for( u32 j = 0; j < 3; ++j )
+            {
+                ASSERT_NEAR( 0, e.m_elements[i][j], tolerance );
+                ASSERT_NEAR( 0, o.m_elements[i][j], orthogonality_tolerance );
+            }
+    }
+}
+
+TYPED_TEST(DecompositionTest, EigenSymmetric )
+{
+    using Matrix3 = Matrix<TypeParam, 3, 3>;
+    using Vector3 = Vector<TypeParam, 3>;
+    const TypeParam tolerance =
+                            std::numeric_limits<TypeParam>::epsilon() * 16;
+
+    for( u32 n = 0; n < 100; ++n )
+    {
+        Matrix3 a = GetRandomMatrix<Matrix3>() / TypeParam{1000};
+        if( n % 4 == 1 )
+            a.SetColumn( 2, a.GetColumn( 1 ) );
+        a = Mul( a, Transposed( a ) );
+
+        //
+        // Only the lower triangle is read
+        //
+        Matrix3 lower = a;
+        lower.m_elements[2][0] = TypeParam{100};
+
+        const auto e = EigenSymmetric( lower );
+        ASSERT_GE( e.m_values[0], e.m_values[1] );
+        ASSERT_GE( e.m_values[1], e.m_values[2] );
+        CheckDecomposition( a, e.m_vectors, e.m_values,
+                            Transposed( e.m_vectors ),
+                            tolerance * e.m_values[0], tolerance );
+        ASSERT_NEAR( 1, Determinant( e.m_vectors ), tolerance );
+    }
+
+    const Matrix3 diagonal( 1, 0, 0,
+                            0, 3, 0,
+                            0, 0, 2 );
+    const auto d = EigenSymmetric( diagonal );
+    ASSERT_EQ( Vector3( 3, 2, 1 ), d.m_values );
+    CheckDecomposition( diagonal, d.m_vectors, d.m_values,
+                        Transposed( d.m_vectors ), tolerance );
+
+    const auto z = EigenSymmetric( Matrix3( TypeParam{0} ) );
+    ASSERT_EQ( Vector3( TypeParam{0} ), z.m_values );
+    ASSERT_EQ( ( Identity<TypeParam, 3>() ), z.m_vectors );
+}
+
+TYPED_TEST(DecompositionTest, SVD )
+{
+    using Matrix3 = Matrix<TypeParam, 3, 3>;
+    using Vector3 = Vector<TypeParam, 3>;
+    const TypeParam tolerance =
+                            std::numeric_limits<TypeParam>::epsilon() * 256;
+
+    for( u32 n = 0; n < 100; ++n )
+    {
+        Matrix3 a = GetRandomMatrix<Matrix3>();
+        if( n % 4 == 1 )
+            a.SetColumn( 2, a.GetColumn( 0 ) * TypeParam{2} );
+
+        const auto s = SVD( a );
+        ASSERT_GE( s.m_values[0], s.m_values[1] );
+        ASSERT_GE( s.m_values[1], std::abs( s.m_values[2] ) );
+        ASSERT_TRUE( n % 4 == 1 ||
+                     ( Determinant( a ) < 0 ) == ( s.m_values[2] < 0 ) );
+        CheckDecomposition( a, s.m_u, s.m_values, Transposed( s.m_v ),
+                            tolerance * s.m_values[0], tolerance );
+        ASSERT_NEAR( 1, Determinant( s.m_u ), tolerance );
+        ASSERT_NEAR( 1, Determinant( s.m_v ), tolerance );
+        CheckDecomposition( Matrix3( Transposed( a ) ), s.m_v, s.m_values,
+                            Transposed( s.m_u ), tolerance * s.m_values[0],
+                            tolerance );
+    }
+
+    //
+    // A reflection
+    //
+    const Matrix3 m = Scale( Vector3( 2, -1, 3 ) );
+    const auto s = SVD( m );
+    ASSERT_EQ( Vector3( 3, 2, -1 ), s.m_values );
+    CheckDecomposition( m, s.m_u, s.m_values, Transposed( s.m_v ),
+                        tolerance );
+
+    const auto z = SVD( Matrix3( TypeParam{0} ) );
+    ASSERT_EQ( Vector3( TypeParam{0} ), z.m_values );
+}
+
+TYPED_TEST(DecompositionTest, Orthonormalize )
+{
+    using Matrix3 = Matrix<TypeParam, 3, 3>;
+    using Matrix4 = Matrix<TypeParam, 4, 4>;
+    using Vector3 = Vector<TypeParam, 3>;
+    const TypeParam tolerance =
+                            std::numeric_limits<TypeParam>::epsilon() * 16;
+
+    //
+    // A rotation which has drifted after many multiplications
+    //
+    const Matrix3 step = RotateAxisAngle( Normalized( Vector3( 1, 2, 3 ) ),
+                                          TypeParam{0.1} ).
+                                                     template GetSubMatrix<3, 3>();
+    Matrix3 r = Identity<TypeParam, 3>();
+    for( u32 n = 0; n < 1000; ++n )
+        r = Mul( r, step + Matrix3( TypeParam{1e-4} ) );
+
+    const Matrix3 o = Orthonormalized( r );
+    CheckDecomposition( Matrix3( Identity<TypeParam, 3>() ), o,
+                        Vector3( TypeParam{1} ), Transposed( o ), tolerance );
+    ASSERT_NEAR( 1, Determinant( o ), tolerance );
+    ASSERT_NEAR( 0, Dot( Normalized( r.GetColumn( 0 ) ), o.GetColumn( 0 ) ) - 1,
+                 tolerance );
+    ASSERT_NEAR( 0, Dot( o.GetColumn( 1 ), Cross( o.GetColumn( 0 ),
+                                                  r.GetColumn( 1 ) ) ),
+                 tolerance );
+
+    //
+    // The translation of a 4x4 matrix is kept
+    //
+    Matrix4 t = Translate( Vector<TypeParam, 4>( 1, 2, 3, 1 ) );
+    t.m_elements[0][1] = TypeParam{0.5};
+    Matrix4 u = t;
+    Orthonormalize( u );
+    ASSERT_EQ( t.GetColumn( 3 ), u.GetColumn( 3 ) );
+    ASSERT_EQ( t.GetRow( 3 ), u.GetRow( 3 ) );
+    const Matrix3 upper = t.template GetSubMatrix<3, 3>();
+    const Matrix3 orthonormal = u.template GetSubMatrix<3, 3>();
+    ASSERT_EQ( Orthonormalized( upper ), orthonormal );
+}
+
+TYPED_TEST(DecompositionTest, PolarDecompose )
+{
+    using Matrix3 = Matrix<TypeParam, 3, 3>;
+    using Vector3 = Vector<TypeParam, 3>;
+    const TypeParam tolerance =
+                            std::numeric_limits<TypeParam>::epsilon() * 64;
+
+    //
+    // A rotation and a symmetric positive definite stretch are unique, so
+    // checking those and the product is enough
+    //
+    for( u32 n = 0; n < 100; ++n )
+    {
+        const Matrix3 m = GetRandomMatrix<Matrix3>() / TypeParam{1000};
+        const auto p = PolarDecompose( m );
+
+        ASSERT_NEAR( Determinant( m ) < 0 ? -1 : 1,
+                     Determinant( p.m_rotation ), tolerance );
+        ASSERT_EQ( p.m_stretch, Transposed( p.m_stretch ) );
+        ASSERT_LT( 0, EigenSymmetric( p.m_stretch ).m_values[2] );
+        CheckDecomposition( m, p.m_rotation, Vector3( TypeParam{1} ),
+                            p.m_stretch, tolerance );
+    }
+
+    const Matrix3 r = RotateZ<TypeParam, 3>( TypeParam{0.5} );
+    const auto p = PolarDecompose( Mul( r, Scale( Vector3( 1, 2, 3 ) ) ) );
+    CheckDecomposition( r, p.m_rotation, Vector3( TypeParam{1} ),
+                        Matrix3( Identity<TypeParam, 3>() ), tolerance );
+    CheckDecomposition( Scale( Vector3( 1, 2, 3 ) ),
+                        Matrix3( Identity<TypeParam, 3>() ),
+                        Vector3( TypeParam{1} ), p.m_stretch, tolerance );
+}
+
+TYPED_TEST(MatrixTest, ConstantExpression )
+{
+    using Scalar = typename TypeParam::scalar_type;
+    using Transpose = Matrix<Scalar, TypeParam::columns, TypeParam::rows>;
+    using Product   = Matrix<Scalar, TypeParam::rows, TypeParam::rows>;
+
+    constexpr TypeParam a( Scalar{2} );
+    constexpr TypeParam b = a * Scalar{3} - Scalar{1};
+    static_assert( b == TypeParam( Scalar{5} ), "Scalar arithmetic" );
+
+    constexpr TypeParam c = -( a + b ) / +a * a - b;
+    static_assert( c == TypeParam( Scalar{-12} ), "Matrix arithmetic" );
+
+    constexpr Transpose t = Transposed( b );
+    static_assert( t == Transpose( Scalar{5} ), "Transposed" );
+
+    constexpr Product p = Mul( a, t );
+    static_assert( p == Product( Scalar{10} * TypeParam::columns ), "Mul" );
+
+    //
+    // The constant evaluation must give the same results as the runtime one
+    //
+    TypeParam d = a;
+    EXPECT_EQ( b, d * Scalar{3} - Scalar{1} );
+    EXPECT_EQ( c, -( d + b ) / +d * d - b );
+    EXPECT_EQ( p, Mul( d, Transposed( b ) ) );
+}
+
+TEST(MatrixTest, ConstantExpressionTransforms )
+{
+    constexpr float4 position( float3( 1, 2, 3 ), 1.f );
+    static_assert( position == float4( 1, 2, 3, 1 ), "Mixed constructor" );
+    static_assert( position.x() == 1 && position.y() == 2 &&
+                   position.z() == 3 && position.w() == 1, "Accessors" );
+    static_assert( position[2] == 3, "Accessors" );
+
+    constexpr float4x4 t = Translate( position );
+    constexpr float4x4 s = Scale( float4( 2, 2, 2, 1 ) );
+    constexpr float4x4 ts = Mul( t, s );
+    static_assert( ts == float4x4( float4( 2, 0, 0, 0 ),
+                                   float4( 0, 2, 0, 0 ),
+                                   float4( 0, 0, 2, 0 ),
+                                   float4( 1, 2, 3, 1 ) ), "Translate Scale" );
+    static_assert( Mul( ts, float4( 1, 1, 1, 1 ) ) == float4( 3, 4, 5, 1 ),
+                   "Mul vector" );
+    static_assert( ts.Determinant() == 8 && Determinant( t ) == 1,
+                   "Determinant" );
+    static_assert( ts.GetRow( 3 ) == Transposed( float4( 0, 0, 0, 1 ) ),
+                   "GetRow" );
+    static_assert( ts.GetSubMatrix<3, 3>() == Identity<float, 3>() * 2.f,
+                   "GetSubMatrix" );
+    static_assert( Transposed( Transposed( ts ) ) == ts, "Transposed" );
+
+    static_assert( Cross( float3( 1, 0, 0 ), float3( 0, 1, 0 ) ) ==
+                   float3( 0, 0, 1 ), "Cross" );
+    static_assert( Dot( position, position ) == 15 &&
+                   position.LengthSq() == 15, "Dot" );
+    static_assert( Outer( float2( 1, 2 ), float2( 3, 4 ) ) ==
+                   float2x2( 3, 6, 4, 8 ), "Outer" );
+
+    constexpr float4x4 o = Ortho( -1.f, 1.f, 1.f, -1.f, 0.f, 1.f );
+
+    //
+    // Compare against the runtime versions
+    //
+    float4 p = position;
+    float4x4 rt = Translate( p );
+    float4x4 rs = Scale( float4( 2, 2, 2, 1 ) );
+    EXPECT_EQ( ts, Mul( rt, rs ) );
+    EXPECT_EQ( ts.Determinant(), rs.Determinant() );
+    EXPECT_EQ( o, Ortho( -1.f, 1.f, 1.f, -1.f, 0.f, 1.f ) );
+    EXPECT_EQ( Transposed( ts ), Transposed( Mul( rt, rs ) ) );
+}
@@ -0,0 +1,287 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <joemath/joemath.hpp>
+#include <joemath/parallel.hpp>
+
+using namespace JoeMath;
+
+namespace
+{
+    template <typename T>
+    T GetRandomMatrix()
+    {
+        static std::uniform_real_distribution<typename T::scalar_type> re(-10,
+                                                                          10);
+        static auto ran = std::bind(re,std::minstd_rand());
+        T ret;
+        for( u32 i = 0; i < T::columns; ++i )
+            for( u32 j = 0; j < T::rows; ++j )
+                ret.m_elements[i][j] = ran();
+        return ret;
+    }
+
+    template <typename T>
+    std::vector<T> GetRandomMatrices( u32 count )
+    {
+        std::vector<T> ret( count );
+        for( T& t : ret )
+            t = GetRandomMatrix<T>();
+        return ret;
+    }
+
+    //
+    // Runs ParallelFor and checks that the chunks cover the range exactly
+    // once, starting at multiples of the grain. Without workers the range
+    // isn't split.
+    //
+    void CheckChunks( ThreadPool& pool, u32 begin, u32 end, u32 grain )
+    {
+        std::mutex mutex;
+        std::vector<std::pair<u32, u32>> chunks;
+        pool.ParallelFor( begin, end, grain, [&]( u32 b, u32 e )
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            chunks.emplace_back( b, e );
+        } );
+
+        std::sort( chunks.begin(), chunks.end() );
+        u32 next = begin;
+        for( const auto& chunk : chunks )
+        {
+            EXPECT_EQ( next, chunk.first );
+            EXPECT_LT( chunk.first, chunk.second );
+            EXPECT_TRUE( pool.GetThreadCount() == 0 ||
+                         chunk.second - chunk.first <= std::max( grain, 1u ) );
+            EXPECT_EQ( 0u, ( chunk.first - begin ) % std::max( grain, 1u ) );
+            next = chunk.second;
+        }
+        EXPECT_EQ( end > begin ? end : begin, next );
+    }
+}
+
+TEST(ParallelTest, ParallelFor )
+{
+    for( u32 threads : { 0u, 1u, 3u } )
+    {
+        ThreadPool pool( threads );
+        EXPECT_EQ( threads, pool.GetThreadCount() );
+
+        CheckChunks( pool, 0, 1000, 1 );
+        CheckChunks( pool, 0, 1000, 7 );
+        CheckChunks( pool, 13, 1000, 64 );
+        CheckChunks( pool, 5, 10, 100 );
+        CheckChunks( pool, 10, 10, 1 );
+        CheckChunks( pool, 10, 5, 1 );
+        CheckChunks( pool, 0, 100, 0 );
+    }
+}
+
+TEST(ParallelTest, Nested )
+{
+    ThreadPool pool( 3 );
+    std::vector<u32> counts( 64 * 64, 0 );
+    pool.ParallelFor( 0, 64, 1, [&]( u32 begin, u32 end )
+    {
+        for( u32 i = begin; i < end; ++i )
+            pool.ParallelFor( 0, 64, 4, [&]( u32 b, u32 e )
+            {
+                for( u32 j = b; j < e; ++j )
+                    ++counts[i * 64 + j];
+            } );
+    } );
+    for( u32 c : counts )
+        EXPECT_EQ( 1u, c );
+
+    //
+    // Several threads outside the pool using it at once
+    //
+    std::atomic<u32> sum( 0 );
+    std::vector<std::thread> callers;
+    for( u32 t = 0; t < 4; ++t )
+        callers.emplace_back( [&]
+        {
+            for( u32 n = 0; n < 10; ++n )
+                pool.ParallelFor( 0, 1000, 10, [&]( u32 begin, u32 end )
+                {
+                    sum += end - begin;
+                } );
+        } );
+    for( std::thread& caller : callers )
+        caller.join();
+    EXPECT_EQ( 4u * 10u * 1000u, sum.load() );
+
+    u32 total = 0;
+    ParallelFor( 0, 100, 100, [&]( u32 begin, u32 end )
+    {
+        total += end - begin;
+    } );
+    EXPECT_EQ( 100u, total );
+}
+
+//
+// Every policy gives the same results as the batch functions, seq as the
+// generic ones and the others as the SSE ones. The arrays are offset by a
+// float so that the chunks can't all start on a cache line.
+//
+TEST(ParallelTest, Policies )
+{
+    ThreadPool pool( 3 );
+    const execution::ParallelSimdPolicy par( &pool, 1 );
+    const u32 count = 1001;
+
+    for( u32 offset = 0; offset < 2; ++offset )
+    {
+        const std::vector<float4x4> ms = GetRandomMatrices<float4x4>( count );
+        const std::vector<float4> vs = GetRandomMatrices<float4>( count +
+                                                                  offset );
+        std::vector<float3> ps( count + offset );
+        for( u32 i = 0; i < ps.size(); ++i )
+            ps[i] = vs[i].xyz();
+        const float4x4 m = ms[0];
+
+        std::vector<float3> p0( count + offset ), p1( p0 ), p2( p0 ), p3( p0 );
+        TransformPoints( m, ps.data() + offset, p0.data() + offset, count );
+        TransformPoints( execution::simd, m, ps.data() + offset,
+                         p1.data() + offset, count );
+        TransformPoints( par, m, ps.data() + offset, p2.data() + offset,
+                         count );
+        TransformPoints( execution::par_simd, m, ps.data() + offset,
+                         p3.data() + offset, count );
+        EXPECT_EQ( p0, p1 );
+        EXPECT_EQ( p0, p2 );
+        EXPECT_EQ( p0, p3 );
+        TransformPoints<float, 4>( m, ps.data() + offset,
+                                   p0.data() + offset, count );
+        TransformPoints( execution::seq, m, ps.data() + offset,
+                         p1.data() + offset, count );
+        EXPECT_EQ( p0, p1 );
+
+        TransformVectors( m, ps.data() + offset, p0.data() + offset, count );
+        TransformVectors( par, m, ps.data() + offset, p1.data() + offset,
+                          count );
+        EXPECT_EQ( p0, p1 );
+
+        //
+        // In place, with the points in the middle of float4s
+        //
+        std::vector<float4> h0( vs ), h1( vs );
+        TransformPoints( m, reinterpret_cast<float3*>( h0.data() + offset ),
+                         reinterpret_cast<float3*>( h0.data() + offset ),
+                         count, sizeof(float4), sizeof(float4) );
+        TransformPoints( par, m,
+                         reinterpret_cast<float3*>( h1.data() + offset ),
+                         reinterpret_cast<float3*>( h1.data() + offset ),
+                         count, sizeof(float4), sizeof(float4) );
+        EXPECT_EQ( h0, h1 );
+
+        TransformHomogeneous( m, vs.data() + offset, h0.data(), count );
+        TransformHomogeneous( par, m, vs.data() + offset, h1.data(), count );
+        EXPECT_EQ( h0, h1 );
+
+        std::vector<float4x4> i0( count ), i1( count );
+        std::unique_ptr<bool[]> s0( new bool[count] );
+        std::unique_ptr<bool[]> s1( new bool[count] );
+        InvertBatch( ms.data(), i0.data(), count, s0.get() );
+        InvertBatch( par, ms.data(), i1.data(), count, s1.get() );
+        EXPECT_EQ( i0, i1 );
+        EXPECT_TRUE( std::equal( s0.get(), s0.get() + count, s1.get() ) );
+        InvertBatch<float, 4>( ms.data(), i0.data(), count );
+        InvertBatch( execution::seq, ms.data(), i1.data(), count );
+        EXPECT_EQ( i0, i1 );
+
+        NormalizedFast( vs.data() + offset, h0.data(), count );
+        NormalizedFast( par, vs.data() + offset, h1.data(), count );
+        EXPECT_EQ( h0, h1 );
+        NormalizedPrecise( vs.data() + offset, h0.data(), count );
+        NormalizedPrecise( par, vs.data() + offset, h1.data(), count );
+        EXPECT_EQ( h0, h1 );
+        NormalizedSafe( vs.data() + offset, h0.data(), count, float4( 1 ) );
+        NormalizedSafe( par, vs.data() + offset, h1.data(), count,
+                        float4( 1 ) );
+        EXPECT_EQ( h0, h1 );
+
+        std::vector<float> l0( count + offset ), l1( l0 );
+        LengthFast( ps.data(), l0.data() + offset, count );
+        LengthFast( par, ps.data(), l1.data() + offset, count );
+        EXPECT_EQ( l0, l1 );
+        InverseLength( ps.data(), l0.data() + offset, count );
+        InverseLength( par, ps.data(), l1.data() + offset, count );
+        EXPECT_EQ( l0, l1 );
+
+        RotateZBatch( l0.data(), i0.data(), count );
+        RotateZBatch( par, l0.data(), i1.data(), count );
+        EXPECT_EQ( i0, i1 );
+
+        OrthonormalizeBatch( ms.data(), i0.data(), count );
+        OrthonormalizeBatch( par, ms.data(), i1.data(), count );
+        EXPECT_EQ( i0, i1 );
+
+        const std::vector<float3x3> ts = GetRandomMatrices<float3x3>( count );
+        std::vector<EigenDecomposition<float>> e0( count ), e1( count );
+        EigenSymmetricBatch( ts.data(), e0.data(), count );
+        EigenSymmetricBatch( par, ts.data(), e1.data(), count );
+        std::vector<SingularValueDecomposition<float>> d0( count ), d1( count );
+        SVDBatch( ts.data(), d0.data(), count );
+        SVDBatch( par, ts.data(), d1.data(), count );
+        std::vector<PolarDecomposition<float>> q0( count ), q1( count );
+        PolarDecomposeBatch( ts.data(), q0.data(), count );
+        PolarDecomposeBatch( par, ts.data(), q1.data(), count );
+        for( u32 i = 0; i < count; ++i )
+        {
+            EXPECT_EQ( e0[i].m_values, e1[i].m_values );
+            EXPECT_EQ( e0[i].m_vectors, e1[i].m_vectors );
+            EXPECT_EQ( d0[i].m_u, d1[i].m_u );
+            EXPECT_EQ( d0[i].m_values, d1[i].m_values );
+            EXPECT_EQ( d0[i].m_v, d1[i].m_v );
+            EXPECT_EQ( q0[i].m_rotation, q1[i].m_rotation );
+            EXPECT_EQ( q0[i].m_stretch, q1[i].m_stretch );
+        }
+    }
+
+    //
+    // Doubles only have the generic versions
+    //
+    const std::vector<Matrix<double, 3, 3>> ds =
+                               GetRandomMatrices<Matrix<double, 3, 3>>( 100 );
+    std::vector<Matrix<double, 3, 3>> o0( 100 ), o1( 100 );
+    InvertBatch( ds.data(), o0.data(), 100 );
+    InvertBatch( par, ds.data(), o1.data(), 100 );
+    EXPECT_EQ( o0, o1 );
+    InvertBatch( execution::seq, ds.data(), o1.data(), 100 );
+    EXPECT_EQ( o0, o1 );
+}
@@ -0,0 +1,287 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#include "gtest/gtest.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <joemath/joemath.hpp>
+
+using namespace JoeMath;
+
+namespace
+{
+    template <typename Scalar>
+    Scalar GetRandomScalar( Scalar min, Scalar max )
+    {
+        static std::minstd_rand ran;
+        return std::uniform_real_distribution<Scalar>( min, max )( ran );
+    }
+
+    template <typename Scalar>
+    Vector<Scalar, 3> GetRandomVector()
+    {
+        return Vector<Scalar, 3>( GetRandomScalar<Scalar>( -10, 10 ),
+                                  GetRandomScalar<Scalar>( -10, 10 ),
+                                  GetRandomScalar<Scalar>( -10, 10 ) );
+    }
+
+    template <typename Scalar>
+    Quaternion<Scalar> GetRandomRotation()
+    {
+        return Normalized( Quaternion<Scalar>( GetRandomScalar<Scalar>( -1, 1 ),
+                                               GetRandomScalar<Scalar>( -1, 1 ),
+                                               GetRandomScalar<Scalar>( -1, 1 ),
+                                               GetRandomScalar<Scalar>( -1, 1 ) ) );
+    }
+
+    template <typename Scalar, u32 Rows, u32 Columns>
+    void ExpectNear( const Matrix<Scalar, Rows, Columns>& expected,
+                     const Matrix<Scalar, Rows, Columns>& actual,
+                     Scalar tolerance )
+    {
+        for( u32 i = 0; i < Rows * Columns; ++i )
+            EXPECT_NEAR( expected.m_elements[0][i], actual.m_elements[0][i],
+                         tolerance );
+    }
+
+    //
+    // q and -q are the same rotation
+    //
+    template <typename Scalar>
+    void ExpectSameRotation( const Quaternion<Scalar>& expected,
+                             const Quaternion<Scalar>& actual,
+                             Scalar tolerance )
+    {
+        ExpectNear( expected.xyzw() * ( Dot( expected, actual ) < 0 ? -1 : 1 ),
+                    actual.xyzw(), tolerance );
+    }
+}
+
+template <typename T>
+class QuaternionTest : public testing::Test
+{
+};
+
+using testing::Types;
+
+typedef Types<float, double> QuaternionTypes;
+
+TYPED_TEST_CASE(QuaternionTest, QuaternionTypes);
+
+TYPED_TEST(QuaternionTest, Multiplication )
+{
+    typedef TypeParam Scalar;
+    const Scalar tolerance = 1e-4;
+
+    for( u32 i = 0; i < 100; ++i )
+    {
+        Quaternion<Scalar> a = GetRandomRotation<Scalar>();
+        Quaternion<Scalar> b = GetRandomRotation<Scalar>();
+        Vector<Scalar, 3> v = GetRandomVector<Scalar>();
+
+        ExpectNear( Rotate( a, Rotate( b, v ) ), Rotate( a * b, v ),
+                    tolerance );
+        ExpectNear( Mul( Mul( ToMatrix<3>( a ), ToMatrix<3>( b ) ), v ),
+                    Rotate( a * b, v ), tolerance );
+
+        Quaternion<Scalar> c = a;
+        c *= b;
+        EXPECT_EQ( a * b, c );
+    }
+
+    Quaternion<Scalar> q = GetRandomRotation<Scalar>();
+    EXPECT_EQ( q, IdentityQuaternion<Scalar>() * q );
+    EXPECT_EQ( q, q * IdentityQuaternion<Scalar>() );
+}
+
+TYPED_TEST(QuaternionTest, Inverse )
+{
+    typedef TypeParam Scalar;
+    const Scalar tolerance = 1e-5;
+
+    for( u32 i = 0; i < 100; ++i )
+    {
+        Quaternion<Scalar> q = GetRandomRotation<Scalar>();
+        Vector<Scalar, 3> v = GetRandomVector<Scalar>();
+
+        ExpectNear( v, Rotate( Conjugated( q ), Rotate( q, v ) ),
+                    Scalar{1e-4} );
+        ExpectNear( IdentityQuaternion<Scalar>().xyzw(),
+                    ( q * Conjugated( q ) ).xyzw(), tolerance );
+
+        //
+        // Inverted works for quaternions which aren't normalized
+        //
+        Quaternion<Scalar> s = q * Scalar{3};
+        ExpectNear( IdentityQuaternion<Scalar>().xyzw(),
+                    ( s * Inverted( s ) ).xyzw(), tolerance );
+        ExpectNear( IdentityQuaternion<Scalar>().xyzw(),
+                    ( Inverted( s ) * s ).xyzw(), tolerance );
+
+        Quaternion<Scalar> c = q;
+        Conjugate( c );
+        EXPECT_EQ( Conjugated( q ), c );
+        Invert( s );
+        EXPECT_EQ( Inverted( q * Scalar{3} ), s );
+    }
+}
+
+TYPED_TEST(QuaternionTest, AxisAngle )
+{
+    typedef TypeParam Scalar;
+    const Scalar tolerance = 1e-5;
+
+    for( u32 i = 0; i < 100; ++i )
+    {
+        Vector<Scalar, 3> axis = Normalized( GetRandomVector<Scalar>() );
+        Scalar angle = GetRandomScalar<Scalar>( -Pi<Scalar>(), Pi<Scalar>() );
+        Quaternion<Scalar> q = QuaternionAxisAngle( axis, angle );
+
+        EXPECT_NEAR( Scalar{1}, Length( q ), tolerance );
+        ExpectNear( RotateAxisAngle( axis, angle ), ToMatrix( q ), tolerance );
+        ExpectNear( RotateAxisAngle( axis, angle ).
+                                        template GetSubMatrix<3, 3>(),
+                    ToMatrix<3>( q ), tolerance );
+    }
+
+    ExpectNear( RotateX<Scalar, 4>( 1 ),
+                ToMatrix( QuaternionAxisAngle( Vector<Scalar, 3>( 1, 0, 0 ),
+                                               Scalar{1} ) ),
+                tolerance );
+    ExpectNear( RotateZ<Scalar, 3>( 2 ),
+                ToMatrix<3>( QuaternionAxisAngle( Vector<Scalar, 3>( 0, 0, 1 ),
+                                                  Scalar{2} ) ),
+                tolerance );
+}
+
+TYPED_TEST(QuaternionTest, FromMatrix )
+{
+    typedef TypeParam Scalar;
+    const Scalar tolerance = 1e-5;
+
+    for( u32 i = 0; i < 100; ++i )
+    {
+        Quaternion<Scalar> q = GetRandomRotation<Scalar>();
+        ExpectSameRotation( q, ToQuaternion( ToMatrix<3>( q ) ), tolerance );
+        ExpectSameRotation( q, ToQuaternion( ToMatrix<4>( q ) ), tolerance );
+    }
+
+    //
+    // Each of the branches for the largest component
+    //
+    const Scalar half_pi = Pi<Scalar>() / 2;
+    for( const auto& q : { IdentityQuaternion<Scalar>(),
+                           QuaternionAxisAngle( Vector<Scalar, 3>( 1, 0, 0 ),
+                                                Pi<Scalar>() - half_pi / 8 ),
+                           QuaternionAxisAngle( Vector<Scalar, 3>( 0, 1, 0 ),
+                                                Pi<Scalar>() ),
+                           QuaternionAxisAngle( Vector<Scalar, 3>( 0, 0, 1 ),
+                                                Pi<Scalar>() ) } )
+        ExpectSameRotation( q, ToQuaternion( ToMatrix( q ) ), tolerance );
+}
+
+TYPED_TEST(QuaternionTest, Slerp )
+{
+    typedef TypeParam Scalar;
+    const Scalar tolerance = 1e-5;
+
+    Vector<Scalar, 3> axis = Normalized( Vector<Scalar, 3>( 1, 2, 3 ) );
+    Quaternion<Scalar> q0 = QuaternionAxisAngle( axis, Scalar{0.25} );
+    Quaternion<Scalar> q1 = QuaternionAxisAngle( axis, Scalar{2.25} );
+
+    EXPECT_EQ( q0, Slerp( q0, q1, 0 ) );
+    ExpectNear( q1.xyzw(), Slerp( q0, q1, 1 ).xyzw(), tolerance );
+    for( Scalar t : { Scalar{0.1}, Scalar{0.5}, Scalar{0.75} } )
+        ExpectNear( QuaternionAxisAngle( axis, Scalar{0.25} + 2 * t ).xyzw(),
+                    Slerp( q0, q1, t ).xyzw(), tolerance );
+
+    //
+    // The shortest path is taken
+    //
+    ExpectSameRotation( QuaternionAxisAngle( axis, Scalar{1.25} ),
+                        Slerp( q0, -q1, Scalar{0.5} ), tolerance );
+
+    //
+    // Identical quaternions
+    //
+    ExpectNear( q0.xyzw(), Slerp( q0, q0, Scalar{0.3} ).xyzw(), tolerance );
+
+    //
+    // Nlerp has the same end points and takes the same path
+    //
+    ExpectNear( q0.xyzw(), Nlerp( q0, q1, 0 ).xyzw(), tolerance );
+    ExpectNear( q1.xyzw(), Nlerp( q0, q1, 1 ).xyzw(), tolerance );
+    ExpectNear( Slerp( q0, q1, Scalar{0.5} ).xyzw(),
+                Nlerp( q0, q1, Scalar{0.5} ).xyzw(), tolerance );
+    ExpectSameRotation( Slerp( q0, q1, Scalar{0.5} ),
+                        Nlerp( q0, -q1, Scalar{0.5} ), tolerance );
+}
+
+TYPED_TEST(QuaternionTest, SlerpBatch )
+{
+    typedef TypeParam Scalar;
+    const u32 count = 37;
+
+    std::vector<Quaternion<Scalar>> q0( count );
+    std::vector<Quaternion<Scalar>> q1( count );
+    std::vector<Quaternion<Scalar>> out( count );
+    for( u32 i = 0; i < count; ++i )
+    {
+        q0[i] = GetRandomRotation<Scalar>();
+        q1[i] = GetRandomRotation<Scalar>();
+    }
+    q1[3] = q0[3];
+    q1[5] = -q0[5];
+
+    for( Scalar t : { Scalar{0}, Scalar{0.3}, Scalar{0.5}, Scalar{1} } )
+    {
+        Slerp( q0.data(), q1.data(), t, out.data(), count );
+        for( u32 i = 0; i < count; ++i )
+        {
+            ExpectNear( Slerp( q0[i], q1[i], t ).xyzw(), out[i].xyzw(),
+                        Scalar{2e-6} );
+
+            //
+            // Every element gives the same result wherever it is in the array
+            //
+            Quaternion<Scalar> single;
+            Slerp( &q0[i], &q1[i], t, &single, 1 );
+            EXPECT_EQ( single, out[i] );
+        }
+    }
+
+    //
+    // In place
+    //
+    std::vector<Quaternion<Scalar>> in_place( q0 );
+    Slerp( in_place.data(), q1.data(), Scalar{0.3}, in_place.data(), count );
+    Slerp( q0.data(), q1.data(), Scalar{0.3}, out.data(), count );
+    EXPECT_EQ( out, in_place );
+}
@@ -0,0 +1,143 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#include "compare.hpp"
+
+#include <iomanip>
+
+using JoeMath::u32;
+using JoeMath::u64;
+
+Tolerance Max( const Tolerance& a, const Tolerance& b )
+{
+    return Tolerance( std::max( a.m_MaxUlps, b.m_MaxUlps ),
+                      std::max( a.m_MaxRelativeError, b.m_MaxRelativeError ) );
+}
+
+bool Comparison::Passes( const Tolerance& tolerance ) const
+{
+    return m_Parsed && ( m_Ulps <= tolerance.m_MaxUlps ||
+                         m_RelativeError <= tolerance.m_MaxRelativeError );
+}
+
+void ErrorReport::Add( const std::string& test_name,
+                       const Comparison& comparison,
+                       bool passed )
+{
+    TestErrors& e = m_Tests[test_name];
+    ++e.m_Datums;
+    if( !passed )
+        ++e.m_Failures;
+    e.m_MaxUlps          = std::max( e.m_MaxUlps, comparison.m_Ulps );
+    e.m_MaxRelativeError = std::max( e.m_MaxRelativeError,
+                                     comparison.m_RelativeError );
+    ++e.m_Histogram[GetBucket( comparison.m_Ulps )];
+}
+
+u32 ErrorReport::GetBucket( u64 ulps )
+{
+    u32 bucket = 0;
+    while( ulps != 0 && bucket < bucket_count - 1 )
+    {
+        ulps >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+std::string ErrorReport::GetBucketName( u32 bucket )
+{
+    std::stringstream ss;
+    if( bucket == 0 )
+        ss << "0";
+    else if( bucket == 1 )
+        ss << "1";
+    else if( bucket == bucket_count - 1 )
+        ss << ">=" << ( u64{1} << ( bucket - 1 ) );
+    else
+        ss << ( u64{1} << ( bucket - 1 ) ) << "-" <<
+              ( u64{1} << bucket ) - 1;
+    return ss.str();
+}
+
+void ErrorReport::Print( std::ostream& out ) const
+{
+    const int name_width = 32;
+
+    out << "\nNumeric comparison\n\n";
+    out << std::left << std::setw( name_width ) << "test" << std::right <<
+           std::setw( 10 ) << "datums" <<
+           std::setw( 10 ) << "failures" <<
+           std::setw( 12 ) << "max ulps" <<
+           std::setw( 16 ) << "max rel error" << "\n";
+
+    Histogram total = Histogram{};
+    u64       total_datums = 0;
+
+    for( const auto& p : m_Tests )
+    {
+        const TestErrors& e = p.second;
+        out << std::left << std::setw( name_width ) << p.first << std::right <<
+               std::setw( 10 ) << e.m_Datums <<
+               std::setw( 10 ) << e.m_Failures <<
+               std::setw( 12 ) << e.m_MaxUlps <<
+               std::setw( 16 ) << std::setprecision( 3 ) <<
+                                  std::scientific << e.m_MaxRelativeError <<
+               "\n";
+
+        //
+        // Only the inexact tests have their distribution listed
+        //
+        if( e.m_MaxUlps != 0 )
+        {
+            out << "    ulps";
+            for( u32 b = 0; b < bucket_count; ++b )
+                if( e.m_Histogram[b] != 0 )
+                    out << "  " << GetBucketName( b ) << ":" << e.m_Histogram[b];
+            out << "\n";
+        }
+
+        for( u32 b = 0; b < bucket_count; ++b )
+            total[b] += e.m_Histogram[b];
+        total_datums += e.m_Datums;
+    }
+
+    out << "\nULP error distribution over " << total_datums << " datums\n\n";
+
+    const u32 bar_width = 50;
+    const u64 largest   = *std::max_element( total.begin(), total.end() );
+    for( u32 b = 0; b < bucket_count; ++b )
+    {
+        const u32 bar = largest == 0 ? 0 :
+                        u32( ( total[b] * bar_width + largest - 1 ) / largest );
+        out << std::setw( 12 ) << GetBucketName( b ) << " | " <<
+               std::string( bar, '#' ) << std::string( bar_width - bar, ' ' ) <<
+               " " << total[b] << "\n";
+    }
+    out << std::endl;
+}
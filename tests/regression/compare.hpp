@@ -0,0 +1,266 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <joemath/joemath.hpp>
+
+#include "data_file.hpp"
+
+//
+// Numeric comparison of regression results
+//
+// By default results are compared as the strings they're formatted to, so
+// the smallest change in a result is a failure. In numeric mode both the
+// expected and the new result are parsed back into scalars and each element
+// is compared by the distance in ULPs between them and by their relative
+// error. A datum passes if the largest of either is within the test's
+// Tolerance.
+//
+// Both values are parsed from the same fixed point format, so the
+// resolution of the stored data limits how small an error can be seen. An
+// identical result is always zero ULPs away.
+//
+
+/**
+  * An error budget, a result passes if it's within either bound
+  */
+struct Tolerance
+{
+    Tolerance( JoeMath::u64 max_ulps = 0, double max_relative_error = 0 )
+        :m_MaxUlps( max_ulps )
+        ,m_MaxRelativeError( max_relative_error )
+    {}
+
+    JoeMath::u64    m_MaxUlps;
+    double          m_MaxRelativeError;
+};
+
+/**
+  * The element-wise maximum of two budgets
+  */
+Tolerance   Max     ( const Tolerance& a, const Tolerance& b );
+
+/**
+  * The largest error over the elements of one result
+  */
+struct Comparison
+{
+    //
+    // False if either result couldn't be parsed or they have different
+    // numbers of elements, in which case the errors are as large as they go
+    //
+    bool            m_Parsed        = true;
+    JoeMath::u64    m_Ulps          = 0;
+    double          m_RelativeError = 0;
+
+    bool    Passes  ( const Tolerance& tolerance ) const;
+};
+
+namespace detail
+{
+    //
+    // Maps the bits of a float to an integer with the same order, with both
+    // zeros at 0
+    //
+    template <typename Float, typename Int>
+    JoeMath::s64 OrderedBits( Float f )
+    {
+        static_assert( sizeof(Float) == sizeof(Int), "Size mismatch" );
+        Int i;
+        std::memcpy( &i, &f, sizeof(i) );
+        return i >= 0 ? JoeMath::s64( i ) :
+                        -JoeMath::s64( i & std::numeric_limits<Int>::max() );
+    }
+
+    inline JoeMath::s64 OrderedBits( float f )
+    {
+        return OrderedBits<float, JoeMath::s32>( f );
+    }
+
+    inline JoeMath::s64 OrderedBits( double f )
+    {
+        return OrderedBits<double, JoeMath::s64>( f );
+    }
+
+    template <typename Scalar>
+    void CompareElement( Scalar expected,
+                         Scalar actual,
+                         Comparison& c,
+                         std::true_type /* is_floating_point */ )
+    {
+        JoeMath::u64 ulps;
+        double       relative_error;
+        if( std::isnan( expected ) || std::isnan( actual ) )
+        {
+            const bool same = std::isnan( expected ) && std::isnan( actual );
+            ulps           = same ? 0 : std::numeric_limits<JoeMath::u64>::max();
+            relative_error = same ? 0 : std::numeric_limits<double>::infinity();
+        }
+        else
+        {
+            const JoeMath::s64 a = OrderedBits( expected );
+            const JoeMath::s64 b = OrderedBits( actual );
+            ulps = a < b ? JoeMath::u64( b ) - JoeMath::u64( a ) :
+                           JoeMath::u64( a ) - JoeMath::u64( b );
+            relative_error = ulps == 0 ? 0 :
+                             std::abs( double( actual ) - double( expected ) ) /
+                             std::abs( double( expected ) );
+        }
+        c.m_Ulps          = std::max( c.m_Ulps, ulps );
+        c.m_RelativeError = std::max( c.m_RelativeError, relative_error );
+    }
+
+    //
+    // For integers the distance is just the difference
+    //
+    template <typename Scalar>
+    void CompareElement( Scalar expected,
+                         Scalar actual,
+                         Comparison& c,
+                         std::false_type /* is_floating_point */ )
+    {
+        const JoeMath::u64 ulps = expected < actual ?
+                                  JoeMath::u64( actual - expected ) :
+                                  JoeMath::u64( expected - actual );
+        const double relative_error =
+                              ulps == 0 ? 0 :
+                              double( ulps ) / std::abs( double( expected ) );
+        c.m_Ulps          = std::max( c.m_Ulps, ulps );
+        c.m_RelativeError = std::max( c.m_RelativeError, relative_error );
+    }
+
+    template <typename R, bool = JoeMath::is_matrix<R>::value>
+    struct result_scalar
+    {
+        typedef R type;
+    };
+
+    template <typename R>
+    struct result_scalar<R, true>
+    {
+        typedef typename R::scalar_type type;
+    };
+
+    template <typename Scalar>
+    bool ParseElements( std::istream& in, std::vector<Scalar>& elements )
+    {
+        Scalar e;
+        while( in >> e )
+            elements.push_back( e );
+        return in.eof();
+    }
+}
+
+/**
+  * Parses both results as a sequence of the scalars R is made of and compares
+  * them element by element
+  */
+template <typename R>
+Comparison CompareResults( const TestString& expected,
+                           const std::string& actual )
+{
+    typedef typename std::remove_cv<
+            typename std::remove_reference<R>::type>::type Result;
+    typedef typename detail::result_scalar<Result>::type Scalar;
+
+    std::vector<Scalar> expected_elements;
+    std::vector<Scalar> actual_elements;
+
+    TestStringBuf      buf( expected );
+    std::istream       expected_in( &buf );
+    std::istringstream actual_in( actual );
+
+    Comparison c;
+    if( !detail::ParseElements( expected_in, expected_elements ) ||
+        !detail::ParseElements( actual_in, actual_elements ) ||
+        expected_elements.size() != actual_elements.size() )
+    {
+        c.m_Parsed        = false;
+        c.m_Ulps          = std::numeric_limits<JoeMath::u64>::max();
+        c.m_RelativeError = std::numeric_limits<double>::infinity();
+        return c;
+    }
+
+    for( std::size_t i = 0; i < expected_elements.size(); ++i )
+        detail::CompareElement( expected_elements[i],
+                                actual_elements[i],
+                                c,
+                                std::is_floating_point<Scalar>() );
+    return c;
+}
+
+/**
+  * Collects the comparisons of every test for a summary with a histogram of
+  * the ULP errors
+  */
+class ErrorReport
+{
+public:
+    void        Add     ( const std::string& test_name,
+                          const Comparison& comparison,
+                          bool passed );
+
+    void        Print   ( std::ostream& out ) const;
+
+private:
+    //
+    // Bucket 0 is exact results, bucket b covers [2^(b-1), 2^b) ULPs and the
+    // last one everything larger
+    //
+    static const JoeMath::u32 bucket_count = 13;
+
+    typedef std::array<JoeMath::u64, bucket_count> Histogram;
+
+    static JoeMath::u32 GetBucket       ( JoeMath::u64 ulps );
+    static std::string  GetBucketName   ( JoeMath::u32 bucket );
+
+    struct TestErrors
+    {
+        JoeMath::u64    m_Datums            = 0;
+        JoeMath::u64    m_Failures          = 0;
+        JoeMath::u64    m_MaxUlps           = 0;
+        double          m_MaxRelativeError  = 0;
+        Histogram       m_Histogram         = Histogram{};
+    };
+
+    std::map<std::string, TestErrors> m_Tests;
+};
@@ -0,0 +1,490 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#include "data_file.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+
+#if defined( _WIN32 )
+#   define JOEMATH_NO_MMAP
+#else
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
+using JoeMath::u32;
+
+////////////////////////////////////////////////////////////////////////////////
+// TestString
+////////////////////////////////////////////////////////////////////////////////
+
+bool TestString::empty( ) const
+{
+    return m_Size == 0;
+}
+
+std::string TestString::str( ) const
+{
+    return std::string( m_Data, m_Size );
+}
+
+bool operator == ( const TestString& a, const std::string& b )
+{
+    return a.m_Size == b.size() &&
+           std::equal( a.m_Data, a.m_Data + a.m_Size, b.begin() );
+}
+
+bool operator == ( const std::string& a, const TestString& b )
+{
+    return b == a;
+}
+
+std::ostream& operator << ( std::ostream& out, const TestString& s )
+{
+    return out.write( s.m_Data, s.m_Size );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// MappedFile
+////////////////////////////////////////////////////////////////////////////////
+
+MappedFile::~MappedFile( )
+{
+#if !defined( JOEMATH_NO_MMAP )
+    if( m_Mapped )
+        munmap( const_cast<char*>( m_Data ), m_Size );
+#endif
+}
+
+bool MappedFile::Open( const std::string& filename )
+{
+#if !defined( JOEMATH_NO_MMAP )
+    const int fd = open( filename.c_str(), O_RDONLY );
+    if( fd < 0 )
+        return false;
+
+    struct stat s;
+    if( fstat( fd, &s ) != 0 )
+    {
+        close( fd );
+        return false;
+    }
+
+    //
+    // Empty files can't be mapped but there's nothing to read anyway
+    //
+    m_Size = s.st_size;
+    if( m_Size != 0 )
+    {
+        void* p = mmap( nullptr, m_Size, PROT_READ, MAP_PRIVATE, fd, 0 );
+        if( p == MAP_FAILED )
+        {
+            close( fd );
+            m_Size = 0;
+            return false;
+        }
+        m_Data   = static_cast<const char*>( p );
+        m_Mapped = true;
+    }
+    close( fd );
+    return true;
+#else
+    std::ifstream in( filename, std::ios::binary );
+    if( !in )
+        return false;
+    m_Buffer.assign( std::istreambuf_iterator<char>( in ),
+                     std::istreambuf_iterator<char>() );
+    m_Data = m_Buffer.data();
+    m_Size = m_Buffer.size();
+    return true;
+#endif
+}
+
+const char* MappedFile::GetData( ) const
+{
+    return m_Data;
+}
+
+std::size_t MappedFile::GetSize( ) const
+{
+    return m_Size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// TestDataFile
+////////////////////////////////////////////////////////////////////////////////
+
+const char BinaryHeader::magic[4] = { 'J', 'M', 'R', 'D' };
+const u32  BinaryHeader::version;
+const u32  BinaryHeader::byte_order_mark;
+
+bool TestDataFile::Read( const std::string& filename )
+{
+    m_Tests.clear();
+    m_File.reset( new MappedFile );
+    if( !m_File->Open( filename ) )
+        return false;
+
+    const bool binary = m_File->GetSize() >= sizeof(BinaryHeader::magic) &&
+                        std::equal( BinaryHeader::magic,
+                                    BinaryHeader::magic +
+                                        sizeof(BinaryHeader::magic),
+                                    m_File->GetData() );
+    if( binary ? ReadBinary() : ReadText() )
+        return true;
+
+    m_Tests.clear();
+    return false;
+}
+
+namespace
+{
+    //
+    // Tokenizing the text format straight from the mapped file
+    //
+    class TextReader
+    {
+    public:
+        TextReader( const char* begin, const char* end )
+            :m_Position( begin )
+            ,m_End( end )
+        {
+        }
+
+        //
+        // Returns a whole word, or the contents of a block with its
+        // whitespace reduced to single spaces, or false when there are no
+        // tokens left
+        //
+        bool GetToken( std::string& token )
+        {
+            token.clear();
+            SkipSpace();
+            if( m_Position == m_End )
+                return false;
+
+            if( *m_Position != '{' )
+            {
+                const char* begin = m_Position;
+                while( m_Position != m_End && !IsSpace( *m_Position ) )
+                    ++m_Position;
+                token.assign( begin, m_Position );
+                return true;
+            }
+
+            ++m_Position;
+            const char* end = std::find( m_Position, m_End, '}' );
+            while( true )
+            {
+                while( m_Position != end && IsSpace( *m_Position ) )
+                    ++m_Position;
+                if( m_Position == end )
+                    break;
+                if( !token.empty() )
+                    token += ' ';
+                const char* word = m_Position;
+                while( m_Position != end && !IsSpace( *m_Position ) )
+                    ++m_Position;
+                token.append( word, m_Position );
+            }
+            m_Position = end == m_End ? end : end + 1;
+            return true;
+        }
+
+    private:
+        static bool IsSpace( char c )
+        {
+            return std::isspace( static_cast<unsigned char>( c ) );
+        }
+
+        void SkipSpace( )
+        {
+            while( m_Position != m_End && IsSpace( *m_Position ) )
+                ++m_Position;
+        }
+
+        const char* m_Position;
+        const char* m_End;
+    };
+}
+
+bool TestDataFile::ReadText( )
+{
+    TextReader reader( m_File->GetData(),
+                       m_File->GetData() + m_File->GetSize() );
+    std::string test_name;
+    std::string test_number;
+    std::string input;
+    std::string output;
+
+    //
+    // A datum's index is implied by its position, so the number is skipped
+    //
+    while( reader.GetToken( test_name ) )
+    {
+        reader.GetToken( test_number );
+        reader.GetToken( input );
+        reader.GetToken( output );
+
+        TestDatum d;
+        d.m_Input  = Intern( input );
+        d.m_Output = Intern( output );
+        m_Tests[test_name].m_Datums.push_back( d );
+    }
+    return true;
+}
+
+bool TestDataFile::ReadBinary( )
+{
+    const char*       data = m_File->GetData();
+    const std::size_t size = m_File->GetSize();
+
+    if( size < sizeof(BinaryHeader) )
+        return false;
+    BinaryHeader header;
+    std::memcpy( &header, data, sizeof(header) );
+    if( header.m_Version != BinaryHeader::version ||
+        header.m_ByteOrder != BinaryHeader::byte_order_mark )
+        return false;
+
+    const std::size_t tests_offset   = sizeof(BinaryHeader);
+    const std::size_t datums_offset  = tests_offset +
+                              std::size_t( header.m_TestCount ) *
+                              sizeof(BinaryTest);
+    const std::size_t strings_offset = datums_offset +
+                              std::size_t( header.m_DatumCount ) *
+                              sizeof(BinaryDatum);
+    if( strings_offset + header.m_StringsSize != size )
+        return false;
+
+    //
+    // The tables are at multiples of four bytes from the start of the
+    // mapping, which is page aligned, so they can be read in place
+    //
+    const BinaryTest*  tests  = reinterpret_cast<const BinaryTest*>(
+                                                       data + tests_offset );
+    const BinaryDatum* datums = reinterpret_cast<const BinaryDatum*>(
+                                                       data + datums_offset );
+    const char*        strings = data + strings_offset;
+
+    const auto in_strings = [&]( u32 offset, u32 length )
+    {
+        return offset <= header.m_StringsSize &&
+               length <= header.m_StringsSize - offset;
+    };
+
+    for( u32 t = 0; t < header.m_TestCount; ++t )
+    {
+        const BinaryTest& test = tests[t];
+        if( !in_strings( test.m_NameOffset, test.m_NameSize ) ||
+            test.m_FirstDatum > header.m_DatumCount ||
+            test.m_DatumCount > header.m_DatumCount - test.m_FirstDatum )
+            return false;
+
+        //
+        // The tests are sorted, so each one goes at the end of the map
+        //
+        TestData& test_data = m_Tests.emplace_hint(
+               m_Tests.end(),
+               std::string( strings + test.m_NameOffset, test.m_NameSize ),
+               TestData() )->second;
+        test_data.m_Datums.resize( test.m_DatumCount );
+
+        for( u32 i = 0; i < test.m_DatumCount; ++i )
+        {
+            const BinaryDatum& datum = datums[test.m_FirstDatum + i];
+            if( !in_strings( datum.m_InputOffset, datum.m_InputSize ) ||
+                !in_strings( datum.m_OutputOffset, datum.m_OutputSize ) )
+                return false;
+
+            TestDatum& d = test_data.m_Datums[i];
+            d.m_Input.m_Data  = strings + datum.m_InputOffset;
+            d.m_Input.m_Size  = datum.m_InputSize;
+            d.m_Output.m_Data = strings + datum.m_OutputOffset;
+            d.m_Output.m_Size = datum.m_OutputSize;
+        }
+    }
+    return true;
+}
+
+bool TestDataFile::Write( const std::string& filename ) const
+{
+    return IsBinaryFilename( filename ) ? WriteBinary( filename ) :
+                                          WriteText( filename );
+}
+
+namespace
+{
+    //
+    // Indents every line of s with a tab
+    //
+    std::string Pad( const TestString& s )
+    {
+        std::string ret;
+        if( !s.empty() )
+            ret += '\t';
+
+        for( u32 i = 0; i < s.m_Size; ++i )
+        {
+            ret += s.m_Data[i];
+            if( s.m_Data[i] == '\n' )
+                ret += '\t';
+        }
+        return ret;
+    }
+}
+
+bool TestDataFile::WriteText( const std::string& filename ) const
+{
+    std::ofstream out( filename );
+
+    for( const auto& p : m_Tests )
+    {
+        const TestData& d = p.second;
+        int i = 0;
+        for( const TestDatum& a : d.m_Datums )
+        {
+            out << p.first << "\n";
+            out << i++ << "\n";
+            out << "{" << Pad(a.m_Input) << "}\n";
+            out << "{" << Pad(a.m_Output) << "}\n";
+        }
+        out << "\n";
+    }
+    return out.good();
+}
+
+bool TestDataFile::WriteBinary( const std::string& filename ) const
+{
+    std::vector<BinaryTest>  tests;
+    std::vector<BinaryDatum> datums;
+    std::string              strings;
+
+    const auto add_string = [&]( const char* s, std::size_t length )
+    {
+        const u32 offset = strings.size();
+        strings.append( s, length );
+        return offset;
+    };
+
+    for( const auto& p : m_Tests )
+    {
+        BinaryTest test;
+        test.m_NameSize   = p.first.size();
+        test.m_NameOffset = add_string( p.first.data(), p.first.size() );
+        test.m_FirstDatum = datums.size();
+        test.m_DatumCount = p.second.m_Datums.size();
+        tests.push_back( test );
+
+        for( const TestDatum& d : p.second.m_Datums )
+        {
+            BinaryDatum datum;
+            datum.m_InputSize    = d.m_Input.m_Size;
+            datum.m_InputOffset  = add_string( d.m_Input.m_Data,
+                                               d.m_Input.m_Size );
+            datum.m_OutputSize   = d.m_Output.m_Size;
+            datum.m_OutputOffset = add_string( d.m_Output.m_Data,
+                                               d.m_Output.m_Size );
+            datums.push_back( datum );
+        }
+    }
+
+    if( strings.size() > std::numeric_limits<u32>::max() )
+        return false;
+
+    BinaryHeader header;
+    std::copy( BinaryHeader::magic,
+               BinaryHeader::magic + sizeof(BinaryHeader::magic),
+               header.m_Magic );
+    header.m_Version     = BinaryHeader::version;
+    header.m_ByteOrder   = BinaryHeader::byte_order_mark;
+    header.m_TestCount   = tests.size();
+    header.m_DatumCount  = datums.size();
+    header.m_StringsSize = strings.size();
+
+    std::ofstream out( filename, std::ios::binary );
+    out.write( reinterpret_cast<const char*>( &header ), sizeof(header) );
+    out.write( reinterpret_cast<const char*>( tests.data() ),
+               tests.size() * sizeof(BinaryTest) );
+    out.write( reinterpret_cast<const char*>( datums.data() ),
+               datums.size() * sizeof(BinaryDatum) );
+    out.write( strings.data(), strings.size() );
+    return out.good();
+}
+
+const TestData& TestDataFile::GetTestData(
+                                          const std::string& test_name ) const
+{
+    static const TestData empty;
+    const auto i = m_Tests.find( test_name );
+    return i == m_Tests.end() ? empty : i->second;
+}
+
+void TestDataFile::SetTestData( const std::string& test_name,
+                                TestData test_data )
+{
+    m_Tests[test_name] = std::move( test_data );
+}
+
+void TestDataFile::SetOutputs( const std::string& test_name,
+                               const std::vector<std::string>& outputs )
+{
+    TestData& test_data = m_Tests[test_name];
+    test_data.m_Datums.resize( outputs.size() );
+    for( u32 i = 0; i < outputs.size(); ++i )
+        test_data.m_Datums[i].m_Output = Intern( outputs[i] );
+}
+
+const std::map<std::string, TestData>& TestDataFile::GetTests( ) const
+{
+    return m_Tests;
+}
+
+TestString TestDataFile::Intern( std::string s )
+{
+    m_Pool.push_back( std::move( s ) );
+    TestString ret;
+    ret.m_Data = m_Pool.back().data();
+    ret.m_Size = m_Pool.back().size();
+    return ret;
+}
+
+bool TestDataFile::IsBinaryFilename( const std::string& filename )
+{
+    const std::string extension = ".bin";
+    return filename.size() >= extension.size() &&
+           std::equal( extension.rbegin(), extension.rend(),
+                       filename.rbegin() );
+}
@@ -0,0 +1,219 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include <joemath/types.hpp>
+
+//
+// Regression test data files
+//
+// The text format is a sequence of datums, each of which is the test's name,
+// the datum's index, the input in braces and the output in braces. The
+// whitespace in the inputs and outputs is reduced to single spaces when
+// they're read.
+//
+// The binary format holds the same strings, after the whitespace has been
+// reduced. It has a BinaryHeader, then a BinaryTest for each test sorted by
+// name, then a BinaryDatum for each datum with the datums of each test
+// together, and then the strings which they point into. Binary files are
+// mapped into memory and the strings are used from there without being
+// copied or parsed, so loading one takes the same time however many datums
+// it holds.
+//
+
+/**
+  * A string owned by a TestDataFile, either in its mapped file or in its pool
+  */
+struct TestString
+{
+    const char*     m_Data = nullptr;
+    JoeMath::u32    m_Size = 0;
+
+    bool            empty   ( ) const;
+    std::string     str     ( ) const;
+};
+
+bool            operator == ( const TestString& a, const std::string& b );
+bool            operator == ( const std::string& a, const TestString& b );
+std::ostream&   operator << ( std::ostream& out, const TestString& s );
+
+/**
+  * Reads a TestString in place
+  */
+class TestStringBuf : public std::streambuf
+{
+public:
+    explicit TestStringBuf( const TestString& s )
+    {
+        char* begin = const_cast<char*>( s.m_Data );
+        setg( begin, begin, begin + s.m_Size );
+    }
+};
+
+struct TestDatum
+{
+    TestString m_Input;
+    TestString m_Output;
+};
+
+struct TestData
+{
+    std::vector<TestDatum> m_Datums;
+};
+
+//
+// The layout of the binary format, every field is a u32 in the byte order of
+// the machine that wrote it
+//
+
+struct BinaryHeader
+{
+    char            m_Magic[4];
+    JoeMath::u32    m_Version;
+    //
+    // byte_order_mark as written by the machine which made the file, files
+    // of the other byte order are rejected
+    //
+    JoeMath::u32    m_ByteOrder;
+    JoeMath::u32    m_TestCount;
+    JoeMath::u32    m_DatumCount;
+    JoeMath::u32    m_StringsSize;
+
+    static const char           magic[4];
+    static const JoeMath::u32   version         = 1;
+    static const JoeMath::u32   byte_order_mark = 0x01020304;
+};
+
+struct BinaryTest
+{
+    JoeMath::u32    m_NameOffset;
+    JoeMath::u32    m_NameSize;
+    JoeMath::u32    m_FirstDatum;
+    JoeMath::u32    m_DatumCount;
+};
+
+struct BinaryDatum
+{
+    JoeMath::u32    m_InputOffset;
+    JoeMath::u32    m_InputSize;
+    JoeMath::u32    m_OutputOffset;
+    JoeMath::u32    m_OutputSize;
+};
+
+/**
+  * A read only view of a whole file, mapped into memory where that's
+  * supported and read into a buffer otherwise
+  */
+class MappedFile
+{
+public:
+    MappedFile              ( ) = default;
+    ~MappedFile             ( );
+
+    MappedFile              ( const MappedFile& ) = delete;
+    MappedFile& operator =  ( const MappedFile& ) = delete;
+
+    bool            Open    ( const std::string& filename );
+
+    const char*     GetData ( ) const;
+    std::size_t     GetSize ( ) const;
+
+private:
+    const char*         m_Data = nullptr;
+    std::size_t         m_Size = 0;
+    bool                m_Mapped = false;
+    std::vector<char>   m_Buffer;
+};
+
+/**
+  * The data of every test, read from and written to either format
+  */
+class TestDataFile
+{
+public:
+    /**
+      * Reads either format, telling them apart by the magic number. Returns
+      * false and leaves the data empty if the file can't be read or is
+      * malformed.
+      */
+    bool            Read            ( const std::string& filename );
+
+    /**
+      * Writes the binary format if the filename ends in .bin and the text
+      * format otherwise
+      */
+    bool            Write           ( const std::string& filename ) const;
+
+    bool            WriteText       ( const std::string& filename ) const;
+    bool            WriteBinary     ( const std::string& filename ) const;
+
+    /**
+      * The data of the named test, or no data if it isn't there. This and the
+      * other const members are safe to call from several threads at once.
+      */
+    const TestData& GetTestData     ( const std::string& test_name ) const;
+
+    void            SetTestData     ( const std::string& test_name,
+                                      TestData test_data );
+
+    /**
+      * Replaces the outputs of the named test's datums, in order
+      */
+    void            SetOutputs      ( const std::string& test_name,
+                                      const std::vector<std::string>& outputs );
+
+    const std::map<std::string, TestData>& GetTests ( ) const;
+
+    /**
+      * Keeps a copy of s for as long as this file exists
+      */
+    TestString      Intern          ( std::string s );
+
+    static bool     IsBinaryFilename( const std::string& filename );
+
+private:
+    bool            ReadText        ( );
+    bool            ReadBinary      ( );
+
+    std::map<std::string, TestData> m_Tests;
+    std::unique_ptr<MappedFile>     m_File;
+    //
+    // A deque so that adding strings doesn't move the ones already there
+    //
+    std::deque<std::string>         m_Pool;
+};
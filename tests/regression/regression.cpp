@@ -27,10 +27,9 @@
     policies, either expressed or implied, of Joe Hermaszewski.
 */
 
-#include <cctype>
-#include <fstream>
 #include <iostream>
-#include <map>
+#include <memory>
+#include <string>
 
 #include <gtest/gtest.h>
 
@@ -38,24 +37,33 @@
 
 void PrintUsage()
 {
-    std::cout << "Usage: ./regression_tester [-w -i] datafile" << std::endl;
+    std::cout << "Usage: ./regression_tester [-w -i -n count -j threads -c -u ulps -e error] datafile" << std::endl;
     std::cout << "-w updates the results in the datafile" << std::endl;
     std::cout << "-i generates new input data (pointless to use without -w)" << std::endl;
+    std::cout << "-n sets the number of datums generated for each test with -i, the default is 10" << std::endl;
+    std::cout << "-j sets the number of worker threads, the default is one for each hardware thread but the main one" << std::endl;
+    std::cout << "-c compares results numerically rather than as strings and prints a report of the errors" << std::endl;
+    std::cout << "-u sets the number of ulps every result may be out by with -c, the default is 0" << std::endl;
+    std::cout << "-e sets the relative error every result may have with -c, the default is 0" << std::endl;
+    std::cout << "datafile may be text or binary, files ending in .bin are written as binary" << std::endl;
 }
 
 
-std::map<std::string, TestData> g_TestDataMap;
-bool                            g_UpdateResults     = false;
-bool                            g_GenerateInputData = false;
-
-void ReadTestData( const std::string& filename );
-void WriteTestData( const std::string& filename );
+TestDataFile                         g_TestDataFile;
+bool                                 g_UpdateResults     = false;
+bool                                 g_GenerateInputData = false;
+u32                                  g_GenerateCount     = 10;
+std::unique_ptr<JoeMath::ThreadPool> g_ThreadPool;
+bool                                 g_NumericCompare    = false;
+Tolerance                            g_DefaultTolerance;
+ErrorReport                          g_ErrorReport;
 
 int main(int argc, char **argv)
 {
     testing::InitGoogleTest(&argc, argv);
 
     std::string filename;
+    u32         thread_count = JoeMath::ThreadPool::DefaultThreadCount();
 
     for( int i = 1; i < argc; ++i )
     {
@@ -63,147 +71,56 @@ int main(int argc, char **argv)
             g_UpdateResults = true;
         else if( std::string( "-i" ) == argv[i] )
             g_GenerateInputData = true;
+        else if( std::string( "-n" ) == argv[i] && i + 1 < argc )
+            g_GenerateCount = std::stoul( argv[++i] );
+        else if( std::string( "-j" ) == argv[i] && i + 1 < argc )
+            thread_count = std::stoul( argv[++i] );
+        else if( std::string( "-c" ) == argv[i] )
+            g_NumericCompare = true;
+        else if( std::string( "-u" ) == argv[i] && i + 1 < argc )
+            g_DefaultTolerance.m_MaxUlps = std::stoull( argv[++i] );
+        else if( std::string( "-e" ) == argv[i] && i + 1 < argc )
+            g_DefaultTolerance.m_MaxRelativeError = std::stod( argv[++i] );
+        else if( std::string( "-h" ) == argv[i] )
+        {
+            PrintUsage();
+            return 0;
+        }
         else
             filename = argv[i];
     }
 
-    if( !g_GenerateInputData )
-        ReadTestData( filename );
-
-    auto ret = RUN_ALL_TESTS();
-
-    if( g_UpdateResults )
-        WriteTestData( filename );
-
-    return ret;
-}
-
-TestData& GetCurrentTestData()
-{
-    const ::testing::TestInfo* const test_info =
-        ::testing::UnitTest::GetInstance()->current_test_info();
-
-    std::string test_name = std::string( test_info->test_case_name() ) + "." +
-                            std::string( test_info->name() );
-
-    return g_TestDataMap[test_name];
-}
-
-std::string ReduceWhitespace( const std::string& s )
-{
-    std::stringstream ss(s);
-    std::string ret;
-    while( ss.good() )
-    {
-        std::string a;
-        ss >> a;
-        ret += a;
-        if( ss.good() )
-            ret += " ";
-    }
-    return ret;
-}
-
-//
-// This will return either whole words or block values or the empty string when
-// we are out of tokens
-//
-std::string GetToken( std::ifstream& in )
-{
-    //
-    // First read all the leading whitespace
-    //
-    char c = ' ';
-    while( in.good() && std::isspace(c) )
-        c = in.get();
-
-    if( !in.good() )
-        return "";
-
-    std::string ret;
+    g_ThreadPool.reset( new JoeMath::ThreadPool( thread_count ) );
 
     //
-    // If we have a block read until the next } and replace all whitespace with
-    // single spaces
+    // Listing the tests doesn't need a datafile
     //
-    if( c == '{' )
+    if( !g_GenerateInputData && !filename.empty() &&
+        !g_TestDataFile.Read( filename ) )
     {
-        c = in.get();
-        while( in.good() && c != '}' )
-        {
-            ret += c;
-            c = in.get();
-        }
-        ret = ReduceWhitespace( ret );
-    }
-    else
-    {
-        ret += c;
-        c = in.get();
-        while( in.good() && !std::isspace(c) )
-        {
-            ret += c;
-            c = in.get();
-        }
+        std::cerr << "Couldn't read " << filename << std::endl;
+        return 1;
     }
 
-    return ret;
-}
+    auto ret = RUN_ALL_TESTS();
 
-void ReadTestData( const std::string& filename )
-{
-    std::ifstream in( filename );
+    if( g_NumericCompare && !g_UpdateResults )
+        g_ErrorReport.Print( std::cout );
 
-    while( true )
+    if( g_UpdateResults && !g_TestDataFile.Write( filename ) )
     {
-        std::string test_name;
-        std::string test_number;
-        std::string input;
-        std::string output;
-
-        test_name = GetToken( in );
-        if( test_name == "" )
-            return;
-
-        test_number = GetToken( in );
-        input = GetToken( in );
-        output = GetToken( in );
-
-        g_TestDataMap[test_name].m_Datums.emplace_back( TestDatum(input,
-                                                                  output) );
+        std::cerr << "Couldn't write " << filename << std::endl;
+        return 1;
     }
-}
 
-std::string Pad( const std::string& s )
-{
-    std::string ret;
-    if( !s.empty() )
-        ret += '\t';
-
-    for( char c : s )
-    {
-        ret += c;
-        if( c == '\n' )
-            ret += '\t';
-    }
     return ret;
 }
 
-void WriteTestData( const std::string& filename )
+std::string GetCurrentTestName()
 {
-    std::ofstream out( filename );
+    const ::testing::TestInfo* const test_info =
+        ::testing::UnitTest::GetInstance()->current_test_info();
 
-    for( const auto& p : g_TestDataMap )
-    {
-        const TestData& d = p.second;
-        int i = 0;
-        for( const TestDatum& a : d.m_Datums )
-        {
-            out << p.first << "\n";
-            out << i++ << "\n";
-            out << "{" << Pad(a.m_Input) << "}\n";
-            out << "{" << Pad(a.m_Output) << "}\n";
-        }
-        out << "\n";
-    }
+    return std::string( test_info->test_case_name() ) + "." +
+           std::string( test_info->name() );
 }
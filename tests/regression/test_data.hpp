@@ -31,6 +31,7 @@
 #include <cctype>
 #include <functional>
 #include <map>
+#include <memory>
 #include <random>
 #include <sstream>
 #include <string>
@@ -38,34 +39,24 @@
 
 #include <gtest/gtest.h>
 
+#include "compare.hpp"
+#include "data_file.hpp"
+
 #include <joemath/joemath.hpp>
+#include <joemath/parallel.hpp>
 
 
 using JoeMath::u32;
 using JoeMath::u64;
 
-struct TestDatum
-{
-    TestDatum()
-    {}
-
-    TestDatum( std::string input, std::string output )
-        :m_Input( std::move(input) )
-        ,m_Output( std::move(output) )
-    {}
-
-    std::string m_Input;
-    std::string m_Output;
-};
-
-struct TestData
-{
-    std::vector<TestDatum> m_Datums;
-};
-
-extern std::map<std::string, TestData> g_TestDataMap;
-extern bool                            g_UpdateResults;
-extern bool                            g_GenerateInputData;
+extern TestDataFile                         g_TestDataFile;
+extern bool                                 g_UpdateResults;
+extern bool                                 g_GenerateInputData;
+extern u32                                  g_GenerateCount;
+extern std::unique_ptr<JoeMath::ThreadPool> g_ThreadPool;
+extern bool                                 g_NumericCompare;
+extern Tolerance                            g_DefaultTolerance;
+extern ErrorReport                          g_ErrorReport;
 
 ////////////////////////////////////////////////////////////////////////////////
 // Template Magic
@@ -230,13 +221,26 @@ namespace detail
     // Testing
     ////////////////////////////////////////////////////////////////////////////
 
+    inline bool AtEnd( std::istream& in )
+    {
+        std::streambuf* buf = in.rdbuf();
+        while( std::isspace( buf->sgetc() ) )
+            buf->sbumpc();
+        return buf->sgetc() == std::char_traits<char>::eof();
+    }
+
+    //
+    // This is called from several threads at once so rather than reporting
+    // malformed input itself it sets error, which is reported afterwards
+    //
     template <typename R, typename I>
-    std::string GetResult( const std::string& input,
+    std::string GetResult( std::istream& input,
                            const std::function<R()>& f,
-                           I )
+                           I,
+                           const char*& error )
     {
-        if( !input.empty() )
-            ADD_FAILURE() << "Extra arguments in test input";
+        if( !AtEnd( input ) )
+            error = "Extra arguments in test input";
 
         std::stringstream ret;
         ret << std::setprecision( std::numeric_limits<R>::digits10 + 1) <<
@@ -249,25 +253,24 @@ namespace detail
     template <typename R,
               int... I, template<int...> class P,
               typename First, typename... Rest>
-    std::string GetResult( const std::string& input,
+    std::string GetResult( std::istream& input,
                            const std::function<R(First, Rest...)>& f,
-                           P<I...> )
+                           P<I...>,
+                           const char*& error )
     {
-        if( input.empty() )
-            ADD_FAILURE() << "Too few arguments in test input";
+        if( AtEnd( input ) )
+            error = "Too few arguments in test input";
 
-        std::stringstream ss( input );
         using G = typename std::remove_cv<
                   typename std::remove_reference<First>::type>::type;
         G p;
-        ss >> p;
-
-        std::string rest;
-        std::getline( ss, rest, char(0) );
+        input >> p;
 
         auto b = std::bind( f, p, Placeholder<I>()... );
         std::function<R(Rest...)> g = b;
-        return GetResult( rest, g, typename Indices1<sizeof...(Rest)>::type{} );
+        return GetResult( input, g,
+                          typename Indices1<sizeof...(Rest)>::type{},
+                          error );
     }
 }
 
@@ -281,9 +284,13 @@ TestData GenerateInputData( const std::function<R(Ps...)>& )
         return ret;
     }
 
-    for( u32 i = 0; i < 10; ++i )
-        ret.m_Datums.push_back( TestDatum( detail::GetInputString<Ps...>(
-                                                std::function<int()>()), "" ) );
+    for( u32 i = 0; i < g_GenerateCount; ++i )
+    {
+        TestDatum d;
+        d.m_Input = g_TestDataFile.Intern( detail::GetInputString<Ps...>(
+                                                   std::function<int()>() ) );
+        ret.m_Datums.push_back( d );
+    }
 
     return ret;
 }
@@ -294,41 +301,120 @@ TestData GenerateInputData( R(*f)(Ps...) )
     return GenerateInputData( std::function<R(Ps...)>() );
 }
 
-
+/**
+  * Calculates the results of the datums in [begin, end), this only reads the
+  * test data so it's safe to call from several threads at once
+  */
 template <typename R, typename... Ps>
-void Test( const std::string& input, std::string& output,
-           const std::function<R(Ps...)>& f )
+void GetResults( const TestData& test_data,
+                 u32 begin,
+                 u32 end,
+                 const std::function<R(Ps...)>& f,
+                 std::vector<std::string>& results,
+                 std::vector<const char*>& errors )
 {
-    std::string result = detail::GetResult( input, f,
-                  typename detail::Indices1<sizeof...(Ps)>::type{} );
-
-    if( g_UpdateResults )
-        output = result;
-
-    ASSERT_EQ( output, result ) << "On Input: \"" << input << "\"";
+    for( u32 i = begin; i < end; ++i )
+    {
+        TestStringBuf buf( test_data.m_Datums[i].m_Input );
+        std::istream in( &buf );
+        results[i] = detail::GetResult( in, f,
+                       typename detail::Indices1<sizeof...(Ps)>::type{},
+                       errors[i] );
+    }
 }
 
-template <typename R, typename... Ps>
-void Test( const std::string& input, std::string& output,
-           R(*f)(Ps...) )
+std::string GetCurrentTestName();
+
+/**
+  * Compares every datum's result numerically and adds them to the report.
+  * Only the first failure is described so that large data sets don't flood
+  * the output.
+  */
+template <typename R>
+void CompareNumerically( const std::string& test_name,
+                         const TestData& test_data,
+                         const std::vector<std::string>& results,
+                         const Tolerance& tolerance )
 {
-    Test( input, output, std::function<R(Ps...)>(f) );
+    u32 failures = 0;
+    for( u32 i = 0; i < results.size(); ++i )
+    {
+        const TestDatum& d = test_data.m_Datums[i];
+        const Comparison c = CompareResults<R>( d.m_Output, results[i] );
+        const bool passed = c.Passes( tolerance );
+        g_ErrorReport.Add( test_name, c, passed );
+
+        if( !passed && failures++ == 0 )
+            ADD_FAILURE() << "Expected \"" << d.m_Output <<
+                             "\" but got \"" << results[i] <<
+                             "\", " << c.m_Ulps << " ulps and " <<
+                             c.m_RelativeError << " relative error " <<
+                             "on input: \"" << d.m_Input << "\"";
+    }
+    if( failures > 1 )
+        ADD_FAILURE() << "and " << failures - 1 << " more of " <<
+                         results.size() << " datums outside the tolerance";
 }
 
-TestData& GetCurrentTestData();
-
-template <typename F>
-void RunAllTests( F f )
+/**
+  * Runs f on every datum of the current test and checks the results. In
+  * numeric mode they may differ from the stored results by up to the larger
+  * of tolerance and the default tolerance.
+  */
+template <typename R, typename... Ps>
+void RunAllTests( const std::function<R(Ps...)>& f,
+                  const Tolerance& tolerance = Tolerance() )
 {
-    TestData& test_data = GetCurrentTestData();
+    const std::string test_name = GetCurrentTestName();
 
     if( g_GenerateInputData )
-        test_data = GenerateInputData( f );
+        g_TestDataFile.SetTestData( test_name, GenerateInputData( f ) );
+
+    //
+    // The datums are shared out between the threads and the results are
+    // kept in order, so the comparisons and any updated data are the same
+    // however many threads there are
+    //
+    const TestData& test_data = g_TestDataFile.GetTestData( test_name );
+    const u32 size = test_data.m_Datums.size();
+
+    ASSERT_NE( 0, size ) << "No test data";
+
+    std::vector<std::string> results( size );
+    std::vector<const char*> errors( size, nullptr );
+    const u32 grain = 64;
+    g_ThreadPool->ParallelFor( 0, size, grain, [&]( u32 begin, u32 end )
+    {
+        GetResults( test_data, begin, end, f, results, errors );
+    } );
 
-    ASSERT_NE( 0, test_data.m_Datums.size() ) << "No test data";
+    for( u32 i = 0; i < size; ++i )
+    {
+        if( errors[i] )
+        {
+            ADD_FAILURE() << errors[i] << " on input: \"" <<
+                             test_data.m_Datums[i].m_Input << "\"";
+        }
+    }
 
-    for( TestDatum& d : test_data.m_Datums )
+    if( g_UpdateResults )
+        g_TestDataFile.SetOutputs( test_name, results );
+    else if( g_NumericCompare )
+        CompareNumerically<R>( test_name, test_data, results,
+                               Max( tolerance, g_DefaultTolerance ) );
+    else
     {
-        Test( d.m_Input, d.m_Output, f );
+        for( u32 i = 0; i < size; ++i )
+        {
+            const TestDatum& d = test_data.m_Datums[i];
+            ASSERT_EQ( d.m_Output, results[i] ) <<
+                "On Input: \"" << d.m_Input << "\"";
+        }
     }
 }
+
+template <typename R, typename... Ps>
+void RunAllTests( R(*f)(Ps...), const Tolerance& tolerance = Tolerance() )
+{
+    RunAllTests( std::function<R(Ps...)>( f ), tolerance );
+}
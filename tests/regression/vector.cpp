@@ -67,25 +67,33 @@ typedef Types< Vector<float, 3> > Vector3Types;
 TYPED_TEST_CASE(VectorTest, VectorTypes);
 TYPED_TEST_CASE(Vector3Test, Vector3Types);
 
+//
+// The functions which sum over the elements may round differently when
+// they're vectorized, so they're given a few ulps for numeric comparisons
+//
+
 TYPED_TEST(VectorTest, Normalized)
 {
     RunAllTests( Normalized<typename TypeParam::scalar_type,
                             TypeParam::rows,
-                            TypeParam::columns> );
+                            TypeParam::columns>,
+                 Tolerance( 4 ) );
 }
 
 TYPED_TEST(VectorTest, Length)
 {
     RunAllTests( Length<typename TypeParam::scalar_type,
                         TypeParam::rows,
-                        TypeParam::columns> );
+                        TypeParam::columns>,
+                 Tolerance( 2 ) );
 }
 
 TYPED_TEST(VectorTest, LengthSq)
 {
     RunAllTests( LengthSq<typename TypeParam::scalar_type,
                           TypeParam::rows,
-                          TypeParam::columns> );
+                          TypeParam::columns>,
+                 Tolerance( 2 ) );
 }
 
 TYPED_TEST(VectorTest, Dot)
@@ -93,7 +101,8 @@ TYPED_TEST(VectorTest, Dot)
     RunAllTests( Dot<typename TypeParam::scalar_type,
                      TypeParam::rows,
                      TypeParam::columns,
-                     typename TypeParam::scalar_type> );
+                     typename TypeParam::scalar_type>,
+                 Tolerance( 2 ) );
 }
 
 TYPED_TEST(Vector3Test, Cross)
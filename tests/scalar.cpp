@@ -342,3 +342,58 @@ TYPED_TEST(ScalarTest, DistanceWorks)
     ASSERT_EQ( 1, Distance( TypeParam{2}, TypeParam{1} ));
     ASSERT_EQ( 1, Distance( TypeParam{2}, TypeParam{3} ));
 }
+
+TYPED_TEST(ScalarTest, SinCos)
+{
+    for( u64 i = 0; i < NUM_TESTS; ++i )
+    {
+        TypeParam x = Rand<TypeParam>();
+        TypeParam s;
+        TypeParam c;
+        SinCos( x, s, c );
+        ASSERT_EQ( std::sin( x ), s );
+        ASSERT_EQ( std::cos( x ), c );
+    }
+}
+
+TYPED_TEST(ScalarTest, SinCosFast)
+{
+    const TypeParam epsilon = std::numeric_limits<TypeParam>::epsilon();
+    std::uniform_real_distribution<TypeParam> d( -Pi<TypeParam>(),
+                                                  Pi<TypeParam>() );
+    std::uniform_real_distribution<TypeParam> large( -8192, 8192 );
+    for( u64 i = 0; i < NUM_TESTS; ++i )
+    {
+        TypeParam s;
+        TypeParam c;
+        TypeParam x = d( g_RandGenerator );
+        SinCosFast( x, s, c );
+        ASSERT_NEAR( std::sin( x ), s, epsilon );
+        ASSERT_NEAR( std::cos( x ), c, epsilon );
+
+        x = large( g_RandGenerator );
+        SinCosFast( x, s, c );
+        ASSERT_NEAR( std::sin( x ), s, epsilon );
+        ASSERT_NEAR( std::cos( x ), c, epsilon );
+
+        //
+        // Outside of the polynomial's range it's the same as SinCos
+        //
+        x = Rand<TypeParam>();
+        if( std::abs( x ) > 8192 )
+        {
+            SinCosFast( x, s, c );
+            ASSERT_EQ( std::sin( x ), s );
+            ASSERT_EQ( std::cos( x ), c );
+        }
+    }
+
+    TypeParam s;
+    TypeParam c;
+    SinCosFast( TypeParam{0}, s, c );
+    ASSERT_EQ( 0, s );
+    ASSERT_EQ( 1, c );
+    SinCosFast( std::numeric_limits<TypeParam>::quiet_NaN(), s, c );
+    ASSERT_TRUE( std::isnan( s ) );
+    ASSERT_TRUE( std::isnan( c ) );
+}
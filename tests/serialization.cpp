@@ -0,0 +1,278 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#include "gtest/gtest.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <joemath/joemath.hpp>
+#include <joemath/serialization.hpp>
+
+using namespace JoeMath;
+
+namespace
+{
+    typedef Matrix<double, 3, 2> double3x2;
+    typedef Vector<double, 4>    double4;
+
+    template <typename T>
+    std::vector<T> RandomMatrices( std::size_t count )
+    {
+        std::mt19937 generator( 6 );
+        std::uniform_real_distribution<double> distribution( -100, 100 );
+        std::vector<T> ret( count );
+        for( T& m : ret )
+            for( u32 i = 0; i < T::rows * T::columns; ++i )
+                m.m_elements[0][i] = static_cast<typename T::scalar_type>(
+                                                    distribution( generator ) );
+        return ret;
+    }
+
+    template <typename T>
+    void ExpectEqual( const std::vector<T>& expected,
+                      const MappedMatrixArray<T>& actual )
+    {
+        ASSERT_TRUE( actual.IsOpen() );
+        ASSERT_EQ( expected.size(), actual.size() );
+        for( std::size_t i = 0; i < expected.size(); ++i )
+            EXPECT_EQ( 0, std::memcmp( &expected[i], &actual[i], sizeof(T) ) )
+                << i;
+    }
+
+    //
+    // Removes the file when it goes out of scope
+    //
+    struct TemporaryFile
+    {
+        explicit TemporaryFile( const std::string& name )
+            :m_name( "joemath_serialization_" + name + ".bin" )
+        { }
+
+        ~TemporaryFile( )
+        {
+            std::remove( m_name.c_str() );
+        }
+
+        const std::string m_name;
+    };
+
+    template <typename T>
+    void RoundTrip( const std::string& name, std::size_t count )
+    {
+        TemporaryFile file( name );
+        std::vector<T> matrices = RandomMatrices<T>( count );
+
+        ASSERT_TRUE( WriteMatrixArray( file.m_name,
+                                       matrices.data(),
+                                       matrices.size() ) );
+
+        MappedMatrixArray<T> mapped( file.m_name );
+        ExpectEqual( matrices, mapped );
+        EXPECT_EQ( 0u, reinterpret_cast<std::size_t>( mapped.data() ) %
+                       alignof(T) );
+    }
+
+    //
+    // Writes a header followed by data_size bytes of zeros
+    //
+    void WriteFile( const std::string& filename,
+                    const MatrixArrayHeader& header,
+                    std::size_t data_size )
+    {
+        std::ofstream file( filename, std::ios::binary );
+        file.write( reinterpret_cast<const char*>( &header ), sizeof(header) );
+        std::vector<char> data( data_size );
+        file.write( data.data(), data.size() );
+    }
+}
+
+TEST(SerializationTest, RoundTrip )
+{
+    RoundTrip<float3>( "float3", 1000 );
+    RoundTrip<float4>( "float4", 1000 );
+    RoundTrip<float4x4>( "float4x4", 1000 );
+    RoundTrip<double3x2>( "double3x2", 1000 );
+    RoundTrip<Matrix<s16, 3, 3>>( "s16_3x3", 1000 );
+    RoundTrip<Matrix<u64, 2, 1>>( "u64_2x1", 1000 );
+}
+
+TEST(SerializationTest, Empty )
+{
+    TemporaryFile file( "empty" );
+
+    MatrixArrayWriter<float4> writer;
+    ASSERT_TRUE( writer.Open( file.m_name ) );
+    ASSERT_TRUE( writer.Close() );
+
+    MappedMatrixArray<float4> mapped;
+    ASSERT_TRUE( mapped.Open( file.m_name ) );
+    EXPECT_TRUE( mapped.empty() );
+    EXPECT_EQ( mapped.begin(), mapped.end() );
+}
+
+//
+// Writes in pieces which don't line up with the buffer, some of which are
+// larger than it
+//
+TEST(SerializationTest, Chunked )
+{
+    TemporaryFile file( "chunked" );
+    std::vector<float4x4> matrices = RandomMatrices<float4x4>( 1000 );
+
+    MatrixArrayWriter<float4x4> writer( sizeof(float4x4) * 7 + 3 );
+    ASSERT_TRUE( writer.Open( file.m_name ) );
+    std::size_t written = 0;
+    std::size_t piece   = 0;
+    while( written < matrices.size() )
+    {
+        if( piece % 3 == 0 )
+        {
+            writer.Write( matrices[written] );
+            ++written;
+        }
+        else
+        {
+            std::size_t count = std::min( piece % 13, matrices.size() - written );
+            writer.Write( matrices.data() + written, count );
+            written += count;
+        }
+        ++piece;
+    }
+    EXPECT_EQ( matrices.size(), writer.GetCount() );
+    ASSERT_TRUE( writer.Close() );
+
+    std::vector<float4x4> read;
+    MappedMatrixArray<float4x4> mapped( file.m_name );
+    for( const float4x4& m : mapped )
+        read.push_back( m );
+    EXPECT_EQ( matrices.size(), read.size() );
+    ExpectEqual( read, mapped );
+    ExpectEqual( matrices, mapped );
+}
+
+TEST(SerializationTest, Header )
+{
+    MatrixArrayHeader header = MatrixArrayHeader::Make<double3x2>( 5 );
+    EXPECT_EQ( 0, std::memcmp( header.m_magic, "JMMATARR", 8 ) );
+    EXPECT_EQ( 1u, header.m_version );
+    EXPECT_EQ( ScalarType::Double, header.m_scalar_type );
+    EXPECT_EQ( sizeof(double), header.m_scalar_size );
+    EXPECT_EQ( 3u, header.m_rows );
+    EXPECT_EQ( 2u, header.m_columns );
+    EXPECT_EQ( sizeof(double3x2), header.m_element_size );
+    EXPECT_EQ( alignof(double3x2), header.m_alignment );
+    EXPECT_EQ( 5u, header.m_count );
+    EXPECT_EQ( 0u, header.m_data_offset % cache_line_size );
+}
+
+TEST(SerializationTest, Rejected )
+{
+    TemporaryFile file( "rejected" );
+    const std::size_t size = sizeof(float4) * 10;
+    MappedMatrixArray<float4> mapped;
+
+    WriteFile( file.m_name, MatrixArrayHeader::Make<float4>( 10 ), size );
+    EXPECT_TRUE( mapped.Open( file.m_name ) );
+    EXPECT_EQ( 10u, mapped.size() );
+
+    //
+    // The wrong type
+    //
+    EXPECT_FALSE( MappedMatrixArray<int4>( file.m_name ).IsOpen() );
+    EXPECT_FALSE( MappedMatrixArray<float3>( file.m_name ).IsOpen() );
+    EXPECT_FALSE( MappedMatrixArray<float2x2>( file.m_name ).IsOpen() );
+    EXPECT_FALSE( MappedMatrixArray<double4>( file.m_name ).IsOpen() );
+
+    //
+    // Truncated
+    //
+    WriteFile( file.m_name, MatrixArrayHeader::Make<float4>( 11 ), size );
+    EXPECT_FALSE( mapped.Open( file.m_name ) );
+    EXPECT_FALSE( mapped.IsOpen() );
+    EXPECT_EQ( 0u, mapped.size() );
+
+    MatrixArrayHeader header = MatrixArrayHeader::Make<float4>( 10 );
+    header.m_count = ~u64( 0 );
+    WriteFile( file.m_name, header, size );
+    EXPECT_FALSE( mapped.Open( file.m_name ) );
+
+    header = MatrixArrayHeader::Make<float4>( 10 );
+    header.m_data_offset = ~u64( 0 );
+    WriteFile( file.m_name, header, size );
+    EXPECT_FALSE( mapped.Open( file.m_name ) );
+
+    {
+        std::ofstream truncated( file.m_name, std::ios::binary );
+        truncated.write( "JMMATARR", 8 );
+    }
+    EXPECT_FALSE( mapped.Open( file.m_name ) );
+
+    //
+    // Not a matrix array, or written somewhere else
+    //
+    header = MatrixArrayHeader::Make<float4>( 10 );
+    header.m_magic[0] = 'X';
+    WriteFile( file.m_name, header, size );
+    EXPECT_FALSE( mapped.Open( file.m_name ) );
+
+    header = MatrixArrayHeader::Make<float4>( 10 );
+    header.m_version = 2;
+    WriteFile( file.m_name, header, size );
+    EXPECT_FALSE( mapped.Open( file.m_name ) );
+
+    header = MatrixArrayHeader::Make<float4>( 10 );
+    header.m_byte_order = 0x04030201;
+    WriteFile( file.m_name, header, size );
+    EXPECT_FALSE( mapped.Open( file.m_name ) );
+
+    EXPECT_FALSE( mapped.Open( "joemath_serialization_missing.bin" ) );
+}
+
+TEST(SerializationTest, Move )
+{
+    TemporaryFile file( "move" );
+    std::vector<float3> matrices = RandomMatrices<float3>( 100 );
+    ASSERT_TRUE( WriteMatrixArray( file.m_name,
+                                   matrices.data(),
+                                   matrices.size() ) );
+
+    MappedMatrixArray<float3> a( file.m_name );
+    MappedMatrixArray<float3> b( std::move( a ) );
+    EXPECT_FALSE( a.IsOpen() );
+    ExpectEqual( matrices, b );
+
+    MappedMatrixArray<float3> c;
+    c = std::move( b );
+    EXPECT_FALSE( b.IsOpen() );
+    ExpectEqual( matrices, c );
+}
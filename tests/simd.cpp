@@ -0,0 +1,185 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#include "gtest/gtest.h"
+#include <random>
+
+#include <joemath/joemath.hpp>
+
+using namespace JoeMath;
+
+//
+// These check that the SIMD overloads for float4 and float4x4 agree with the
+// generic versions. Explicitly specifying the template arguments forces the
+// generic version to be called.
+//
+
+namespace
+{
+    template <typename T>
+    T GetRandomMatrix()
+    {
+        static std::uniform_real_distribution<typename T::scalar_type> re(-1000,
+                                                                          1000);
+        static auto ran = std::bind(re,std::minstd_rand());
+        T ret;
+        for( u32 i = 0; i < T::columns; ++i )
+            for( u32 j = 0; j < T::rows; ++j )
+                ret.m_elements[i][j] = ran();
+        return ret;
+    }
+}
+
+template <typename T>
+class SimdTest : public testing::Test
+{
+};
+
+using testing::Types;
+
+typedef Types<float4, float4x4> SimdTypes;
+
+TYPED_TEST_CASE(SimdTest, SimdTypes);
+
+TYPED_TEST(SimdTest, Negation )
+{
+    TypeParam m = GetRandomMatrix<TypeParam>();
+    ASSERT_EQ( (operator-<float, TypeParam::rows, TypeParam::columns>(m)), -m );
+}
+
+TYPED_TEST(SimdTest, ScalarArithmetic )
+{
+    TypeParam m = GetRandomMatrix<TypeParam>();
+    float s = GetRandomMatrix<Matrix<float,1,1>>()[0];
+    ASSERT_EQ( (operator+<float, TypeParam::rows, TypeParam::columns, float>(m, s)),
+               m + s );
+    ASSERT_EQ( (operator-<float, TypeParam::rows, TypeParam::columns, float>(m, s)),
+               m - s );
+    ASSERT_EQ( (operator*<float, TypeParam::rows, TypeParam::columns, float>(m, s)),
+               m * s );
+    ASSERT_EQ( (operator/<float, TypeParam::rows, TypeParam::columns, float>(m, s)),
+               m / s );
+}
+
+TYPED_TEST(SimdTest, ComponentWiseArithmetic )
+{
+    TypeParam m = GetRandomMatrix<TypeParam>();
+    TypeParam n = GetRandomMatrix<TypeParam>();
+    ASSERT_EQ( (operator+<float, TypeParam::rows, TypeParam::columns, float>(m, n)),
+               m + n );
+    ASSERT_EQ( (operator-<float, TypeParam::rows, TypeParam::columns, float>(m, n)),
+               m - n );
+    ASSERT_EQ( (operator*<float, TypeParam::rows, TypeParam::columns, float>(m, n)),
+               m * n );
+    ASSERT_EQ( (operator/<float, TypeParam::rows, TypeParam::columns, float>(m, n)),
+               m / n );
+}
+
+TYPED_TEST(SimdTest, Assignment )
+{
+    TypeParam m = GetRandomMatrix<TypeParam>();
+    TypeParam n = GetRandomMatrix<TypeParam>();
+    float s = GetRandomMatrix<Matrix<float,1,1>>()[0];
+    TypeParam o;
+    TypeParam p;
+
+    o = m; o += s; p = m;
+    ASSERT_EQ( (operator+=<float, TypeParam::rows, TypeParam::columns>(p, s)), o );
+    o = m; o -= s; p = m;
+    ASSERT_EQ( (operator-=<float, TypeParam::rows, TypeParam::columns>(p, s)), o );
+    o = m; o *= s; p = m;
+    ASSERT_EQ( (operator*=<float, TypeParam::rows, TypeParam::columns>(p, s)), o );
+    o = m; o /= s; p = m;
+    ASSERT_EQ( (operator/=<float, TypeParam::rows, TypeParam::columns>(p, s)), o );
+    o = m; o += n; p = m;
+    ASSERT_EQ( (operator+=<float, TypeParam::rows, TypeParam::columns>(p, n)), o );
+    o = m; o -= n; p = m;
+    ASSERT_EQ( (operator-=<float, TypeParam::rows, TypeParam::columns>(p, n)), o );
+    o = m; o *= n; p = m;
+    ASSERT_EQ( (operator*=<float, TypeParam::rows, TypeParam::columns>(p, n)), o );
+    o = m; o /= n; p = m;
+    ASSERT_EQ( (operator/=<float, TypeParam::rows, TypeParam::columns>(p, n)), o );
+}
+
+TYPED_TEST(SimdTest, Mul )
+{
+    float4x4 m = GetRandomMatrix<float4x4>();
+    TypeParam n = GetRandomMatrix<TypeParam>();
+    ASSERT_EQ( (Mul<float, 4, 4, float, TypeParam::columns>(m, n)), Mul(m, n) );
+}
+
+TEST(SimdTest, Dot )
+{
+    float4 v = GetRandomMatrix<float4>();
+    float4 u = GetRandomMatrix<float4>();
+    ASSERT_EQ( (Dot<float, 4, 1, float>(v, u)), Dot(v, u) );
+}
+
+TEST(SimdTest, Cross )
+{
+    float3 v = GetRandomMatrix<float3>();
+    float3 u = GetRandomMatrix<float3>();
+    ASSERT_EQ( (Cross<float, 3, 1, float>(v, u)), Cross(v, u) );
+}
+
+TEST(SimdTest, Transposed )
+{
+    float4x4 m = GetRandomMatrix<float4x4>();
+    ASSERT_EQ( (Transposed<float, 4, 4>(m)), Transposed(m) );
+}
+
+TEST(SimdTest, Determinant )
+{
+    float4x4 m = GetRandomMatrix<float4x4>();
+
+    //
+    // Compare relative to the Hadamard bound, the determinant itself can be
+    // arbitrarily small
+    //
+    float bound = 1;
+    for( u32 i = 0; i < 4; ++i )
+        bound *= m.GetColumn(i).Length();
+
+    ASSERT_NEAR( (Determinant<float, 4, 4>(m)), Determinant(m), bound * 1e-5f );
+}
+
+TEST(SimdTest, Inverted )
+{
+    float4x4 m = GetRandomMatrix<float4x4>();
+    float4x4 n = Inverted<float, 4, 4>(m);
+    float4x4 o = Inverted(m);
+
+    float largest = 0;
+    for( u32 i = 0; i < 16; ++i )
+        largest = std::max( largest, std::abs(n.m_elements[0][i]) );
+
+    for( u32 i = 0; i < 4; ++i )
+        for( u32 j = 0; j < 4; ++j )
+            ASSERT_NEAR( n.m_elements[i][j], o.m_elements[i][j],
+                         largest * 1e-3f );
+}
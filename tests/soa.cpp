@@ -0,0 +1,227 @@
+/*
+    Copyright 2013 Joe Hermaszewski. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are
+    permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this list of
+    conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice, this list
+    of conditions and the following disclaimer in the documentation and/or other materials
+    provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY Joe Hermaszewski "AS IS" AND ANY EXPRESS OR IMPLIED
+    WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Joe Hermaszewski OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+    ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+    ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    The views and conclusions contained in the software and documentation are those of the
+    authors and should not be interpreted as representing official policies, either expressed
+    or implied, of Joe Hermaszewski.
+*/
+
+#include "gtest/gtest.h"
+#include <random>
+#include <vector>
+
+#include <joemath/joemath.hpp>
+#include <joemath/soa.hpp>
+
+using namespace JoeMath;
+
+//
+// The containers should give exactly the same results as the Vector
+// functions on each element
+//
+
+namespace
+{
+    template <typename T>
+    T GetRandomMatrix()
+    {
+        static std::uniform_real_distribution<typename T::scalar_type> re(-1000,
+                                                                          1000);
+        static auto ran = std::bind(re,std::minstd_rand());
+        T ret;
+        for( u32 i = 0; i < T::columns; ++i )
+            for( u32 j = 0; j < T::rows; ++j )
+                ret.m_elements[i][j] = ran();
+        return ret;
+    }
+
+    template <typename Container>
+    std::vector<typename Container::value_type> GetRandomVectors( u32 count )
+    {
+        std::vector<typename Container::value_type> ret( count );
+        for( auto& v : ret )
+            v = GetRandomMatrix<typename Container::value_type>();
+        return ret;
+    }
+
+    //
+    // Applies f to every element and compares against the container
+    //
+    template <typename Container, typename T, typename F>
+    void ExpectElementWise( const Container& c, const std::vector<T>& a,
+                            F f )
+    {
+        ASSERT_EQ( a.size(), c.GetSize() );
+        for( u32 i = 0; i < a.size(); ++i )
+            ASSERT_EQ( f( i ), c[i] ) << "at element " << i;
+    }
+}
+
+template <typename T>
+class SoATest : public testing::Test
+{
+};
+
+using testing::Types;
+
+typedef Types<VectorSoA<float, 3>,
+              VectorSoA<float, 4>,
+              VectorSoA<double, 3>,
+              AoSoA<float, 3, 4>,
+              AoSoA<float, 3, 8>,
+              AoSoA<double, 3, 4>  > SoATypes;
+
+TYPED_TEST_CASE(SoATest, SoATypes);
+
+//
+// Odd so that there's a partial pack or block at the end
+//
+const u32 COUNT = 37;
+
+TYPED_TEST(SoATest, Conversion )
+{
+    auto a = GetRandomVectors<TypeParam>( COUNT );
+    TypeParam c( a );
+    ASSERT_EQ( COUNT, c.GetSize() );
+    ASSERT_EQ( a, c.ToAoS() );
+
+    TypeParam d;
+    for( const auto& v : a )
+        d.PushBack( v );
+    ASSERT_EQ( a, d.ToAoS() );
+}
+
+TYPED_TEST(SoATest, Reference )
+{
+    typedef typename TypeParam::value_type Vector;
+    auto a = GetRandomVectors<TypeParam>( COUNT );
+    TypeParam c( a );
+
+    Vector v = c[3];
+    ASSERT_EQ( a[3], v );
+
+    c[5] = a[0];
+    ASSERT_EQ( a[0], Vector( c[5] ) );
+
+    c[6] = c[7];
+    ASSERT_EQ( a[7], Vector( c[6] ) );
+
+    c[8][1] = 2;
+    ASSERT_EQ( 2, c[8][1] );
+    ASSERT_EQ( a[8][0], c[8][0] );
+}
+
+TYPED_TEST(SoATest, Resize )
+{
+    typedef typename TypeParam::value_type Vector;
+    auto a = GetRandomVectors<TypeParam>( COUNT );
+    TypeParam c( a );
+    c.Resize( 2 );
+    c.Resize( COUNT );
+    ASSERT_EQ( a[1], Vector( c[1] ) );
+    for( u32 i = 2; i < COUNT; ++i )
+        ASSERT_EQ( Vector( 0 ), Vector( c[i] ) );
+}
+
+TYPED_TEST(SoATest, Arithmetic )
+{
+    typedef typename TypeParam::scalar_type Scalar;
+    auto a = GetRandomVectors<TypeParam>( COUNT );
+    auto b = GetRandomVectors<TypeParam>( COUNT );
+    Scalar s = GetRandomMatrix<Matrix<Scalar, 1, 1>>()[0];
+    TypeParam ca( a );
+    TypeParam cb( b );
+
+    ExpectElementWise( ca + cb, a, [&]( u32 i ){ return a[i] + b[i]; } );
+    ExpectElementWise( ca - cb, a, [&]( u32 i ){ return a[i] - b[i]; } );
+    ExpectElementWise( ca * cb, a, [&]( u32 i ){ return a[i] * b[i]; } );
+    ExpectElementWise( ca / cb, a, [&]( u32 i ){ return a[i] / b[i]; } );
+    ExpectElementWise( ca + s, a, [&]( u32 i ){ return a[i] + s; } );
+    ExpectElementWise( ca - s, a, [&]( u32 i ){ return a[i] - s; } );
+    ExpectElementWise( ca * s, a, [&]( u32 i ){ return a[i] * s; } );
+    ExpectElementWise( s * ca, a, [&]( u32 i ){ return s * a[i]; } );
+    ExpectElementWise( ca / s, a, [&]( u32 i ){ return a[i] / s; } );
+
+    TypeParam c( ca );
+    c += cb;
+    c *= s;
+    c -= ca;
+    c /= cb;
+    ExpectElementWise( c, a, [&]( u32 i ){ return ( ( a[i] + b[i] ) * s -
+                                                    a[i] ) / b[i]; } );
+}
+
+TYPED_TEST(SoATest, VectorFunctions )
+{
+    typedef typename TypeParam::scalar_type Scalar;
+    auto a = GetRandomVectors<TypeParam>( COUNT );
+    auto b = GetRandomVectors<TypeParam>( COUNT );
+    TypeParam ca( a );
+    TypeParam cb( b );
+
+    auto dot = Dot( ca, cb );
+    auto length = Length( ca );
+    auto length_sq = LengthSq( ca );
+    for( u32 i = 0; i < COUNT; ++i )
+    {
+        ASSERT_EQ( Dot( a[i], b[i] ), dot[i][0] );
+        ASSERT_EQ( Length( a[i] ), length[i][0] );
+        ASSERT_EQ( LengthSq( a[i] ), length_sq[i][0] );
+    }
+
+    ExpectElementWise( Normalized( ca ), a,
+                       [&]( u32 i ){ return Normalized( a[i] ); } );
+    ExpectElementWise( Lerp( ca, cb, Scalar{0.25} ), a,
+                       [&]( u32 i ){ return Lerp( a[i], b[i], Scalar{0.25} ); } );
+
+    Normalize( ca );
+    ExpectElementWise( ca, a, [&]( u32 i ){ return Normalized( a[i] ); } );
+}
+
+template <typename T>
+class SoACrossTest : public testing::Test
+{
+};
+
+typedef Types<VectorSoA<float, 3>,
+              VectorSoA<double, 3>,
+              AoSoA<float, 3, 4>,
+              AoSoA<float, 3, 8>  > SoACrossTypes;
+
+TYPED_TEST_CASE(SoACrossTest, SoACrossTypes);
+
+TYPED_TEST(SoACrossTest, Cross )
+{
+    auto a = GetRandomVectors<TypeParam>( COUNT );
+    auto b = GetRandomVectors<TypeParam>( COUNT );
+    TypeParam ca( a );
+    TypeParam cb( b );
+    ExpectElementWise( Cross( ca, cb ), a,
+                       [&]( u32 i ){ return Cross( a[i], b[i] ); } );
+
+    //
+    // In place
+    //
+    ca = Cross( ca, cb );
+    ExpectElementWise( ca, a, [&]( u32 i ){ return Cross( a[i], b[i] ); } );
+}
@@ -1,5 +1,6 @@
 #include "gtest/gtest.h"
 #include <functional>
+#include <limits>
 #include <random>
 
 #include <joemath/joemath.hpp>
@@ -435,6 +436,42 @@ TYPED_TEST(VectorTest, NormalizedLength )
     ASSERT_FLOAT_EQ( 1, Length(v) );
 }
 
+TYPED_TEST(VectorTest, NormalizedVariants )
+{
+    typedef typename TypeParam::scalar_type Scalar;
+    auto v = GetRandomVector<TypeParam>();
+    auto u = Normalized(v);
+    ASSERT_EQ( u, NormalizedPrecise(v) );
+    ASSERT_EQ( u, NormalizedSafe(v) );
+
+    auto f = NormalizedFast(v);
+    for( u32 i = 0; i < v.vector_size; ++i )
+        ASSERT_NEAR( u[i], f[i], 4 * std::numeric_limits<Scalar>::epsilon() );
+
+    TypeParam fallback( Scalar{1} );
+    ASSERT_EQ( fallback, NormalizedSafe( TypeParam( Scalar{0} ), fallback ) );
+    ASSERT_EQ( TypeParam( Scalar{0} ),
+               NormalizedSafe( TypeParam( Scalar{0} ) ) );
+    ASSERT_EQ( fallback, NormalizedSafe(
+                  TypeParam( std::numeric_limits<Scalar>::quiet_NaN() ),
+                  fallback ) );
+    ASSERT_EQ( fallback, NormalizedSafe(
+                  TypeParam( std::numeric_limits<Scalar>::infinity() ),
+                  fallback ) );
+}
+
+TYPED_TEST(VectorTest, LengthVariants )
+{
+    typedef typename TypeParam::scalar_type Scalar;
+    auto v = GetRandomVector<TypeParam>();
+    const Scalar length = Length(v);
+    ASSERT_NEAR( length, LengthFast(v),
+                 4 * std::numeric_limits<Scalar>::epsilon() * length );
+    ASSERT_NEAR( 1 / length, InverseLength(v),
+                 2 * std::numeric_limits<Scalar>::epsilon() / length );
+    ASSERT_EQ( 0, LengthFast( TypeParam( Scalar{0} ) ) );
+}
+
 TYPED_TEST(VectorTest, LengthIsNonNegative )
 {
     auto v = GetRandomVector<TypeParam>();